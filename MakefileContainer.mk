@@ -53,6 +53,7 @@ define run_docker
 	-e DEVEL=$(DEVEL) \
 	-e TARGET_NAME=$(TARGET_NAME) \
 	-e NO_INTEGRITY_CHECK=$(NO_INTEGRITY_CHECK) \
+	-e HEADLESS=$(HEADLESS) \
 	-u $(USERID):$(USERID) \
 	-v $(shell pwd):/app \
 	$(1) \
@@ -88,6 +89,10 @@ listvariants:
 size:
 	$(call run_docker, , make size)
 
+.PHONY: ram_report
+ram_report:
+	$(call run_docker, , make ram_report)
+
 
 ##############
 #   Style    #
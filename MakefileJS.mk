@@ -55,3 +55,22 @@ js-prepublish:
 js-run-example:
 	cd ledgerjs-fio && yarn run-example && cd ..
 
+.PHONY: js-export-transcripts
+js-export-transcripts:
+	cd ledgerjs-fio && yarn export-transcripts && cd ..
+
+.PHONY: js-check-transcripts
+js-check-transcripts:
+	cd ledgerjs-fio && yarn check-transcripts && cd ..
+
+.PHONY: js-bench-sign
+js-bench-sign:
+	cd ledgerjs-fio && yarn bench-sign && cd ..
+
+.PHONY: js-integrity-hashes
+js-integrity-hashes:
+	cd ledgerjs-fio && yarn integrity-hashes && cd ..
+
+.PHONY: js-check-integrity-hashes
+js-check-integrity-hashes:
+	cd ledgerjs-fio && yarn check-integrity-hashes && cd ..
@@ -92,6 +92,9 @@ ifeq ($(DEVEL), 1)
 	ifeq ($(NO_INTEGRITY_CHECK), 1)
 	DEFINES += NO_INTEGRITY_CHECK
 	endif
+	ifeq ($(HEADLESS), 1)
+	DEFINES += HEADLESS
+	endif
 else
 	DEFINES += RESET_ON_CRASH
 	DEFINES += PRINTF\(...\)=
@@ -195,3 +198,11 @@ format:
 size: bin/app.elf
 	$(GCCPATH)arm-none-eabi-size --format=GNU bin/app.elf
 
+# Sizes and offsets of instruction contexts and their fields, as laid out for the target
+# see src/ramReport.c
+ram_report:
+	@$(CC) -S -o - $(CFLAGS) $(addprefix -D,$(DEFINES)) -DRAM_REPORT $(addprefix -I,$(INCLUDES_PATH)) src/ramReport.c \
+	| sed -n -e 's/^.*->RAM_REPORT //p' | tr -d '#$$' \
+	| awk '{ printf "%-64s %6d %6d\n", $$1, $$2, $$3 }' \
+	| { printf "%-64s %6s %6s\n" "STRUCT / FIELD" "SIZE" "OFFSET"; cat; }
+
@@ -30,25 +30,40 @@ define run_nodejs_test
         } | tee -a ../speculos-port-$(1).log >&4; } 3>&1 | { read xs; exit $$xs; } } 4>&1
 endef
 
+define newline
+
+
+endef
+
+# run_nodejs_test of every test file in $(3), one recipe line each, so the first failure stops
+define run_nodejs_tests
+$(foreach test,$(3),$(call run_nodejs_test,$(1),$(2),$(test))$(newline))
+endef
+
+# The integration tests run by speculos_port_5001_test, speculos_port_5001_test_single_process
+# and speculos_parallel_test, the longest first so that the parallel shards are balanced
+# (getVersion.js is not run)
+SPECULOS_TESTS ?= \
+	signTransactionOtherFioAddress.js \
+	signTransactionAddaddress.js \
+	signTransactionRemaddress.js \
+	signTransactionRecordobt.js \
+	signTransactionAddnft.js \
+	signTransactionRemnft.js \
+	signTransactionTrnsfiopubky.js \
+	signTransactionNewfundsreq.js \
+	signTransactionOtherEosio.js \
+	signTransactionOtherFioStaking.js \
+	signTransactionOtherFioReqobt.js \
+	signTransactionOtherFioOracle.js \
+	decodeMessage.js \
+	getPublicKey.js \
+	getSerial.js
+
 .PHONY: speculos_port_5001_test_internal
 speculos_port_5001_test_internal:
 	$(call run_announce,$@)
-#	$(call run_nodejs_test,5001,40001,getVersion.js)
-	$(call run_nodejs_test,5001,40001,getSerial.js)
-	$(call run_nodejs_test,5001,40001,getPublicKey.js)
-	$(call run_nodejs_test,5001,40001,decodeMessage.js)
-	$(call run_nodejs_test,5001,40001,signTransactionTrnsfiopubky.js)
-	$(call run_nodejs_test,5001,40001,signTransactionNewfundsreq.js)
-	$(call run_nodejs_test,5001,40001,signTransactionRecordobt.js)
-	$(call run_nodejs_test,5001,40001,signTransactionAddaddress.js)
-	$(call run_nodejs_test,5001,40001,signTransactionRemaddress.js)
-	$(call run_nodejs_test,5001,40001,signTransactionAddnft.js)
-	$(call run_nodejs_test,5001,40001,signTransactionRemnft.js)
-	$(call run_nodejs_test,5001,40001,signTransactionOtherFioAddress.js)	
-	$(call run_nodejs_test,5001,40001,signTransactionOtherFioReqobt.js)	
-	$(call run_nodejs_test,5001,40001,signTransactionOtherFioStaking.js)	
-	$(call run_nodejs_test,5001,40001,signTransactionOtherEosio.js)	
-	$(call run_nodejs_test,5001,40001,signTransactionOtherFioOracle.js)	
+	$(call run_nodejs_tests,5001,40001,$(SPECULOS_TESTS))
 	@echo "# ALL TESTS COMPLETED!" | tee -a speculos-port-5001.log
 
 .PHONY: speculos_port_5001_unit_test_internal
@@ -73,9 +88,108 @@ speculos_port_5001_test:
 	$(call run_announce,$@)
 	$(MAKE) --no-print-directory speculos_port_5001_start && ($(MAKE) --no-print-directory speculos_port_5001_test_internal; ret=$$?;$(MAKE) --no-print-directory speculos_port_5001_stop;$(call run_announce,note: logs: cat speculos-port-5001.log);cat speculos-port-5001.log; exit $$ret)
 
-.PHONY: get_integrity_hashes_from_logs
-get_integrity_hashes_from_logs:
-	sed -n -e  's/^.*Integrity check for: //p' speculos-port-5001.log
+# The tests run in a single node process (test-integration/runAllTests.js), the per-file startup
+# is paid only once
+.PHONY: speculos_port_5001_test_single_process_internal
+speculos_port_5001_test_single_process_internal:
+	$(call run_announce,$@)
+	$(call run_nodejs_test,5001,40001,runAllTests.js $(SPECULOS_TESTS))
+	@echo "# ALL TESTS COMPLETED!" | tee -a speculos-port-5001.log
+
+.PHONY: speculos_port_5001_test_single_process
+speculos_port_5001_test_single_process:
+	$(call run_announce,$@)
+	$(MAKE) --no-print-directory speculos_port_5001_start && ($(MAKE) --no-print-directory speculos_port_5001_test_single_process_internal; ret=$$?;$(MAKE) --no-print-directory speculos_port_5001_stop;$(call run_announce,note: logs: cat speculos-port-5001.log);cat speculos-port-5001.log; exit $$ret)
+
+# Tests of the host-side parts of ledgerjs-fio, no speculos container is started
+.PHONY: host_test
+host_test:
+	$(call run_announce,$@)
+	@cd $(TESTS_SPECULOS_DIR) && node hostTests.js
+
+# Parallel integration tests: SPECULOS_PARALLEL_INSTANCES containers, instance i listens
+# on ports 5000+i (API) and 40000+i (APDU) and logs to speculos-port-<5000+i>.log.
+# The test files are sharded round-robin among the instances.
+
+SPECULOS_PARALLEL_INSTANCES ?= $(shell nproc)
+
+SPECULOS_PARALLEL_INDEXES = $(shell seq 1 $(SPECULOS_PARALLEL_INSTANCES))
+speculos_parallel_api_port = $(shell expr 5000 + $(1))
+speculos_parallel_apdu_port = $(shell expr 40000 + $(1))
+# tests of instance $(1): every SPECULOS_PARALLEL_INSTANCES-th test starting with the $(1)-th one
+speculos_parallel_shard = $(shell echo $(SPECULOS_TESTS) | tr ' ' '\n' | awk 'NR % $(SPECULOS_PARALLEL_INSTANCES) == $(1) % $(SPECULOS_PARALLEL_INSTANCES)')
+
+# Runs the shard of one instance, the failed tests are written to speculos-port-<port>.failed
+.PHONY: speculos_parallel_instance_%
+speculos_parallel_instance_%:
+	$(call run_announce,$@)
+	$(call start_speculos_container,$(call speculos_parallel_api_port,$*),$(call speculos_parallel_apdu_port,$*),/bin)
+	@: > speculos-port-$(call speculos_parallel_api_port,$*).failing
+	$(foreach test,$(call speculos_parallel_shard,$*),$(call run_nodejs_test,$(call speculos_parallel_api_port,$*),$(call speculos_parallel_apdu_port,$*),$(test)) \
+	  || printf ' %s' $(test) >> ../speculos-port-$(call speculos_parallel_api_port,$*).failing$(newline))
+	@mv speculos-port-$(call speculos_parallel_api_port,$*).failing speculos-port-$(call speculos_parallel_api_port,$*).failed
+	$(call stop_speculos_container,$(call speculos_parallel_api_port,$*))
+
+.PHONY: speculos_parallel_test
+speculos_parallel_test:
+	$(call run_announce,$@)
+	$(DOCKER_SPECULOS_PULL_COMMAND)
+	@rm -f speculos-port-*.failed
+	@$(MAKE) --no-print-directory -k -O -j$(SPECULOS_PARALLEL_INSTANCES) NO_PULL=1 $(addprefix speculos_parallel_instance_,$(SPECULOS_PARALLEL_INDEXES)); \
+	ret=$$?; \
+	for i in $(SPECULOS_PARALLEL_INDEXES); do \
+	  port=$$(expr 5000 + $$i); \
+	  if [ ! -f speculos-port-$$port.failed ]; then \
+	    echo "# instance $$i did not finish, see speculos-port-$$port.log"; ret=1; \
+	  elif [ -n "$$(cat speculos-port-$$port.failed)" ]; then \
+	    echo "# instance $$i FAILED:$$(cat speculos-port-$$port.failed), see speculos-port-$$port.log"; ret=1; \
+	  fi; \
+	done; \
+	if [ $$ret -eq 0 ]; then echo "# ALL TESTS COMPLETED!"; fi; \
+	exit $$ret
+
+# FioPool load test: SPECULOS_POOL_INSTANCES containers on the ports of the parallel tests,
+# the throughput of pools of 1, 2, 4, ... of them is written to speculos-pool-load-test.log
+
+SPECULOS_POOL_INSTANCES ?= 4
+SPECULOS_POOL_REQUESTS ?= 200
+SPECULOS_POOL_INDEXES = $(shell seq 1 $(SPECULOS_POOL_INSTANCES))
+
+.PHONY: speculos_pool_start_%
+speculos_pool_start_%:
+	$(call start_speculos_container,$(call speculos_parallel_api_port,$*),$(call speculos_parallel_apdu_port,$*),/bin)
+
+.PHONY: speculos_pool_stop_%
+speculos_pool_stop_%:
+	$(call stop_speculos_container,$(call speculos_parallel_api_port,$*))
+
+.PHONY: speculos_pool_load_test
+speculos_pool_load_test:
+	$(call run_announce,$@)
+	$(DOCKER_SPECULOS_PULL_COMMAND)
+	@$(MAKE) --no-print-directory -j$(SPECULOS_POOL_INSTANCES) NO_PULL=1 $(addprefix speculos_pool_start_,$(SPECULOS_POOL_INDEXES)) && \
+	(cd $(TESTS_SPECULOS_DIR) && TEST_SPECULOS_APDU_PORT=40001 node poolLoadTest.js $(SPECULOS_POOL_INSTANCES) $(SPECULOS_POOL_REQUESTS) > ../speculos-pool-load-test.log 2>&1); \
+	ret=$$?; \
+	cat speculos-pool-load-test.log; \
+	$(MAKE) --no-print-directory -k $(addprefix speculos_pool_stop_,$(SPECULOS_POOL_INDEXES)); \
+	exit $$ret
+
+# Bulk signing load test: tools/bulkSign.ts signs SPECULOS_BULK_SIGN_TRANSACTIONS sample transactions
+# on one container, the app has to be built with DEVEL=1 HEADLESS=1 to confirm them by itself
+
+SPECULOS_BULK_SIGN_TRANSACTIONS ?= 100
+
+.PHONY: speculos_bulk_sign_test
+speculos_bulk_sign_test:
+	$(DOCKER_SPECULOS_PULL_COMMAND)
+	@$(MAKE) --no-print-directory NO_PULL=1 speculos_pool_start_1 && \
+	(cd ledgerjs-fio && yarn -s sample-transactions $(SPECULOS_BULK_SIGN_TRANSACTIONS) \
+	  | yarn -s bulk-sign --transport speculos:$(call speculos_parallel_apdu_port,1) --output ../speculos-bulk-sign.jsonl \
+	  > ../speculos-bulk-sign-test.log 2>&1); \
+	ret=$$?; \
+	cat speculos-bulk-sign-test.log; \
+	$(MAKE) --no-print-directory -k speculos_pool_stop_1; \
+	exit $$ret
 
 .PHONY: get_allowed_sequences_from_logs
 get_allowed_sequences_from_logs:
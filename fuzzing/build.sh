@@ -11,4 +11,4 @@ cd "$BUILDDIR"
 
 cmake -DCMAKE_C_COMPILER=clang ..
 make clean
-make fuzz_message
\ No newline at end of file
+make fuzz_message fuzz_flow
\ No newline at end of file
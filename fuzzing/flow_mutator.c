@@ -0,0 +1,370 @@
+#include "bip44.h"
+#include "decodeDH.h"
+#include "device.h"
+#include "fio.h"
+#include "os_math.h"
+#include "securityPolicy.h"
+#include "signTransactionParse.h"
+
+#include <stdint.h>
+#include <string.h>
+
+// Structure-aware mutator for fuzz_flow inputs (transcripts of request APDUs).
+//
+// Random byte mutations mostly break the framing (lc, the const/var split of sign
+// transaction APDUs) or fail the first VALIDATEs of the subhandlers. Here we keep
+// the framing consistent and mutate the fields of the sign transaction INIT and
+// APPEND_DATA and decode DECODE requests with values the app actually accepts,
+// mixed with sequence level mutations (duplicating, dropping, swapping APDUs).
+
+size_t LLVMFuzzerMutate(uint8_t *Data, size_t Size, size_t MaxSize);
+
+enum {
+    MAX_APDUS = 64,
+    MAX_APDU_DATA = 255,
+
+    INS_SIGN_TX = 0x20,
+    INS_DECODE = 0x30,
+
+    SIGN_TX_P1_INIT = 0x01,
+    SIGN_TX_P1_APPEND_DATA = 0x04,
+
+    // sign transaction APDU data: const data length, var data length, const data, var data
+    SIGN_TX_HEADER_SIZE = 2,
+    // APPEND_DATA const data: format, validation, 2x 8 byte argument, policy|storage,
+    // key length, key
+    APPEND_DATA_KEY_LEN_OFFSET = 19,
+    APPEND_DATA_KEY_OFFSET = 20,
+};
+
+// Same as tx_storage_check_t in signTransaction.c
+static const uint8_t STORAGE_CHECKS[] = {0x00, 0x10, 0x20, 0x30, 0x40};
+
+static const uint8_t VALUE_FORMATS[] = {
+    VALUE_FORMAT_BUFFER_SHOW_AS_HEX,
+    VALUE_FORMAT_ASCII_STRING,
+    VALUE_FORMAT_NAME,
+    VALUE_FORMAT_ASCII_STRING_WITH_LENGTH,
+    VALUE_FORMAT_FIO_AMOUNT,
+    VALUE_FORMAT_UINT64,
+    VALUE_FORMAT_VARUINT32,
+    VALUE_FORMAT_MEMO_HASH,
+    VALUE_FORMAT_CHAIN_CODE_TOKEN_CODE_PUBLIC_ADDR,
+};
+
+static const uint8_t VALUE_VALIDATIONS[] = {
+    VALUE_VALIDATION_NONE,
+    VALUE_VALIDATION_INBUFFER_LENGTH,
+    VALUE_VALIDATION_NUMBER,
+};
+
+static const uint8_t POLICIES[] = {
+    POLICY_ALLOW_WITHOUT_PROMPT,
+    POLICY_SHOW_BEFORE_RESPONSE,
+    POLICY_SHOW_BEFORE_RESPONSE_IF_NONEMPTY,
+};
+
+static const uint8_t TESTNET_CHAIN_ID[CHAIN_ID_LENGTH] = {
+    0xb2, 0x09, 0x01, 0x38, 0x0a, 0xf4, 0x4e, 0xf5, 0x9c, 0x59, 0x18, 0x43, 0x9a, 0x1f, 0x9a, 0x41,
+    0xd8, 0x36, 0x69, 0x02, 0x03, 0x19, 0xa8, 0x05, 0x74, 0xb8, 0x04, 0xa5, 0xf9, 0x5c, 0xbd, 0x7e};
+static const uint8_t MAINNET_CHAIN_ID[CHAIN_ID_LENGTH] = {
+    0x21, 0xdc, 0xae, 0x42, 0xc0, 0x18, 0x22, 0x00, 0xe9, 0x3f, 0x95, 0x4a, 0x07, 0x40, 0x11, 0xf9,
+    0x04, 0x8a, 0x76, 0x24, 0xc6, 0xfe, 0x81, 0xd3, 0xc9, 0x54, 0x1a, 0x61, 0x4a, 0x88, 0xbd, 0x1c};
+
+static const uint32_t PATH_ELEMENTS[] = {
+    44 | HARDENED_BIP32, 235 | HARDENED_BIP32, HARDENED_BIP32, 0, 1, 2000, HARDENED_BIP32 - 1};
+
+static const uint64_t INTERESTING_ARGS[] = {
+    0, 1, 2, 8, 20, 32, 200, 220, 0xFFFFFFFF, 0x7FFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF};
+
+typedef struct {
+    uint8_t header[4];  // cla, ins, p1, p2
+    uint8_t data[MAX_APDU_DATA];
+    size_t dataSize;
+} apdu_t;
+
+typedef struct {
+    apdu_t apdus[MAX_APDUS];
+    size_t count;
+} transcript_t;
+
+static uint32_t rngState;
+
+static uint32_t rnd(uint32_t bound) {
+    // xorshift32, bound > 0
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState % bound;
+}
+
+#define PICK(array) ((array)[rnd(ARRAY_LEN(array))])
+
+static void transcript_parse(transcript_t *t, const uint8_t *data, size_t size) {
+    size_t offset = 0;
+    t->count = 0;
+    while (t->count < MAX_APDUS) {
+        size_t apduSize = device_nextAPDUSize(data, size, offset);
+        if (apduSize == 0) break;
+        apdu_t *apdu = &t->apdus[t->count++];
+        memcpy(apdu->header, data + offset, SIZEOF(apdu->header));
+        apdu->dataSize = apduSize - DEVICE_APDU_HEADER_SIZE;
+        memcpy(apdu->data, data + offset + DEVICE_APDU_HEADER_SIZE, apdu->dataSize);
+        offset += apduSize;
+    }
+}
+
+// Returns 0 if the transcript does not fit
+static size_t transcript_serialize(const transcript_t *t, uint8_t *data, size_t maxSize) {
+    size_t offset = 0;
+    for (size_t i = 0; i < t->count; i++) {
+        const apdu_t *apdu = &t->apdus[i];
+        if (offset + DEVICE_APDU_HEADER_SIZE + apdu->dataSize > maxSize) return 0;
+        memcpy(data + offset, apdu->header, SIZEOF(apdu->header));
+        data[offset + 4] = (uint8_t) apdu->dataSize;
+        memcpy(data + offset + DEVICE_APDU_HEADER_SIZE, apdu->data, apdu->dataSize);
+        offset += DEVICE_APDU_HEADER_SIZE + apdu->dataSize;
+    }
+    return offset;
+}
+
+static bool isSignTx(const apdu_t *apdu, uint8_t p1) {
+    return apdu->header[1] == INS_SIGN_TX && apdu->header[2] == p1 &&
+           apdu->dataSize >= SIGN_TX_HEADER_SIZE;
+}
+
+// Replaces size bytes at offset by newSize bytes of value (or keeps the old
+// content if value is NULL and the size does not change), returns false if it does not fit
+static bool apdu_splice(apdu_t *apdu,
+                        size_t offset,
+                        size_t size,
+                        const uint8_t *value,
+                        size_t newSize) {
+    if (offset + size > apdu->dataSize) return false;
+    if (apdu->dataSize - size + newSize > MAX_APDU_DATA) return false;
+    memmove(apdu->data + offset + newSize,
+            apdu->data + offset + size,
+            apdu->dataSize - offset - size);
+    if (value != NULL) memcpy(apdu->data + offset, value, newSize);
+    apdu->dataSize = apdu->dataSize - size + newSize;
+    return true;
+}
+
+// Const and var data lengths of sign transaction APDUs must add up to the data size
+static void signTx_fixLengths(apdu_t *apdu) {
+    if (apdu->header[1] != INS_SIGN_TX || apdu->dataSize < SIGN_TX_HEADER_SIZE) return;
+    size_t payload = apdu->dataSize - SIGN_TX_HEADER_SIZE;
+    if (apdu->data[0] > payload) apdu->data[0] = (uint8_t) payload;
+    apdu->data[1] = (uint8_t) (payload - apdu->data[0]);
+}
+
+static void writePath(uint8_t *out, size_t length) {
+    out[0] = (uint8_t) length;
+    for (size_t i = 0; i < length; i++) {
+        uint32_t element = PICK(PATH_ELEMENTS);
+        memcpy(out + 1 + 4 * i, &element, 4);
+    }
+}
+
+static void mutateInit(apdu_t *apdu) {
+    uint8_t *var = apdu->data + SIGN_TX_HEADER_SIZE + apdu->data[0];
+    size_t varSize = apdu->data[1];
+
+    switch (rnd(3)) {
+        case 0: {
+            // chain id
+            if (varSize < CHAIN_ID_LENGTH) return;
+            const uint8_t *chainId = rnd(2) ? TESTNET_CHAIN_ID : MAINNET_CHAIN_ID;
+            memcpy(var, chainId, CHAIN_ID_LENGTH);
+            if (rnd(4) == 0) var[rnd(CHAIN_ID_LENGTH)] ^= (uint8_t) (1 + rnd(255));
+            break;
+        }
+        case 1: {
+            // whole path, including invalid lengths
+            if (varSize < CHAIN_ID_LENGTH) return;
+            uint8_t path[1 + 4 * (BIP44_MAX_PATH_ELEMENTS + 1)];
+            size_t length = rnd(BIP44_MAX_PATH_ELEMENTS + 2);
+            writePath(path, length);
+            size_t pathSize = 1 + 4 * length;
+            if (rnd(8) == 0) pathSize = rnd(pathSize + 1);
+            size_t varOffset = SIGN_TX_HEADER_SIZE + apdu->data[0] + CHAIN_ID_LENGTH;
+            if (apdu_splice(apdu, varOffset, varSize - CHAIN_ID_LENGTH, path, pathSize)) {
+                apdu->data[1] = (uint8_t) (CHAIN_ID_LENGTH + pathSize);
+            }
+            break;
+        }
+        default: {
+            // single path element
+            if (varSize < CHAIN_ID_LENGTH + 1 + 4) return;
+            size_t elements = (varSize - CHAIN_ID_LENGTH - 1) / 4;
+            uint32_t element = PICK(PATH_ELEMENTS) ^ (rnd(4) == 0 ? HARDENED_BIP32 : 0);
+            memcpy(var + CHAIN_ID_LENGTH + 1 + 4 * rnd(elements), &element, 4);
+            break;
+        }
+    }
+}
+
+static void mutateAppendData(apdu_t *apdu) {
+    uint8_t *constData = apdu->data + SIGN_TX_HEADER_SIZE;
+    size_t constSize = apdu->data[0];
+
+    if (constSize < APPEND_DATA_KEY_OFFSET) {
+        // make it long enough to be parsed at all
+        uint8_t header[APPEND_DATA_KEY_OFFSET] = {0};
+        header[0] = VALUE_FORMAT_ASCII_STRING;
+        header[1] = VALUE_VALIDATION_NONE;
+        header[18] = POLICY_ALLOW_WITHOUT_PROMPT;
+        if (!apdu_splice(apdu, SIGN_TX_HEADER_SIZE, constSize, header, SIZEOF(header))) return;
+        apdu->data[0] = APPEND_DATA_KEY_OFFSET;
+        return;
+    }
+
+    switch (rnd(6)) {
+        case 0:
+            constData[0] = rnd(8) == 0 ? (uint8_t) rnd(256) : PICK(VALUE_FORMATS);
+            break;
+        case 1:
+            constData[1] = rnd(8) == 0 ? (uint8_t) rnd(256) : PICK(VALUE_VALIDATIONS);
+            break;
+        case 2: {
+            // one of the arguments, either interesting or the var data length
+            uint64_t arg = rnd(2) ? PICK(INTERESTING_ARGS) : apdu->data[1];
+            memcpy(constData + 2 + 8 * rnd(2), &arg, 8);
+            break;
+        }
+        case 3:
+            constData[18] = PICK(STORAGE_CHECKS) | PICK(POLICIES);
+            break;
+        case 4: {
+            // display key, keeping constSize == 20 + keyLen
+            static const char *KEYS[] = {"Amount", "Payee Pubkey", "", "0123456789012345678"};
+            const char *key = PICK(KEYS);
+            size_t keyLen = strlen(key);
+            if (rnd(8) == 0) keyLen = MAX_DISPLAY_KEY_LENGTH;  // one too long
+            size_t oldKeyLen = constSize - APPEND_DATA_KEY_OFFSET;
+            uint8_t keyBuffer[MAX_DISPLAY_KEY_LENGTH] = {0};
+            memcpy(keyBuffer, key, strlen(key));
+            if (apdu_splice(apdu,
+                            SIGN_TX_HEADER_SIZE + APPEND_DATA_KEY_OFFSET,
+                            oldKeyLen,
+                            keyBuffer,
+                            keyLen)) {
+                apdu->data[0] = (uint8_t) (APPEND_DATA_KEY_OFFSET + keyLen);
+                apdu->data[SIGN_TX_HEADER_SIZE + APPEND_DATA_KEY_LEN_OFFSET] = (uint8_t) keyLen;
+            }
+            break;
+        }
+        default: {
+            // var data size, within and above MAX_TX_APPEND_IN_SINGLE_APDU
+            size_t varSize = apdu->data[1];
+            size_t newSize = rnd(MAX_TX_APPEND_IN_SINGLE_APDU + 8);
+            size_t varOffset = SIGN_TX_HEADER_SIZE + constSize;
+            if (newSize > varSize) {
+                if (!apdu_splice(apdu, varOffset + varSize, 0, NULL, newSize - varSize)) return;
+                memset(apdu->data + varOffset + varSize, 'a' + rnd(26), newSize - varSize);
+            } else {
+                apdu_splice(apdu, varOffset + newSize, varSize - newSize, NULL, 0);
+            }
+            apdu->data[1] = (uint8_t) newSize;
+            break;
+        }
+    }
+}
+
+static void mutateDecode(apdu_t *apdu) {
+    switch (rnd(3)) {
+        case 0:
+            apdu->header[2] = (uint8_t) (DECODE_STAGE_RECEIVE_DATA + rnd(3));
+            break;
+        case 1:
+            apdu->header[3] = (uint8_t) rnd(3);
+            break;
+        default: {
+            // DECODE request: other public key, path
+            if (apdu->header[2] != DECODE_STAGE_DECODE || apdu->dataSize < PUBKEY_LENGTH) return;
+            uint8_t path[1 + 4 * (BIP44_MAX_PATH_ELEMENTS + 1)];
+            size_t length = rnd(BIP44_MAX_PATH_ELEMENTS + 2);
+            writePath(path, length);
+            apdu_splice(apdu, PUBKEY_LENGTH, apdu->dataSize - PUBKEY_LENGTH, path, 1 + 4 * length);
+            break;
+        }
+    }
+}
+
+static void mutateSequence(transcript_t *t) {
+    if (t->count == 0) return;
+    size_t i = rnd(t->count);
+    size_t j = rnd(t->count);
+    switch (rnd(3)) {
+        case 0:
+            // repeat an APDU
+            if (t->count == MAX_APDUS) return;
+            memmove(&t->apdus[i + 1], &t->apdus[i], (t->count - i) * SIZEOF(t->apdus[0]));
+            t->count++;
+            break;
+        case 1:
+            // drop an APDU
+            memmove(&t->apdus[i], &t->apdus[i + 1], (t->count - i - 1) * SIZEOF(t->apdus[0]));
+            t->count--;
+            break;
+        default: {
+            apdu_t tmp = t->apdus[i];
+            t->apdus[i] = t->apdus[j];
+            t->apdus[j] = tmp;
+            break;
+        }
+    }
+}
+
+static void mutateBytes(apdu_t *apdu) {
+    // header bytes are mutated rarely, the flow is driven by ins and p1
+    if (rnd(8) == 0) {
+        apdu->header[2 + rnd(2)] = (uint8_t) rnd(256);
+        return;
+    }
+    uint8_t buffer[MAX_APDU_DATA];
+    memcpy(buffer, apdu->data, apdu->dataSize);
+    apdu->dataSize = LLVMFuzzerMutate(buffer, apdu->dataSize, SIZEOF(buffer));
+    memcpy(apdu->data, buffer, apdu->dataSize);
+    signTx_fixLengths(apdu);
+}
+
+size_t LLVMFuzzerCustomMutator(uint8_t *Data, size_t Size, size_t MaxSize, unsigned int Seed) {
+    static transcript_t t;
+
+    rngState = Seed | 1;
+    transcript_parse(&t, Data, Size);
+    if (t.count == 0) {
+        return LLVMFuzzerMutate(Data, Size, MaxSize);
+    }
+
+    apdu_t *apdu = &t.apdus[rnd(t.count)];
+    switch (rnd(4)) {
+        case 0:
+            if (isSignTx(apdu, SIGN_TX_P1_INIT)) {
+                signTx_fixLengths(apdu);
+                mutateInit(apdu);
+            } else if (isSignTx(apdu, SIGN_TX_P1_APPEND_DATA)) {
+                signTx_fixLengths(apdu);
+                mutateAppendData(apdu);
+            } else if (apdu->header[1] == INS_DECODE) {
+                mutateDecode(apdu);
+            } else {
+                mutateBytes(apdu);
+            }
+            break;
+        case 1:
+            mutateSequence(&t);
+            break;
+        default:
+            mutateBytes(apdu);
+            break;
+    }
+
+    // Note: the input is kept if the mutated one does not fit
+    static uint8_t buffer[MAX_APDUS * DEVICE_MAX_APDU_SIZE];
+    size_t newSize = transcript_serialize(&t, buffer, MIN(MaxSize, SIZEOF(buffer)));
+    if (newSize == 0) return Size;
+    memcpy(Data, buffer, newSize);
+    return newSize;
+}
@@ -5,8 +5,6 @@
 
 #include <stdio.h>
 
-static const int INS_NONE = -1;
-
 typedef struct {
     uint8_t cla;
     uint8_t ins;
@@ -0,0 +1,39 @@
+#include "cx_soft.h"
+#include "device.h"
+#include "handlers.h"
+
+#include <stdint.h>
+
+// Stateful harness: the input is a transcript of request APDUs (5 byte header
+// followed by lc bytes of data, the same format as native/transcripts) which are
+// processed one after another the same way as fio_main does, so that multi-APDU
+// flows (e.g. sign transaction past INIT) are explored.
+
+// Unit tests are not fuzzed
+void handleRunTests(uint8_t p1,
+                    uint8_t p2,
+                    uint8_t *wireBuffer,
+                    size_t wireSize,
+                    bool isNewCall) {
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+    uint8_t response[DEVICE_MAX_RESPONSE_SIZE];
+    size_t responseSize;
+    size_t offset = 0;
+
+    // Every input starts with a freshly started app
+    device_reset();
+    cx_soft_seed_rng(0);
+
+    while (offset < Size) {
+        size_t apduSize = device_nextAPDUSize(Data, Size, offset);
+        if (apduSize == 0) break;  // truncated APDU
+
+        // Note: failed assertions restart the app, the following APDUs then go to the fresh app
+        device_exchange(Data + offset, apduSize, response, sizeof(response), &responseSize);
+        offset += apduSize;
+    }
+
+    return 0;
+}
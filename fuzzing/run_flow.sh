@@ -0,0 +1,11 @@
+#!/usr/bin/env bash
+
+set -e
+
+SCRIPTDIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd )"
+BUILDDIR="$SCRIPTDIR/cmake-build-fuzz"
+CORPUSDIR="$SCRIPTDIR/corpus_flow"
+# transcripts exported from the transaction templates, used as additional seeds
+TRANSCRIPTSDIR="$SCRIPTDIR/../native/transcripts"
+
+"$BUILDDIR"/fuzz_flow "$CORPUSDIR" "$TRANSCRIPTSDIR" "$@" > /dev/null
@@ -5,7 +5,11 @@ import {ErrorBase} from "./errorBase"
  * @category Errors
  */
 export const DeviceStatusCodes = {
+    ERR_MALFORMED_REQUEST_HEADER: 0x6e01 as const,
+    ERR_BAD_CLA: 0x6e02 as const,
+    ERR_UNKNOWN_INS: 0x6e03 as const,
     ERR_STILL_IN_CALL: 0x6e04 as const, // internal
+    ERR_INVALID_REQUEST_PARAMETERS: 0x6e05 as const,
     ERR_INVALID_STATE: 0x6e06 as const,
     ERR_INVALID_DATA: 0x6e07 as const,
     ERR_INTEGRITY_CHECK_FAILED: 0x6e08 as const,
@@ -54,3 +58,11 @@ export class DeviceStatusError extends ErrorBase {
         this.code = code
     }
 }
+
+// Errors of the FIO app which do not mean that the app was closed or restarted
+export function isAppStatusError(e: unknown): boolean {
+    return e instanceof DeviceStatusError &&
+        e.code >= DeviceStatusCodes.ERR_MALFORMED_REQUEST_HEADER &&
+        e.code <= DeviceStatusCodes.ERR_INVALID_HMAC &&
+        e.code !== DeviceStatusCodes.ERR_STILL_IN_CALL
+}
@@ -3,3 +3,5 @@ export {InvalidData} from './invalidData'
 export {DeviceVersionUnsupported} from './deviceUnsupported'
 export {DeviceStatusCodes, DeviceStatusError} from './deviceStatusError'
 export {InvalidDataReason} from './invalidDataReason'
+export {TranscriptMismatch} from './transcriptMismatch'
+export {NoDeviceAvailable} from './noDeviceAvailable'
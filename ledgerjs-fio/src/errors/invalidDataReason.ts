@@ -48,4 +48,6 @@ export enum InvalidDataReason {
     INCORRECT_NUMBER_OF_PRODUCERS = "incorrect number of producers",
     INVALID_PRODUCER = "invalid producer",
     INVALID_PROXY = "invalid proxy",
+    INVALID_SIGNATURE = "invalid signature",
+    INTEGRITY_CHECK_FAILED = "command sequence not accepted by the app",
 }
@@ -0,0 +1,11 @@
+import {ErrorBase} from "./errorBase"
+
+/**
+ * No device of a [[FioPool]] can serve the request, e.g. none of them holds the requested key
+ * @category Errors
+ */
+export class NoDeviceAvailable extends ErrorBase {
+    public constructor(reason: string) {
+        super(reason)
+    }
+}
@@ -0,0 +1,11 @@
+import {ErrorBase} from "./errorBase"
+
+/**
+ * APDU sent to a [[ReplayTransport]] differs from the recorded one, or the transcript is exhausted
+ * @category Errors
+ */
+export class TranscriptMismatch extends ErrorBase {
+    public constructor(reason: string) {
+        super(reason)
+    }
+}
@@ -18,20 +18,31 @@ import type Transport from "@ledgerhq/hw-transport"
 import { decodeMessage } from "./interactions/decodeMessage"
 
 import {DeviceStatusCodes, DeviceStatusError, InvalidDataReason} from './errors'
+import {isAppStatusError} from './errors/deviceStatusError'
 import type {Interaction, SendParams} from './interactions/common/types'
+import {getAppInfo} from "./interactions/getAppInfo"
 import {getPublicKey} from "./interactions/getPublicKey"
 import {getSerial} from "./interactions/getSerial"
-import {getCompatibility, getVersion} from "./interactions/getVersion"
+import {ensureLedgerAppVersionCompatible, getCompatibility, getVersion} from "./interactions/getVersion"
 import {runTests} from "./interactions/runTests"
-import {signTransaction} from "./interactions/signTransaction"
-import {HexString, ParsedContext, ParsedTransaction, PUBLIC_KEY_LENGTH, ValidBIP32Path} from './types/internal'
-import type {BIP32Path, DeviceCompatibility, Serial, SignedTransactionData, Transaction, Version} from './types/public'
+import type {PreparedSignTransaction} from "./interactions/signTransaction"
+import {prepareSignTransaction, signPreparedTransaction} from "./interactions/signTransaction"
+import type {FioObserver, OperationEvent} from "./metrics"
+import {startTimer} from "./metrics/observer"
+import {HexString, ParsedContext, PUBLIC_KEY_LENGTH, ValidBIP32Path} from './types/internal'
+import type {AppInfo, BIP32Path, DeviceCompatibility, Serial, SignedTransactionData, Transaction, Version} from './types/public'
 import {stripRetcodeFromResponse} from "./utils"
 import {assert} from './utils/assert'
 import {isArray, parseBIP32Path, parseContext, parseHexString, parseMessage, parseTransaction, validate} from './utils/parse'
 
 export * from './errors'
 export * from './types/public'
+export * from './transports'
+export * from './scheduler'
+export * from './pool'
+export * from './metrics'
+export * from './signatures'
+export * from './simulator'
 
 const CLA = 0xd7
 
@@ -75,9 +86,8 @@ function wrapRetryStillInCall<T extends Function>(fn: T): T {
             return await fn(...args)
         } catch (e: any) {
             if (
-                e &&
-                e.statusCode &&
-                e.statusCode === DeviceStatusCodes.ERR_STILL_IN_CALL
+                e instanceof DeviceStatusError &&
+                e.code === DeviceStatusCodes.ERR_STILL_IN_CALL
             ) {
                 // Do the retry
                 return await fn(...args)
@@ -114,6 +124,18 @@ export class Fio {
     transport: Transport<string>;
     /** @ignore */
     _send: SendFn;
+    /**
+     * App info of the current transport session, fetched by the first call
+     * @ignore
+     */
+    _appInfo: AppInfo | null = null;
+    /** @ignore */
+    _observer: FioObserver | null = null;
+    /**
+     * Totals of the APDUs of the observed operation in progress
+     * @ignore
+     */
+    _operation: {apduCount: number, bytesOut: number, bytesIn: number, deviceNs: number} | null = null;
 
     constructor(transport: Transport<string>, scrambleKey: string = "FIO") {
         this.transport = transport
@@ -121,18 +143,40 @@ export class Fio {
         const methods = [
             "getVersion",
             "getSerial",
+            "getAppInfo",
             "getPublicKey",
             "signTransaction",
+            "signPreparedTransaction",
         ]
         this.transport.decorateAppAPIMethods(this, methods, scrambleKey)
+        this.transport.on("disconnect", () => {
+            this._appInfo = null
+        })
         this._send = async (params: SendParams): Promise<Buffer> => {
-            let response = await wrapConvertDeviceStatusError(this.transport.send)(
-                CLA,
-                params.ins,
-                params.p1,
-                params.p2,
-                params.data,
-            )
+            let response: Buffer
+            const elapsedNs = this._observer !== null ? startTimer() : null
+            try {
+                response = await wrapConvertDeviceStatusError(this.transport.send)(
+                    CLA,
+                    params.ins,
+                    params.p1,
+                    params.p2,
+                    params.data,
+                )
+            } catch (e) {
+                if (elapsedNs !== null) {
+                    const statusWord = e instanceof DeviceStatusError ? e.code : null
+                    this._observeApdu(params, elapsedNs(), statusWord !== null ? 2 : 0, statusWord)
+                }
+                // The app may have been closed or restarted, or it was left in a previous call
+                if (!isAppStatusError(e)) {
+                    this._appInfo = null
+                }
+                throw e
+            }
+            if (elapsedNs !== null) {
+                this._observeApdu(params, elapsedNs(), response.length, 0x9000)
+            }
             response = stripRetcodeFromResponse(response)
 
             if (params.expectedResponseLength != null) {
@@ -146,6 +190,52 @@ export class Fio {
         }
     }
 
+    /**
+     * Reports the timing and size of every APDU and of every [[signTransaction]] and [[decodeMessage]]
+     * call to the observer, e.g. [[HistogramObserver]]. Null stops the reporting.
+     *
+     * @example
+     * const metrics = new HistogramObserver();
+     * fio.setObserver(metrics);
+     *
+     */
+    setObserver(observer: FioObserver | null): void {
+        this._observer = observer
+    }
+
+    /** @ignore */
+    _observeApdu(params: SendParams, durationNs: number, bytesIn: number, statusWord: number | null): void {
+        const bytesOut = 5 + params.data.length
+        if (this._operation !== null) {
+            this._operation.apduCount++
+            this._operation.bytesOut += bytesOut
+            this._operation.bytesIn += bytesIn
+            this._operation.deviceNs += durationNs
+        }
+        this._observer?.onApdu?.({ins: params.ins, p1: params.p1, p2: params.p2, bytesOut, bytesIn, durationNs, statusWord})
+    }
+
+    /** @ignore */
+    async _observeOperation<T>(operation: OperationEvent["operation"], call: () => Promise<T>): Promise<T> {
+        const observer = this._observer
+        if (observer === null) {
+            return call()
+        }
+        const elapsedNs = startTimer()
+        const totals = {apduCount: 0, bytesOut: 0, bytesIn: 0, deviceNs: 0}
+        this._operation = totals
+        let error: unknown = null
+        try {
+            return await call()
+        } catch (e) {
+            error = e
+            throw e
+        } finally {
+            this._operation = null
+            observer.onOperation?.({operation, durationNs: elapsedNs(), ...totals, error})
+        }
+    }
+
     /**
      * Returns an object containing the app version.
      *
@@ -157,10 +247,50 @@ export class Fio {
      *
      */
     async getVersion(): Promise<GetVersionResponse> {
-        const version = await interact(this._getVersion(), this._send)
+        const {version} = await this._getCachedAppInfo()
         return {version, compatibility: getCompatibility(version)}
     }
 
+    /**
+     * Returns the app version, device serial and the supported instructions, all in a single call.
+     * The result is cached until the transport disconnects or the device responds with an error
+     * which means that the app was closed or restarted, the other calls use the cached version.
+     * With `refresh` it is requested from the device again, e.g. to check that the device still
+     * responds or that it is the same one.
+     *
+     * @example
+     * const { version, serial } = await fio.getAppInfo();
+     *
+     */
+    async getAppInfo({refresh = false}: GetAppInfoRequest = {}): Promise<AppInfo> {
+        if (refresh) {
+            this._appInfo = null
+        }
+        return this._getCachedAppInfo()
+    }
+
+    /** @ignore */
+    async _getCachedAppInfo(): Promise<AppInfo> {
+        if (this._appInfo === null) {
+            this._appInfo = await this._fetchAppInfo()
+        }
+        return this._appInfo
+    }
+
+    /** @ignore */
+    async _fetchAppInfo(): Promise<AppInfo> {
+        try {
+            return await interact(getAppInfo(), this._send)
+        } catch (e) {
+            if (!(e instanceof DeviceStatusError && e.code === DeviceStatusCodes.ERR_UNKNOWN_INS)) {
+                throw e
+            }
+            // App without GET_APP_INFO
+            const version = await interact(this._getVersion(), this._send)
+            return {version, serial: null, maxRequestDataSize: 255, instructions: null, signTransactionCommands: null}
+        }
+    }
+
     /** @ignore */
     * _getVersion(): Interaction<Version> {
         return yield* getVersion()
@@ -177,12 +307,20 @@ export class Fio {
      *
      */
     async getSerial(): Promise<GetSerialResponse> {
-        return interact(this._getSerial(), this._send)
+        const {version, serial} = await this._getCachedAppInfo()
+        if (serial !== null) {
+            ensureLedgerAppVersionCompatible(version)
+            return {serial}
+        }
+        const response = await interact(this._getSerial(version), this._send)
+        if (this._appInfo !== null) {
+            this._appInfo = {...this._appInfo, serial: response.serial}
+        }
+        return response
     }
 
     /** @ignore */
-    * _getSerial(): Interaction<GetSerialResponse> {
-        const version = yield* getVersion()
+    * _getSerial(version: Version): Interaction<GetSerialResponse> {
         return yield* getSerial(version)
     }
 
@@ -205,12 +343,12 @@ export class Fio {
         validate(isArray(path), InvalidDataReason.GET_PUB_KEY_PATH_IS_NOT_ARRAY)
         const parsedPath = parseBIP32Path(path, InvalidDataReason.INVALID_PATH)
 
-        return interact(this._getPublicKey(parsedPath, show_or_not), this._send)
+        const {version} = await this._getCachedAppInfo()
+        return interact(this._getPublicKey(version, parsedPath, show_or_not), this._send)
     }
 
     /** @ignore */
-    * _getPublicKey(path: ValidBIP32Path, show_or_not: boolean) {
-        const version = yield* getVersion()
+    * _getPublicKey(version: Version, path: ValidBIP32Path, show_or_not: boolean) {
         return yield* getPublicKey(version, path, show_or_not)
     }
 
@@ -227,17 +365,46 @@ export class Fio {
      * @see [[SignTransactionResponse]]
  * ```
      */
-    async signTransaction({path, chainId, tx}: SignTransactionRequest): Promise<SignTransactionResponse> {
+    async signTransaction(request: SignTransactionRequest): Promise<SignTransactionResponse> {
+        return this._observeOperation("signTransaction", async () => {
+            const prepared = this.prepareTransaction(request)
+            const {version, signTransactionCommands} = await this._getCachedAppInfo()
+            return interact(this._signPreparedTransaction(version, prepared, signTransactionCommands), this._send)
+        })
+    }
+
+    /**
+     * Validates the request and serializes the transaction into the commands sent to the device,
+     * on the host only. [[signPreparedTransaction]] then just exchanges the APDUs, so that the
+     * next transaction of a batch can be prepared while the device signs the previous one.
+     *
+     * @example
+     * ```
+     * const prepared = fio.prepareTransaction({path, chainId, tx});
+     * const sign = await fio.signPreparedTransaction(prepared);
+     * ```
+     */
+    prepareTransaction({path, chainId, tx}: SignTransactionRequest): PreparedTransaction {
         const parsedChainId = parseHexString(chainId, InvalidDataReason.INVALID_CHAIN_ID)
         const parsedPath = parseBIP32Path(path, InvalidDataReason.INVALID_PATH)
         const parsedTx = parseTransaction(parsedChainId, tx)
-        return interact(this._signTransaction(parsedPath, parsedChainId, parsedTx), this._send)
+        return prepareSignTransaction(parsedPath, parsedChainId, parsedTx)
+    }
+
+    /**
+     * Sign transaction prepared by [[prepareTransaction]], the same as [[signTransaction]].
+     * A prepared transaction can be signed by any [[Fio]] instance.
+     */
+    async signPreparedTransaction(prepared: PreparedTransaction): Promise<SignTransactionResponse> {
+        return this._observeOperation("signTransaction", async () => {
+            const {version, signTransactionCommands} = await this._getCachedAppInfo()
+            return interact(this._signPreparedTransaction(version, prepared, signTransactionCommands), this._send)
+        })
     }
 
     /** @ignore */
-    * _signTransaction(parsedPath: ValidBIP32Path, chainId: HexString, tx: ParsedTransaction) {
-        const version = yield* getVersion()
-        return yield* signTransaction(version, parsedPath, chainId, tx)
+    * _signPreparedTransaction(version: Version, prepared: PreparedSignTransaction, signTransactionCommands: Array<number> | null) {
+        return yield* signPreparedTransaction(version, prepared, signTransactionCommands)
     }
 
     /**
@@ -254,16 +421,18 @@ export class Fio {
  * ```
      */
      async decodeMessage({path, publicKeyHex, message, context}: DecodeMessageRequest): Promise<DecodeMessageResponse> {
-        const parsedPath = parseBIP32Path(path, InvalidDataReason.INVALID_PATH)
-        const parsedPubkey = parseHexString(publicKeyHex, InvalidDataReason.INVALID_PUBLIC_KEY, PUBLIC_KEY_LENGTH, PUBLIC_KEY_LENGTH)
-        const parsedMessage = parseMessage(message, InvalidDataReason.INVALID_MESSAGE)
-        const parsedContext = parseContext(context, InvalidDataReason.INVALID_CONTEXT)
-        return interact(this._decodeMessage(parsedPath, parsedPubkey, parsedMessage, parsedContext), this._send)
+        return this._observeOperation("decodeMessage", async () => {
+            const parsedPath = parseBIP32Path(path, InvalidDataReason.INVALID_PATH)
+            const parsedPubkey = parseHexString(publicKeyHex, InvalidDataReason.INVALID_PUBLIC_KEY, PUBLIC_KEY_LENGTH, PUBLIC_KEY_LENGTH)
+            const parsedMessage = parseMessage(message, InvalidDataReason.INVALID_MESSAGE)
+            const parsedContext = parseContext(context, InvalidDataReason.INVALID_CONTEXT)
+            const {version} = await this._getCachedAppInfo()
+            return interact(this._decodeMessage(version, parsedPath, parsedPubkey, parsedMessage, parsedContext), this._send)
+        })
     }
 
     /** @ignore */
-    * _decodeMessage(parsedPath: ValidBIP32Path, pubkey: HexString, message: HexString, context: ParsedContext) {
-        const version = yield* getVersion()
+    * _decodeMessage(version: Version, parsedPath: ValidBIP32Path, pubkey: HexString, message: HexString, context: ParsedContext) {
         return yield* decodeMessage(version, parsedPath, pubkey, message, context)
     }
 
@@ -271,12 +440,12 @@ export class Fio {
      * Runs unit tests on the device (DEVEL app build only)
      */
     async runTests(): Promise<void> {
-        return interact(this._runTests(), this._send)
+        const {version} = await this._getCachedAppInfo()
+        return interact(this._runTests(version), this._send)
     }
 
     /** @ignore */
-    * _runTests(): Interaction<void> {
-        const version = yield* getVersion()
+    * _runTests(version: Version): Interaction<void> {
         return yield* runTests(version)
     }
 
@@ -292,6 +461,16 @@ export type GetVersionResponse = {
     compatibility: DeviceCompatibility
 }
 
+/**
+ * Get app info ([[Fio.getAppInfo]]) request data
+ * @category Main
+ * @see [[AppInfo]]
+ */
+export type GetAppInfoRequest = {
+    /** Request the app info from the device even if it is cached */
+    refresh?: boolean
+}
+
 /**
  * Get device serial number ([[Fio.getSerial]]) response data
  * @category Main
@@ -336,6 +515,13 @@ export type SignTransactionRequest = {
     tx: Transaction,
 }
 
+/**
+ * Transaction validated and serialized on the host by [[Fio.prepareTransaction]],
+ * to be signed by [[Fio.signPreparedTransaction]]
+ * @category Main
+ */
+export type PreparedTransaction = PreparedSignTransaction
+
 /**
  * Sign transaction ([[Fio.signTransaction]]) response data
  * @category Main
@@ -1,6 +1,7 @@
 export const enum INS {
     GET_VERSION = 0x00,
     GET_SERIAL = 0x01,
+    GET_APP_INFO = 0x02,
 
     GET_EXT_PUBLIC_KEY = 0x10,
 
@@ -0,0 +1,46 @@
+import type {AppInfo} from "../types/public"
+import {assert} from "../utils/assert"
+import {chunkBy} from "../utils/ioHelpers"
+import {buf_to_hex} from "../utils/serialize"
+import {INS} from "./common/ins"
+import type {Interaction, SendParams} from "./common/types"
+import {parseVersion} from "./getVersion"
+
+const send = (params: {
+    p1: number,
+    p2: number,
+    data: Buffer,
+    expectedResponseLength?: number
+}): SendParams => ({ins: INS.GET_APP_INFO, ...params})
+
+// list prefixed by its length
+function parseList(data: Buffer): [Array<number>, Buffer] {
+    assert(data.length >= 1 && data.length >= 1 + data[0], "invalid app info")
+    return [[...data.slice(1, 1 + data[0])], data.slice(1 + data[0])]
+}
+
+export function* getAppInfo(): Interaction<AppInfo> {
+    // like getVersion() it is not protected against concurrent execution, it is called
+    // from within the other calls
+
+    const P1_UNUSED = 0x00
+    const P2_UNUSED = 0x00
+    const response = yield send({
+        p1: P1_UNUSED,
+        p2: P2_UNUSED,
+        data: Buffer.alloc(0),
+    })
+
+    const [versionBuf, serialBuf, maxRequestDataSizeBuf, lists] = chunkBy(response, [4, 7, 1])
+    const [instructions, rest] = parseList(lists)
+    const [signTransactionCommands, end] = parseList(rest)
+    assert(end.length === 0, "invalid app info")
+
+    return {
+        version: parseVersion(versionBuf),
+        serial: buf_to_hex(serialBuf),
+        maxRequestDataSize: maxRequestDataSizeBuf[0],
+        instructions,
+        signTransactionCommands,
+    }
+}
@@ -24,6 +24,11 @@ export function* getVersion(): Interaction<Version> {
         data: Buffer.alloc(0),
         expectedResponseLength: 4,
     })
+    return parseVersion(response)
+}
+
+// Also the first 4 bytes of the app info
+export function parseVersion(response: Buffer): Version {
     const [major, minor, patch, flags_value] = response
 
     const FLAG_IS_DEBUG = 1
@@ -42,17 +47,20 @@ export function getCompatibility(version: Version): DeviceCompatibility {
     return {
         isCompatible: v1_0,
         recommendedVersion: v1_0 ? null : '1.0',
+        supportsGetAppInfo: v1_0 && isLedgerAppVersionAtLeast(version, 1, 0, 8),
+        supportsSignTransactionTemplate: v1_0 && isLedgerAppVersionAtLeast(version, 1, 0, 8),
     }
 }
 
 export function isLedgerAppVersionAtLeast(
     version: Version,
     minMajor: number,
-    minMinor: number
+    minMinor: number,
+    minPatch: number = 0
 ): boolean {
-    const {major, minor} = version
+    const {major, minor, patch} = version
 
-    return major > minMajor || (major === minMajor && minor >= minMinor)
+    return major > minMajor || (major === minMajor && (minor > minMinor || (minor === minMinor && patch >= minPatch)))
 }
 
 export function isLedgerAppVersionAtMost(
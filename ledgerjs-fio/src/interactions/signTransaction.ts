@@ -1,12 +1,15 @@
-import type {HexString, ParsedTransaction, Uint8_t, ValidBIP32Path} from "../types/internal"
+import type {HexString, ParsedTransaction, ValidBIP32Path} from "../types/internal"
 
 import {InvalidDataReason} from "../errors"
 import type {SignedTransactionData, Version} from "../types/public"
 import {validate} from "../utils/parse"
-import {uint8_to_buf} from "../utils/serialize"
 import {INS} from "./common/ins"
 import type {Interaction, SendParams} from "./common/types"
-import {ensureLedgerAppVersionCompatible} from "./getVersion"
+import {ensureLedgerAppVersionCompatible, getCompatibility} from "./getVersion"
+import type { Command, SignTransactionState } from "./transactionTemplates/commands"
+import { COMMAND, signedTransactionData, VALUE_POLICY } from "./transactionTemplates/commands"
+import type { ExpandedTemplate } from "./transactionTemplates/appTemplates"
+import { appTemplate, isIntegrityCheckPassed } from "./transactionTemplates/integrity"
 import { templete_all } from "./transactionTemplates/template_all"
 
 const send = (params: {
@@ -16,31 +19,185 @@ const send = (params: {
     expectedResponseLength?: number
 }): SendParams => ({ins: INS.SIGN_TX, ...params})
 
+const MAX_APDU_DATA_LENGTH = 255
 
-export function* signTransaction(version: Version, parsedPath: ValidBIP32Path, chainId: HexString, tx: ParsedTransaction): Interaction<SignedTransactionData> {
-    ensureLedgerAppVersionCompatible(version)
+/**
+ * APDU data of the TEMPLATE command, the steps of the commands up to `command`.
+ * Its response is the response of `command`.
+ */
+export type TemplateApdu = {
+    data: Buffer
+    command: Command
+}
+
+/**
+ * Sign transaction request validated and serialized into the template commands on the host,
+ * signed later by [[signPreparedTransaction]]
+ */
+export type PreparedSignTransaction = {
+    path: ValidBIP32Path
+    commands: Array<Command>
+    /** The APDU data of every command, framed when the transaction is prepared */
+    apduData: Array<Buffer>
+    /**
+     * The APDUs running the commands as a template compiled into the app, null if the app
+     * has no template for them
+     */
+    templateApdus: Array<TemplateApdu> | null
+    /** Whether the release build of the app accepts the command sequence */
+    integrityCheckPassed: boolean
+}
+
+// The APDU data of all the commands framed one after another into a single buffer, so that
+// nothing is serialized or copied between the exchanges with the device. When transactions
+// are prepared ahead (Fio.prepareTransaction), the framing of the next transaction overlaps
+// the exchanges of the previous one.
+function frameCommands(commands: Array<Command>): Array<Buffer> {
+    let total = 0;
+    for (const command of commands) {
+        const length = 2 + command.constData.length + command.varData.length;
+        validate(length <= MAX_APDU_DATA_LENGTH, InvalidDataReason.UNEXPECTED_ERROR);
+        total += length;
+    }
+    const buf = Buffer.allocUnsafe(total);
+    const apduData: Array<Buffer> = [];
+    let offset = 0;
+    for (const command of commands) {
+        const start = offset;
+        buf[offset++] = command.constData.length;
+        buf[offset++] = command.varData.length;
+        offset += command.constData.copy(buf, offset);
+        offset += command.varData.copy(buf, offset);
+        apduData.push(buf.subarray(start, offset));
+    }
+    return apduData;
+}
+
+// Offset of the policy (low nibble) and storage in the const data of APPEND_DATA
+const APPEND_DATA_POLICY_AND_STORAGE_OFFSET = 18;
+
+// Whether the command can wait for the user on the device, by its const data only
+function canPrompt(command: Command): boolean {
+    switch (command.command) {
+    case COMMAND.APPEND_CONST_DATA:
+    case COMMAND.START_COUNTED_SECTION:
+    case COMMAND.END_COUNTED_SECTION:
+    case COMMAND.STORE_VALUE:
+        return false;
+    case COMMAND.APPEND_DATA:
+        return command.constData.length <= APPEND_DATA_POLICY_AND_STORAGE_OFFSET ||
+            (command.constData[APPEND_DATA_POLICY_AND_STORAGE_OFFSET] & 0x0F) !== VALUE_POLICY.VALUE_DO_NOT_SHOW_ON_DEVICE;
+    default:
+        return true;
+    }
+}
 
+// The TEMPLATE command sends only the variable data of the commands, the steps of the template,
+// [varLength | varData] each, as many in an APDU as fit after the template ID in the first one.
+// The value of the parameter of the template (the count of its loop or its alternative) is sent
+// as an entry [1 | value] where the template takes it, always in the APDU of the next step.
+// The steps whose response is needed end their APDU: START_DH_ENCRYPTION, the steps of the
+// encrypted part (the response is their encryption) and FINISH. So do the steps which can wait
+// for the user, the app runs the next steps only from the APDU handler. The app checks the same.
+function frameTemplateSteps(template: ExpandedTemplate, commands: Array<Command>): Array<TemplateApdu> {
+    const parameterEntry = template.parameter !== null ? Buffer.from([1, template.parameter]) : Buffer.alloc(0);
+    let total = template.id.length;
+    for (const step of template.steps) {
+        total += step === null ? parameterEntry.length : 0;
+    }
+    for (const command of commands) {
+        total += 1 + command.varData.length;
+    }
+    const buf = Buffer.allocUnsafe(total);
+    const apdus: Array<TemplateApdu> = [];
+    let start = 0;
+    let offset = template.id.copy(buf, 0);
+    let dhIsActive = false;
+    let i = 0;
+    let parameterPending = false;
+    for (const step of template.steps) {
+        if (step === null) {
+            parameterPending = true;
+            continue;
+        }
+        const command = commands[i++];
+        const entriesLength = (parameterPending ? parameterEntry.length : 0) + 1 + command.varData.length;
+        if (offset - start + entriesLength > MAX_APDU_DATA_LENGTH) {
+            apdus.push({data: buf.subarray(start, offset), command: commands[i - 2]});
+            start = offset;
+        }
+        if (parameterPending) {
+            offset += parameterEntry.copy(buf, offset);
+            parameterPending = false;
+        }
+        buf[offset++] = command.varData.length;
+        offset += command.varData.copy(buf, offset);
+        if (dhIsActive || canPrompt(command)) {
+            apdus.push({data: buf.subarray(start, offset), command});
+            start = offset;
+        }
+        if (command.command === COMMAND.START_DH_ENCRYPTION) dhIsActive = true;
+        if (command.command === COMMAND.END_DH_ENCRYPTION) dhIsActive = false;
+    }
+    // the templates end with FINISH
+    validate(i === commands.length && start === offset, InvalidDataReason.UNEXPECTED_ERROR);
+    return apdus;
+}
+
+export function prepareSignTransaction(parsedPath: ValidBIP32Path, chainId: HexString, tx: ParsedTransaction): PreparedSignTransaction {
     const commands = templete_all(chainId, tx, parsedPath);
     validate(commands.length != 0, InvalidDataReason.ACTION_NOT_SUPPORTED);
+    const template = appTemplate(commands);
+    return {
+        path: parsedPath,
+        commands,
+        apduData: frameCommands(commands),
+        templateApdus: template !== null ? frameTemplateSteps(template, commands) : null,
+        integrityCheckPassed: isIntegrityCheckPassed(commands),
+    };
+}
 
-    let result: SignedTransactionData = {dhEncryptedData: "", txHashHex: "", witness: {path: parsedPath, witnessSignatureHex: ""}};
-
-    for(const command of commands) {
-        validate(command.constData.length + command.varData.length +2 <= 255, InvalidDataReason.UNEXPECTED_ERROR);
-        result = command.dataAction(
-            yield send({
-                p1: command.command,
-                p2: command.p2,
-                data: Buffer.concat([
-                    uint8_to_buf(Buffer.from(command.constData, "hex").length as Uint8_t),
-                    uint8_to_buf(command.varData.length as Uint8_t),
-                    Buffer.from(command.constData, "hex"), 
-                    command.varData,
-                ]),
+export function* signTransaction(version: Version, parsedPath: ValidBIP32Path, chainId: HexString, tx: ParsedTransaction,
+    signTransactionCommands: ReadonlyArray<number> | null = null): Interaction<SignedTransactionData> {
+    ensureLedgerAppVersionCompatible(version)
+    return yield* signPreparedTransaction(version, prepareSignTransaction(parsedPath, chainId, tx), signTransactionCommands)
+}
+
+/**
+ * Signs the prepared transaction. The template compiled into the app is used if the app
+ * supports the TEMPLATE command (`signTransactionCommands` of GET_APP_INFO) in its current
+ * framing (since 1.0.8), otherwise every command is sent on its own.
+ */
+export function* signPreparedTransaction(version: Version, {path, commands, apduData, templateApdus, integrityCheckPassed}: PreparedSignTransaction,
+    signTransactionCommands: ReadonlyArray<number> | null = null): Interaction<SignedTransactionData> {
+    ensureLedgerAppVersionCompatible(version)
+    // The release app rejects unknown command sequences only at the end, after the user reviewed
+    // the transaction. Debug builds accept also the test sequences or skip the check.
+    validate(version.flags.isDebug || integrityCheckPassed, InvalidDataReason.INTEGRITY_CHECK_FAILED);
+
+    const state: SignTransactionState = {dhEncryptedChunks: [], txHashHex: "", witness: {path, witnessSignatureHex: ""}};
+    if (templateApdus !== null && signTransactionCommands !== null && signTransactionCommands.includes(COMMAND.TEMPLATE) &&
+        getCompatibility(version).supportsSignTransactionTemplate) {
+        for (const {data, command} of templateApdus) {
+            const response = yield send({
+                p1: COMMAND.TEMPLATE,
+                p2: 0,
+                data,
                 expectedResponseLength: command.expectedResponseLength,
-            }),
-            result
-        )
+            });
+            command.dataAction(response, state);
+        }
+        return signedTransactionData(state);
+    }
+    for (let i = 0; i < commands.length; i++) {
+        const command = commands[i];
+        const response = yield send({
+            p1: command.command,
+            p2: command.p2,
+            data: apduData[i],
+            expectedResponseLength: command.expectedResponseLength,
+        });
+        command.dataAction(response, state);
     }
-    return result;
+    return signedTransactionData(state);
 }
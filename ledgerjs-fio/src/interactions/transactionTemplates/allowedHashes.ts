@@ -0,0 +1,171 @@
+// Integrity hashes of the command sequences accepted by the device, the same as allowedHashes
+// in src/signTransactionIntegrity.c. Both lists of the release build are generated from the
+// templates by tools/integrityHashes.ts, do not edit them by hand.
+
+/**
+ * Integrity hashes accepted by the release build of the app
+ * @category Simulator
+ */
+export const ALLOWED_HASHES: ReadonlyArray<string> = [
+    // trnsfiopubky
+    "720b29b9b706aaacdd35a7aeefde25591a55460616548278841683e1f0d79873",
+    // newfundsreq (DH step)
+    "04686b09f51d68b08a0d0c6fac1a533705e4028a86f0c52fb92c2c09e1300952",
+    // newfundsreq (FINISH step)
+    "23277c5c25481da2a897a5f2b7a3661e35d7899061ad9b0091c25330b26b42ca",
+    // recordobt (DH step)
+    "b9b36e49e5c2ac9e27d7bfd16c33dba47936c36fa2ac28dc9ed8a85b67336f44",
+    // recordobt (FINISH step)
+    "90d9ddf70d8832c28ab2a8b2d5ae082154c6cf764e775e22de3463104b60d473",
+    // cancelfndreq
+    "10212406f8ecc12b0946004c6c81018267c881685a8a576a7eb1b1f76a7b4bae",
+    // rejectfndreq
+    "b8196b10794b3fe150b3a1db0f74d382a16caddbb10dd020c2ad8e74beb19fb4",
+    // addaddress, public addresses: 1
+    "ab0f5cce2faf6b9093f3b5bea96a74a770d29168f71fe53d1974f7a5103963c1",
+    // addaddress, public addresses: 2
+    "307300ed8d1065247fa3dd2a1b7c90a8b26fafadb6f7a75f919297e5f1b12196",
+    // addaddress, public addresses: 3
+    "13024aa0a0ea70c811522d671741cd8c4ef680317c4d5ca0f2fa3c4bb185c5cd",
+    // addaddress, public addresses: 4
+    "8e26849440d8cdf9d01a0817aa0b5733f648f01feafd51b4ac3d18ad873fb9a4",
+    // addaddress, public addresses: 5
+    "f69ce50f3cdfa41e007ef3b029c43bc7923eb378717ded961c415a4c8250c9a1",
+    // remaddress, public addresses: 1
+    "e7a8d4ed82d26032545ac2c67373fbf5faa68f2fb4b891e3e8116aca08bf59e1",
+    // remaddress, public addresses: 2
+    "26e5210f8fc8778eb724973220a2bc85be1110b8398dd27e9d3abcaf581a4879",
+    // remaddress, public addresses: 3
+    "e0a606d134b3bffd726f69f7d1a56878d8ad1566d41edc301dbeea0982f13d0b",
+    // remaddress, public addresses: 4
+    "d6cc0560fda97d55b2494e2a5913e3e43cf73e5e283d15e4682d233e7c9b0b63",
+    // remaddress, public addresses: 5
+    "b5f3ed5f34485da3a49310f0098dfb71345e0f6ac84216c0e1b9ed11097c2230",
+    // addnft, NFTs: 1
+    "3b19b463cdbad4757678039217aed5ea13e1e8abc8c8357b50c8ef5c1c2ee172",
+    // addnft, NFTs: 2
+    "3931a71c078e5e2820903e25e1818fea46da16d9d256f3917e5ae45b947345df",
+    // addnft, NFTs: 3
+    "eaa0ae505810804b521e910bc964ad7376d937fa33abcf1ff87150f9baea4b2d",
+    // remnft, NFTs: 1
+    "eb1264c290a67809e156df0615d6647e47b99295922b5140e8c9827f684fe6fc",
+    // remnft, NFTs: 2
+    "6262114fad7596767f6543d06191351d6ebf64d6941c25bb59c126e594ce89cf",
+    // remnft, NFTs: 3
+    "684d191bec18693ac22a79e3bce5a4c6e1a5b3fd6e04b033d42fe61b5d517b80",
+    // remalladdr
+    "f7f1e3ccdabc219cb7efbe456c87f35976c99c0de9ac109346da1f91d3781b53",
+    // remallnfts
+    "21fb2150d17ba2064be752a81fca68df606243eb753c569d9710c42420baf44d",
+    // addbundles
+    "047d8504b6b92151197d20c9e79fc1813ee4a0d5a21d3c366689011a71e92a8a",
+    // regaddress
+    "4775d126a44b48952d845e43067e6b13426fdd7755259d6afc7f83c082c2eb4c",
+    // xferaddress
+    "5244214f79f9ba279e34d4fb35137fc406e6c77d99517ed4d27d8e97f81c3454",
+    // regdomain
+    "f87329bdc72daf8ddbacac28ea247ae11a8297474f9b5986cb27e5f9991df143",
+    // renewdomain
+    "2d267c41f632279110769639570fe3f5569b81a302c91d4695190b263b60f0e4",
+    // setdomainpub, public
+    "2f1e4ea281485e01551b4f20567b9727baaead605fb683d7374a0d06eba0f8bb",
+    // setdomainpub, not public
+    "e4852261223ba30542a0b60d73bff9cd826a9c9b7470475c6180312546a94f21",
+    // xferdomain
+    "f2efc6698f0536148b561d43b222fb42b91f8dd88307b7ff870947f1b86152bb",
+    // stakefio
+    "a81e4ec5a91e6b4de233461ffdbf3c847755cb1f64dd17dce635b4b9e77d27dc",
+    // unstakefio
+    "849542843c8b00d89c2c17a07266f915080bc9f0487c0109152e427b70820d7a",
+    // voteproducer, producers: 1
+    "72123cb528c567c4e345561fa974e3cc8733bf9ee4c6370b8f777ce3a3a102a3",
+    // voteproducer, producers: 2
+    "bd92948409aa7b8ec0ed3a0781a37132ec5dda02543fe72cedb5e8c0b95add38",
+    // voteproducer, producers: 3
+    "fd0010471a47add15b015dcf12d4ba20127dd66a9937de57796a303fc3924586",
+    // voteproducer, producers: 4
+    "4c3b0fe98990d301ac21876f36f13c74e0ad9d6e2bb65a22647804ca15a18cfc",
+    // voteproducer, producers: 5
+    "bfb978516e2d390e609918167b35e3eaa56c85107a7931e3c3723d464ab1406a",
+    // voteproducer, producers: 6
+    "415f45837ab3bf544c6aa09948fb939aa99f4e606125eaa3e33eca60dea9ce8e",
+    // voteproducer, producers: 7
+    "fda3e58e3292b9a46c17803487f8afcda8e51e91bd2f898e1ee83048a88dd7bc",
+    // voteproducer, producers: 8
+    "9c084d078a166f65cad8805a826fe328181388eec4d7af2fda1be9a0f3740160",
+    // voteproducer, producers: 9
+    "227767749f04fdb01b4a9e87aa3c35a6c3f1b862b1d9123343552de8257d7caa",
+    // voteproducer, producers: 10
+    "538fc3e7cc1026041ce708fd9af0f88a06c46204a5d07cfdd49930bd2998598e",
+    // voteproducer, producers: 11
+    "23c9ce25f60ad3616542cd86b67673477ff214452b01669635ed82f71af15d30",
+    // voteproducer, producers: 12
+    "ac3497b2d8eb94d32246082e3f2809b3401af08f7d301a83d77bbc137ca2de5c",
+    // voteproducer, producers: 13
+    "928045f068ab6283fd9b55af83af5f9f8b924cb1b62d121ae946a00f0fd54c82",
+    // voteproducer, producers: 14
+    "54a0de8810bd6f6714fcd10d93b9e70728142dab505c1283dc87b5526a02f961",
+    // voteproducer, producers: 15
+    "f5d6f237b46656e3cabaac01504c97a62bb71445b6547c1829b7de4ff3aefd02",
+    // voteproducer, producers: 16
+    "816f57d97d973fc63061795b262d5722e8e7dc8dbfb2ab51154b7b575270dc2d",
+    // voteproducer, producers: 17
+    "a9ae657f2c82952bab45318543e41259454e2c109c13e6be2a1e970acefac613",
+    // voteproducer, producers: 18
+    "0f32003ea448c1df21e8f4ec4eae7a6836680a20b5a0d52cec262c950450f907",
+    // voteproducer, producers: 19
+    "5a28c155fe775306e797cd1f65e5bebe6a49dd0dce100410f2cbe0ada4d70d66",
+    // voteproducer, producers: 20
+    "891645a3ad26e6dcc6b944b3747c76e70e56b839e575e548233293b27cbf44ad",
+    // voteproducer, producers: 21
+    "0cf24f0e34eb55aea2605546a34e480db834582a8062c30765766534e6e94569",
+    // voteproducer, producers: 22
+    "804e3b2dea0b2c7b06fb0cb563fc66f10c95d00e6765a898a3a8e01eeb5e653c",
+    // voteproducer, producers: 23
+    "a21284f7d74e243bbd7c6103be8bebebde4409f25cd208901d03f2afa322bcb1",
+    // voteproducer, producers: 24
+    "85d6134e7e0c789c598b423da8573e53b082cbc90301e962bd01557340a0c6d9",
+    // voteproducer, producers: 25
+    "afcade50caf16f6c6e0eca9bda547d22a40432179863246237e4097d021548ed",
+    // voteproducer, producers: 26
+    "7c779d79d45e495ad4b98df6b9b34b445ed36a4a369f1fd71a5bec1945d96c39",
+    // voteproducer, producers: 27
+    "2e75a8748bcfdd432db2581a20c106cd766a556dac2933623e3f72f4aff21c20",
+    // voteproducer, producers: 28
+    "3ab8acce823b31fff54f18951982edec8276de4a914c97c818c4aa9065ae99c1",
+    // voteproducer, producers: 29
+    "2c03663ba4a816e1d533edc953e4e0b2b5f19ffa486162dcd2206ec9468ce2cb",
+    // voteproducer, producers: 30
+    "4ade67615fa67460a0709b9e810f5476e86aed5baabc0496c15deb28f57ca525",
+    // voteproxy
+    "f84daca3b093a73247214c7ef1fb990ab54ff06b9d3b69ac73d991f9df79544c",
+    // wrapdomain
+    "1520a01b8c14c1462ce2cb55207cefba6d77565fece1bfe90a60f9a2e12d33f8",
+    // wraptokens
+    "97b8d1c489189bbccbc6b18e540cba7337d2e38f043e98adb97e6dbaaaaeefa0",
+]
+
+/**
+ * Integrity hashes accepted only by the development build of the app (the command tests)
+ * @category Simulator
+ */
+export const ALLOWED_HASHES_DEVEL: ReadonlyArray<string> = [
+    // Testing transaction template for signTransactionCommandsBasic.js
+    "8ae37fe495027ac109de2ee3f79539140fd56aa56a50d3e996830e033eda3676",
+    // Testing transaction template for signTransactionCommandsShowData.js
+    "e66126ce7557f130ca99d7a3051c813680fa4102d7915cbd68e6e361ef857103",
+    // Testing transaction template for signTransactionCommandsCountedSection.js
+    "2c550f1f218d013a027d2b98befd5b8231c57dcfe363456a6e9c9ccfb7a53b30",
+    // Testing transaction template for signTransactionCommandsStorage.js
+    "3cc2a20dfb3bdef4dd17f9971cc8421ac39f6a639d0d5d9fb424cf6be57c3829",
+    // Testing transaction template for signTransactionCommandsDH.js (DH step, and FINISH step)
+    "ad0ed3a295d52c97b3f5a6c066eae55dbb71d11f57693589d43a5af03eedbf17",
+    "f2ab8ed1160ac83e672cefcd8f814297607d8a1ec87687e43f6a923d03a08a16",
+    "43d20e077af1889a211309a88bfea46aad4e4384b294e695e55cc98d95873bf9",
+    "c51db36c7bca2bbdde285502edd10a592be2fab73f9e77ca36d1334e857899cd",
+    // Testing transaction template for signTransactionCommandsDHCountedSections.js (DH step, and
+    // FINISH step)
+    "3294cbbb5216fbe3ffba8a8fdd9da64b7d278d8853d0fe529602ed5d968620f0",
+    "a370531ef33ebe293cb7cdd3e42be019a0dfb12c92a1086cd80bd4c537ced2ea",
+    "02f32d9fa2faec13da8164bb66ea0effde094350cabad46fbf94c54d7c5cb341",
+]
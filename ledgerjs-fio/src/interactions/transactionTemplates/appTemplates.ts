@@ -0,0 +1,457 @@
+// Transaction templates compiled into the app and run by the TEMPLATE command, the same as in
+// src/signTransactionTemplates.c. Every supported action has one template program: its steps
+// (the constant part of the commands) with the counted loops and alternatives of the action.
+// The tables are generated with the integrity hashes by tools/integrityHashes.ts from the same
+// samples, do not edit them by hand.
+
+import * as crypto from "crypto"
+
+/**
+ * Ops of the template programs, see doc/ins_sign_tx.md
+ */
+export const enum TEMPLATE_OP {
+    /** step: runs the command of the step */
+    STEP = 0x01,
+    /** step: runs the command of the step with the iteration of the loop (from 1) appended to its key */
+    STEP_INDEXED = 0x02,
+    /** min, max: takes the count of the loop from the host */
+    COUNT = 0x03,
+    /** appends the count as constant data (APPEND_CONST_DATA of one byte) */
+    APPEND_COUNT = 0x04,
+    /** body length: repeats the ops of the body count times */
+    LOOP = 0x05,
+    /** alternatives, alternative length: takes the alternative from the host and runs its ops */
+    CHOICE = 0x06,
+}
+
+export const TEMPLATE_ID_LENGTH = 4
+
+// Offset of the key length in the const data of the commands with an indexed key
+const APPEND_DATA_KEY_LENGTH_OFFSET = 19
+const SHOW_MESSAGE_KEY_LENGTH_OFFSET = 0
+const APPEND_CONST_DATA = 0x02
+const SHOW_MESSAGE = 0x03
+const APPEND_DATA = 0x04
+
+/**
+ * Constant part of every command of the templates, each once: p1, p2, const data length and data.
+ * The keys of the indexed steps are without the iteration.
+ */
+export const TEMPLATE_STEPS: ReadonlyArray<string> = [
+    // 0: INIT
+    "010000",
+    // 1: APPEND_DATA ""
+    "04001401020a000000000000000a000000000000000200",
+    // 2: APPEND_CONST_DATA 5 bytes
+    "0200050000000001",
+    // 3: APPEND_CONST_DATA 17 bytes
+    "0200110000980ad20ca85be0e1d195ba85e7cd01",
+    // 4: SHOW_MESSAGE "Action"
+    "03001b06416374696f6e135472616e736665722046494f20746f6b656e73",
+    // 5: STORE_VALUE R1
+    "070100",
+    // 6: APPEND_DATA ""
+    "0400140102080000000000000008000000000000001200",
+    // 7: APPEND_DATA ""
+    "0400140102080000000000000008000000000000000200",
+    // 8: START_COUNTED_SECTION
+    "05001217030000000000000000ffffffff00000000",
+    // 9: APPEND_DATA "Payee Pubkey"
+    "040020040201000000000000000400000001000000050c5061796565205075626b6579",
+    // 10: APPEND_DATA "Amount"
+    "04001a10030000000000000000ffffffffffffff7f0506416d6f756e74",
+    // 11: APPEND_DATA "Max fee"
+    "04001b10030000000000000000ffffffffffffff7f05074d617820666565",
+    // 12: APPEND_DATA ""
+    "0400140402010000000000000004000000010000000200",
+    // 13: END_COUNTED_SECTION
+    "060000",
+    // 14: APPEND_CONST_DATA 33 bytes
+    "020021000000000000000000000000000000000000000000000000000000000000000000",
+    // 15: FINISH
+    "100000",
+    // 16: APPEND_CONST_DATA 17 bytes
+    "02001100403ed4aa0ba85b00acba384dbdb89a01",
+    // 17: SHOW_MESSAGE "Action"
+    "03001506416374696f6e0d526571756573742046756e6473",
+    // 18: APPEND_DATA "Payer FIO Handle"
+    "040024040204000000000000004100000000000000051050617965722046494f2048616e646c65",
+    // 19: APPEND_DATA "Payee FIO Handle"
+    "040024040204000000000000004100000000000000051050617965652046494f2048616e646c65",
+    // 20: START_COUNTED_SECTION
+    "050012170340000000000000002801000000000000",
+    // 21: START_DH_ENCRYPTION
+    "080000",
+    // 22: APPEND_DATA "Payee Public Addr"
+    "04002504020100000000000000040000000100000005115061796565205075626c69632041646472",
+    // 23: APPEND_DATA "Amount requested"
+    "0400240402010000000000000004000000010000000510416d6f756e7420726571756573746564",
+    // 24: APPEND_DATA "Chain code"
+    "04001e040202000000000000000b00000000000000050a436861696e20636f6465",
+    // 25: APPEND_DATA "Token code"
+    "04001e040202000000000000000b00000000000000050a546f6b656e20636f6465",
+    // 26: APPEND_DATA ""
+    "0400142001000000000000000000000000000000000200",
+    // 27: END_DH_ENCRYPTION
+    "090000",
+    // 28: APPEND_DATA ""
+    "040014020200000000000000000e000000000000004200",
+    // 29: APPEND_CONST_DATA 17 bytes
+    "02001100403ed4aa0ba85b0000c887a64b91ba01",
+    // 30: SHOW_MESSAGE "Action"
+    "03001706416374696f6e0f5265636f7264206d65746164617461",
+    // 31: APPEND_DATA "Request ID"
+    "04001e040201000000000000000400000001000000060a52657175657374204944",
+    // 32: START_COUNTED_SECTION
+    "05001217034000000000000000b001000000000000",
+    // 33: APPEND_DATA "Payer Public Addr"
+    "04002504020100000000000000040000000100000005115061796572205075626c69632041646472",
+    // 34: APPEND_DATA "Status"
+    "04001a0402010000000000000004000000010000000506537461747573",
+    // 35: APPEND_DATA "Obt ID"
+    "04001a04020100000000000000040000000100000005064f6274204944",
+    // 36: APPEND_CONST_DATA 17 bytes
+    "02001100403ed4aa0ba85b60d54d734585a64101",
+    // 37: SHOW_MESSAGE "Action"
+    "03001c06416374696f6e1443616e63656c2066756e64732072657175657374",
+    // 38: APPEND_DATA "Request ID"
+    "04001e040201000000000000000400000001000000050a52657175657374204944",
+    // 39: APPEND_CONST_DATA 17 bytes
+    "02001100403ed4aa0ba85b60d54d7365a49eba01",
+    // 40: SHOW_MESSAGE "Action"
+    "03001c06416374696f6e1452656a6563742066756e64732072657175657374",
+    // 41: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b0000c6eaa664523201",
+    // 42: SHOW_MESSAGE "Action"
+    "03001a06416374696f6e124d6170207075626c69632061646472657373",
+    // 43: APPEND_DATA "FIO Handle"
+    "04001e040204000000000000004100000000000000050a46494f2048616e646c65",
+    // 44: APPEND_DATA "Mapping "
+    "04001c21010000000000000000000000000000000005084d617070696e6720",
+    // 45: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b0000c6eaa664a4ba01",
+    // 46: SHOW_MESSAGE "Action"
+    "03002606416374696f6e1e52656d6f7665207075626c69632061646472657373206d617070696e6773",
+    // 47: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b00000000e435533201",
+    // 48: SHOW_MESSAGE "Action"
+    "03001006416374696f6e084d6170206e667473",
+    // 49: SHOW_MESSAGE "Mapping "
+    "03000a084d617070696e672000",
+    // 50: APPEND_DATA "Contract address"
+    "0400240402020000000000000082000000000000000510436f6e74726163742061646472657373",
+    // 51: APPEND_DATA "NFT Token ID"
+    "040020040201000000000000008200000000000000050c4e465420546f6b656e204944",
+    // 52: APPEND_DATA ""
+    "0400140402010000000000000082000000000000000200",
+    // 53: APPEND_DATA ""
+    "0400140402010000000000000041000000000000000200",
+    // 54: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b00000000e435a5ba01",
+    // 55: SHOW_MESSAGE "Action"
+    "03001b06416374696f6e1352656d6f7665206e6674206d617070696e6773",
+    // 56: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b00c04dc9c468a4ba01",
+    // 57: SHOW_MESSAGE "Action"
+    "03002a06416374696f6e2252656d6f766520616c6c207075626c69632061646472657373206d617070696e6773",
+    // 58: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b0000ce6bc668a4ba01",
+    // 59: SHOW_MESSAGE "Action"
+    "03001f06416374696f6e1752656d6f766520616c6c206e6674206d617070696e6773",
+    // 60: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b000056314d7d523201",
+    // 61: SHOW_MESSAGE "Action"
+    "03001306416374696f6e0b4164642042756e646c6573",
+    // 62: APPEND_DATA "Bundle sets"
+    "04001f14030000000000000000ffffffffffffff7f050b42756e646c652073657473",
+    // 63: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b0000c6eaa66498ba01",
+    // 64: SHOW_MESSAGE "Action"
+    "03002206416374696f6e1a52656769737465722046494f2043727970746f2048616e646c65",
+    // 65: APPEND_DATA "Owner Pubkey"
+    "040020040201000000000000000400000001000000050c4f776e6572205075626b6579",
+    // 66: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b003056372573d5ea01",
+    // 67: SHOW_MESSAGE "Action"
+    "03002206416374696f6e1a5472616e736665722046494f2043727970746f2048616e646c65",
+    // 68: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b000098ce489a98ba01",
+    // 69: SHOW_MESSAGE "Action"
+    "03001b06416374696f6e1352656769737465722046494f20446f6d61696e",
+    // 70: APPEND_DATA "FIO Domain"
+    "04001e040202000000000000003f00000000000000050a46494f20446f6d61696e",
+    // 71: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b00a6339226aea6ba01",
+    // 72: SHOW_MESSAGE "Action"
+    "03001806416374696f6e1052656e65772046494f20646f6d61696e",
+    // 73: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b70749dce489ab2c201",
+    // 74: SHOW_MESSAGE "Action"
+    "03002e06416374696f6e265365742046494f20446f6d61696e20726567697374726174696f6e207065726d697373696f6e",
+    // 75: APPEND_CONST_DATA 1 bytes
+    "02000101",
+    // 76: SHOW_MESSAGE "Make"
+    "03000c044d616b65065075626c6963",
+    // 77: APPEND_CONST_DATA 1 bytes
+    "02000100",
+    // 78: SHOW_MESSAGE "Make"
+    "03000d044d616b650750726976617465",
+    // 79: APPEND_CONST_DATA 17 bytes
+    "020011003056372503a85b00c07446d274d5ea01",
+    // 80: SHOW_MESSAGE "Action"
+    "03001b06416374696f6e135472616e736665722046494f20446f6d61696e",
+    // 81: APPEND_DATA "New owner Pubkey"
+    "04002404020100000000000000040000000100000005104e6577206f776e6572205075626b6579",
+    // 82: APPEND_CONST_DATA 17 bytes
+    "02001100d874d0640ca85b000000d42d054dc601",
+    // 83: SHOW_MESSAGE "Action"
+    "03001806416374696f6e105374616b652046494f20546f6b656e73",
+    // 84: APPEND_CONST_DATA 17 bytes
+    "02001100d874d0640ca85b0000754b4193f1d401",
+    // 85: SHOW_MESSAGE "Action"
+    "03001a06416374696f6e12556e7374616b652046494f20546f6b656e73",
+    // 86: APPEND_CONST_DATA 17 bytes
+    "0200110000000000ea30557015d289deaa32dd01",
+    // 87: SHOW_MESSAGE "Action"
+    "03002406416374696f6e1c566f746520666f722046494f20426c6f636b2070726f647563657273",
+    // 88: APPEND_DATA "Producer "
+    "04001d040204000000000000004100000000000000050950726f647563657220",
+    // 89: APPEND_CONST_DATA 17 bytes
+    "0200110000000000ea30550000f09ddeaa32dd01",
+    // 90: SHOW_MESSAGE "Action"
+    "03001306416374696f6e0b50726f787920766f746573",
+    // 91: APPEND_DATA "Proxy"
+    "040019040204000000000000004100000000000000050550726f7879",
+    // 92: APPEND_CONST_DATA 17 bytes
+    "02001100808ac85c0aa85b00c07446d254cde501",
+    // 93: SHOW_MESSAGE "Action"
+    "03001706416374696f6e0f577261702046494f20446f6d61696e",
+    // 94: APPEND_DATA "Public Address"
+    "040022040201000000000000000400000001000000050e5075626c69632041646472657373",
+    // 95: APPEND_DATA "Max oracle fee"
+    "04002210030000000000000000ffffffffffffff7f050e4d6178206f7261636c6520666565",
+    // 96: APPEND_CONST_DATA 17 bytes
+    "02001100808ac85c0aa85b00009e0ad25ccde501",
+    // 97: SHOW_MESSAGE "Action"
+    "03001306416374696f6e0b5772617020546f6b656e73",
+]
+
+/**
+ * ID and the program of every template
+ */
+export const TEMPLATES: ReadonlyArray<[string, string]> = [
+    // trnsfiopubky
+    ["8542bf32", "0100010101020103010401050106010701080109010a010b0106010c010d010e010f"],
+    // newfundsreq
+    ["b87acbe0", "01000101010201100111010501060107010801120113011401150116011701180119011a011b010d010b0108011c010d010c010d010e010f"],
+    // recordobt
+    ["84e96663", "010001010102011d011e0105010601070108011f01120113012001150121011601170118011901220123011a011b010d010b0108011c010d010c010d010e010f"],
+    // cancelfndreq
+    ["ec410638", "0100010101020124012501050106010701080126010b0108011c010d010c010d010e010f"],
+    // rejectfndreq
+    ["852b1d85", "0100010101020127012801050106010701080126010b0108011c010d010c010d010e010f"],
+    // addaddress
+    ["4a97cfc0", "0100010101020129012a0105010601070108012b030105040502022c010b0106010c010d010e010f"],
+    // remaddress
+    ["9afccda4", "010001010102012d012e0105010601070108012b030105040502022c010b0106010c010d010e010f"],
+    // addnft
+    ["e5c72657", "010001010102012f01300105010601070108012b03010304050e0231011801320133013401350134010b0106010c010d010e010f"],
+    // remnft
+    ["cfad8675", "010001010102013601370105010601070108012b0301030405080231011801320133010b0106010c010d010e010f"],
+    // remalladdr
+    ["e553124c", "010001010102013801390105010601070108012b010b0106010c010d010e010f"],
+    // remallnfts
+    ["9a5311a7", "010001010102013a013b0105010601070108012b010b0106010c010d010e010f"],
+    // addbundles
+    ["c39ca14b", "010001010102013c013d0105010601070108012b013e010b010c0106010d010e010f"],
+    // regaddress
+    ["dba83ae8", "010001010102013f01400105010601070108012b0141010b0106010c010d010e010f"],
+    // xferaddress
+    ["7a7cd737", "010001010102014201430105010601070108012b0141010b0106010c010d010e010f"],
+    // regdomain
+    ["0e55076d", "01000101010201440145010501060107010801460141010b0106010c010d010e010f"],
+    // renewdomain
+    ["9616a29c", "0100010101020147014801050106010701080146010b010c0106010d010e010f"],
+    // setdomainpub
+    ["a9e65ca3", "0100010101020149014a01050106010701080146060204014b014c014d014e010b0106010c010d010e010f"],
+    // xferdomain
+    ["773e3ec2", "010001010102014f0150010501060107010801460151010b0106010c010d010e010f"],
+    // stakefio
+    ["c59281ec", "010001010102015201530105010601070108012b010a010b010c0106010d010e010f"],
+    // unstakefio
+    ["3228ac12", "010001010102015401550105010601070108012b010a010b010c0106010d010e010f"],
+    // voteproducer
+    ["eb282686", "01000101010201560157010501060107010803011e0405020258012b0106010b010d010e010f"],
+    // voteproxy
+    ["573e9044", "0100010101020159015a0105010601070108015b012b0106010b010d010e010f"],
+    // wrapdomain
+    ["f9455b9d", "010001010102015c015d010501060107010801460118015e015f010b010c0106010d010e010f"],
+    // wraptokens
+    ["925e73df", "010001010102016001610105010601070108010a0118015e015f010b010c0106010d010e010f"],
+]
+
+/**
+ * A command of a template, with its const data
+ */
+export type TemplateStep = {p1: number, p2: number, constData: Buffer}
+
+/**
+ * The steps of a template run with the value of its parameter, the host sends the value (a
+ * parameter entry) where its op is (`null` steps)
+ */
+export type ExpandedTemplate = {
+    id: Buffer
+    parameter: number | null
+    steps: Array<TemplateStep | null>
+}
+
+export function parseTemplateStep(hex: string): TemplateStep {
+    const data = Buffer.from(hex, "hex")
+    return {p1: data[0], p2: data[1], constData: data.slice(3, 3 + data[2])}
+}
+
+function keyLengthOffset(p1: number): number {
+    switch (p1) {
+    case APPEND_DATA: return APPEND_DATA_KEY_LENGTH_OFFSET
+    case SHOW_MESSAGE: return SHOW_MESSAGE_KEY_LENGTH_OFFSET
+    default: throw new Error(`no key to index in command ${p1}`)
+    }
+}
+
+/**
+ * The step with the iteration appended to its key, as by txTemplate_indexStep on the device
+ */
+export function indexTemplateStep({p1, p2, constData}: TemplateStep, iteration: number): TemplateStep {
+    const offset = keyLengthOffset(p1)
+    const keyEnd = offset + 1 + constData[offset]
+    const digits = Buffer.from(String(iteration))
+    const indexed = Buffer.concat([constData.slice(0, keyEnd), digits, constData.slice(keyEnd)])
+    indexed[offset] += digits.length
+    return {p1, p2, constData: indexed}
+}
+
+/**
+ * The range of the parameter of the template program (COUNT or CHOICE), null if it has none
+ */
+export function templateParameterRange(program: Buffer): {min: number, max: number} | null {
+    for (let pc = 0; pc < program.length; pc += opLength(program[pc])) {
+        if (program[pc] === TEMPLATE_OP.COUNT) return {min: program[pc + 1], max: program[pc + 2]}
+        if (program[pc] === TEMPLATE_OP.CHOICE) return {min: 0, max: program[pc + 1] - 1}
+    }
+    return null
+}
+
+function opLength(op: number): number {
+    switch (op) {
+    case TEMPLATE_OP.APPEND_COUNT: return 1
+    case TEMPLATE_OP.STEP:
+    case TEMPLATE_OP.STEP_INDEXED:
+    case TEMPLATE_OP.LOOP: return 2
+    case TEMPLATE_OP.COUNT:
+    case TEMPLATE_OP.CHOICE: return 3
+    default: throw new Error(`unknown template op ${op}`)
+    }
+}
+
+/**
+ * The steps of the template program run with the parameter (ignored if the program has none),
+ * `null` where the host sends the parameter
+ */
+export function expandTemplateProgram(program: Buffer, steps: ReadonlyArray<TemplateStep>,
+    parameter: number): Array<TemplateStep | null> {
+    const expanded: Array<TemplateStep | null> = []
+    const run = (from: number, to: number, iteration: number): void => {
+        let pc = from
+        while (pc < to) {
+            const op = program[pc]
+            switch (op) {
+            case TEMPLATE_OP.STEP:
+                expanded.push(steps[program[pc + 1]])
+                break
+            case TEMPLATE_OP.STEP_INDEXED:
+                expanded.push(indexTemplateStep(steps[program[pc + 1]], iteration))
+                break
+            case TEMPLATE_OP.COUNT:
+            case TEMPLATE_OP.CHOICE:
+                expanded.push(null)
+                break
+            case TEMPLATE_OP.APPEND_COUNT:
+                expanded.push({p1: APPEND_CONST_DATA, p2: 0, constData: Buffer.from([parameter])})
+                break
+            case TEMPLATE_OP.LOOP:
+                for (let i = 1; i <= parameter; i++) {
+                    run(pc + 2, pc + 2 + program[pc + 1], i)
+                }
+                pc += program[pc + 1]
+                break
+            }
+            if (op === TEMPLATE_OP.CHOICE) {
+                const alternativeStart = pc + 3 + parameter * program[pc + 2]
+                run(alternativeStart, alternativeStart + program[pc + 2], iteration)
+                pc += program[pc + 1] * program[pc + 2]
+            }
+            pc += opLength(op)
+        }
+    }
+    run(0, program.length, 0)
+    return expanded
+}
+
+/**
+ * ID of the template program: the beginning of SHA-256 of its ops with the steps inlined
+ */
+export function templateProgramId(program: Buffer, steps: ReadonlyArray<string>): Buffer {
+    const hash = crypto.createHash("sha256")
+    for (let pc = 0; pc < program.length; pc += opLength(program[pc])) {
+        const op = program[pc]
+        if (op === TEMPLATE_OP.STEP || op === TEMPLATE_OP.STEP_INDEXED) {
+            hash.update(Buffer.from([op])).update(Buffer.from(steps[program[pc + 1]], "hex"))
+        } else {
+            hash.update(program.slice(pc, pc + opLength(op)))
+        }
+    }
+    return hash.digest().subarray(0, TEMPLATE_ID_LENGTH)
+}
+
+/**
+ * The integrity hash at FINISH of the steps, as computed by the device
+ */
+export function templateIntegrityHash(steps: Array<TemplateStep | null>): string {
+    let hash = Buffer.alloc(32)
+    for (const step of steps) {
+        if (step === null) continue
+        hash = crypto.createHash("sha256")
+            .update(hash)
+            .update(Buffer.from([step.p1, step.p2, step.constData.length]))
+            .update(step.constData)
+            .digest()
+    }
+    return hash.toString("hex")
+}
+
+// Every run of every template by its integrity hash at FINISH, built on the first use
+let templatesByHash: Map<string, ExpandedTemplate> | null = null
+
+/**
+ * The template of the app and its parameter running the command sequence with the integrity
+ * hash at FINISH, null if there is none
+ */
+export function findAppTemplate(finishHash: string): ExpandedTemplate | null {
+    if (templatesByHash === null) {
+        templatesByHash = new Map()
+        const steps = TEMPLATE_STEPS.map(parseTemplateStep)
+        for (const [idHex, programHex] of TEMPLATES) {
+            const program = Buffer.from(programHex, "hex")
+            const range = templateParameterRange(program) ?? {min: 0, max: 0}
+            for (let parameter = range.min; parameter <= range.max; parameter++) {
+                const expanded = expandTemplateProgram(program, steps, parameter)
+                templatesByHash.set(templateIntegrityHash(expanded), {
+                    id: Buffer.from(idHex, "hex"),
+                    parameter: templateParameterRange(program) !== null ? parameter : null,
+                    steps: expanded,
+                })
+            }
+        }
+    }
+    return templatesByHash.get(finishHash) ?? null
+}
@@ -2,9 +2,9 @@ import { assert } from "../../utils/assert";
 import { InvalidDataReason } from "../../errors"
 import { HexString, Uint8_t, ParsedTransaction, ValidBIP32Path, VarlenAsciiString, Uint64_str } from "types/internal"
 import { buf_to_hex, path_to_buf, uint8_to_buf, varuint32_to_buf } from "../../utils/serialize";
-import type { SignedTransactionData } from "../../types/public";
+import type { SignedTransactionData, Witness } from "../../types/public";
 import { chunkBy } from "../../utils/ioHelpers"
-import { validate } from "../../utils/parse";
+import { parseNameString, validate } from "../../utils/parse";
 
 export const enum COMMAND {
     NONE = 0x00,
@@ -18,6 +18,8 @@ export const enum COMMAND {
     START_DH_ENCRYPTION = 0x08,
     END_DH_ENCRYPTION = 0x09,
     FINISH= 0x10,
+    // Runs the steps of a template compiled into the app, see signTransaction.ts
+    TEMPLATE = 0x11,
 };
 
 export const enum VALUE_FORMAT {
@@ -54,20 +56,34 @@ export const enum VALUE_STORAGE_COMPARE {
     COMPARE_REGISTER1_DECODE_NAME = 0x40,
 }
 
-export type DataAction = (b: Buffer, s: SignedTransactionData) => SignedTransactionData
+// The responses collected while signing. The DH output comes in many responses, its chunks
+// are joined only once at the end.
+export type SignTransactionState = {
+    dhEncryptedChunks: Array<Buffer>,
+    txHashHex: string,
+    witness: Witness,
+}
+
+export type DataAction = (b: Buffer, s: SignTransactionState) => void
 
 export const dhDataAction: DataAction = (b, s) => {
+    if (b.length > 0) {
+        s.dhEncryptedChunks.push(b);
+    }
+}
+
+export function signedTransactionData(s: SignTransactionState): SignedTransactionData {
     return {
-        dhEncryptedData: s.dhEncryptedData + b.toString(),
+        dhEncryptedData: Buffer.concat(s.dhEncryptedChunks).toString(),
         txHashHex: s.txHashHex,
-        witness: s.witness
+        witness: s.witness,
     }
 }
 
 export type Command = {
     command: COMMAND,
     p2: Uint8_t,
-    constData: HexString,
+    constData: Buffer, //shared between transactions, never modified
     varData: Buffer,
     expectedResponseLength?: number,
     dataAction: DataAction, 
@@ -77,42 +93,62 @@ export type Command = {
 export const defaultCommand: Command = {
     command: COMMAND.NONE,
     p2: 0 as Uint8_t,
-    constData: "" as HexString,
-    varData: Buffer.from(""),
+    constData: Buffer.alloc(0),
+    varData: Buffer.alloc(0),
     dataAction: dhDataAction, //does nothing if there is no DH
     txLen: 0
 }
 
 export type TransactionTemplate = (chainId: HexString, tx: ParsedTransaction, parsedPath: ValidBIP32Path) => Array<Command>;
 
+// The constant data depends only on the template, not on the transaction. It is encoded once
+// and the same Buffer is used by all transactions.
+const constDataCache = new Map<string, Buffer>();
+
+function cachedConstData(cacheKey: string, encode: () => Buffer): Buffer {
+    let buf = constDataCache.get(cacheKey);
+    if (buf === undefined) {
+        buf = encode();
+        constDataCache.set(cacheKey, buf);
+    }
+    return buf;
+}
+
 export function constDataAppendData(format: VALUE_FORMAT, validation: VALUE_VALIDATION, arg1: bigint, arg2: bigint,
-                                    policy: VALUE_POLICY, storage: VALUE_STORAGE_COMPARE, key: string): HexString {
-    const buf = Buffer.allocUnsafe(20+ key.length);
-    buf.writeUInt8(format, 0);
-    buf.writeUInt8(validation, 1);
-    buf.writeBigUInt64LE(arg1, 2);
-    buf.writeBigUInt64LE(arg2, 10);
-    buf.writeUInt8(policy | storage, 18);
-    buf.writeUInt8(key.length, 19);
-    buf.write(key, 20);
-    return buf.toString("hex") as HexString;
-}
-
-export function constDataShowMessage(key: string, value: string) {    const buf = Buffer.allocUnsafe(2+key.length+value.length);
-    buf.writeUInt8(key.length, 0);
-    buf.write(key, 1);
-    buf.writeUInt8(value.length, 1+key.length);
-    buf.write(value, 2+key.length);
-    return buf.toString("hex") as HexString;
-}
-
-export function constDataStartCountedSection(format: VALUE_FORMAT, validation: VALUE_VALIDATION, arg1: bigint, arg2: bigint): HexString {
-    const buf = Buffer.allocUnsafe(18);
-    buf.writeUInt8(format, 0);
-    buf.writeUInt8(validation, 1);
-    buf.writeBigUInt64LE(arg1, 2);
-    buf.writeBigUInt64LE(arg2, 10);
-    return buf.toString("hex") as HexString;
+                                    policy: VALUE_POLICY, storage: VALUE_STORAGE_COMPARE, key: string): Buffer {
+    return cachedConstData(`append:${format}:${validation}:${arg1}:${arg2}:${policy | storage}:${key}`, () => {
+        const buf = Buffer.allocUnsafe(20+ key.length);
+        buf.writeUInt8(format, 0);
+        buf.writeUInt8(validation, 1);
+        buf.writeBigUInt64LE(arg1, 2);
+        buf.writeBigUInt64LE(arg2, 10);
+        buf.writeUInt8(policy | storage, 18);
+        buf.writeUInt8(key.length, 19);
+        buf.write(key, 20);
+        return buf;
+    });
+}
+
+export function constDataShowMessage(key: string, value: string): Buffer {
+    return cachedConstData(`show:${key.length}:${key}:${value}`, () => {
+        const buf = Buffer.allocUnsafe(2+key.length+value.length);
+        buf.writeUInt8(key.length, 0);
+        buf.write(key, 1);
+        buf.writeUInt8(value.length, 1+key.length);
+        buf.write(value, 2+key.length);
+        return buf;
+    });
+}
+
+export function constDataStartCountedSection(format: VALUE_FORMAT, validation: VALUE_VALIDATION, arg1: bigint, arg2: bigint): Buffer {
+    return cachedConstData(`counted:${format}:${validation}:${arg1}:${arg2}`, () => {
+        const buf = Buffer.allocUnsafe(18);
+        buf.writeUInt8(format, 0);
+        buf.writeUInt8(validation, 1);
+        buf.writeBigUInt64LE(arg1, 2);
+        buf.writeBigUInt64LE(arg2, 10);
+        return buf;
+    });
 }
 
 export function getCommandVarLength(commands: Array<Command>): number {
@@ -148,6 +184,21 @@ export function templateAlternative(templates: Array<TransactionTemplate>): Tran
     }
 }
 
+// Picks the template of the action by its contract account and action name instead of trying
+// them one by one. The index is built once, the chosen template still checks its own match.
+export function templateIndex(templates: Array<[string, string, TransactionTemplate]>): TransactionTemplate {
+    const index = new Map<string, TransactionTemplate>();
+    for (const [account, name, template] of templates) {
+        const key = parseNameString(account, InvalidDataReason.UNEXPECTED_ERROR) + parseNameString(name, InvalidDataReason.UNEXPECTED_ERROR);
+        assert(!index.has(key), "Duplicate template for " + account + "::" + name);
+        index.set(key, template);
+    }
+    return (chainId, tx, path) => {
+        const template = index.get(tx.actions[0].account + tx.actions[0].name);
+        return template !== undefined ? template(chainId, tx, path) : [];
+    }
+}
+
 //---------------------INSTRUCTION SPECIFIC COMMANDS---------------------------------
 
 export function COMMAND_INIT(chainId: HexString, parsedPath: ValidBIP32Path): Command {
@@ -161,11 +212,12 @@ export function COMMAND_INIT(chainId: HexString, parsedPath: ValidBIP32Path): Co
 }
 
 export function COMMAND_APPEND_CONST_DATA(constData: HexString): Command {
+    const buf = cachedConstData(`const:${constData}`, () => Buffer.from(constData, "hex"));
     return {
         ...defaultCommand,
         command: COMMAND.APPEND_CONST_DATA, 
-        constData: constData,
-        txLen: Buffer.from(constData, "hex").length,
+        constData: buf,
+        txLen: buf.length,
     }
 }
 
@@ -388,28 +440,36 @@ export function COMMAND_FINISH(parsedPath: ValidBIP32Path): Command {
         dataAction: (b, s) => {
             const [witnessSignature, hash, rest] = chunkBy(b, [65, 32])
             assert(rest.length === 0, "invalid response length")
-        
-            return {
-                dhEncryptedData: s.dhEncryptedData,
-                txHashHex: buf_to_hex(hash),
-                witness: {
-                    path: parsedPath,
-                    witnessSignatureHex: buf_to_hex(witnessSignature),
-                },
-            }
-        
+
+            s.txHashHex = buf_to_hex(hash);
+            s.witness = {
+                path: parsedPath,
+                witnessSignatureHex: buf_to_hex(witnessSignature),
+            };
         },
     }
 }
 
+// The constant data with the check, by the constant data without it
+const storageCheckCache = new WeakMap<Buffer, Map<VALUE_STORAGE_COMPARE, Buffer>>();
+
 export function ADD_STORAGE_CHECK(check: VALUE_STORAGE_COMPARE, c: Command): Command {
-    const constData: Buffer = Buffer.from(c.constData, "hex")
-    const policyAndStorage: Uint8_t = constData[18] as Uint8_t
-    const newValue: Uint8_t = ((policyAndStorage & 0x0F) | check) as Uint8_t
-    constData.writeUInt8(newValue,18)
+    let checks = storageCheckCache.get(c.constData);
+    if (checks === undefined) {
+        checks = new Map();
+        storageCheckCache.set(c.constData, checks);
+    }
+    let constData = checks.get(check);
+    if (constData === undefined) {
+        constData = Buffer.from(c.constData)
+        const policyAndStorage: Uint8_t = constData[18] as Uint8_t
+        const newValue: Uint8_t = ((policyAndStorage & 0x0F) | check) as Uint8_t
+        constData.writeUInt8(newValue,18)
+        checks.set(check, constData);
+    }
     return {
         ...c,
-        constData: constData.toString("hex") as HexString,
+        constData: constData,
     }
 }
 
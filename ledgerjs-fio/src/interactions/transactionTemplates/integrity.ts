@@ -0,0 +1,88 @@
+// Host side of the integrity check of src/signTransactionIntegrity.c. The device chains
+// SHA-256 over the constant part of every command (p1, p2 and the const data, not the
+// variable data) and accepts the sequence only if the chain is one of its allowed hashes at
+// END_DH_ENCRYPTION and FINISH. The same chain is computed here from the commands of the
+// templates, so a sequence the device would reject is refused before anything is sent.
+
+import * as crypto from "crypto"
+
+import type {HexString} from "../../types/internal"
+import {ALLOWED_HASHES} from "./allowedHashes"
+import type {ExpandedTemplate} from "./appTemplates"
+import {findAppTemplate} from "./appTemplates"
+import type {Command} from "./commands"
+import {COMMAND} from "./commands"
+
+const allowedHashes = new Set(ALLOWED_HASHES)
+
+// The hash chain after a command sequence, with the chains after its continuations. The const
+// data of the templates is encoded once (see cachedConstData), so the same sequences of the same
+// buffers come again and the chain is computed only once for each of them.
+type ChainNode = {
+    hash: Buffer
+    hashHex: HexString
+    next: WeakMap<Buffer, Map<number, ChainNode>>
+}
+
+const chainRoot: ChainNode = {hash: Buffer.alloc(32), hashHex: "00".repeat(32) as HexString, next: new WeakMap()}
+
+function nextNode(node: ChainNode, command: Command): ChainNode {
+    let byHeader = node.next.get(command.constData)
+    if (byHeader === undefined) {
+        byHeader = new Map()
+        node.next.set(command.constData, byHeader)
+    }
+    const header = (command.command << 8) | command.p2
+    let next = byHeader.get(header)
+    if (next === undefined) {
+        const hash = crypto.createHash("sha256")
+            .update(node.hash)
+            .update(Buffer.from([command.command, command.p2, command.constData.length]))
+            .update(command.constData)
+            .digest()
+        next = {hash, hashHex: hash.toString("hex") as HexString, next: new WeakMap()}
+        byHeader.set(header, next)
+    }
+    return next
+}
+
+// The chain nodes at the points the device checks them (END_DH_ENCRYPTION and FINISH)
+function checkedNodes(commands: Array<Command>): Array<ChainNode> {
+    const nodes: Array<ChainNode> = []
+    let node = chainRoot
+    for (const command of commands) {
+        node = nextNode(node, command)
+        if (command.command === COMMAND.END_DH_ENCRYPTION || command.command === COMMAND.FINISH) {
+            nodes.push(node)
+        }
+    }
+    return nodes
+}
+
+/**
+ * The integrity hashes of the commands at the points the device checks them
+ * (END_DH_ENCRYPTION and FINISH), in the order of the commands
+ */
+export function integrityHashes(commands: Array<Command>): Array<HexString> {
+    return checkedNodes(commands).map(node => node.hashHex)
+}
+
+/**
+ * Whether the release build of the app accepts the command sequence
+ */
+export function isIntegrityCheckPassed(commands: Array<Command>): boolean {
+    return checkedNodes(commands).every(node => allowedHashes.has(node.hashHex))
+}
+
+/**
+ * The template compiled into the app which runs the command sequence, with the value of its
+ * parameter, null if the release build does not accept the sequence.
+ * The templates are generated from the same samples as the allowed hashes.
+ */
+export function appTemplate(commands: Array<Command>): ExpandedTemplate | null {
+    const nodes = checkedNodes(commands)
+    if (nodes.length === 0 || !nodes.every(node => allowedHashes.has(node.hashHex))) {
+        return null
+    }
+    return findAppTemplate(nodes[nodes.length - 1].hashHex)
+}
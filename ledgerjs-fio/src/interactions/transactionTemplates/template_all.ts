@@ -1,5 +1,5 @@
 import type {HexString, ParsedTransaction, ValidBIP32Path} from "../../types/internal"
-import { Command, templateAlternative, COMMAND_INIT,  COMMAND_APPEND_CONST_DATA, COMMAND_FINISH, COMMAND_APPEND_DATA_BUFFER_DO_NOT_SHOW} from "./commands"
+import { Command, templateIndex, COMMAND_INIT,  COMMAND_APPEND_CONST_DATA, COMMAND_FINISH, COMMAND_APPEND_DATA_BUFFER_DO_NOT_SHOW} from "./commands"
 import { date_to_buf, uint16_to_buf, uint32_to_buf } from "../../utils/serialize"
 import { validate } from "../../utils/parse"
 import { InvalidDataReason } from "../../errors";
@@ -28,38 +28,41 @@ import { template_voteproxy } from "./template_voteproxy";
 import { template_wrapdomain } from "./template_wrapdomain";
 import { template_wraptokens } from "./template_wraptokens";
 
+//Action templates by contract account and action name
+const actionTemplate = templateIndex([
+    ["fio.token", "trnsfiopubky", template_trnsfiopubky],
+    ["fio.reqobt", "newfundsreq", template_newfundsreq],
+    ["fio.reqobt", "recordobt", template_recordopt],
+    ["fio.address", "addaddress", template_addaddress],
+    ["fio.address", "remaddress", template_remaddress],
+    ["fio.address", "addnft", template_addnft],
+    ["fio.address", "remnft", template_remnft],
+    ["fio.address", "remalladdr", template_remalladdr],
+    ["fio.reqobt", "cancelfndreq", template_cancelfndreq],
+    ["fio.reqobt", "rejectfndreq", template_rejectfndreq],
+    ["fio.address", "addbundles", template_addbundles],
+    ["fio.address", "regaddress", template_regaddress],
+    ["fio.address", "xferaddress", template_xferaddress],
+    ["fio.address", "regdomain", template_regdomain],
+    ["fio.address", "renewdomain", template_renewdomain],
+    ["fio.address", "setdomainpub", template_setdomainpub],
+    ["fio.address", "xferdomain", template_xferdomain],
+    ["fio.address", "remallnfts", template_remallnfts],
+    ["fio.staking", "stakefio", template_stakefio],
+    ["fio.staking", "unstakefio", template_unstakefio],
+    ["eosio", "voteproducer", template_voteproducer],
+    ["eosio", "voteproxy", template_voteproxy],
+    ["fio.oracle", "wrapdomain", template_wrapdomain],
+    ["fio.oracle", "wraptokens", template_wraptokens]
+]);
+
 export function templete_all(chainId: HexString, tx: ParsedTransaction, parsedPath: ValidBIP32Path): Array<Command> {
     //Validate template expectations
     validate(tx.context_free_actions.length == 0, InvalidDataReason.CONTEXT_FREE_ACTIONS_NOT_SUPPORTED);
     validate(tx.actions.length == 1, InvalidDataReason.MULTIPLE_ACTIONS_NOT_SUPPORTED);
 
     //Match action
-    const actionCommands:Array<Command> = templateAlternative([
-        template_trnsfiopubky, 
-        template_newfundsreq,
-        template_recordopt,
-        template_addaddress,
-        template_remaddress,
-        template_addnft,
-        template_remnft,
-        template_remalladdr,
-        template_cancelfndreq,
-        template_rejectfndreq,
-        template_addbundles,
-        template_regaddress,
-        template_xferaddress,
-        template_regdomain,
-        template_renewdomain,
-        template_setdomainpub,
-        template_xferdomain,
-        template_remallnfts,
-        template_stakefio,
-        template_unstakefio,
-        template_voteproducer,
-        template_voteproxy,
-        template_wrapdomain,
-        template_wraptokens
-    ])(chainId, tx, parsedPath)
+    const actionCommands:Array<Command> = actionTemplate(chainId, tx, parsedPath)
     if (actionCommands.length == 0) return [];
 
     return [
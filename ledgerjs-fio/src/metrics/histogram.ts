@@ -0,0 +1,147 @@
+import {assert} from "../utils/assert"
+
+/**
+ * @category Metrics
+ */
+export type HistogramSummary = {
+    count: number
+    min: number
+    max: number
+    mean: number
+    p50: number
+    p90: number
+    p99: number
+    p999: number
+}
+
+// floor(log2(value)) of a positive integer, exact also above 2^32
+function magnitude(value: number): number {
+    let m = Math.floor(Math.log2(value))
+    if (2 ** m > value) m--
+    if (2 ** (m + 1) <= value) m++
+    return m
+}
+
+/**
+ * Histogram of non-negative integers (e.g. latencies in nanoseconds) in the style of
+ * HdrHistogram: the values are counted in buckets whose width grows with the value, so that
+ * every recorded value is known to the given number of significant decimal digits while
+ * the memory grows only with the logarithm of the maximum.
+ *
+ * Values below 2^subBucketBits are counted exactly. Above, the values of the same
+ * power of two share 2^(subBucketBits - 1) buckets.
+ * @category Metrics
+ */
+export class Histogram {
+    private readonly subBucketBits: number
+    private readonly subBucketHalfCount: number
+    private counts: Array<number> = []
+    private total = 0
+    private sum = 0
+    private minValue = Number.POSITIVE_INFINITY
+    private maxValue = 0
+
+    /**
+     * @param significantDigits precision of the recorded values, 1 to 5
+     */
+    constructor(significantDigits = 3) {
+        assert(Number.isInteger(significantDigits) && significantDigits >= 1 && significantDigits <= 5, "invalid significant digits")
+        this.subBucketBits = Math.ceil(Math.log2(2 * 10 ** significantDigits))
+        this.subBucketHalfCount = 2 ** (this.subBucketBits - 1)
+    }
+
+    private index(value: number): number {
+        if (value < 2 * this.subBucketHalfCount) return value
+        const shift = magnitude(value) - (this.subBucketBits - 1)
+        return shift * this.subBucketHalfCount + Math.floor(value / 2 ** shift)
+    }
+
+    // the highest value counted in the bucket
+    private highestValue(index: number): number {
+        if (index < 2 * this.subBucketHalfCount) return index
+        const shift = Math.floor(index / this.subBucketHalfCount) - 1
+        const subBucket = index - shift * this.subBucketHalfCount
+        return (subBucket + 1) * 2 ** shift - 1
+    }
+
+    record(value: number, count = 1): void {
+        assert(Number.isSafeInteger(value) && value >= 0, "histogram values are non-negative integers")
+        const index = this.index(value)
+        while (this.counts.length <= index) this.counts.push(0)
+        this.counts[index] += count
+        this.total += count
+        this.sum += value * count
+        this.minValue = Math.min(this.minValue, value)
+        this.maxValue = Math.max(this.maxValue, value)
+    }
+
+    /**
+     * Adds the values of another histogram of the same precision
+     */
+    add(other: Histogram): void {
+        assert(other.subBucketBits === this.subBucketBits, "histograms of different precision")
+        while (this.counts.length < other.counts.length) this.counts.push(0)
+        other.counts.forEach((count, index) => {
+            this.counts[index] += count
+        })
+        this.total += other.total
+        this.sum += other.sum
+        this.minValue = Math.min(this.minValue, other.minValue)
+        this.maxValue = Math.max(this.maxValue, other.maxValue)
+    }
+
+    reset(): void {
+        this.counts = []
+        this.total = 0
+        this.sum = 0
+        this.minValue = Number.POSITIVE_INFINITY
+        this.maxValue = 0
+    }
+
+    get count(): number {
+        return this.total
+    }
+
+    get min(): number {
+        return this.total > 0 ? this.minValue : 0
+    }
+
+    get max(): number {
+        return this.maxValue
+    }
+
+    get mean(): number {
+        return this.total > 0 ? this.sum / this.total : 0
+    }
+
+    /**
+     * The value which the given percentage (0 to 100) of the recorded values do not exceed,
+     * to the precision of the histogram
+     */
+    percentile(percentile: number): number {
+        if (this.total === 0) return 0
+        // without the rounding error of the division (e.g. 99.9 / 100 * 1000 > 999)
+        const rank = Math.max(1, Math.ceil(percentile / 100 * this.total * (1 - 4 * Number.EPSILON)))
+        let seen = 0
+        for (let index = 0; index < this.counts.length; index++) {
+            seen += this.counts[index]
+            if (seen >= rank) {
+                return Math.min(this.highestValue(index), this.maxValue)
+            }
+        }
+        return this.maxValue
+    }
+
+    summary(): HistogramSummary {
+        return {
+            count: this.count,
+            min: this.min,
+            max: this.max,
+            mean: this.mean,
+            p50: this.percentile(50),
+            p90: this.percentile(90),
+            p99: this.percentile(99),
+            p999: this.percentile(99.9),
+        }
+    }
+}
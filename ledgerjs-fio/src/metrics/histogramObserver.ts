@@ -0,0 +1,123 @@
+import type {HistogramSummary} from "./histogram"
+import {Histogram} from "./histogram"
+import type {ApduEvent, FioObserver, OperationEvent} from "./observer"
+
+/**
+ * Aggregated APDUs of one instruction and P1 (e.g. one sign transaction command)
+ * @category Metrics
+ */
+export type ApduStats = {
+    ins: number
+    p1: number
+    count: number
+    /** APDUs answered by other status words than 0x9000 or failed by the transport */
+    errors: number
+    bytesOut: number
+    bytesIn: number
+    latencyNs: HistogramSummary
+}
+
+/**
+ * @category Metrics
+ */
+export type OperationStats = {
+    operation: OperationEvent["operation"]
+    count: number
+    errors: number
+    apduCount: number
+    bytesOut: number
+    bytesIn: number
+    latencyNs: HistogramSummary
+    /** Time waiting for the device per call */
+    deviceNs: HistogramSummary
+}
+
+/**
+ * @category Metrics
+ */
+export type MetricsSnapshot = {
+    apdus: Array<ApduStats>
+    operations: Array<OperationStats>
+}
+
+type ApduAggregate = Omit<ApduStats, "latencyNs"> & {latency: Histogram}
+type OperationAggregate = Omit<OperationStats, "latencyNs" | "deviceNs"> & {latency: Histogram, device: Histogram}
+
+/**
+ * [[FioObserver]] aggregating the APDUs by instruction and P1 and the calls by operation
+ * into latency histograms ([[Histogram]]), e.g. to be exported to a metrics system periodically.
+ *
+ * @example
+ * ```
+ * const metrics = new HistogramObserver()
+ * fio.setObserver(metrics)
+ * // later
+ * for (const {ins, p1, latencyNs} of metrics.snapshot().apdus) console.log(ins, p1, latencyNs.p99)
+ * ```
+ * @category Metrics
+ */
+export class HistogramObserver implements FioObserver {
+    private readonly significantDigits: number
+    private apdus = new Map<number, ApduAggregate>()
+    private operations = new Map<string, OperationAggregate>()
+
+    /**
+     * @param significantDigits precision of the histograms, see [[Histogram]]
+     */
+    constructor(significantDigits = 3) {
+        this.significantDigits = significantDigits
+    }
+
+    onApdu = (event: ApduEvent): void => {
+        const key = (event.ins << 8) | event.p1
+        let aggregate = this.apdus.get(key)
+        if (aggregate === undefined) {
+            aggregate = {
+                ins: event.ins, p1: event.p1, count: 0, errors: 0, bytesOut: 0, bytesIn: 0,
+                latency: new Histogram(this.significantDigits),
+            }
+            this.apdus.set(key, aggregate)
+        }
+        aggregate.count++
+        if (event.statusWord !== 0x9000) aggregate.errors++
+        aggregate.bytesOut += event.bytesOut
+        aggregate.bytesIn += event.bytesIn
+        aggregate.latency.record(event.durationNs)
+    }
+
+    onOperation = (event: OperationEvent): void => {
+        let aggregate = this.operations.get(event.operation)
+        if (aggregate === undefined) {
+            aggregate = {
+                operation: event.operation, count: 0, errors: 0, apduCount: 0, bytesOut: 0, bytesIn: 0,
+                latency: new Histogram(this.significantDigits), device: new Histogram(this.significantDigits),
+            }
+            this.operations.set(event.operation, aggregate)
+        }
+        aggregate.count++
+        if (event.error !== null) aggregate.errors++
+        aggregate.apduCount += event.apduCount
+        aggregate.bytesOut += event.bytesOut
+        aggregate.bytesIn += event.bytesIn
+        aggregate.latency.record(event.durationNs)
+        aggregate.device.record(event.deviceNs)
+    }
+
+    /**
+     * The statistics since the creation or the last [[reset]], the APDUs ordered by INS and P1
+     */
+    snapshot(): MetricsSnapshot {
+        return {
+            apdus: [...this.apdus.entries()]
+                .sort(([a], [b]) => a - b)
+                .map(([, {latency, ...stats}]) => ({...stats, latencyNs: latency.summary()})),
+            operations: [...this.operations.values()]
+                .map(({latency, device, ...stats}) => ({...stats, latencyNs: latency.summary(), deviceNs: device.summary()})),
+        }
+    }
+
+    reset(): void {
+        this.apdus = new Map()
+        this.operations = new Map()
+    }
+}
@@ -0,0 +1,5 @@
+export type {HistogramSummary} from './histogram'
+export {Histogram} from './histogram'
+export type {ApduStats, MetricsSnapshot, OperationStats} from './histogramObserver'
+export {HistogramObserver} from './histogramObserver'
+export type {ApduEvent, FioObserver, OperationEvent} from './observer'
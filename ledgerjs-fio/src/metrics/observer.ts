@@ -0,0 +1,73 @@
+/**
+ * One APDU exchanged by [[Fio]], see [[FioObserver.onApdu]]
+ * @category Metrics
+ */
+export type ApduEvent = {
+    ins: number
+    p1: number
+    p2: number
+    /** Size of the APDU including the 5 byte header */
+    bytesOut: number
+    /** Size of the response including the status word, 0 if the transport failed */
+    bytesIn: number
+    /** Time from sending the APDU to the response */
+    durationNs: number
+    /** 0x9000 on success, null if the transport failed without a status word */
+    statusWord: number | null
+}
+
+/**
+ * One call of [[Fio.signTransaction]] or [[Fio.decodeMessage]], see [[FioObserver.onOperation]]
+ * @category Metrics
+ */
+export type OperationEvent = {
+    operation: "signTransaction" | "decodeMessage"
+    /** Time of the whole call, including the validation and encoding on the host */
+    durationNs: number
+    /** Time spent waiting for the device responses, the rest is spent on the host */
+    deviceNs: number
+    apduCount: number
+    bytesOut: number
+    bytesIn: number
+    /** The error the call failed with, null on success */
+    error: unknown
+}
+
+/**
+ * Receives the timings of the device calls of a [[Fio]] instance, see [[Fio.setObserver]].
+ * The callbacks run synchronously between the APDUs and must not throw.
+ * @category Metrics
+ */
+export type FioObserver = {
+    onApdu?: (event: ApduEvent) => void
+    onOperation?: (event: OperationEvent) => void
+}
+
+type Clock = () => () => number
+
+function selectClock(): Clock {
+    if (typeof process !== "undefined" && typeof process.hrtime?.bigint === "function") {
+        return () => {
+            const start = process.hrtime.bigint()
+            return () => Number(process.hrtime.bigint() - start)
+        }
+    }
+    const performance = (globalThis as {performance?: {now: () => number}}).performance
+    if (performance !== undefined) {
+        return () => {
+            const start = performance.now()
+            return () => Math.round((performance.now() - start) * 1e6)
+        }
+    }
+    return () => {
+        const start = Date.now()
+        return () => (Date.now() - start) * 1e6
+    }
+}
+
+/**
+ * Starts a monotonic timer, the returned function returns the nanoseconds elapsed since.
+ * process.hrtime in node, performance.now() in browsers.
+ * @ignore
+ */
+export const startTimer: Clock = selectClock()
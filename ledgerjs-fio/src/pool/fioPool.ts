@@ -0,0 +1,373 @@
+import {DeviceStatusError, ErrorBase, InvalidDataReason, NoDeviceAvailable} from "../errors"
+import {isAppStatusError} from "../errors/deviceStatusError"
+import type {
+    DecodeMessageRequest, DecodeMessageResponse, Fio, GetPublicKeyRequest, GetPublicKeyResponse,
+    SignTransactionRequest, SignTransactionResponse,
+} from "../fio"
+import type {BIP32Path} from "../types/public"
+import {assert} from "../utils/assert"
+import {parseBIP32Path} from "../utils/parse"
+
+/**
+ * The device a request has to run on
+ * @category Pool
+ */
+export type PoolTarget = {
+    /** Serial of the device, as in [[Serial]] */
+    serial?: string
+    /**
+     * Public key (raw hex, as in [[GetPublicKeyResponse]]) the device derives at the path of the request,
+     * i.e. the device holds the seed of the key
+     */
+    publicKeyHex?: string
+}
+
+/**
+ * @category Pool
+ */
+export type PoolRetryPolicy = {
+    /** Attempts of a request including the first one, 3 by default */
+    maxAttempts?: number
+    /**
+     * Errors after which the request is retried on any device able to serve it, [[isDeviceFailure]] by default.
+     * Only the requests with [[PoolRequestOptions.retry]] are retried.
+     */
+    isRetryable?: (error: unknown) => boolean
+}
+
+/**
+ * @category Pool
+ */
+export type FioPoolOptions = {
+    retry?: PoolRetryPolicy
+    /** A device failing this many times in a row ([[isDeviceFailure]]) is evicted, 3 by default */
+    maxConsecutiveFailures?: number
+}
+
+/**
+ * @category Pool
+ */
+export type PoolRequestOptions = {
+    target?: PoolTarget
+    /** Path of the key of [[PoolTarget.publicKeyHex]], required if it is given */
+    path?: BIP32Path
+    /**
+     * Retry the request after a failure according to the [[PoolRetryPolicy]]. True by default,
+     * except for [[FioPool.signTransaction]] and [[FioPool.decodeMessage]]: the user may have
+     * confirmed them on the failed device already, a retry would ask for a second confirmation
+     * on another one.
+     */
+    retry?: boolean
+}
+
+/**
+ * @category Pool
+ */
+export type PoolDeviceStats = {
+    /** Index of the device in the pool */
+    id: number
+    /** Serial of the device, null until it is needed for routing or a health check */
+    serial: string | null
+    busy: boolean
+    /** Evicted devices get no requests until [[FioPool.checkHealth]] readmits them */
+    evicted: boolean
+    /** Requests finished on the device, including the failed ones */
+    completed: number
+    failed: number
+    consecutiveFailures: number
+}
+
+/**
+ * @category Pool
+ */
+export type PoolStats = {
+    /** Requests waiting for a device */
+    queueDepth: number
+    /** Finished requests, including the failed ones */
+    completed: number
+    failed: number
+    /** Attempts which failed and were retried */
+    retried: number
+    devices: Array<PoolDeviceStats>
+}
+
+/**
+ * True if the error means that the device rather than the request failed: the transport failed,
+ * the device responded with a status which is not one of the FIO app (e.g. the app was closed)
+ * or the app was still in a previous call.
+ * @category Pool
+ */
+export function isDeviceFailure(error: unknown): boolean {
+    if (error instanceof DeviceStatusError) return !isAppStatusError(error)
+    return !(error instanceof ErrorBase)
+}
+
+type Job = {
+    operation: (fio: Fio) => Promise<unknown>
+    target: PoolTarget
+    // path.join("/") of the key of target.publicKeyHex
+    pathKey: string | null
+    path: BIP32Path | null
+    retry: boolean
+    attempts: number
+    resolve: (value: unknown) => void
+    reject: (reason: unknown) => void
+}
+
+type PoolDevice = {
+    id: number
+    fio: Fio
+    // undefined until requested, null if the device did not provide it
+    serial: string | null | undefined
+    // public keys by path, null if the device did not export the key without a prompt
+    publicKeys: Map<string, string | null>
+    busy: boolean
+    evicted: boolean
+    completed: number
+    failed: number
+    consecutiveFailures: number
+}
+
+const enum Match {
+    YES,
+    NO,
+    // the device has to be asked for its serial or public key first
+    PROBE,
+}
+
+/**
+ * Runs requests on a set of devices, each request on an idle device able to serve it,
+ * so that the throughput grows with the number of devices.
+ *
+ * A request may require a device by its serial or by a public key it derives
+ * ([[PoolTarget]]). The serials and public keys of the devices are requested
+ * (without showing them) when first needed and cached. A request which no device can serve
+ * fails with [[NoDeviceAvailable]].
+ *
+ * A failed request is retried according to [[PoolRetryPolicy]], by default if the device rather than
+ * the request failed ([[isDeviceFailure]]). Signing and decoding are retried only if the request
+ * asks for it ([[PoolRequestOptions.retry]]). A device failing [[FioPoolOptions.maxConsecutiveFailures]]
+ * times in a row is evicted, [[checkHealth]] pings the devices and readmits the evicted ones which respond.
+ *
+ * @example
+ * ```
+ * const pool = new FioPool(transports.map((transport) => new Fio(transport)))
+ * const signed = await pool.signTransaction({path, chainId, tx}, {publicKeyHex})
+ * ```
+ * @category Pool
+ */
+export class FioPool {
+    private readonly devices: Array<PoolDevice> = []
+    private readonly queue: Array<Job> = []
+    private readonly maxAttempts: number
+    private readonly isRetryable: (error: unknown) => boolean
+    private readonly maxConsecutiveFailures: number
+    private completed = 0
+    private failed = 0
+    private retried = 0
+
+    constructor(devices: Array<Fio>, options: FioPoolOptions = {}) {
+        this.maxAttempts = options.retry?.maxAttempts ?? 3
+        this.isRetryable = options.retry?.isRetryable ?? isDeviceFailure
+        this.maxConsecutiveFailures = options.maxConsecutiveFailures ?? 3
+        for (const fio of devices) {
+            this.add(fio)
+        }
+    }
+
+    /**
+     * Adds a device to the pool, returns its id
+     */
+    add(fio: Fio): number {
+        const id = this.devices.length
+        this.devices.push({
+            id, fio, serial: undefined, publicKeys: new Map(), busy: false, evicted: false,
+            completed: 0, failed: 0, consecutiveFailures: 0,
+        })
+        this.dispatch()
+        return id
+    }
+
+    /**
+     * Runs the operation on an idle device able to serve the target. All the device calls
+     * of the operation run on the same device, an attempt which is retried runs whole again.
+     */
+    run<T>(operation: (fio: Fio) => Promise<T>, options: PoolRequestOptions = {}): Promise<T> {
+        const target = options.target ?? {}
+        const path = options.path ?? null
+        return new Promise<T>((resolve, reject) => {
+            if (target.publicKeyHex !== undefined) {
+                assert(path !== null, "path of the public key is required")
+                parseBIP32Path(path, InvalidDataReason.INVALID_PATH)
+            }
+            this.queue.push({
+                operation,
+                target,
+                path,
+                pathKey: path !== null ? path.join("/") : null,
+                retry: options.retry ?? true,
+                attempts: 0,
+                resolve: resolve as (value: unknown) => void,
+                reject,
+            })
+            this.dispatch()
+        })
+    }
+
+    getPublicKey(request: GetPublicKeyRequest, target?: PoolTarget): Promise<GetPublicKeyResponse> {
+        return this.run((fio) => fio.getPublicKey(request), {target, path: request.path})
+    }
+
+    signTransaction(request: SignTransactionRequest, target?: PoolTarget, retry = false): Promise<SignTransactionResponse> {
+        return this.run((fio) => fio.signTransaction(request), {target, path: request.path, retry})
+    }
+
+    decodeMessage(request: DecodeMessageRequest, target?: PoolTarget, retry = false): Promise<DecodeMessageResponse> {
+        return this.run((fio) => fio.decodeMessage(request), {target, path: request.path, retry})
+    }
+
+    /**
+     * Pings every idle device, including the evicted ones, by requesting its app info again.
+     * A device which fails counts the failure as a failed request would, an evicted device
+     * which responds is readmitted. Busy devices are skipped, their requests tell their health.
+     */
+    async checkHealth(): Promise<Array<PoolDeviceStats>> {
+        const idle = this.devices.filter((device) => !device.busy)
+        await Promise.all(idle.map((device) => this.runOnDevice(device, async () => {
+            const {serial} = await device.fio.getAppInfo({refresh: true})
+            if (serial !== null && serial !== device.serial) {
+                if (typeof device.serial === "string") {
+                    // another device on the same transport
+                    device.publicKeys.clear()
+                }
+                device.serial = serial
+            }
+            device.evicted = false
+        }, null)))
+        return this.stats().devices
+    }
+
+    stats(): PoolStats {
+        return {
+            queueDepth: this.queue.length,
+            completed: this.completed,
+            failed: this.failed,
+            retried: this.retried,
+            devices: this.devices.map(({id, serial, busy, evicted, completed, failed, consecutiveFailures}) => ({
+                id, serial: serial ?? null, busy, evicted, completed, failed, consecutiveFailures,
+            })),
+        }
+    }
+
+    private match(device: PoolDevice, job: Job): Match {
+        const {serial, publicKeyHex} = job.target
+        if (serial !== undefined) {
+            if (device.serial === undefined) return Match.PROBE
+            if (device.serial !== serial) return Match.NO
+        }
+        if (publicKeyHex !== undefined && job.pathKey !== null) {
+            const publicKey = device.publicKeys.get(job.pathKey)
+            if (publicKey === undefined) return Match.PROBE
+            if (publicKey !== publicKeyHex) return Match.NO
+        }
+        return Match.YES
+    }
+
+    // Requests what the device has to be matched by. If the device refuses (e.g. the key is rejected
+    // by the security policy without a prompt), it does not match.
+    private async probe(device: PoolDevice, job: Job): Promise<void> {
+        if (job.target.serial !== undefined && device.serial === undefined) {
+            try {
+                device.serial = (await device.fio.getSerial()).serial
+            } catch (e) {
+                if (isDeviceFailure(e)) throw e
+                device.serial = null
+            }
+        }
+        if (job.target.publicKeyHex !== undefined && job.path !== null && job.pathKey !== null &&
+            !device.publicKeys.has(job.pathKey)) {
+            try {
+                const {publicKeyHex} = await device.fio.getPublicKey({path: job.path, show_or_not: false})
+                device.publicKeys.set(job.pathKey, publicKeyHex)
+            } catch (e) {
+                if (isDeviceFailure(e)) throw e
+                device.publicKeys.set(job.pathKey, null)
+            }
+        }
+    }
+
+    // Starts a job or a probe on every idle device which can take one
+    private dispatch(): void {
+        for (const device of this.devices) {
+            if (device.busy || device.evicted) continue
+            for (let i = 0; i < this.queue.length; i++) {
+                const job = this.queue[i]
+                const match = this.match(device, job)
+                if (match === Match.NO) continue
+                if (match === Match.PROBE) {
+                    this.runOnDevice(device, () => this.probe(device, job), null)
+                } else {
+                    this.queue.splice(i, 1)
+                    job.attempts++
+                    this.runOnDevice(device, () => job.operation(device.fio), job)
+                }
+                break
+            }
+        }
+        this.rejectUnservable()
+    }
+
+    private rejectUnservable(): void {
+        const available = this.devices.filter((device) => !device.evicted)
+        for (let i = 0; i < this.queue.length; i++) {
+            const job = this.queue[i]
+            if (available.some((device) => this.match(device, job) !== Match.NO)) continue
+            this.queue.splice(i--, 1)
+            this.completed++
+            this.failed++
+            job.reject(new NoDeviceAvailable(available.length === 0
+                ? "all devices of the pool are evicted"
+                : `no device of the pool matches ${JSON.stringify(job.target)}`))
+        }
+    }
+
+    private runOnDevice(device: PoolDevice, work: () => Promise<unknown>, job: Job | null): Promise<void> {
+        device.busy = true
+        return Promise.resolve().then(work).then(
+            (value) => {
+                device.busy = false
+                device.consecutiveFailures = 0
+                if (job !== null) {
+                    device.completed++
+                    this.completed++
+                    job.resolve(value)
+                }
+                this.dispatch()
+            },
+            (error) => {
+                device.busy = false
+                if (isDeviceFailure(error)) {
+                    device.consecutiveFailures++
+                    if (device.consecutiveFailures >= this.maxConsecutiveFailures) {
+                        device.evicted = true
+                    }
+                } else {
+                    device.consecutiveFailures = 0
+                }
+                if (job !== null) {
+                    device.completed++
+                    device.failed++
+                    if (job.retry && job.attempts < this.maxAttempts && this.isRetryable(error)) {
+                        this.retried++
+                        this.queue.unshift(job)
+                    } else {
+                        this.completed++
+                        this.failed++
+                        job.reject(error)
+                    }
+                }
+                this.dispatch()
+            },
+        )
+    }
+}
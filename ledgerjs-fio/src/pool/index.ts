@@ -0,0 +1,2 @@
+export type {FioPoolOptions, PoolDeviceStats, PoolRequestOptions, PoolRetryPolicy, PoolStats, PoolTarget} from './fioPool'
+export {FioPool, isDeviceFailure} from './fioPool'
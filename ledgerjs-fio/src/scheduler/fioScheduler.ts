@@ -0,0 +1,243 @@
+import type {
+    DecodeMessageRequest, DecodeMessageResponse, Fio, GetPublicKeyRequest, GetPublicKeyResponse,
+    GetSerialResponse, GetVersionResponse, SignTransactionRequest, SignTransactionResponse,
+} from "../fio"
+import type {AppInfo} from "../types/public"
+import {assert} from "../utils/assert"
+
+/**
+ * Priorities of the scheduled operations, lower values run first
+ * @category Scheduler
+ */
+export const SchedulerPriority = {
+    /** Calls a user is waiting for, the default for getVersion, getSerial, getAppInfo and getPublicKey */
+    INTERACTIVE: 0,
+    /** The default for signTransaction and decodeMessage */
+    NORMAL: 1,
+    /** Background work which runs only if nothing else is waiting */
+    BULK: 2,
+}
+
+/**
+ * @category Scheduler
+ */
+export type ScheduleOptions = {
+    /**
+     * Callers of the same priority take turns, one operation each,
+     * so that a caller with a long queue does not delay the others. "default" if not given.
+     */
+    caller?: string
+    /** See [[SchedulerPriority]] */
+    priority?: number
+}
+
+/**
+ * @category Scheduler
+ */
+export type SchedulerStats = {
+    /** Operations waiting to run */
+    queueDepth: number
+    /** Waiting operations by priority */
+    queueDepthByPriority: Record<number, number>
+    /** True if an operation is running on the device */
+    running: boolean
+    /** Finished operations, including the failed ones */
+    completed: number
+    failed: number
+    /** Time from scheduling to the start of the operation, of the started operations */
+    waitTimeMs: {mean: number, max: number}
+    /** Time the device was running operations */
+    busyTimeMs: number
+    /** Time since the scheduler was created */
+    uptimeMs: number
+}
+
+type Job = {
+    operation: () => Promise<unknown>
+    resolve: (value: unknown) => void
+    reject: (reason: unknown) => void
+    scheduledAt: number
+}
+
+type CallerQueue = {
+    caller: string
+    jobs: Array<Job>
+}
+
+// Queues of one priority, the callers with waiting jobs are in turns in the order they take turns
+type PriorityLevel = {
+    priority: number
+    queues: Map<string, CallerQueue>
+    turns: Array<CallerQueue>
+}
+
+/**
+ * Queues operations on a [[Fio]] instance shared by many asynchronous callers and runs them
+ * one at a time, so the APDU sequences of different calls never interleave. `Fio` itself
+ * rejects a call made while another one is running.
+ *
+ * The next operation starts as soon as the previous one finishes: the one with the highest
+ * priority (lowest [[SchedulerPriority]] value), among callers of the same priority the
+ * callers take turns.
+ *
+ * @example
+ * ```
+ * const scheduler = new FioScheduler(new Fio(transport))
+ * // from any number of producers
+ * const signed = await scheduler.signTransaction({path, chainId, tx}, {caller: "payouts", priority: SchedulerPriority.BULK})
+ * ```
+ * @category Scheduler
+ */
+export class FioScheduler {
+    readonly fio: Fio
+    // by priority, ascending
+    private levels: Array<PriorityLevel> = []
+    private queueDepth = 0
+    private running = false
+    private completed = 0
+    private failed = 0
+    private started = 0
+    private totalWaitMs = 0
+    private maxWaitMs = 0
+    private busyTimeMs = 0
+    private readonly createdAt = Date.now()
+
+    constructor(fio: Fio) {
+        this.fio = fio
+    }
+
+    /**
+     * Runs the operation when it is its turn. All the device calls of the operation run
+     * without calls of other operations in between.
+     */
+    schedule<T>(operation: (fio: Fio) => Promise<T>, options: ScheduleOptions = {}): Promise<T> {
+        const caller = options.caller ?? "default"
+        const priority = options.priority ?? SchedulerPriority.NORMAL
+        return new Promise<T>((resolve, reject) => {
+            const level = this.level(priority)
+            let queue = level.queues.get(caller)
+            if (queue === undefined) {
+                queue = {caller, jobs: []}
+                level.queues.set(caller, queue)
+                level.turns.push(queue)
+            }
+            queue.jobs.push({
+                operation: () => operation(this.fio),
+                resolve: resolve as (value: unknown) => void,
+                reject,
+                scheduledAt: Date.now(),
+            })
+            this.queueDepth++
+            this.runNext()
+        })
+    }
+
+    getVersion(options?: ScheduleOptions): Promise<GetVersionResponse> {
+        return this.schedule((fio) => fio.getVersion(), {priority: SchedulerPriority.INTERACTIVE, ...options})
+    }
+
+    getSerial(options?: ScheduleOptions): Promise<GetSerialResponse> {
+        return this.schedule((fio) => fio.getSerial(), {priority: SchedulerPriority.INTERACTIVE, ...options})
+    }
+
+    getAppInfo(options?: ScheduleOptions): Promise<AppInfo> {
+        return this.schedule((fio) => fio.getAppInfo(), {priority: SchedulerPriority.INTERACTIVE, ...options})
+    }
+
+    getPublicKey(request: GetPublicKeyRequest, options?: ScheduleOptions): Promise<GetPublicKeyResponse> {
+        return this.schedule((fio) => fio.getPublicKey(request), {priority: SchedulerPriority.INTERACTIVE, ...options})
+    }
+
+    signTransaction(request: SignTransactionRequest, options?: ScheduleOptions): Promise<SignTransactionResponse> {
+        return this.schedule((fio) => fio.signTransaction(request), options)
+    }
+
+    decodeMessage(request: DecodeMessageRequest, options?: ScheduleOptions): Promise<DecodeMessageResponse> {
+        return this.schedule((fio) => fio.decodeMessage(request), options)
+    }
+
+    stats(): SchedulerStats {
+        const queueDepthByPriority: Record<number, number> = {}
+        for (const level of this.levels) {
+            let depth = 0
+            for (const queue of level.turns) depth += queue.jobs.length
+            queueDepthByPriority[level.priority] = depth
+        }
+        return {
+            queueDepth: this.queueDepth,
+            queueDepthByPriority,
+            running: this.running,
+            completed: this.completed,
+            failed: this.failed,
+            waitTimeMs: {
+                mean: this.started > 0 ? this.totalWaitMs / this.started : 0,
+                max: this.maxWaitMs,
+            },
+            busyTimeMs: this.busyTimeMs,
+            uptimeMs: Date.now() - this.createdAt,
+        }
+    }
+
+    private level(priority: number): PriorityLevel {
+        let level = this.levels.find((l) => l.priority === priority)
+        if (level === undefined) {
+            level = {priority, queues: new Map(), turns: []}
+            this.levels = [...this.levels, level].sort((a, b) => a.priority - b.priority)
+        }
+        return level
+    }
+
+    private dequeue(): Job | null {
+        for (const level of this.levels) {
+            const queue = level.turns.shift()
+            if (queue === undefined) continue
+            const job = queue.jobs.shift()
+            assert(job !== undefined, "empty caller queue")
+            if (queue.jobs.length > 0) {
+                level.turns.push(queue)
+            } else {
+                level.queues.delete(queue.caller)
+            }
+            this.queueDepth--
+            return job
+        }
+        return null
+    }
+
+    private runNext(): void {
+        if (this.running) return
+        const job = this.dequeue()
+        if (job === null) return
+
+        this.running = true
+        const start = Date.now()
+        const waitMs = start - job.scheduledAt
+        this.started++
+        this.totalWaitMs += waitMs
+        this.maxWaitMs = Math.max(this.maxWaitMs, waitMs)
+
+        const finish = (failed: boolean) => {
+            this.busyTimeMs += Date.now() - start
+            this.completed++
+            if (failed) this.failed++
+            this.running = false
+            this.runNext()
+        }
+        let promise: Promise<unknown>
+        try {
+            promise = job.operation()
+        } catch (e) {
+            promise = Promise.reject(e)
+        }
+        promise.then(
+            (value) => {
+                finish(false)
+                job.resolve(value)
+            },
+            (reason) => {
+                finish(true)
+                job.reject(reason)
+            },
+        )
+    }
+}
@@ -0,0 +1,2 @@
+export type {ScheduleOptions, SchedulerStats} from './fioScheduler'
+export {FioScheduler, SchedulerPriority} from './fioScheduler'
@@ -0,0 +1 @@
+export {recoverSigner, verifySigner} from './recoverSigner'
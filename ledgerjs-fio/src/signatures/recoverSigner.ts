@@ -0,0 +1,50 @@
+import {InvalidDataReason} from "../errors"
+import type {GetPublicKeyResponse, SignTransactionResponse} from "../fio"
+import {parseHexStringOfLength, validate} from "../utils/parse"
+import {publicKeyToWIF, recoverPublicKey} from "../utils/secp256k1"
+
+/**
+ * Recovers the public key which made a signature returned by [[Fio.signTransaction]]
+ * (`witness.witnessSignatureHex`) from the signed hash (`txHashHex`), on the host.
+ * It replaces a [[Fio.getPublicKey]] call to learn the signer, and the signature is valid
+ * if and only if the recovered key is the expected one, see [[verifySigner]].
+ *
+ * @returns The public key in the same format as [[Fio.getPublicKey]]
+ * @throws [[InvalidData]] if the hash or the signature is malformed
+ *
+ * @example
+ * ```
+ * const {txHashHex, witness} = await fio.signTransaction({path, chainId, tx})
+ * const {publicKeyWIF} = recoverSigner(txHashHex, witness.witnessSignatureHex)
+ * ```
+ * @category Signatures
+ */
+export function recoverSigner(txHashHex: string, signatureHex: string): GetPublicKeyResponse {
+    const hash = parseHexStringOfLength(txHashHex, 32, InvalidDataReason.INVALID_HASH)
+    const signature = parseHexStringOfLength(signatureHex, 65, InvalidDataReason.INVALID_SIGNATURE)
+    const publicKey = recoverPublicKey(Buffer.from(hash, "hex"), Buffer.from(signature, "hex"))
+    validate(publicKey !== null, InvalidDataReason.INVALID_SIGNATURE)
+    return {
+        publicKeyHex: publicKey.toString("hex"),
+        publicKeyWIF: publicKeyToWIF(publicKey),
+    }
+}
+
+/**
+ * Checks on the host that the transaction was signed by the public key
+ * (raw hex as [[GetPublicKeyResponse.publicKeyHex]] or the FIO public key
+ * as [[GetPublicKeyResponse.publicKeyWIF]]).
+ *
+ * Note that the hash is the one returned by the device, callers should also check that it is
+ * the hash of their serialization of the transaction.
+ * @category Signatures
+ */
+export function verifySigner({txHashHex, witness}: SignTransactionResponse, publicKey: string): boolean {
+    let signer: GetPublicKeyResponse
+    try {
+        signer = recoverSigner(txHashHex, witness.witnessSignatureHex)
+    } catch (e) {
+        return false
+    }
+    return publicKey === signer.publicKeyWIF || publicKey.toLowerCase() === signer.publicKeyHex
+}
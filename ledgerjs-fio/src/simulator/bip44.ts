@@ -0,0 +1,38 @@
+// BIP44 paths of the simulator, the same parsing and checks as src/bip44.c
+
+import {DeviceStatusCodes} from "../errors"
+import {HARDENED} from "../types/public"
+import {validate} from "./common"
+
+const BIP44_MAX_PATH_ELEMENTS = 10
+const PURPOSE_FIO = 44
+const COIN_TYPE_FIO = 235
+const MAX_REASONABLE_ADDRESS = 1000
+
+// Path elements are little endian on the wire, returns the path and the number of bytes read
+export function parsePathFromWire(data: Buffer): [Array<number>, number] {
+    validate(data.length >= 1, DeviceStatusCodes.ERR_INVALID_DATA)
+    const length = data[0]
+    validate(length <= BIP44_MAX_PATH_ELEMENTS, DeviceStatusCodes.ERR_INVALID_DATA)
+    validate(length * 4 + 1 <= data.length, DeviceStatusCodes.ERR_INVALID_DATA)
+    const path = [...Array(length).keys()].map((i) => data.readUInt32LE(1 + 4 * i))
+    return [path, 1 + 4 * length]
+}
+
+// FIO: /44'/235'/0'/0
+export const hasValidFIOPrefix = (path: Array<number>): boolean =>
+    path.length > 1 &&
+    path[0] === PURPOSE_FIO + HARDENED &&
+    path[1] === COIN_TYPE_FIO + HARDENED &&
+    (path[2] ?? 0) === HARDENED &&
+    (path[3] ?? 0) === 0
+
+export const containsAddress = (path: Array<number>): boolean => path.length > 4
+
+export const containsMoreThanAddress = (path: Array<number>): boolean => path.length > 5
+
+export const hasReasonableAddress = (path: Array<number>): boolean =>
+    containsAddress(path) && path[4] <= MAX_REASONABLE_ADDRESS
+
+export const pathToString = (path: Array<number>): string =>
+    "m" + path.map((value) => value >= HARDENED ? `/${value - HARDENED}'` : `/${value}`).join("")
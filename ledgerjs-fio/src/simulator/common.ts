@@ -0,0 +1,31 @@
+import {DeviceStatusError} from "../errors"
+
+// VALIDATE() of the app: the simulated call fails with the status code
+export function validate(cond: boolean, code: number): asserts cond {
+    if (!cond) throw new DeviceStatusError(code)
+}
+
+// Internal error of the app, the device does not respond to it
+export const ERR_NOT_IMPLEMENTED = 0x4701
+
+// What the instruction handlers need from the simulated device
+export type SimulatorEnvironment = {
+    // private key and uncompressed public key of the path
+    deriveKey: (path: Array<number>) => {privateKey: Buffer, publicKey: Buffer}
+    isAllowedHash: (integrityHash: string) => boolean
+    randomBytes: (size: number) => Buffer
+    // a screen the user scrolls through
+    display: (header: string, body: string) => void
+    // a screen the user confirms, throws ERR_REJECTED_BY_USER if rejected
+    prompt: (header: string, body: string) => void
+}
+
+export const MAX_DISPLAY_KEY_LENGTH = 20
+export const MAX_DISPLAY_VALUE_LENGTH = 220
+export const MAX_TX_APPEND_IN_SINGLE_APDU = 220
+
+// check if it is ASCII between 32 and 126
+export function validateText(text: Buffer, code: number): string {
+    validate(text.every((c) => c >= 32 && c <= 126), code)
+    return text.toString("ascii")
+}
@@ -0,0 +1,238 @@
+// The simulated FIO app: APDU dispatching of src/handlers.c and src/main.c and the
+// instructions which do not need a real device. The sign transaction call is in signTransaction.ts.
+
+import * as crypto from "crypto"
+
+import {DeviceStatusCodes, DeviceStatusError} from "../errors"
+import type {Version} from "../types/public"
+import {ALLOWED_HASHES, ALLOWED_HASHES_DEVEL} from "../interactions/transactionTemplates/allowedHashes"
+import {parsePathFromWire, pathToString} from "./bip44"
+import type {SimulatorEnvironment} from "./common"
+import {validate} from "./common"
+import {derivePrivateKey, getPublicKey, mnemonicToSeed, publicKeyToWIF} from "./secp256k1"
+import {policyForGetPublicKey, SecurityPolicy} from "./securityPolicy"
+import type {HandlerResponse} from "./signTransaction"
+import {SIGN_TX_COMMANDS, SignTransactionContext} from "./signTransaction"
+
+const {
+    ERR_MALFORMED_REQUEST_HEADER, ERR_BAD_CLA, ERR_UNKNOWN_INS, ERR_STILL_IN_CALL, ERR_INVALID_REQUEST_PARAMETERS,
+    ERR_INVALID_STATE, ERR_INVALID_DATA, ERR_REJECTED_BY_USER, ERR_REJECTED_BY_POLICY,
+} = DeviceStatusCodes
+
+const CLA = 0xd7
+const SUCCESS = 0x9000
+// errors the app responds with, any other error means the app crashed
+const ERR_AUTORESPOND_START = 0x6e00
+const ERR_AUTORESPOND_END = 0x6e13
+
+const enum INS {
+    GET_VERSION = 0x00,
+    GET_SERIAL = 0x01,
+    GET_APP_INFO = 0x02,
+    GET_EXT_PUBLIC_KEY = 0x10,
+    SIGN_TX = 0x20,
+}
+
+/**
+ * Mnemonic of the seed used by the integration tests (speculos `--seed`)
+ * @category Simulator
+ */
+export const TEST_MNEMONIC = "abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about"
+
+/**
+ * A screen shown by the simulated device
+ * @category Simulator
+ */
+export type SimulatorScreen = {
+    header: string
+    body: string
+    /** True if the user has to confirm or reject the screen */
+    prompt: boolean
+}
+
+/**
+ * @category Simulator
+ */
+export type SimulatorOptions = {
+    /** Mnemonic of the device seed, [[TEST_MNEMONIC]] by default */
+    mnemonic?: string
+    /**
+     * Reported app version, 1.0.8 by default. A debug version also accepts the integrity
+     * hashes of the development build ([[ALLOWED_HASHES_DEVEL]]), as the app built with DEVEL.
+     */
+    version?: Version
+    /** Integrity hashes of the accepted command sequences, `"any"` accepts every sequence */
+    allowedHashes?: ReadonlyArray<string> | "any"
+    /** Device serial, 7 bytes */
+    serial?: Buffer
+    /** Source of the DH initialization vectors, random by default (e.g. fixed for reproducible output) */
+    randomBytes?: (size: number) => Buffer
+    /** Called for every screen shown, e.g. to record what the user would review */
+    onScreen?: (screen: SimulatorScreen) => void
+    /** Answers the prompts, everything is approved by default */
+    approve?: (screen: SimulatorScreen) => boolean
+}
+
+/**
+ * In-process simulation of the FIO app. It checks the APDUs the same way as the app and
+ * answers them with the same responses and status codes, without any device or emulator.
+ * Screens are passed to [[SimulatorOptions.onScreen]] and prompts answered by
+ * [[SimulatorOptions.approve]].
+ *
+ * Supported instructions: GET_VERSION, GET_SERIAL, GET_APP_INFO, GET_EXT_PUBLIC_KEY and SIGN_TX,
+ * other instructions are answered with ERR_UNKNOWN_INS.
+ * @category Simulator
+ */
+export class SimulatedDevice {
+    private readonly options: SimulatorOptions
+    private readonly version: Version
+    private readonly seed: Buffer
+    private readonly allowedHashes: Set<string> | null
+    private readonly keys = new Map<string, {privateKey: Buffer, publicKey: Buffer}>()
+    private readonly env: SimulatorEnvironment
+    private currentInstruction: number | null = null
+    private signTransactionContext: SignTransactionContext | null = null
+
+    constructor(options: SimulatorOptions = {}) {
+        this.options = options
+        this.version = options.version ?? {major: 1, minor: 0, patch: 8, flags: {isDebug: false}}
+        this.seed = mnemonicToSeed(options.mnemonic ?? TEST_MNEMONIC)
+        const allowedHashes = options.allowedHashes ??
+            (this.version.flags.isDebug ? [...ALLOWED_HASHES_DEVEL, ...ALLOWED_HASHES] : ALLOWED_HASHES)
+        this.allowedHashes = allowedHashes === "any" ? null : new Set(allowedHashes)
+        this.env = {
+            deriveKey: (path) => this.deriveKey(path),
+            isAllowedHash: (hash) => this.allowedHashes === null || this.allowedHashes.has(hash),
+            randomBytes: options.randomBytes ?? crypto.randomBytes,
+            display: (header, body) => this.show({header, body, prompt: false}),
+            prompt: (header, body) => this.show({header, body, prompt: true}),
+        }
+    }
+
+    private show(screen: SimulatorScreen): void {
+        this.options.onScreen?.(screen)
+        if (screen.prompt && this.options.approve) {
+            validate(this.options.approve(screen), ERR_REJECTED_BY_USER)
+        }
+    }
+
+    // BIP32 derivation is slow, the keys are derived once per path
+    private deriveKey(path: Array<number>): {privateKey: Buffer, publicKey: Buffer} {
+        const id = path.join("/")
+        let key = this.keys.get(id)
+        if (key === undefined) {
+            const privateKey = derivePrivateKey(this.seed, path)
+            key = {privateKey, publicKey: getPublicKey(privateKey)}
+            this.keys.set(id, key)
+        }
+        return key
+    }
+
+    /**
+     * Processes one APDU, returns the response with the status word
+     */
+    exchange(apdu: Buffer): Buffer {
+        try {
+            const data = this.dispatchAPDU(apdu)
+            return Buffer.concat([data, Buffer.from([SUCCESS >> 8, SUCCESS & 0xff])])
+        } catch (e) {
+            this.currentInstruction = null
+            if (e instanceof DeviceStatusError && e.code >= ERR_AUTORESPOND_START && e.code < ERR_AUTORESPOND_END) {
+                return Buffer.from([e.code >> 8, e.code & 0xff])
+            }
+            throw e
+        }
+    }
+
+    private dispatchAPDU(apdu: Buffer): Buffer {
+        validate(apdu.length >= 5, ERR_MALFORMED_REQUEST_HEADER)
+        const [cla, ins, p1, p2, lc] = apdu
+        validate(apdu.length === 5 + lc, ERR_MALFORMED_REQUEST_HEADER)
+        validate(cla === CLA, ERR_BAD_CLA)
+        const handler = this.lookupHandler(ins)
+        validate(handler !== null, ERR_UNKNOWN_INS)
+
+        let isNewCall = false
+        if (this.currentInstruction === null) {
+            isNewCall = true
+            this.currentInstruction = ins
+        } else {
+            validate(ins === this.currentInstruction, ERR_STILL_IN_CALL)
+        }
+
+        const response = handler(p1, p2, apdu.slice(5), isNewCall)
+        if (response.done) {
+            this.currentInstruction = null
+        }
+        return response.data
+    }
+
+    private lookupHandler(ins: number): ((p1: number, p2: number, data: Buffer, isNewCall: boolean) => HandlerResponse) | null {
+        switch (ins) {
+        case INS.GET_VERSION: return (p1, p2, data) => this.getVersion(p1, p2, data)
+        case INS.GET_SERIAL: return (p1, p2, data) => this.getSerial(p1, p2, data)
+        case INS.GET_APP_INFO: return (p1, p2, data) => this.getAppInfo(p1, p2, data)
+        case INS.GET_EXT_PUBLIC_KEY: return (p1, p2, data, isNewCall) => this.getPublicKey(p1, p2, data, isNewCall)
+        case INS.SIGN_TX: return (p1, p2, data, isNewCall) => this.signTransaction(p1, p2, data, isNewCall)
+        default: return null
+        }
+    }
+
+    private getVersion(p1: number, p2: number, data: Buffer): HandlerResponse {
+        validate(p1 === 0 && p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(data.length === 0, ERR_INVALID_DATA)
+        const {major, minor, patch, flags} = this.version
+        return {data: Buffer.from([major, minor, patch, flags.isDebug ? 1 : 0]), done: true}
+    }
+
+    private getSerial(p1: number, p2: number, data: Buffer): HandlerResponse {
+        validate(p1 === 0 && p2 === 0 && data.length === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        return {data: this.options.serial ?? Buffer.alloc(7), done: true}
+    }
+
+    private getAppInfo(p1: number, p2: number, data: Buffer): HandlerResponse {
+        validate(p1 === 0 && p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(data.length === 0, ERR_INVALID_DATA)
+        const instructions = [INS.GET_VERSION, INS.GET_SERIAL, INS.GET_APP_INFO, INS.GET_EXT_PUBLIC_KEY, INS.SIGN_TX]
+        return {
+            data: Buffer.concat([
+                this.getVersion(0, 0, Buffer.alloc(0)).data,
+                this.getSerial(0, 0, Buffer.alloc(0)).data,
+                Buffer.from([255, instructions.length, ...instructions]),
+                Buffer.from([SIGN_TX_COMMANDS.length, ...SIGN_TX_COMMANDS]),
+            ]),
+            done: true,
+        }
+    }
+
+    private getPublicKey(p1: number, p2: number, data: Buffer, isNewCall: boolean): HandlerResponse {
+        const P1_SHOW = 0x01
+        const P1_DO_NOT_SHOW = 0x02
+        validate(isNewCall, ERR_INVALID_STATE)
+        validate(p1 === P1_SHOW || p1 === P1_DO_NOT_SHOW, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        const [path, parsedSize] = parsePathFromWire(data)
+        validate(parsedSize === data.length, ERR_INVALID_DATA)
+
+        const policy = policyForGetPublicKey(path, p1 === P1_SHOW)
+        validate(policy !== SecurityPolicy.DENY, ERR_REJECTED_BY_POLICY)
+        const {publicKey} = this.deriveKey(path)
+        const wif = publicKeyToWIF(publicKey)
+        if (policy === SecurityPolicy.PROMPT_WARN_UNUSUAL) {
+            this.env.display("Unusual request", "Proceed with care")
+            this.env.display("Export public key", pathToString(path))
+        }
+        if (policy !== SecurityPolicy.ALLOW_WITHOUT_PROMPT) {
+            this.env.display("Public key", wif)
+            this.env.prompt("Confirm export", "public key?")
+        }
+        return {data: Buffer.concat([publicKey, Buffer.from(wif)]), done: true}
+    }
+
+    private signTransaction(p1: number, p2: number, data: Buffer, isNewCall: boolean): HandlerResponse {
+        if (isNewCall || this.signTransactionContext === null) {
+            this.signTransactionContext = new SignTransactionContext(this.env)
+        }
+        return this.signTransactionContext.handleAPDU(p1, p2, data, isNewCall)
+    }
+}
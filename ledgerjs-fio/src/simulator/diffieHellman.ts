@@ -0,0 +1,69 @@
+// Streaming DH encryption of the sign transaction call, the same output as dh_encode_init(),
+// dh_encode_append() and dh_encode_finalize() in src/diffieHellman.c: base64 of
+// IV || AES-256-CBC(data, PKCS7 padding) || HMAC-SHA256(IV || ciphertext), every chunk of the
+// output contains only whole base64 blocks.
+
+import * as crypto from "crypto"
+
+import {ecdhX} from "./secp256k1"
+
+const AES_BLOCK_SIZE = 16
+const BASE64_IN_BLOCK_SIZE = 3
+
+export class DHEncoder {
+    private readonly cipher: crypto.Cipher
+    private readonly hmac: crypto.Hmac
+    private cacheLength = 0
+    private base64Cache = Buffer.alloc(0)
+
+    // First 32 bytes of sha512(sha512(ECDH x)) are the AES key, the other 32 the HMAC key
+    constructor(privateKey: Buffer, otherPublicKey: Buffer, iv: Buffer) {
+        const secret = crypto.createHash("sha512").update(ecdhX(privateKey, otherPublicKey)).digest()
+        const K = crypto.createHash("sha512").update(secret).digest()
+        this.cipher = crypto.createCipheriv("aes-256-cbc", K.slice(0, 32), iv).setAutoPadding(false)
+        this.hmac = crypto.createHmac("sha256", K.slice(32))
+        this.hmac.update(iv)
+        this.base64Cache = Buffer.from(iv)
+    }
+
+    // Base64 of the whole blocks in the cache
+    private base64WholeBlocks(): Buffer {
+        const wholeLength = this.base64Cache.length - this.base64Cache.length % BASE64_IN_BLOCK_SIZE
+        const out = Buffer.from(this.base64Cache.slice(0, wholeLength).toString("base64"))
+        this.base64Cache = this.base64Cache.slice(wholeLength)
+        return out
+    }
+
+    private pushCiphertext(ciphertext: Buffer): Buffer {
+        this.hmac.update(ciphertext)
+        this.base64Cache = Buffer.concat([this.base64Cache, ciphertext])
+        return this.base64WholeBlocks()
+    }
+
+    // Output of dh_encode_init(): the base64 of the IV
+    init(): Buffer {
+        return this.base64WholeBlocks()
+    }
+
+    // Size of the output of append(), dh_encode_append_output_size()
+    appendOutputSize(inSize: number): number {
+        const aesBlocks = Math.floor((this.cacheLength + inSize) / AES_BLOCK_SIZE)
+        const base64Input = this.base64Cache.length + aesBlocks * AES_BLOCK_SIZE
+        return 4 * Math.floor(base64Input / BASE64_IN_BLOCK_SIZE)
+    }
+
+    append(data: Buffer): Buffer {
+        this.cacheLength = (this.cacheLength + data.length) % AES_BLOCK_SIZE
+        return this.pushCiphertext(this.cipher.update(data))
+    }
+
+    finalize(): Buffer {
+        const fillValue = AES_BLOCK_SIZE - this.cacheLength
+        const out = this.pushCiphertext(Buffer.concat([
+            this.cipher.update(Buffer.alloc(fillValue, fillValue)),
+            this.cipher.final(),
+        ]))
+        this.base64Cache = Buffer.concat([this.base64Cache, this.hmac.digest()])
+        return Buffer.concat([out, Buffer.from(this.base64Cache.toString("base64"))])
+    }
+}
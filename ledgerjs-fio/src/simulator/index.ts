@@ -0,0 +1,4 @@
+export {ALLOWED_HASHES, ALLOWED_HASHES_DEVEL} from '../interactions/transactionTemplates/allowedHashes'
+export type {SimulatorOptions, SimulatorScreen} from './device'
+export {SimulatedDevice, TEST_MNEMONIC} from './device'
+export {SimulatorTransport} from './simulatorTransport'
@@ -0,0 +1,102 @@
+// Key derivation, ECDH and signatures of the simulator, done the same way as on the device:
+// BIP32 derivation from the seed, ECDH returning the x coordinate and EOS-style signatures
+// with the RFC6979 nonce generator of eos_utils.c (retried until the signature is canonical).
+// Point multiplication is left to node's ECDH, the rest is plain bigint arithmetic
+// (shared with the public key recovery in utils/secp256k1.ts).
+
+import * as crypto from "crypto"
+
+import {HARDENED} from "../types/public"
+import {assert} from "../utils/assert"
+import {modInverse, N, N_HEX, toBigInt, toBuf32} from "../utils/secp256k1"
+
+export {publicKeyToWIF} from "../utils/secp256k1"
+
+const CURVE = "secp256k1"
+const N_BYTES = Buffer.from(N_HEX, "hex")
+
+const hmacSha256 = (key: Buffer, ...data: Array<Buffer>): Buffer => {
+    const hmac = crypto.createHmac("sha256", key)
+    data.forEach((d) => hmac.update(d))
+    return hmac.digest()
+}
+
+export function mnemonicToSeed(mnemonic: string): Buffer {
+    return crypto.pbkdf2Sync(mnemonic.normalize("NFKD"), "mnemonic", 2048, 64, "sha512")
+}
+
+export function getPublicKey(privateKey: Buffer, compressed = false): Buffer {
+    const ecdh = crypto.createECDH(CURVE)
+    ecdh.setPrivateKey(privateKey)
+    return ecdh.getPublicKey(null, compressed ? "compressed" : "uncompressed")
+}
+
+export function derivePrivateKey(seed: Buffer, path: Array<number>): Buffer {
+    let I = crypto.createHmac("sha512", "Bitcoin seed").update(seed).digest()
+    let key = I.slice(0, 32)
+    let chainCode = I.slice(32)
+    for (const index of path) {
+        const data = Buffer.alloc(37)
+        if (index >= HARDENED) {
+            key.copy(data, 1)
+        } else {
+            getPublicKey(key, true).copy(data)
+        }
+        data.writeUInt32BE(index, 33)
+        I = crypto.createHmac("sha512", chainCode).update(data).digest()
+        key = toBuf32((toBigInt(I.slice(0, 32)) + toBigInt(key)) % N)
+        chainCode = I.slice(32)
+    }
+    return key
+}
+
+// Throws if publicKey is not an uncompressed point of the curve
+export function validatePublicKey(publicKey: Buffer): void {
+    assert(publicKey.length === 65 && publicKey[0] === 0x04, "invalid public key")
+    crypto.ECDH.convertKey(publicKey, CURVE)
+}
+
+// x coordinate of privateKey * publicKey
+export function ecdhX(privateKey: Buffer, publicKey: Buffer): Buffer {
+    const ecdh = crypto.createECDH(CURVE)
+    ecdh.setPrivateKey(privateKey)
+    return ecdh.computeSecret(publicKey)
+}
+
+// Nonce candidates of rng_rfc6979() in eos_utils.c, including its "< n" check
+function* rfc6979Nonces(hash: Buffer, privateKey: Buffer): Generator<Buffer> {
+    let V = Buffer.alloc(32, 0x01)
+    let K = Buffer.alloc(32, 0x00)
+    K = hmacSha256(K, V, Buffer.from([0x00]), privateKey, hash)
+    V = hmacSha256(K, V)
+    K = hmacSha256(K, V, Buffer.from([0x01]), privateKey, hash)
+    V = hmacSha256(K, V)
+    for (;;) {
+        V = hmacSha256(K, V)
+        if (V.some((byte, i) => byte < N_BYTES[i])) {
+            yield V
+        }
+        K = hmacSha256(K, V, Buffer.from([0x00]))
+        V = hmacSha256(K, V)
+    }
+}
+
+const isCanonical = (rs: Buffer): boolean =>
+    !(rs[0] & 0x80) && !(rs[0] === 0 && !(rs[1] & 0x80)) &&
+    !(rs[32] & 0x80) && !(rs[32] === 0 && !(rs[33] & 0x80))
+
+// Signature as returned by the device: recovery byte (27 + 4 + parity of R.y), r and s
+export function signHash(privateKey: Buffer, hash: Buffer): Buffer {
+    const d = toBigInt(privateKey)
+    const h = toBigInt(hash)
+    for (const k of rfc6979Nonces(hash, privateKey)) {
+        const R = getPublicKey(k)
+        const r = toBigInt(R.slice(1, 33)) % N
+        const s = (modInverse(toBigInt(k), N) * (h + r * d)) % N
+        const signature = Buffer.concat([Buffer.from([27 + 4 + (R[64] & 0x01)]), toBuf32(r), toBuf32(s)])
+        if (isCanonical(signature.slice(1))) {
+            return signature
+        }
+    }
+    assert(false, "unreachable")
+}
@@ -0,0 +1,27 @@
+// Security policies of the simulated instructions, the same as src/securityPolicy.c
+
+import {containsAddress, containsMoreThanAddress, hasReasonableAddress, hasValidFIOPrefix} from "./bip44"
+
+export const enum SecurityPolicy {
+    DENY = 1,
+    ALLOW_WITHOUT_PROMPT = 2,
+    PROMPT_BEFORE_RESPONSE = 3,
+    PROMPT_WARN_UNUSUAL = 4,
+    SHOW_BEFORE_RESPONSE = 5,
+    SHOW_BEFORE_RESPONSE_IF_NONEMPTY = 6,
+}
+
+const isFIOAddressPath = (path: Array<number>): boolean =>
+    hasValidFIOPrefix(path) && containsAddress(path) && !containsMoreThanAddress(path)
+
+export function policyForGetPublicKey(path: Array<number>, show: boolean): SecurityPolicy {
+    if (!isFIOAddressPath(path)) return SecurityPolicy.DENY
+    if (!hasReasonableAddress(path)) return SecurityPolicy.PROMPT_WARN_UNUSUAL
+    if (show) return SecurityPolicy.PROMPT_BEFORE_RESPONSE
+    return SecurityPolicy.ALLOW_WITHOUT_PROMPT
+}
+
+export function policyForSignTxInit(path: Array<number>): SecurityPolicy {
+    if (!isFIOAddressPath(path)) return SecurityPolicy.DENY
+    return SecurityPolicy.SHOW_BEFORE_RESPONSE
+}
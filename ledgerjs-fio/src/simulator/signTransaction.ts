@@ -0,0 +1,543 @@
+// SIGN_TX instruction of the simulator, a port of src/signTransaction.c: the integrity hash
+// chain of the command sequence, counted sections, storage registers, SHA-256 of the
+// transaction and DH encryption of its parts. The subhandlers check the same things in the
+// same order as on the device, so the simulator answers with the same status codes.
+
+import * as crypto from "crypto"
+
+import {DeviceStatusCodes} from "../errors"
+import type {TemplateStep} from "../interactions/transactionTemplates/appTemplates"
+import {
+    indexTemplateStep, parseTemplateStep, TEMPLATE_ID_LENGTH, TEMPLATE_OP, TEMPLATE_STEPS, TEMPLATES,
+} from "../interactions/transactionTemplates/appTemplates"
+import {assert} from "../utils/assert"
+import {parsePathFromWire} from "./bip44"
+import type {SimulatorEnvironment} from "./common"
+import {ERR_NOT_IMPLEMENTED, MAX_DISPLAY_KEY_LENGTH, MAX_DISPLAY_VALUE_LENGTH, MAX_TX_APPEND_IN_SINGLE_APDU, validate, validateText} from "./common"
+import {DHEncoder} from "./diffieHellman"
+import {publicKeyToWIF, signHash, validatePublicKey} from "./secp256k1"
+import {policyForSignTxInit, SecurityPolicy} from "./securityPolicy"
+import {nameToString, parseValueToDisplay, parseValueToUInt64} from "./valueParse"
+
+const {
+    ERR_INVALID_REQUEST_PARAMETERS, ERR_INVALID_STATE, ERR_INVALID_DATA, ERR_INTEGRITY_CHECK_FAILED,
+    ERR_REJECTED_BY_POLICY,
+} = DeviceStatusCodes
+
+const CHAIN_ID_LENGTH = 32
+const PUBKEY_LENGTH = 65
+const MAX_NESTED_COUNTED_SECTIONS = 5
+const UINT32_MAX = 0xffffffff
+// G_io_apdu_buffer
+const APDU_BUFFER_SIZE = 260
+const STORAGE_SIZES = [8, 8, 64]
+
+const NETWORKS: Record<string, string> = {
+    "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e": "Testnet",
+    "21dcae42c0182200e93f954a074011f9048a7624c6fe81d3c9541a614a88bd1c": "Mainnet",
+}
+
+const enum P1 {
+    INIT = 0x01,
+    APPEND_CONST_DATA = 0x02,
+    SHOW_MESSAGE = 0x03,
+    APPEND_DATA = 0x04,
+    START_COUNTED_SECTION = 0x05,
+    END_COUNTED_SECTION = 0x06,
+    STORE_VALUE = 0x07,
+    START_DH = 0x08,
+    END_DH = 0x09,
+    FINISH = 0x10,
+    TEMPLATE = 0x11,
+}
+
+// Commands (P1) of the call, as reported by GET_APP_INFO
+export const SIGN_TX_COMMANDS: ReadonlyArray<number> = [
+    P1.INIT, P1.APPEND_CONST_DATA, P1.SHOW_MESSAGE, P1.APPEND_DATA, P1.START_COUNTED_SECTION,
+    P1.END_COUNTED_SECTION, P1.STORE_VALUE, P1.START_DH, P1.END_DH, P1.FINISH, P1.TEMPLATE,
+]
+
+// Offset of valuePolicyAndStorage in the const data of APPEND_DATA
+const APPEND_DATA_POLICY_AND_STORAGE_OFFSET = 18
+
+// The steps which can wait for the user end their APDU, signTx_templateStepCanPrompt
+function templateStepCanPrompt({p1, constData}: TemplateStep): boolean {
+    switch (p1) {
+    case P1.APPEND_CONST_DATA:
+    case P1.START_COUNTED_SECTION:
+    case P1.END_COUNTED_SECTION:
+    case P1.STORE_VALUE:
+        return false
+    case P1.APPEND_DATA:
+        return constData.length <= APPEND_DATA_POLICY_AND_STORAGE_OFFSET ||
+            (constData[APPEND_DATA_POLICY_AND_STORAGE_OFFSET] & 0x0F) !== SecurityPolicy.ALLOW_WITHOUT_PROMPT
+    default:
+        return true
+    }
+}
+
+// The program of every template by its ID (hex), src/signTransactionTemplates.c
+const templatePrograms = new Map<string, Buffer>(TEMPLATES.map(([id, program]) => [id, Buffer.from(program, "hex")]))
+const templateSteps = TEMPLATE_STEPS.map(parseTemplateStep)
+
+// Position in the program of the running template, txTemplate_next
+class TemplateCursor {
+    private readonly program: Buffer
+    private pc = 0
+    private count = 0
+    private iteration = 0
+    private loopStart = 0
+    private loopEnd = 0
+    private alternativeEnd = 0
+    private choiceEnd = 0
+
+    constructor(program: Buffer) {
+        this.program = program
+    }
+
+    // Runs the ops up to the next one taking the entry: a step (returned) or a parameter (null)
+    next(entry: Buffer): TemplateStep | null {
+        const program = this.program
+        for (;;) {
+            if (this.choiceEnd !== 0 && this.pc === this.alternativeEnd) {
+                this.pc = this.choiceEnd
+                this.alternativeEnd = this.choiceEnd = 0
+            }
+            if (this.iteration !== 0 && this.pc === this.loopEnd) {
+                if (this.iteration < this.count) {
+                    this.iteration++
+                    this.pc = this.loopStart
+                } else {
+                    this.iteration = 0
+                }
+            }
+            // the host sent more entries than the template takes
+            validate(this.pc < program.length, ERR_INVALID_DATA)
+
+            const pc = this.pc
+            switch (program[pc]) {
+            case TEMPLATE_OP.STEP:
+                this.pc += 2
+                return templateSteps[program[pc + 1]]
+            case TEMPLATE_OP.STEP_INDEXED:
+                this.pc += 2
+                return indexTemplateStep(templateSteps[program[pc + 1]], this.iteration)
+            case TEMPLATE_OP.COUNT:
+                validate(entry.length === 1, ERR_INVALID_DATA)
+                validate(program[pc + 1] <= entry[0] && entry[0] <= program[pc + 2], ERR_INVALID_DATA)
+                this.count = entry[0]
+                this.pc += 3
+                return null
+            case TEMPLATE_OP.APPEND_COUNT:
+                this.pc += 1
+                return {p1: P1.APPEND_CONST_DATA, p2: 0, constData: Buffer.from([this.count])}
+            case TEMPLATE_OP.LOOP:
+                this.pc += 2
+                if (this.count > 0) {
+                    this.iteration = 1
+                    this.loopStart = this.pc
+                    this.loopEnd = this.pc + program[pc + 1]
+                } else {
+                    this.pc += program[pc + 1]
+                }
+                break
+            case TEMPLATE_OP.CHOICE:
+                validate(entry.length === 1, ERR_INVALID_DATA)
+                validate(entry[0] < program[pc + 1], ERR_INVALID_DATA)
+                this.pc += 3
+                this.choiceEnd = this.pc + program[pc + 1] * program[pc + 2]
+                this.pc += entry[0] * program[pc + 2]
+                this.alternativeEnd = this.pc + program[pc + 2]
+                return null
+            default:
+                assert(false, "unknown template op")
+            }
+        }
+    }
+}
+
+const enum StorageCheck {
+    NO = 0x00,
+    R1 = 0x10,
+    R2 = 0x20,
+    R3 = 0x30,
+    R1_DECODE_NAME = 0x40,
+}
+
+/**
+ * Result of one simulated APDU, `done` is set when the instruction call ends
+ */
+export type HandlerResponse = {
+    data: Buffer
+    done?: boolean
+}
+
+export class SignTransactionContext {
+    private readonly env: SimulatorEnvironment
+    private integrityHash = Buffer.alloc(32)
+    private readonly hash = crypto.createHash("sha256")
+    // remaining bytes of the open counted sections, outermost first
+    private readonly countedSections: Array<number> = []
+    private readonly storage: Array<Buffer> = [Buffer.alloc(0), Buffer.alloc(0), Buffer.alloc(0)]
+    private witnessPath: Array<number> = []
+    private dh: DHEncoder | null = null
+    private dhCountedSectionEntryLevel = 0
+    private countedSectionDifference = 0
+    // the template run by TEMPLATE
+    private template: TemplateCursor | null = null
+
+    constructor(env: SimulatorEnvironment) {
+        this.env = env
+    }
+
+    handleAPDU(p1: number, p2: number, wireData: Buffer, isNewCall: boolean): HandlerResponse {
+        if (p1 === P1.TEMPLATE) {
+            return this.handleTemplate(p2, wireData, isNewCall)
+        }
+        // the commands of a template are its steps only
+        validate(this.template === null, ERR_INVALID_STATE)
+
+        validate(wireData.length >= 2, ERR_INVALID_DATA)
+        const constSize = wireData[0]
+        const varSize = wireData[1]
+        validate(wireData.length >= 2 + constSize + varSize, ERR_INVALID_DATA)
+        const constData = wireData.slice(2, 2 + constSize)
+        const varData = wireData.slice(2 + constSize, 2 + constSize + varSize)
+        return this.handleCommand(p1, p2, constData, varData)
+    }
+
+    private handleCommand(p1: number, p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        this.integrityCheckProcessInstruction(p1, p2, constData)
+
+        switch (p1) {
+        case P1.INIT: return this.handleInit(p2, constData, varData)
+        case P1.APPEND_CONST_DATA: return this.handleAppendConstData(p2, constData, varData)
+        case P1.SHOW_MESSAGE: return this.handleShowMessage(p2, constData, varData)
+        case P1.APPEND_DATA: return this.handleAppendData(p2, constData, varData)
+        case P1.START_COUNTED_SECTION: return this.handleStartCountedSection(p2, constData, varData)
+        case P1.END_COUNTED_SECTION: return this.handleEndCountedSection(p2, constData, varData)
+        case P1.STORE_VALUE: return this.handleStoreValue(p2, constData, varData)
+        case P1.START_DH: return this.handleStartDH(p2, constData, varData)
+        case P1.END_DH: return this.handleEndDH(p2, constData, varData)
+        case P1.FINISH: return this.handleFinish(p2, constData, varData)
+        default:
+            validate(false, ERR_INVALID_REQUEST_PARAMETERS)
+        }
+    }
+
+    // ============================== TEMPLATE ==============================
+
+    // The template ID in the first APDU of the call, then [varLength | varData] of every step.
+    // The response of the APDU is the response of its last step.
+    private handleTemplate(p2: number, wireData: Buffer, isNewCall: boolean): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        let offset = 0
+        if (isNewCall) {
+            validate(wireData.length >= TEMPLATE_ID_LENGTH, ERR_INVALID_DATA)
+            const program = templatePrograms.get(wireData.slice(0, TEMPLATE_ID_LENGTH).toString("hex"))
+            validate(program !== undefined, ERR_INVALID_DATA)
+            this.template = new TemplateCursor(program)
+            offset = TEMPLATE_ID_LENGTH
+        }
+        const template = this.template
+        validate(template !== null, ERR_INVALID_STATE)
+        validate(offset < wireData.length, ERR_INVALID_DATA)
+
+        let response: HandlerResponse = {data: Buffer.alloc(0)}
+        while (offset < wireData.length) {
+            const varSize = wireData[offset]
+            validate(offset + 1 + varSize <= wireData.length, ERR_INVALID_DATA)
+            const varData = wireData.slice(offset + 1, offset + 1 + varSize)
+            offset += 1 + varSize
+            const step = template.next(varData)
+            if (step === null) {
+                // a parameter of the template, the step using it follows in the same APDU
+                validate(offset < wireData.length, ERR_INVALID_DATA)
+                continue
+            }
+            // the steps responding with data or waiting for the user end their APDU
+            if (this.dh !== null || templateStepCanPrompt(step)) {
+                validate(offset === wireData.length, ERR_INVALID_DATA)
+            }
+            response = this.handleCommand(step.p1, step.p2, step.constData, varData)
+        }
+        return response
+    }
+
+    // ============================== INTEGRITY ==============================
+
+    private integrityCheckProcessInstruction(p1: number, p2: number, constData: Buffer): void {
+        this.integrityHash = crypto.createHash("sha256")
+            .update(this.integrityHash)
+            .update(Buffer.from([p1, p2, constData.length]))
+            .update(constData)
+            .digest()
+    }
+
+    private integrityCheckEvaluate(): boolean {
+        return this.env.isAllowedHash(this.integrityHash.toString("hex"))
+    }
+
+    // ============================== COUNTED SECTIONS ==============================
+
+    private countedSectionBegin(expectedLength: number): boolean {
+        if (this.countedSections.length >= MAX_NESTED_COUNTED_SECTIONS) {
+            return false
+        }
+        this.countedSections.push(expectedLength)
+        return true
+    }
+
+    private countedSectionProcess(length: number): boolean {
+        for (let i = 0; i < this.countedSections.length; i++) {
+            if (this.countedSections[i] < length) {
+                return false
+            }
+            this.countedSections[i] -= length
+        }
+        return true
+    }
+
+    private countedSectionEnd(): boolean {
+        if (this.countedSections.length === 0 || this.countedSections[this.countedSections.length - 1] !== 0) {
+            return false
+        }
+        this.countedSections.pop()
+        return true
+    }
+
+    // ============================== MISC ==============================
+
+    private privateKey(): Buffer {
+        return this.env.deriveKey(this.witnessPath).privateKey
+    }
+
+    // Extends the hash with data, or with its encryption if DH is active (which is the response)
+    private processShaAndPosibleDH(data: Buffer): Buffer {
+        assert(data.length <= MAX_TX_APPEND_IN_SINGLE_APDU, "data too long")
+        if (this.dh === null) {
+            this.hash.update(data)
+            return Buffer.alloc(0)
+        }
+        // the encryption runs in place in G_io_apdu_buffer on the device (dh_encode_append_in_place),
+        // only its output has to fit
+        validate(this.dh.appendOutputSize(data.length) <= APDU_BUFFER_SIZE, ERR_INVALID_DATA)
+        const response = this.dh.append(data)
+        this.hash.update(response)
+        validate(this.countedSectionDifference + response.length >= data.length, ERR_INVALID_STATE)
+        this.countedSectionDifference += response.length - data.length
+        return response
+    }
+
+    // ============================== INIT ==============================
+
+    private handleInit(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length >= CHAIN_ID_LENGTH, ERR_INVALID_DATA)
+
+        const chainId = varData.slice(0, CHAIN_ID_LENGTH)
+        const network = NETWORKS[chainId.toString("hex")]
+        validate(network !== undefined, ERR_INVALID_DATA)
+        const [path, parsedSize] = parsePathFromWire(varData.slice(CHAIN_ID_LENGTH))
+        validate(parsedSize === varData.length - CHAIN_ID_LENGTH, ERR_INVALID_DATA)
+        this.witnessPath = path
+
+        validate(this.dh === null, ERR_INVALID_STATE)
+        validate(this.countedSectionProcess(CHAIN_ID_LENGTH), ERR_INVALID_DATA)
+        this.hash.update(chainId)
+
+        const policy = policyForSignTxInit(path)
+        validate(policy !== SecurityPolicy.DENY, ERR_REJECTED_BY_POLICY)
+        validate(policy === SecurityPolicy.SHOW_BEFORE_RESPONSE, ERR_NOT_IMPLEMENTED)
+        this.env.display("Chain", network)
+        return {data: Buffer.alloc(0)}
+    }
+
+    // ======================= APPEND CONST DATA ===========================
+
+    private handleAppendConstData(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length < MAX_TX_APPEND_IN_SINGLE_APDU, ERR_INVALID_DATA)
+        validate(varData.length === 0, ERR_INVALID_DATA)
+
+        validate(this.countedSectionProcess(constData.length), ERR_INVALID_DATA)
+        return {data: this.processShaAndPosibleDH(constData)}
+    }
+
+    // ======================= SHOW MESSAGE ===========================
+
+    private handleShowMessage(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length >= 1, ERR_INVALID_DATA)
+        const keyLen = constData[0]
+        validate(keyLen < MAX_DISPLAY_KEY_LENGTH - 1, ERR_INVALID_DATA)
+        validate(constData.length >= 2 + keyLen, ERR_INVALID_DATA)
+        const valueLen = constData[1 + keyLen]
+        validate(valueLen < MAX_DISPLAY_VALUE_LENGTH - 1, ERR_INVALID_DATA)
+        validate(constData.length === 2 + keyLen + valueLen, ERR_INVALID_DATA)
+        validate(varData.length === 0, ERR_INVALID_DATA)
+
+        const key = validateText(constData.slice(1, 1 + keyLen), ERR_INVALID_DATA)
+        const value = validateText(constData.slice(2 + keyLen), ERR_INVALID_DATA)
+        this.env.display(key, value)
+        return {data: Buffer.alloc(0)}
+    }
+
+    // ======================= APPEND DATA ===========================
+
+    private handleAppendData(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length >= 20, ERR_INVALID_DATA)
+        const [valueFormat, valueValidation] = constData
+        const validationArgs = constData.slice(2, 18)
+        const policyAndStorage = constData[18]
+        const keyLen = constData[19]
+        validate(keyLen <= MAX_DISPLAY_KEY_LENGTH - 1, ERR_INVALID_DATA)
+        validate(constData.length === 20 + keyLen, ERR_INVALID_DATA)
+        validate(varData.length <= MAX_TX_APPEND_IN_SINGLE_APDU, ERR_INVALID_DATA)
+
+        const storage = policyAndStorage & 0xf0
+        switch (storage) {
+        case StorageCheck.R1:
+        case StorageCheck.R2:
+        case StorageCheck.R3:
+            validate(this.storage[storage / 0x10 - 1].equals(varData), ERR_INVALID_DATA)
+            break
+        case StorageCheck.R1_DECODE_NAME:
+            assert(this.storage[0].length === 8, "stored value is not a name")
+            validate(varData.length < 14, ERR_INVALID_DATA)
+            validate(nameToString(this.storage[0]) === varData.toString("latin1"), ERR_INVALID_DATA)
+            break
+        case StorageCheck.NO:
+            break
+        default:
+            validate(false, ERR_INVALID_DATA)
+        }
+
+        const key = validateText(constData.slice(20), ERR_INVALID_DATA)
+        const value = parseValueToDisplay(valueFormat, valueValidation, validationArgs, varData)
+        const policy = policyAndStorage & 0x0f
+
+        validate(this.countedSectionProcess(varData.length), ERR_INVALID_DATA)
+        const response = this.processShaAndPosibleDH(varData)
+
+        switch (policy) {
+        case SecurityPolicy.ALLOW_WITHOUT_PROMPT:
+            break
+        case SecurityPolicy.SHOW_BEFORE_RESPONSE:
+            this.env.display(key, value)
+            break
+        case SecurityPolicy.SHOW_BEFORE_RESPONSE_IF_NONEMPTY:
+            if (value.length > 0) this.env.display(key, value)
+            break
+        default:
+            validate(false, ERR_NOT_IMPLEMENTED)
+        }
+        return {data: response}
+    }
+
+    // ======================= START COUNTED SECTION ===========================
+
+    private handleStartCountedSection(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 18, ERR_INVALID_DATA)
+        validate(varData.length <= MAX_TX_APPEND_IN_SINGLE_APDU, ERR_INVALID_DATA)
+
+        const value = parseValueToUInt64(constData[0], constData[1], constData.slice(2, 18), varData)
+        validate(value <= BigInt(UINT32_MAX), ERR_INVALID_DATA)
+
+        // this data does not count towards new counted section but counts towards old ones
+        validate(this.countedSectionProcess(varData.length), ERR_INVALID_DATA)
+        validate(this.countedSectionBegin(Number(value)), ERR_INVALID_DATA)
+        return {data: this.processShaAndPosibleDH(varData)}
+    }
+
+    // ======================= END COUNTED SECTION ===========================
+
+    private handleEndCountedSection(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length === 0, ERR_INVALID_DATA)
+
+        // Counted section that started before DH encoding cannot end within DH encoding
+        if (this.dh !== null) {
+            validate(this.dhCountedSectionEntryLevel < this.countedSections.length, ERR_INVALID_STATE)
+        }
+        validate(this.countedSectionEnd(), ERR_INVALID_DATA)
+        return {data: Buffer.alloc(0)}
+    }
+
+    // ======================= STORE_VALUE ===========================
+
+    private handleStoreValue(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(1 <= p2 && p2 <= 3, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length <= STORAGE_SIZES[p2 - 1], ERR_INVALID_DATA)
+        this.storage[p2 - 1] = Buffer.from(varData)
+        return {data: Buffer.alloc(0)}
+    }
+
+    // ======================= START DH ENCODING ===========================
+
+    private handleStartDH(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length === PUBKEY_LENGTH, ERR_INVALID_DATA)
+        try {
+            validatePublicKey(varData)
+        } catch (e) {
+            validate(false, ERR_INVALID_DATA)
+        }
+
+        validate(this.dh === null, ERR_INVALID_STATE)
+        this.dh = new DHEncoder(this.privateKey(), varData, this.env.randomBytes(16))
+        this.dhCountedSectionEntryLevel = this.countedSections.length
+        const response = this.dh.init()
+        assert(response.length === 20, "unexpected DH init length")
+        this.countedSectionDifference = response.length
+        this.hash.update(response)
+
+        this.env.display("Encrypting", "content")
+        return {data: response}
+    }
+
+    // ======================= END DH ENCODING ===========================
+
+    private handleEndDH(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length === 0, ERR_INVALID_DATA)
+
+        // To be sure that we are encoding correct DH data
+        validate(this.integrityCheckEvaluate(), ERR_INTEGRITY_CHECK_FAILED)
+        validate(this.dh !== null, ERR_INVALID_STATE)
+        // Counted section that started within DH encoding cannot end after DH encoding
+        validate(this.dhCountedSectionEntryLevel === this.countedSections.length, ERR_INVALID_STATE)
+        const response = this.dh.finalize()
+        this.countedSectionDifference += response.length
+        validate(this.countedSectionProcess(this.countedSectionDifference), ERR_INVALID_STATE)
+        this.hash.update(response)
+        this.dh = null
+
+        this.env.prompt("Encrypt content?", "")
+        return {data: response}
+    }
+
+    // ============================== FINISH ==============================
+
+    private handleFinish(p2: number, constData: Buffer, varData: Buffer): HandlerResponse {
+        validate(p2 === 0, ERR_INVALID_REQUEST_PARAMETERS)
+        validate(constData.length === 0, ERR_INVALID_DATA)
+        validate(varData.length === 0, ERR_INVALID_DATA)
+
+        const txHash = this.hash.digest()
+        validate(this.dh === null, ERR_INVALID_STATE)
+        validate(this.integrityCheckEvaluate(), ERR_INTEGRITY_CHECK_FAILED)
+        validate(this.countedSections.length === 0, ERR_INVALID_DATA)
+
+        this.env.display("Sign with", publicKeyToWIF(this.env.deriveKey(this.witnessPath).publicKey))
+        this.env.prompt("Sign", "transaction?")
+        return {data: Buffer.concat([signHash(this.privateKey(), txHash), txHash]), done: true}
+    }
+}
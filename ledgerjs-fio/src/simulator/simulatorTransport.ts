@@ -0,0 +1,40 @@
+import Transport from "@ledgerhq/hw-transport"
+
+import type {SimulatorOptions} from "./device"
+import {SimulatedDevice} from "./device"
+
+/**
+ * Transport answering the APDUs with a [[SimulatedDevice]] in the same process, e.g. for
+ * dry runs of transactions before they are sent to a real device or for tests without
+ * speculos.
+ *
+ * @example
+ * ```
+ * const fio = new Fio(new SimulatorTransport())
+ * const signed = await fio.signTransaction({path, chainId, tx})
+ * ```
+ * @category Simulator
+ */
+export class SimulatorTransport extends Transport<string> {
+    readonly device: SimulatedDevice
+
+    constructor(options: SimulatorOptions = {}) {
+        super()
+        this.device = new SimulatedDevice(options)
+    }
+
+    exchange(apdu: Buffer): Promise<Buffer> {
+        try {
+            return Promise.resolve(this.device.exchange(apdu))
+        } catch (e) {
+            return Promise.reject(e)
+        }
+    }
+
+    setScrambleKey(): void {
+    }
+
+    close(): Promise<void> {
+        return Promise.resolve()
+    }
+}
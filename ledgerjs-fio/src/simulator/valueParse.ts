@@ -0,0 +1,194 @@
+// Value formats and validations of the APPEND_DATA and START_COUNTED_SECTION commands,
+// the same checks as src/signTransactionParse.c.
+
+import {DeviceStatusCodes} from "../errors"
+import {MAX_DISPLAY_VALUE_LENGTH, validate, validateText} from "./common"
+
+const ERR_INVALID_DATA = DeviceStatusCodes.ERR_INVALID_DATA
+
+export const enum ValueFormat {
+    BUFFER_SHOW_AS_HEX = 0x01,
+    ASCII_STRING = 0x02,
+    NAME = 0x03,
+    ASCII_STRING_WITH_LENGTH = 0x04,
+    FIO_AMOUNT = 0x10,
+    UINT64 = 0x14,
+    VARUINT32 = 0x17,
+    MEMO_HASH = 0x20,
+    CHAIN_CODE_TOKEN_CODE_PUBLIC_ADDR = 0x21,
+}
+
+export const enum ValueValidation {
+    NONE = 1,
+    INBUFFER_LENGTH = 2,
+    NUMBER = 3,
+}
+
+const UINT32_MAX = BigInt(0xffffffff)
+const NAME_CHARMAP = ".12345abcdefghijklmnopqrstuvwxyz"
+
+const isNumberType = (format: number): boolean => format >= 0x10 && format < 0x20
+
+// Returns the number and the number of bytes read
+function getNumberFromVarUInt(value: Buffer): [bigint, number] {
+    let number = BigInt(0)
+    let bitShift = BigInt(0)
+    let readPosition = 0
+    for (;;) {
+        validate(readPosition < value.length, ERR_INVALID_DATA)
+        const nextByte = value[readPosition]
+        number = (number | (BigInt(nextByte & 0x7f) << bitShift)) & BigInt("0xffffffffffffffff")
+        bitShift += BigInt(7)
+        readPosition++
+        if (!(nextByte & 0x80)) {
+            break
+        }
+        validate(readPosition < 9, ERR_INVALID_DATA)
+    }
+    return [number, readPosition]
+}
+
+// name_to_string() of fio.c, value is the little endian uint64 of the name
+export function nameToString(value: Buffer): string {
+    let tmp = value.readBigUInt64LE(0)
+    const str = Array<string>(13).fill(".")
+    for (let i = 0; i <= 12; i++) {
+        str[12 - i] = NAME_CHARMAP[Number(tmp & BigInt(i === 0 ? 0x0f : 0x1f))]
+        tmp >>= BigInt(i === 0 ? 4 : 5)
+    }
+    return str.join("").replace(/\.+$/, "")
+}
+
+function formatFIOAmount(amount: bigint): string {
+    const digits = amount.toString().padStart(10, "0")
+    const whole = digits.slice(0, -9).replace(/\B(?=(\d{3})+(?!\d))/g, ",")
+    return `${whole}.${digits.slice(-9)} FIO`
+}
+
+function displayMemoHash(value: Buffer): string {
+    let read = 0
+    const validateOptional = (): boolean => {
+        validate(value.length >= read + 1, ERR_INVALID_DATA)
+        const hasOptional = value[read]
+        if (!hasOptional) {
+            read += 1
+            return false
+        }
+        validate(hasOptional === 1, ERR_INVALID_DATA)
+        validate(value.length >= read + 2, ERR_INVALID_DATA)
+        const optionalLen = value[read + 1]
+        validate(optionalLen < 127, ERR_INVALID_DATA)
+        read += 2 + optionalLen
+        return true
+    }
+    validateOptional()
+    const hasHash = validateOptional()
+    const hasOfflineUrl = validateOptional()
+    validate(hasHash === hasOfflineUrl, ERR_INVALID_DATA)
+    return "NOT IMPLEMENTED"
+}
+
+function displayChainCodeTokenCodePublicAddr(value: Buffer): string {
+    validate(value.length >= 1, ERR_INVALID_DATA)
+    const tokenCodeLen = value[0]
+    validate(1 <= tokenCodeLen && tokenCodeLen <= 10, ERR_INVALID_DATA)
+    validate(value.length >= tokenCodeLen + 2, ERR_INVALID_DATA)
+    const chainCodeLen = value[tokenCodeLen + 1]
+    validate(1 <= chainCodeLen && chainCodeLen <= 10, ERR_INVALID_DATA)
+    validate(value.length >= tokenCodeLen + chainCodeLen + 3, ERR_INVALID_DATA)
+    const [publicAddrLen, publicAddrLenLen] = getNumberFromVarUInt(value.slice(tokenCodeLen + chainCodeLen + 2))
+    const publicAddrStart = tokenCodeLen + chainCodeLen + 2 + publicAddrLenLen
+    validate(BigInt(1) <= publicAddrLen && publicAddrLen <= BigInt(128), ERR_INVALID_DATA)
+    validate(value.length === publicAddrStart + Number(publicAddrLen), ERR_INVALID_DATA)
+    const tokenCode = validateText(value.slice(1, 1 + tokenCodeLen), ERR_INVALID_DATA)
+    const chainCode = validateText(value.slice(tokenCodeLen + 2, tokenCodeLen + 2 + chainCodeLen), ERR_INVALID_DATA)
+    const publicAddr = validateText(value.slice(publicAddrStart), ERR_INVALID_DATA)
+    return `${chainCode}:${tokenCode}:${publicAddr}`
+}
+
+function parseUInt64(value: Buffer): bigint {
+    validate(value.length === 8, ERR_INVALID_DATA)
+    return value.readBigUInt64LE(0)
+}
+
+function parseVarUInt32(value: Buffer): bigint {
+    const [number, read] = getNumberFromVarUInt(value)
+    validate(read === value.length, ERR_INVALID_DATA)
+    validate(number <= UINT32_MAX, ERR_INVALID_DATA)
+    return number
+}
+
+function bufferValidation(format: number, validation: number, arg1: bigint, arg2: bigint, value: Buffer): void {
+    switch (validation) {
+    case ValueValidation.NONE:
+        validate(arg1 === BigInt(0) && arg2 === BigInt(0), ERR_INVALID_DATA)
+        break
+    case ValueValidation.INBUFFER_LENGTH:
+        validate(arg1 <= BigInt(value.length) && arg2 >= BigInt(value.length), ERR_INVALID_DATA)
+        break
+    case ValueValidation.NUMBER:
+        validate(isNumberType(format), ERR_INVALID_DATA)
+        break
+    default:
+        validate(false, ERR_INVALID_DATA)
+    }
+}
+
+function validateNumber(validation: number, arg1: bigint, arg2: bigint, number: bigint): bigint {
+    if (validation === ValueValidation.NUMBER) {
+        validate(arg1 <= number && number <= arg2, ERR_INVALID_DATA)
+    }
+    return number
+}
+
+export function parseValueToUInt64(format: number, validation: number, args: Buffer, value: Buffer): bigint {
+    const arg1 = args.readBigUInt64LE(0)
+    const arg2 = args.readBigUInt64LE(8)
+    bufferValidation(format, validation, arg1, arg2, value)
+    switch (format) {
+    case ValueFormat.FIO_AMOUNT:
+    case ValueFormat.UINT64:
+        return validateNumber(validation, arg1, arg2, parseUInt64(value))
+    case ValueFormat.VARUINT32:
+        return validateNumber(validation, arg1, arg2, parseVarUInt32(value))
+    default:
+        validate(false, ERR_INVALID_DATA)
+    }
+}
+
+// Returns the text shown on the device
+export function parseValueToDisplay(format: number, validation: number, args: Buffer, value: Buffer): string {
+    const arg1 = args.readBigUInt64LE(0)
+    const arg2 = args.readBigUInt64LE(8)
+    bufferValidation(format, validation, arg1, arg2, value)
+    switch (format) {
+    case ValueFormat.BUFFER_SHOW_AS_HEX:
+        validate(value.length * 2 < MAX_DISPLAY_VALUE_LENGTH, ERR_INVALID_DATA)
+        return value.toString("hex")
+    case ValueFormat.ASCII_STRING:
+        validate(value.length < MAX_DISPLAY_VALUE_LENGTH, ERR_INVALID_DATA)
+        return validateText(value, ERR_INVALID_DATA)
+    case ValueFormat.NAME:
+        validate(value.length === 8, ERR_INVALID_DATA)
+        return nameToString(value)
+    case ValueFormat.ASCII_STRING_WITH_LENGTH: {
+        const [strLen, strLenLen] = getNumberFromVarUInt(value)
+        validate(strLen < BigInt(MAX_DISPLAY_VALUE_LENGTH), ERR_INVALID_DATA)
+        validate(value.length === strLenLen + Number(strLen), ERR_INVALID_DATA)
+        return validateText(value.slice(strLenLen), ERR_INVALID_DATA)
+    }
+    case ValueFormat.FIO_AMOUNT:
+        return formatFIOAmount(validateNumber(validation, arg1, arg2, parseUInt64(value)))
+    case ValueFormat.UINT64:
+    case ValueFormat.VARUINT32: {
+        const number = format === ValueFormat.UINT64 ? parseUInt64(value) : parseVarUInt32(value)
+        return validateNumber(validation, arg1, arg2, number).toString()
+    }
+    case ValueFormat.MEMO_HASH:
+        return displayMemoHash(value)
+    case ValueFormat.CHAIN_CODE_TOKEN_CODE_PUBLIC_ADDR:
+        return displayChainCodeTokenCodePublicAddr(value)
+    default:
+        validate(false, ERR_INVALID_DATA)
+    }
+}
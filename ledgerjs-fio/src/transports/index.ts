@@ -0,0 +1,4 @@
+export type {Transcript, TranscriptEntry} from './transcript'
+export {RecordingTransport} from './recordingTransport'
+export type {LatencyModel, ReplayOptions} from './replayTransport'
+export {linkLatency, ReplayTransport} from './replayTransport'
@@ -0,0 +1,45 @@
+import Transport from "@ledgerhq/hw-transport"
+
+import type {Transcript} from "./transcript"
+
+/**
+ * Transport which forwards the APDUs to another transport and records them together with
+ * the responses and the duration of every exchange.
+ *
+ * @example
+ * ```
+ * const transport = new RecordingTransport(await TransportNodeHid.create())
+ * await new Fio(transport).getVersion()
+ * fs.writeFileSync("getVersion.json", JSON.stringify(transport.transcript))
+ * ```
+ * @category Transports
+ */
+export class RecordingTransport extends Transport<string> {
+    /** Exchanges recorded so far */
+    readonly transcript: Transcript = []
+    private readonly transport: Transport<string>
+
+    constructor(transport: Transport<string>) {
+        super()
+        this.transport = transport
+    }
+
+    async exchange(apdu: Buffer): Promise<Buffer> {
+        const start = Date.now()
+        const response = await this.transport.exchange(apdu)
+        this.transcript.push({
+            apdu: apdu.toString("hex"),
+            response: response.toString("hex"),
+            durationMs: Date.now() - start,
+        })
+        return response
+    }
+
+    setScrambleKey(key: string): void {
+        this.transport.setScrambleKey(key)
+    }
+
+    close(): Promise<void> {
+        return this.transport.close()
+    }
+}
@@ -0,0 +1,94 @@
+import Transport from "@ledgerhq/hw-transport"
+
+import {TranscriptMismatch} from "../errors"
+import type {Transcript} from "./transcript"
+
+/**
+ * Delay of one exchange in milliseconds
+ * @category Transports
+ */
+export type LatencyModel = (apdu: Buffer, response: Buffer) => number
+
+/**
+ * @category Transports
+ */
+export type ReplayOptions = {
+    /**
+     * Delay added to every exchange: `"recorded"` waits as long as the recorded exchange took,
+     * a [[LatencyModel]] simulates a link (see [[linkLatency]]). No delay by default.
+     */
+    latency?: "recorded" | LatencyModel
+}
+
+/**
+ * Latency of a link with a fixed overhead per exchange and a limited throughput,
+ * e.g. to compare how different chunkings of the same data behave over a slow link.
+ * @category Transports
+ */
+export function linkLatency(perExchangeMs: number, bytesPerMs: number): LatencyModel {
+    return (apdu: Buffer, response: Buffer) => perExchangeMs + (apdu.length + response.length) / bytesPerMs
+}
+
+/**
+ * Transport which answers the APDUs with the responses of a [[Transcript]] recorded by
+ * [[RecordingTransport]], without any device. The APDUs must come in the recorded order and
+ * be the same as the recorded ones, otherwise [[TranscriptMismatch]] is thrown.
+ *
+ * @example
+ * ```
+ * const transcript = JSON.parse(fs.readFileSync("getVersion.json", "utf8"))
+ * const fio = new Fio(new ReplayTransport(transcript))
+ * await fio.getVersion()
+ * ```
+ * @category Transports
+ */
+export class ReplayTransport extends Transport<string> {
+    private readonly transcript: Transcript
+    private readonly options: ReplayOptions
+    private position = 0
+
+    constructor(transcript: Transcript, options: ReplayOptions = {}) {
+        super()
+        this.transcript = transcript
+        this.options = options
+    }
+
+    async exchange(apdu: Buffer): Promise<Buffer> {
+        const entry = this.transcript[this.position]
+        const apduHex = apdu.toString("hex")
+        if (entry === undefined) {
+            throw new TranscriptMismatch(`APDU ${this.position} (${apduHex}) is not in the transcript`)
+        }
+        if (entry.apdu !== apduHex) {
+            throw new TranscriptMismatch(`APDU ${this.position} is ${apduHex}, recorded ${entry.apdu}`)
+        }
+        this.position++
+
+        const response = Buffer.from(entry.response, "hex")
+        const latency = this.options.latency
+        const delayMs = latency === undefined ? 0
+            : latency === "recorded" ? entry.durationMs
+                : latency(apdu, response)
+        if (delayMs > 0) {
+            await new Promise((resolve) => setTimeout(resolve, delayMs))
+        }
+        return response
+    }
+
+    /** True if all the recorded exchanges were replayed */
+    get done(): boolean {
+        return this.position === this.transcript.length
+    }
+
+    /** Starts the replay from the first exchange again */
+    rewind(): void {
+        this.position = 0
+    }
+
+    setScrambleKey(): void {
+    }
+
+    close(): Promise<void> {
+        return Promise.resolve()
+    }
+}
@@ -0,0 +1,20 @@
+/**
+ * One exchange with the device
+ * @category Transports
+ */
+export type TranscriptEntry = {
+    /** APDU sent to the device in hex format */
+    apdu: string
+    /** Response of the device in hex format, including the status word */
+    response: string
+    /** Duration of the exchange in milliseconds */
+    durationMs: number
+}
+
+/**
+ * Exchanges with the device in the order they happened, plain JSON so that it can be stored in a file
+ * @category Transports
+ * @see [[RecordingTransport]]
+ * @see [[ReplayTransport]]
+ */
+export type Transcript = Array<TranscriptEntry>
@@ -53,6 +53,10 @@ export type DeviceCompatibility = {
      * Clients of SDK should check whether this is null and if not, urge users to upgrade.
      */
     recommendedVersion: string | null
+    /** Whether the app has the GET_APP_INFO instruction (since 1.0.8) */
+    supportsGetAppInfo: boolean
+    /** Whether the app runs transaction templates with the TEMPLATE command of SIGN_TX (since 1.0.8) */
+    supportsSignTransactionTemplate: boolean
 }
 
 /**
@@ -80,6 +84,26 @@ export type Serial = {
     serial: string
 };
 
+/**
+ * Device app info, everything needed at the start of a session
+ * @category Basic types
+ * @see [[Fio.getAppInfo]]
+ */
+export type AppInfo = {
+    version: Version
+    /**
+     * Serial as in [[Serial]], null if the app does not provide the app info
+     * (it is then requested by [[Fio.getSerial]])
+     */
+    serial: string | null
+    /** Maximal data size of a request APDU */
+    maxRequestDataSize: number
+    /** Supported instructions (INS), null if unknown */
+    instructions: Array<number> | null
+    /** Commands (P1) supported by the sign transaction instruction, null if unknown */
+    signTransactionCommands: Array<number> | null
+}
+
 /**
  * Represents BIP 32 path.
  *
@@ -0,0 +1,181 @@
+// secp256k1 arithmetic which node's crypto does not provide: points given by coordinates
+// (public key recovery) and the FIO public key format. Plain bigint arithmetic, the points
+// in Jacobian coordinates so that only the result needs a modular inverse.
+
+import * as crypto from "crypto"
+
+import {assert} from "./assert"
+
+// field prime, group order and generator
+const P = BigInt("0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffefffffc2f")
+export const N_HEX = "fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141"
+export const N = BigInt("0x" + N_HEX)
+const G = {
+    x: BigInt("0x79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798"),
+    y: BigInt("0x483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"),
+}
+
+const ZERO = BigInt(0)
+const ONE = BigInt(1)
+const TWO = BigInt(2)
+const THREE = BigInt(3)
+const FOUR = BigInt(4)
+const SEVEN = BigInt(7)
+const EIGHT = BigInt(8)
+
+const BASE58_ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
+
+export const toBigInt = (buf: Buffer): bigint => BigInt("0x" + buf.toString("hex"))
+export const toBuf32 = (n: bigint): Buffer => Buffer.from(n.toString(16).padStart(64, "0"), "hex")
+
+const mod = (a: bigint, m: bigint = P): bigint => {
+    const r = a % m
+    return r < ZERO ? r + m : r
+}
+
+export function modInverse(a: bigint, m: bigint): bigint {
+    let oldR = mod(a, m)
+    let r = m
+    let oldS = ONE
+    let s = ZERO
+    while (r !== ZERO) {
+        const q = oldR / r
+        const nextR = oldR - q * r
+        const nextS = oldS - q * s
+        oldR = r
+        r = nextR
+        oldS = s
+        s = nextS
+    }
+    return mod(oldS, m)
+}
+
+function modPow(base: bigint, exponent: bigint, m: bigint): bigint {
+    let result = ONE
+    base = mod(base, m)
+    while (exponent > ZERO) {
+        if (exponent & ONE) result = (result * base) % m
+        base = (base * base) % m
+        exponent >>= ONE
+    }
+    return result
+}
+
+type AffinePoint = {x: bigint, y: bigint}
+// null is the point at infinity
+type JacobianPoint = {x: bigint, y: bigint, z: bigint} | null
+
+function double(p: JacobianPoint): JacobianPoint {
+    if (p === null || p.y === ZERO) return null
+    const yy = mod(p.y * p.y)
+    const s = mod(FOUR * p.x * yy)
+    const m = mod(THREE * p.x * p.x)
+    const x = mod(m * m - TWO * s)
+    return {x, y: mod(m * (s - x) - EIGHT * yy * yy), z: mod(TWO * p.y * p.z)}
+}
+
+function add(p: JacobianPoint, q: JacobianPoint): JacobianPoint {
+    if (p === null) return q
+    if (q === null) return p
+    const pz2 = mod(p.z * p.z)
+    const qz2 = mod(q.z * q.z)
+    const u1 = mod(p.x * qz2)
+    const u2 = mod(q.x * pz2)
+    const s1 = mod(p.y * qz2 * q.z)
+    const s2 = mod(q.y * pz2 * p.z)
+    if (u1 === u2) {
+        return s1 === s2 ? double(p) : null
+    }
+    const h = mod(u2 - u1)
+    const r = mod(s2 - s1)
+    const hh = mod(h * h)
+    const hhh = mod(hh * h)
+    const x = mod(r * r - hhh - TWO * u1 * hh)
+    return {x, y: mod(r * (u1 * hh - x) - s1 * hhh), z: mod(h * p.z * q.z)}
+}
+
+const toJacobian = ({x, y}: AffinePoint): JacobianPoint => ({x, y, z: ONE})
+
+function toAffine(p: JacobianPoint): AffinePoint | null {
+    if (p === null) return null
+    const zInv = modInverse(p.z, P)
+    const zInv2 = mod(zInv * zInv)
+    return {x: mod(p.x * zInv2), y: mod(p.y * zInv2 * zInv)}
+}
+
+// a * A + b * B with a single pass over the bits of the scalars (Shamir's trick)
+function multiplyAdd(a: bigint, pointA: AffinePoint, b: bigint, pointB: AffinePoint): AffinePoint | null {
+    const A = toJacobian(pointA)
+    const B = toJacobian(pointB)
+    const AB = add(A, B)
+    let result: JacobianPoint = null
+    const length = Math.max(a.toString(2).length, b.toString(2).length)
+    const bitsA = a.toString(2).padStart(length, "0")
+    const bitsB = b.toString(2).padStart(length, "0")
+    for (let i = 0; i < length; i++) {
+        result = double(result)
+        if (bitsA[i] === "1" && bitsB[i] === "1") result = add(result, AB)
+        else if (bitsA[i] === "1") result = add(result, A)
+        else if (bitsB[i] === "1") result = add(result, B)
+    }
+    return toAffine(result)
+}
+
+// the point with the x coordinate and parity of y, null if x is not on the curve
+function liftX(x: bigint, odd: boolean): AffinePoint | null {
+    if (x >= P) return null
+    const y2 = mod(x * x * x + SEVEN)
+    // P = 3 mod 4
+    let y = modPow(y2, (P + ONE) / FOUR, P)
+    if (mod(y * y) !== y2) return null
+    if ((y & ONE) !== (odd ? ONE : ZERO)) y = P - y
+    return {x, y}
+}
+
+/**
+ * Uncompressed public key (65 bytes) of the key which made the signature of the hash,
+ * null if the signature is invalid. The signature is in the format of the device:
+ * recovery byte (27 + 4 + recovery id), r and s.
+ */
+export function recoverPublicKey(hash: Buffer, signature: Buffer): Buffer | null {
+    if (hash.length !== 32 || signature.length !== 65) return null
+    const recoveryId = signature[0] - 27 - 4
+    if (recoveryId < 0 || recoveryId > 3) return null
+    const r = toBigInt(signature.slice(1, 33))
+    const s = toBigInt(signature.slice(33, 65))
+    if (r === ZERO || r >= N || s === ZERO || s >= N) return null
+
+    // R is the point of the nonce, r its x coordinate mod N
+    const R = liftX(recoveryId & 2 ? r + N : r, (recoveryId & 1) === 1)
+    if (R === null) return null
+    // Q = r^-1 (s R - e G)
+    const rInv = modInverse(r, N)
+    const e = toBigInt(hash)
+    const Q = multiplyAdd(mod(-e * rInv, N), G, mod(s * rInv, N), R)
+    if (Q === null) return null
+    return Buffer.concat([Buffer.from([0x04]), toBuf32(Q.x), toBuf32(Q.y)])
+}
+
+function base58Encode(data: Buffer): string {
+    let n = toBigInt(data)
+    let out = ""
+    while (n > ZERO) {
+        out = BASE58_ALPHABET[Number(n % BigInt(58))] + out
+        n /= BigInt(58)
+    }
+    for (let i = 0; i < data.length && data[i] === 0; i++) {
+        out = BASE58_ALPHABET[0] + out
+    }
+    return out
+}
+
+/**
+ * FIO public key ("FIO" + base58 of the compressed key and its ripemd160 checksum)
+ * of an uncompressed public key
+ */
+export function publicKeyToWIF(publicKey: Buffer): string {
+    assert(publicKey.length === 65 && publicKey[0] === 0x04, "invalid public key")
+    const compressed = Buffer.concat([Buffer.from([(publicKey[64] & 0x1) ? 0x03 : 0x02]), publicKey.slice(1, 33)])
+    const checksum = crypto.createHash("ripemd160").update(compressed).digest().slice(0, 4)
+    return "FIO" + base58Encode(Buffer.concat([compressed, checksum]))
+}
@@ -0,0 +1,77 @@
+// Measures the host CPU time of Fio.signTransaction, without the device: every sample
+// transaction is signed once on the simulator and recorded, then signed again and again on
+// the replay of the recording, so only the host side (parsing, templates, APDU framing and
+// the responses) is measured.
+//
+// Usage: benchSign.ts [-t <min_seconds>]
+// Runs every sample for at least min_seconds (default 0.2).
+
+import type { SignTransactionRequest, Transcript } from "../src/fio"
+import { Fio, HARDENED, RecordingTransport, ReplayTransport, SimulatorTransport } from "../src/fio"
+import { CHAIN_ID_TESTNET, SAMPLES, sampleTransaction } from "./samples"
+
+const PATH = [44 + HARDENED, 235 + HARDENED, 0 + HARDENED, 0, 0]
+const BATCH = 100
+
+type Result = { name: string, apdus: number, count: number, cpuUs: number }
+
+async function bench(name: string, request: SignTransactionRequest, minSeconds: number): Promise<Result> {
+    // the app info is fetched once by every Fio, only the signing is replayed
+    const recording = new RecordingTransport(new SimulatorTransport())
+    const recordingFio = new Fio(recording)
+    await recordingFio.getAppInfo()
+    const appInfo = recording.transcript.slice()
+    await recordingFio.signTransaction(request)
+    const sign = recording.transcript.slice(appInfo.length)
+
+    const transcript: Transcript = [...appInfo]
+    for (let i = 0; i < BATCH; i++) transcript.push(...sign)
+    const batch = async (): Promise<number> => {
+        const fio = new Fio(new ReplayTransport(transcript))
+        await fio.getAppInfo()
+        const start = process.cpuUsage()
+        for (let i = 0; i < BATCH; i++) {
+            await fio.signTransaction(request)
+        }
+        const { user, system } = process.cpuUsage(start)
+        return user + system
+    }
+
+    // the first batch warms up the JIT
+    await batch()
+    let count = 0
+    let cpuUs = 0
+    while (cpuUs < minSeconds * 1e6) {
+        cpuUs += await batch()
+        count += BATCH
+    }
+    return { name, apdus: sign.length, count, cpuUs }
+}
+
+async function main(args: Array<string>): Promise<number> {
+    const minSeconds = args[0] === "-t" ? Number(args[1]) : 0.2
+    if (!(minSeconds > 0) || args.length !== (args[0] === "-t" ? 2 : 0)) {
+        console.error("Usage: benchSign.ts [-t <min_seconds>]")
+        return 2
+    }
+
+    const results: Array<Result> = []
+    for (const sample of SAMPLES) {
+        const tx = sampleTransaction(sample, sample.data)
+        results.push(await bench(`${sample.account}::${sample.name}`, { path: PATH, chainId: CHAIN_ID_TESTNET, tx }, minSeconds))
+    }
+
+    for (const { name, apdus, count, cpuUs } of results) {
+        console.log(`${name.padEnd(32)} ${String(apdus).padStart(3)} APDUs ${(cpuUs / count).toFixed(1).padStart(8)} us/tx`)
+    }
+    const total = results.reduce((sum, { cpuUs, count }) => sum + cpuUs / count, 0)
+    console.log(`mean ${(total / results.length).toFixed(1)} us/tx of host CPU`)
+    return 0
+}
+
+main(process.argv.slice(2)).then(code => {
+    process.exitCode = code
+}, e => {
+    console.error(e)
+    process.exitCode = 1
+})
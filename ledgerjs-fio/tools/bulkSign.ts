@@ -0,0 +1,268 @@
+// Signs the transactions of a JSONL file (or stdin) on one device and writes the results as JSONL.
+// The input is streamed: every transaction is validated and serialized on the host while the
+// device signs the previous one (Fio.prepareTransaction), so the device does not wait for the
+// host between transactions. An interrupted run is resumed from its checkpoint.
+//
+// Usage: bulkSign.ts [options] [<input.jsonl>]
+//   --transport <transport>  hid (default), speculos[:<APDU port>] or simulator
+//   --output <file>          results, one JSON per line (default stdout)
+//   --checkpoint <file>      progress of the run, the run is resumed from it if it exists
+//   --chain-id <hex>         chain id of the lines without chainId
+//   --path <path>            signing path of the lines without path (default 44'/235'/0'/0/0)
+//   --progress <seconds>     interval of the progress reports on stderr (default 5, 0 disables)
+//
+// Input line: {"id"?, "path"?, "chainId"?, "tx"} (path as "44'/235'/0'/0/0" or an array), or the
+// transaction alone. Output line: {"line", "id"?, "txHashHex", "dhEncryptedData", "witness"}, or
+// {"line", "id"?, "error"} if the transaction was rejected by the host, the app or the user.
+// Failures of the device or the transport stop the run with exit code 1, running the same
+// command again continues after the last written result.
+
+import type Transport from "@ledgerhq/hw-transport"
+import * as fs from "fs"
+import * as readline from "readline"
+
+import type { BIP32Path, PreparedTransaction, SignTransactionRequest, SignTransactionResponse, Transaction } from "../src/fio"
+import { Fio, HistogramObserver, isDeviceFailure, SimulatorTransport } from "../src/fio"
+import { startTimer } from "../src/metrics/observer"
+import { str_to_path } from "../src/utils/address"
+
+type Options = {
+    transport: string
+    input?: string
+    output?: string
+    checkpoint?: string
+    chainId?: string
+    path: string
+    progressSeconds: number
+}
+
+// The first lines of the input are done and their results are the first outputBytes of the output
+type Checkpoint = {
+    lines: number
+    outputBytes: number
+    signed: number
+    failed: number
+}
+
+type Job = {
+    line: number
+    id: unknown
+    prepared: PreparedTransaction | null
+    error: string | null
+    hostNs: number
+}
+
+type InputLine = {
+    id?: unknown
+    path?: string | BIP32Path
+    chainId?: string
+    tx?: Transaction
+}
+
+const USAGE = "Usage: bulkSign.ts [--transport hid|speculos[:<port>]|simulator] [--output <file>] [--checkpoint <file>]"
+    + " [--chain-id <hex>] [--path <path>] [--progress <seconds>] [<input.jsonl>]"
+
+function parseArgs(args: Array<string>): Options | null {
+    const options: Options = { transport: "hid", path: "44'/235'/0'/0/0", progressSeconds: 5 }
+    for (let i = 0; i < args.length; i++) {
+        const arg = args[i]
+        if (!arg.startsWith("--")) {
+            if (options.input !== undefined) return null
+            options.input = arg
+            continue
+        }
+        const value = args[++i]
+        if (value === undefined) return null
+        switch (arg) {
+        case "--transport": options.transport = value; break
+        case "--output": options.output = value; break
+        case "--checkpoint": options.checkpoint = value; break
+        case "--chain-id": options.chainId = value; break
+        case "--path": options.path = value; break
+        case "--progress": options.progressSeconds = Number(value); break
+        default: return null
+        }
+    }
+    // the checkpoint refers to the bytes of the output
+    if (options.checkpoint !== undefined && options.output === undefined) return null
+    return options
+}
+
+// The transports are loaded only when used, node-hid needs the native USB module
+async function openTransport(transport: string): Promise<Transport<string>> {
+    const [kind, port] = transport.split(":")
+    switch (kind) {
+    case "hid": return await (await import("@ledgerhq/hw-transport-node-hid")).default.create(5000)
+    case "speculos": return await (await import("@ledgerhq/hw-transport-node-speculos")).default.open({ apduPort: parseInt(port ?? "40000") })
+    case "simulator": return new SimulatorTransport()
+    default: throw new Error(`unknown transport ${transport}`)
+    }
+}
+
+const describe = (e: unknown): string => e instanceof Error ? `${e.name}: ${e.message}` : String(e)
+
+function toRequest(entry: InputLine, options: Options): SignTransactionRequest {
+    const path = entry.path ?? options.path
+    const chainId = entry.chainId ?? options.chainId
+    if (chainId === undefined) throw new Error("no chainId and no --chain-id")
+    return {
+        path: typeof path === "string" ? str_to_path(path) : path,
+        chainId,
+        tx: entry.tx ?? entry as Transaction,
+    }
+}
+
+function prepare(fio: Fio, line: number, text: string, options: Options): Job {
+    const elapsedNs = startTimer()
+    let id: unknown = undefined
+    try {
+        const entry = JSON.parse(text) as InputLine
+        id = entry.id
+        const prepared = fio.prepareTransaction(toRequest(entry, options))
+        return { line, id, prepared, error: null, hostNs: elapsedNs() }
+    } catch (e) {
+        return { line, id, prepared: null, error: describe(e), hostNs: elapsedNs() }
+    }
+}
+
+// The jobs of the input lines after the skipped ones, each prepared when it is requested
+async function* readJobs(fio: Fio, lines: AsyncIterable<string>, skip: number, options: Options): AsyncGenerator<Job> {
+    let line = 0
+    for await (const text of lines) {
+        line++
+        if (line <= skip || text.trim() === "") continue
+        yield prepare(fio, line, text, options)
+    }
+}
+
+function readCheckpoint(file: string | undefined): Checkpoint {
+    if (file === undefined || !fs.existsSync(file)) return { lines: 0, outputBytes: 0, signed: 0, failed: 0 }
+    return JSON.parse(fs.readFileSync(file, "utf-8")) as Checkpoint
+}
+
+function writeCheckpoint(file: string, checkpoint: Checkpoint): void {
+    fs.writeFileSync(file + ".tmp", JSON.stringify(checkpoint))
+    fs.renameSync(file + ".tmp", file)
+}
+
+type Output = { write: (text: string) => void, close: () => void }
+
+// The output without the results written after the checkpoint, opened for appending
+function openOutput(file: string | undefined, checkpoint: Checkpoint): Output {
+    if (file === undefined) return { write: text => process.stdout.write(text), close: () => undefined }
+    if (checkpoint.lines > 0) {
+        if (!fs.existsSync(file) || fs.statSync(file).size < checkpoint.outputBytes) {
+            throw new Error(`${file} is shorter than in the checkpoint`)
+        }
+        fs.truncateSync(file, checkpoint.outputBytes)
+    }
+    const fd = fs.openSync(file, checkpoint.lines > 0 ? "a" : "w")
+    return { write: text => fs.writeSync(fd, text), close: () => fs.closeSync(fd) }
+}
+
+class Progress {
+    private readonly checkpoint: Checkpoint
+    private readonly elapsedNs = startTimer()
+    private hostNs = 0
+    private count = 0
+    private lastCount = 0
+    private lastNs = 0
+
+    constructor(checkpoint: Checkpoint) {
+        this.checkpoint = checkpoint
+    }
+
+    add(job: Job): void {
+        this.hostNs += job.hostNs
+        this.count++
+    }
+
+    report(): string {
+        const ns = this.elapsedNs()
+        const rate = (count: number, ns: number) => ns > 0 ? (count * 1e9 / ns).toFixed(1) : "0.0"
+        const { lines, signed, failed } = this.checkpoint
+        const text = `${(ns / 1e9).toFixed(1)} s: line ${lines}, ${signed} signed, ${failed} failed, `
+            + `${rate(this.count, ns)} tx/s (last ${rate(this.count - this.lastCount, ns - this.lastNs)}), `
+            + `host ${this.count > 0 ? (this.hostNs / this.count / 1e6).toFixed(2) : "0.00"} ms/tx`
+        this.lastCount = this.count
+        this.lastNs = ns
+        return text
+    }
+}
+
+async function run(options: Options): Promise<number> {
+    const checkpoint = readCheckpoint(options.checkpoint)
+    const output = openOutput(options.output, checkpoint)
+    const fio = new Fio(await openTransport(options.transport))
+    const metrics = new HistogramObserver()
+    fio.setObserver(metrics)
+
+    const input = options.input !== undefined ? fs.createReadStream(options.input) : process.stdin
+    const lines = readline.createInterface({ input, crlfDelay: Infinity })
+    const jobs = readJobs(fio, lines, checkpoint.lines, options)
+    const progress = new Progress(checkpoint)
+    const timer = options.progressSeconds > 0
+        ? setInterval(() => console.error(progress.report()), options.progressSeconds * 1000)
+        : null
+
+    let exitCode = 0
+    try {
+        let next = jobs.next()
+        for (;;) {
+            const step = await next
+            if (step.done) break
+            const job = step.value
+            // double buffering: the next line is parsed and serialized while the device signs this one
+            next = jobs.next()
+
+            let result: { line: number, id?: unknown, error?: string } & Partial<SignTransactionResponse>
+            if (job.prepared !== null) {
+                try {
+                    result = { line: job.line, id: job.id, ...await fio.signPreparedTransaction(job.prepared) }
+                } catch (e) {
+                    if (isDeviceFailure(e)) throw e
+                    result = { line: job.line, id: job.id, error: describe(e) }
+                }
+            } else {
+                result = { line: job.line, id: job.id, error: job.error ?? "" }
+            }
+            const text = JSON.stringify(result) + "\n"
+            output.write(text)
+            progress.add(job)
+            checkpoint.lines = job.line
+            checkpoint.outputBytes += Buffer.byteLength(text)
+            if (result.error === undefined) checkpoint.signed++
+            else checkpoint.failed++
+            if (options.checkpoint !== undefined) writeCheckpoint(options.checkpoint, checkpoint)
+        }
+    } catch (e) {
+        console.error(`stopped after line ${checkpoint.lines}: ${describe(e)}`)
+        exitCode = 1
+    } finally {
+        if (timer !== null) clearInterval(timer)
+        lines.close()
+        await fio.transport.close()
+        output.close()
+    }
+
+    console.error(progress.report())
+    for (const { operation, count, latencyNs, deviceNs } of metrics.snapshot().operations) {
+        const ms = (ns: number) => (ns / 1e6).toFixed(1)
+        console.error(`${operation}: ${count} calls, latency p50 ${ms(latencyNs.p50)} ms, p99 ${ms(latencyNs.p99)} ms, `
+            + `device p50 ${ms(deviceNs.p50)} ms`)
+    }
+    return exitCode
+}
+
+const options = parseArgs(process.argv.slice(2))
+if (options === null) {
+    console.error(USAGE)
+    process.exitCode = 2
+} else {
+    run(options).then(code => {
+        process.exitCode = code
+    }, e => {
+        console.error(describe(e))
+        process.exitCode = 1
+    })
+}
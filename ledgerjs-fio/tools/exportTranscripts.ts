@@ -0,0 +1,142 @@
+// Exports the APDUs sent by signTransaction() for every supported action as binary
+// transcripts (raw APDUs one after another, the format read by native/bench_fio and
+// the fuzzing/fuzz_flow harness). The APDUs are produced by the transaction templates
+// directly, no device is needed. The "template" transcripts run the templates compiled
+// into the app (the TEMPLATE command), the others send every command.
+//
+// Next to every transcript <name>.apdu, <name>.response holds the data of the last response
+// of the simulator (the signature). bench_fio -r checks that the app core responds the same.
+//
+// Usage: exportTranscripts.ts [--check] <output dir>
+// With --check the existing transcripts and responses are compared to the generated ones
+// instead of being written (golden files), the exit code is 1 if any of them differs.
+
+import * as fs from "fs"
+import * as path from "path"
+
+import { HARDENED } from "../src/fio"
+import type { Interaction } from "../src/interactions/common/types"
+import { getVersion } from "../src/interactions/getVersion"
+import { signTransaction } from "../src/interactions/signTransaction"
+import { COMMAND } from "../src/interactions/transactionTemplates/commands"
+import { parseBIP32Path, parseHexString, parseTransaction } from "../src/utils/parse"
+import { InvalidDataReason } from "../src/errors"
+import { SimulatedDevice } from "../src/simulator"
+import type { Sample } from "./samples"
+import { CHAIN_ID_MAINNET, CHAIN_ID_TESTNET, MAX_AMOUNT, SAMPLES, sampleTransaction } from "./samples"
+
+const CLA = 0xd7
+// version of the app the transcripts are generated for
+const VERSION = { major: 1, minor: 0, patch: 8, flags: { isDebug: false } }
+
+type Variant = {
+    name: string
+    chainId: string
+    address: number
+    templates?: boolean
+    data: (sample: Sample) => Record<string, unknown>
+}
+
+const VARIANTS: Array<Variant> = [
+    { name: "testnet", chainId: CHAIN_ID_TESTNET, address: 0, data: sample => sample.data },
+    { name: "mainnet", chainId: CHAIN_ID_MAINNET, address: 0, data: sample => sample.data },
+    // extreme values: other key, empty tpid, maximal amounts and the largest arrays
+    { name: "alt", chainId: CHAIN_ID_TESTNET, address: 2000, data: sample => {
+        const data: Record<string, unknown> = { ...sample.data, max_fee: MAX_AMOUNT, ...sample.alt }
+        if ("tpid" in data) data.tpid = ""
+        for (const key of Object.keys(data)) {
+            if (data[key] === undefined) delete data[key]
+        }
+        return data
+    } },
+    { name: "template", chainId: CHAIN_ID_TESTNET, address: 0, templates: true, data: sample => sample.data },
+]
+
+// Runs the interaction answering every APDU with zeroes and returns the APDUs sent
+function recordAPDUs<T>(interaction: Interaction<T>): Array<Buffer> {
+    const apdus: Array<Buffer> = []
+    let cursor = interaction.next()
+    while (!cursor.done) {
+        const {ins, p1, p2, data, expectedResponseLength} = cursor.value
+        apdus.push(Buffer.concat([Buffer.from([CLA, ins, p1, p2, data.length]), data]))
+        cursor = interaction.next(Buffer.alloc(expectedResponseLength ?? 0))
+    }
+    return apdus
+}
+
+// cx_rng_no_throw() of native/cx_soft.c (splitmix64) seeded as bench_fio does before every
+// transcript, so that the simulator uses the same DH initialization vectors
+function nativeRandomBytes(): (size: number) => Buffer {
+    const MASK = (1n << 64n) - 1n
+    let state = 0n
+    return (size: number) => {
+        const bytes = Buffer.alloc(size)
+        for (let offset = 0; offset < size; offset += 8) {
+            state = (state + 0x9e3779b97f4a7c15n) & MASK
+            let z = state
+            z = ((z ^ (z >> 30n)) * 0xbf58476d1ce4e5b9n) & MASK
+            z = ((z ^ (z >> 27n)) * 0x94d049bb133111ebn) & MASK
+            z ^= z >> 31n
+            for (let i = 0; i < 8 && offset + i < size; i++) {
+                bytes[offset + i] = Number((z >> BigInt(8 * i)) & 0xffn)
+            }
+        }
+        return bytes
+    }
+}
+
+// Response data of the last APDU of the transcript on the simulator
+function simulatedResponse(apdus: Buffer): Buffer {
+    const device = new SimulatedDevice({ version: VERSION, randomBytes: nativeRandomBytes() })
+    let response = Buffer.alloc(0)
+    for (let offset = 0; offset < apdus.length; offset += 5 + apdus[offset + 4]) {
+        response = device.exchange(apdus.subarray(offset, offset + 5 + apdus[offset + 4]))
+        const sw = response.readUInt16BE(response.length - 2)
+        if (sw !== 0x9000) throw new Error(`APDU at offset ${offset} failed with status 0x${sw.toString(16)}`)
+    }
+    return response.subarray(0, response.length - 2)
+}
+
+function transcript(sample: Sample, variant: Variant): Buffer {
+    const tx = sampleTransaction(sample, variant.data(sample))
+    const parsedChainId = parseHexString(variant.chainId, InvalidDataReason.INVALID_CHAIN_ID)
+    const parsedPath = parseBIP32Path([44 + HARDENED, 235 + HARDENED, 0 + HARDENED, 0, variant.address], InvalidDataReason.INVALID_PATH)
+    const parsedTx = parseTransaction(parsedChainId, tx)
+
+    // the same sequence as Fio.signTransaction()
+    const apdus = recordAPDUs(getVersion())
+    const signTransactionCommands = variant.templates ? [COMMAND.TEMPLATE] : null
+    apdus.push(...recordAPDUs(signTransaction(VERSION, parsedPath, parsedChainId, parsedTx, signTransactionCommands)))
+    return Buffer.concat(apdus)
+}
+
+function main(args: Array<string>): number {
+    const check = args[0] === "--check"
+    const outDir = check ? args[1] : args[0]
+    if (outDir === undefined) {
+        console.error("Usage: exportTranscripts.ts [--check] <output dir>")
+        return 2
+    }
+    if (!check) fs.mkdirSync(outDir, { recursive: true })
+
+    let mismatches = 0
+    for (const sample of SAMPLES) {
+        for (const variant of VARIANTS) {
+            const file = path.join(outDir, `${sample.name}_${variant.name}`)
+            const data = transcript(sample, variant)
+            const outputs = [[`${file}.apdu`, data], [`${file}.response`, simulatedResponse(data)]] as const
+            for (const [outFile, outData] of outputs) {
+                if (!check) {
+                    fs.writeFileSync(outFile, outData)
+                } else if (!fs.existsSync(outFile) || !fs.readFileSync(outFile).equals(outData)) {
+                    console.error(`${outFile}: differs from the generated one`)
+                    mismatches++
+                }
+            }
+        }
+    }
+    console.log(`${SAMPLES.length * VARIANTS.length} transcripts ${check ? "checked" : "written"}, ${mismatches} mismatches`)
+    return mismatches === 0 ? 0 : 1
+}
+
+process.exitCode = main(process.argv.slice(2))
@@ -0,0 +1,355 @@
+// Generates the integrity hashes accepted by the release build of the app from the transaction
+// templates: the hash chain of the commands of every template alternative (e.g. every number of
+// addresses) is computed the same way as on the device and written to the allowedHashes table
+// of src/signTransactionIntegrity.c and to ALLOWED_HASHES of the library, which checks the
+// transactions before they are sent. The DEVEL hashes of the command tests are kept as they are.
+//
+// The templates compiled into the app (src/signTransactionTemplates.c) and into the library
+// (src/interactions/transactionTemplates/appTemplates.ts) are written as well, one program for
+// every action: the alternatives of a sample which differ in the number of items become a
+// counted loop (the keys which differ by the item number are indexed steps), the others a
+// choice of alternatives. Every alternative is checked to be a run of the program. The constant
+// part of every command is written once in a pool of steps.
+//
+// Usage: integrityHashes.ts [--check] <signTransactionIntegrity.c> <allowedHashes.ts>
+//                           <signTransactionTemplates.c> <appTemplates.ts>
+// With --check the tables in the files are compared to the generated ones instead of being
+// written, the exit code is 1 if any of them differs.
+
+import * as fs from "fs"
+
+import { HARDENED } from "../src/fio"
+import type { Command } from "../src/interactions/transactionTemplates/commands"
+import { integrityHashes } from "../src/interactions/transactionTemplates/integrity"
+import type { TemplateStep } from "../src/interactions/transactionTemplates/appTemplates"
+import {
+    expandTemplateProgram, parseTemplateStep, TEMPLATE_OP, templateParameterRange, templateProgramId,
+} from "../src/interactions/transactionTemplates/appTemplates"
+import { templete_all } from "../src/interactions/transactionTemplates/template_all"
+import { parseBIP32Path, parseHexString, parseTransaction } from "../src/utils/parse"
+import { InvalidDataReason } from "../src/errors"
+import { CHAIN_ID_TESTNET, SAMPLES, sampleTransaction } from "./samples"
+
+type Entry = { label: string, hash: string }
+type Step = { label: string, data: Buffer }
+type Op =
+    | { op: TEMPLATE_OP.STEP | TEMPLATE_OP.STEP_INDEXED, step: TemplateStep }
+    | { op: TEMPLATE_OP.COUNT, min: number, max: number }
+    | { op: TEMPLATE_OP.APPEND_COUNT }
+    | { op: TEMPLATE_OP.LOOP, body: Array<Op> }
+    | { op: TEMPLATE_OP.CHOICE, alternatives: Array<Array<Op>> }
+type Template = { label: string, id: string, program: Buffer, text: Array<string> }
+type Generated = { entries: Array<Entry>, steps: Array<Step>, templates: Array<Template> }
+
+// TX_TEMPLATE_MAX_INDEXED_STEP_LENGTH of src/signTransactionTemplates.h
+const MAX_INDEXED_STEP_LENGTH = 32
+
+const COMMAND_NAMES: Record<number, string> = {
+    0x01: "INIT", 0x02: "APPEND_CONST_DATA", 0x03: "SHOW_MESSAGE", 0x04: "APPEND_DATA",
+    0x05: "START_COUNTED_SECTION", 0x06: "END_COUNTED_SECTION", 0x07: "STORE_VALUE",
+    0x08: "START_DH_ENCRYPTION", 0x09: "END_DH_ENCRYPTION", 0x10: "FINISH",
+}
+
+function stepLabel({ p1, p2, constData }: TemplateStep): string {
+    const name = COMMAND_NAMES[p1]
+    switch (name) {
+    case "APPEND_CONST_DATA": return `${name} ${constData.length} bytes`
+    case "SHOW_MESSAGE": return `${name} "${constData.slice(1, 1 + constData[0]).toString()}"`
+    case "APPEND_DATA": return `${name} "${constData.slice(20).toString()}"`
+    case "STORE_VALUE": return `${name} R${p2}`
+    default: return name
+    }
+}
+
+const stepOf = ({ command, p2, constData }: Command): TemplateStep => ({ p1: command, p2, constData })
+const stepData = ({ p1, p2, constData }: TemplateStep): Buffer => Buffer.concat([Buffer.from([p1, p2, constData.length]), constData])
+const sameStep = (a: TemplateStep | null, b: TemplateStep | null): boolean =>
+    a !== null && b !== null && stepData(a).equals(stepData(b))
+const stepOps = (steps: Array<TemplateStep>): Array<Op> => steps.map(step => ({ op: TEMPLATE_OP.STEP, step }))
+
+// The step of the first iteration of a loop without the iteration at the end of its key
+function unindexStep(step: TemplateStep): TemplateStep {
+    const offset = step.p1 === 0x04 ? 19 : step.p1 === 0x03 ? 0 : -1
+    const keyEnd = offset + 1 + step.constData[offset]
+    if (offset < 0 || step.constData[keyEnd - 1] !== "1".charCodeAt(0)) {
+        throw new Error(`${stepLabel(step)} differs in the iterations of a loop`)
+    }
+    const constData = Buffer.concat([step.constData.slice(0, keyEnd - 1), step.constData.slice(keyEnd)])
+    constData[offset]--
+    return { p1: step.p1, p2: step.p2, constData }
+}
+
+// The program running the command sequences of all the alternatives of a sample
+function compileProgram(label: string, sequences: Array<Array<TemplateStep>>): Array<Op> {
+    const first = sequences[0]
+    if (sequences.length === 1) return stepOps(first)
+    let prefix = 0
+    while (sequences.every(steps => sameStep(steps[prefix], first[prefix]))) prefix++
+
+    if (sequences.every(steps => steps.length === first.length)) {
+        // the same number of commands, some of them differ
+        let suffix = 0
+        while (sequences.every(steps => sameStep(steps[steps.length - 1 - suffix], first[first.length - 1 - suffix]))) suffix++
+        return [
+            ...stepOps(first.slice(0, prefix)),
+            { op: TEMPLATE_OP.CHOICE, alternatives: sequences.map(steps => stepOps(steps.slice(prefix, steps.length - suffix))) },
+            ...stepOps(first.slice(first.length - suffix)),
+        ]
+    }
+
+    // the number of items (APPEND_CONST_DATA of one byte), then the commands of every item
+    const counts = sequences.map(steps => {
+        const count = steps[prefix]
+        if (count.p1 !== 0x02 || count.constData.length !== 1) throw new Error(`${label}: the alternatives are not counted`)
+        return count.constData[0]
+    })
+    const bodyLength = (sequences[1].length - first.length) / (counts[1] - counts[0])
+    const last = sequences[sequences.length - 1]
+    const body = last.slice(prefix + 1, prefix + 1 + bodyLength).map((step, i) =>
+        sameStep(step, last[prefix + 1 + bodyLength + i]) ? { op: TEMPLATE_OP.STEP, step } as Op
+            : { op: TEMPLATE_OP.STEP_INDEXED, step: unindexStep(step) } as Op)
+    // the app appends the count as one byte and the indexed steps are built in a buffer of the cursor
+    const max = Math.max(...counts)
+    if (max > 127) throw new Error(`${label}: count does not fit one byte`)
+    body.forEach(op => {
+        if (op.op === TEMPLATE_OP.STEP_INDEXED && op.step.constData.length + String(max).length > MAX_INDEXED_STEP_LENGTH) {
+            throw new Error(`${label}: ${stepLabel(op.step)} too long to index`)
+        }
+    })
+    return [
+        ...stepOps(first.slice(0, prefix)),
+        { op: TEMPLATE_OP.COUNT, min: Math.min(...counts), max },
+        { op: TEMPLATE_OP.APPEND_COUNT },
+        { op: TEMPLATE_OP.LOOP, body },
+        ...stepOps(first.slice(prefix + 1 + counts[0] * bodyLength)),
+    ]
+}
+
+// The program as bytes and as the initializer of the C array, the steps added to the pool
+function encodeProgram(ops: Array<Op>, stepIndex: (step: TemplateStep) => number): { program: Array<number>, text: Array<string> } {
+    const program: Array<number> = []
+    const text: Array<string> = []
+    for (const op of ops) {
+        switch (op.op) {
+        case TEMPLATE_OP.STEP:
+        case TEMPLATE_OP.STEP_INDEXED: {
+            const index = stepIndex(op.step)
+            program.push(op.op, index)
+            text.push(`${op.op === TEMPLATE_OP.STEP ? "STEP" : "STEP_INDEXED"}(${index})`)
+            break
+        }
+        case TEMPLATE_OP.COUNT:
+            program.push(op.op, op.min, op.max)
+            text.push(`COUNT(${op.min}, ${op.max})`)
+            break
+        case TEMPLATE_OP.APPEND_COUNT:
+            program.push(op.op)
+            text.push("APPEND_COUNT")
+            break
+        case TEMPLATE_OP.LOOP: {
+            const body = encodeProgram(op.body, stepIndex)
+            program.push(op.op, body.program.length, ...body.program)
+            text.push(`LOOP(${body.program.length})`, ...body.text)
+            break
+        }
+        case TEMPLATE_OP.CHOICE: {
+            const alternatives = op.alternatives.map(alternative => encodeProgram(alternative, stepIndex))
+            const length = alternatives[0].program.length
+            if (alternatives.some(({ program }) => program.length !== length)) throw new Error("alternatives of different lengths")
+            program.push(op.op, alternatives.length, length, ...alternatives.flatMap(({ program }) => program))
+            text.push(`CHOICE(${alternatives.length}, ${length})`, ...alternatives.flatMap(({ text }) => text))
+            break
+        }
+        }
+    }
+    return { program, text }
+}
+
+// The checked hashes of every sample and its alternatives, each hash once, and the template
+// programs of the samples
+function generate(): Generated {
+    // the chain id and the path are variable data, they do not change the hashes
+    const parsedChainId = parseHexString(CHAIN_ID_TESTNET, InvalidDataReason.INVALID_CHAIN_ID)
+    const parsedPath = parseBIP32Path([44 + HARDENED, 235 + HARDENED, 0 + HARDENED, 0, 0], InvalidDataReason.INVALID_PATH)
+
+    const entries = new Map<string, string>()
+    const steps = new Map<string, Step & { index: number }>()
+    const stepIndex = (step: TemplateStep): number => {
+        const data = stepData(step)
+        const key = data.toString("hex")
+        let entry = steps.get(key)
+        if (entry === undefined) {
+            entry = { label: stepLabel(step), data, index: steps.size }
+            steps.set(key, entry)
+        }
+        return entry.index
+    }
+    const templates: Array<Template> = []
+    const sampleSequences: Array<Array<Array<TemplateStep>>> = []
+    for (const sample of SAMPLES) {
+        const sequences: Array<Array<TemplateStep>> = []
+        for (const alternative of sample.alternatives ?? [{ label: "", data: {} }]) {
+            const tx = sampleTransaction(sample, { ...sample.data, ...alternative.data })
+            const commands = templete_all(parsedChainId, parseTransaction(parsedChainId, tx), parsedPath)
+            const hashes = integrityHashes(commands)
+            const label = alternative.label === "" ? sample.name : `${sample.name}, ${alternative.label}`
+            hashes.forEach((hash, i) => {
+                const step = hashes.length === 1 ? "" : i === hashes.length - 1 ? " (FINISH step)" : " (DH step)"
+                if (!entries.has(hash)) entries.set(hash, label + step)
+            })
+            sequences.push(commands.map(stepOf))
+        }
+
+        const { program, text } = encodeProgram(compileProgram(sample.name, sequences), stepIndex)
+        if (program.length > 255) throw new Error(`${sample.name}: program too long`)
+        templates.push({ label: sample.name, id: "", program: Buffer.from(program), text })
+        sampleSequences.push(sequences)
+    }
+
+    // the app looks the templates up by the ID and the steps by one byte indices
+    if (steps.size > 256) throw new Error("too many template steps")
+    const stepHexes = [...steps.keys()]
+    const stepPool = stepHexes.map(parseTemplateStep)
+    for (const template of templates) {
+        template.id = templateProgramId(template.program, stepHexes).toString("hex")
+    }
+    if (new Set(templates.map(({ id }) => id)).size !== templates.length) throw new Error("template IDs are not unique")
+    templates.forEach((template, i) => checkTemplate(template, stepPool, sampleSequences[i]))
+    return {
+        entries: [...entries].map(([hash, label]) => ({ label, hash })),
+        steps: [...steps.values()].map(({ label, data }) => ({ label, data })),
+        templates,
+    }
+}
+
+// The runs of every template (with every value of its parameter) are exactly the command
+// sequences of the alternatives of its sample
+function checkTemplate({ label, program }: Template, stepPool: Array<TemplateStep>, sequences: Array<Array<TemplateStep>>): void {
+    const range = templateParameterRange(program) ?? { min: 0, max: 0 }
+    const runs = new Set<string>()
+    for (let parameter = range.min; parameter <= range.max; parameter++) {
+        const steps = expandTemplateProgram(program, stepPool, parameter).filter((step): step is TemplateStep => step !== null)
+        runs.add(steps.map(step => stepData(step).toString("hex")).join())
+    }
+    const alternatives = new Set(sequences.map(steps => steps.map(step => stepData(step).toString("hex")).join()))
+    if (runs.size !== alternatives.size || [...runs].some(run => !alternatives.has(run))) {
+        throw new Error(`${label}: the runs of the template are not the alternatives of the sample`)
+    }
+}
+
+// The items wrapped into lines of at most 100 characters, as by clang-format
+function wrap(items: Array<string>): string {
+    const lines: Array<string> = []
+    let line = "   "
+    for (const item of items) {
+        if (line.length + 1 + item.length + 1 > 100) {
+            lines.push(line + "\n")
+            line = "   "
+        }
+        line += ` ${item},`
+    }
+    return lines.join("") + line + "\n"
+}
+
+const hexBytes = (data: Buffer): Array<string> => [...data].map(byte => `0x${byte.toString(16).padStart(2, "0")}`)
+
+// The entries as the initializer of the C array, formatted as by clang-format
+function cTable(entries: Array<Entry>): string {
+    return entries.map(({ label, hash }, i) => {
+        const bytes = hash.match(/../g)?.map(byte => `0x${byte}`) ?? []
+        const rows = [bytes.slice(0, 11), bytes.slice(11, 22), bytes.slice(22)].map(row => row.join(", "))
+        const last = i === entries.length - 1
+        return `    // ${label}\n    {${rows.join(",\n     ")}}${last ? "" : ","}\n`
+    }).join("")
+}
+
+function tsTable(entries: Array<Entry>): string {
+    return entries.map(({ label, hash }) => `    // ${label}\n    "${hash}",\n`).join("")
+}
+
+function cStepData(steps: Array<Step>): string {
+    return steps.map(({ label, data }, i) => `    // ${i}: ${label}\n${wrap(hexBytes(data))}`).join("")
+}
+
+function cStepOffsets(steps: Array<Step>): string {
+    const offsets: Array<string> = []
+    let offset = 0
+    for (const { data } of steps) {
+        offsets.push(String(offset))
+        offset += data.length
+    }
+    if (offset > 0xffff) throw new Error("template steps too large")
+    return wrap(offsets)
+}
+
+function cTemplatePrograms(templates: Array<Template>): string {
+    return templates.map(({ label, text }) => `    // ${label}\n${wrap(text)}`).join("")
+}
+
+function cTemplates(templates: Array<Template>): string {
+    let start = 0
+    return templates.map(({ label, id, program }) => {
+        const entry = `    // ${label}\n    {{${hexBytes(Buffer.from(id, "hex")).join(", ")}}, ${start}, ${program.length}},\n`
+        start += program.length
+        return entry
+    }).join("")
+}
+
+function tsTemplateSteps(steps: Array<Step>): string {
+    return steps.map(({ label, data }, i) => `    // ${i}: ${label}\n    "${data.toString("hex")}",\n`).join("")
+}
+
+function tsTemplates(templates: Array<Template>): string {
+    return templates.map(({ label, id, program }) => `    // ${label}\n    ["${id}", "${program.toString("hex")}"],\n`).join("")
+}
+
+// Replaces the text between the start and the end marker following the anchor
+function replaceBetween(text: string, anchor: string, start: string, end: string, replacement: string): string {
+    const from = text.indexOf(start, text.indexOf(anchor))
+    const to = from < 0 ? -1 : text.indexOf(end, from + start.length)
+    if (text.indexOf(anchor) < 0 || to < 0) throw new Error(`${anchor} not found`)
+    return text.slice(0, from + start.length) + replacement + text.slice(to)
+}
+
+function main(args: Array<string>): number {
+    const check = args[0] === "--check"
+    const [cFile, tsFile, cTemplatesFile, tsTemplatesFile] = check ? args.slice(1) : args
+    if (cFile === undefined || tsFile === undefined || cTemplatesFile === undefined || tsTemplatesFile === undefined) {
+        console.error("Usage: integrityHashes.ts [--check] <signTransactionIntegrity.c> <allowedHashes.ts>"
+            + " <signTransactionTemplates.c> <appTemplates.ts>")
+        return 2
+    }
+
+    const { entries, steps, templates } = generate()
+    const files: Array<[string, (text: string) => string]> = [
+        [cFile, text => replaceBetween(text, "allowedHashes[][SHA_256_SIZE]", "#endif\n", "};", cTable(entries))],
+        [tsFile, text => replaceBetween(text, "ALLOWED_HASHES:", "[\n", "]", tsTable(entries))],
+        [cTemplatesFile, text => [
+            (text: string) => replaceBetween(text, "templateStepData[]", "{\n", "};", cStepData(steps)),
+            (text: string) => replaceBetween(text, "templateStepOffsets[]", "{\n", "};", cStepOffsets(steps)),
+            (text: string) => replaceBetween(text, "templatePrograms[]", "{\n", "};", cTemplatePrograms(templates)),
+            (text: string) => replaceBetween(text, "templates[]", "{\n", "};", cTemplates(templates)),
+        ].reduce((text, update) => update(text), text)],
+        [tsTemplatesFile, text => [
+            (text: string) => replaceBetween(text, "TEMPLATE_STEPS:", "[\n", "]\n", tsTemplateSteps(steps)),
+            (text: string) => replaceBetween(text, "TEMPLATES:", "[\n", "]\n", tsTemplates(templates)),
+        ].reduce((text, update) => update(text), text)],
+    ]
+
+    let mismatches = 0
+    for (const [file, update] of files) {
+        const text = fs.readFileSync(file, "utf-8")
+        const updated = update(text)
+        if (!check) {
+            fs.writeFileSync(file, updated)
+        } else if (updated !== text) {
+            console.error(`${file}: differs from the generated integrity hashes`)
+            mismatches++
+        }
+    }
+    console.log(`${entries.length} integrity hashes and ${templates.length} templates of ${steps.length} steps `
+        + `${check ? "checked" : "written"}, ${mismatches} mismatches`)
+    return mismatches === 0 ? 0 : 1
+}
+
+process.exitCode = main(process.argv.slice(2))
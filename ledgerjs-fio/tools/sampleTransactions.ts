@@ -0,0 +1,23 @@
+// Writes sample transactions of every supported action to stdout as the input of bulkSign.ts
+// (one JSON per line), e.g. for load tests on speculos or the simulator.
+//
+// Usage: sampleTransactions.ts <count>
+
+import { CHAIN_ID_TESTNET, SAMPLES, sampleTransaction } from "./samples"
+
+function main(args: Array<string>): number {
+    const count = parseInt(args[0] ?? "")
+    if (!(count >= 0)) {
+        console.error("Usage: sampleTransactions.ts <count>")
+        return 2
+    }
+    const lines: Array<string> = []
+    for (let i = 0; i < count; i++) {
+        const sample = SAMPLES[i % SAMPLES.length]
+        lines.push(JSON.stringify({ id: i, chainId: CHAIN_ID_TESTNET, tx: sampleTransaction(sample, sample.data) }) + "\n")
+    }
+    process.stdout.write(lines.join(""))
+    return 0
+}
+
+process.exitCode = main(process.argv.slice(2))
@@ -0,0 +1,128 @@
+// Sample transactions of every supported action, shared by the tools generating data from
+// the transaction templates (APDU transcripts, integrity hashes).
+
+import type { Transaction } from "../src/types/public"
+
+export const CHAIN_ID_TESTNET = "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e"
+export const CHAIN_ID_MAINNET = "21dcae42c0182200e93f954a074011f9048a7624c6fe81d3c9541a614a88bd1c"
+// largest amount accepted by the app (VALUE_VALIDATION_NUMBER bound of the templates)
+export const MAX_AMOUNT = "9223372036854775807"
+const OTHER_PUBLIC_KEY = "0484e52dfea57b8f1787488a356374cd8e8515b8ad8db3dd4f9088d8e42ed2fb6d571e8894cccbdbf15e1bd84f8b4362f52d1b5b712b9775c0a51cdd5ee9a9e8ca"
+const FIO_PUBLIC_KEY = "FIO8PRe4WRZJj5mkem6qVGKyvNFgPsNnjNN6kPhh6EaCpzCVin5Jj"
+const ACTOR = "aftyershcu22"
+
+export type Sample = {
+    account: string
+    name: string
+    data: Record<string, unknown>
+    // overrides of data used by the "alt" variant, in addition to the common ones
+    alt?: Record<string, unknown>
+    // overrides of data selecting every alternative of the template (e.g. the number of
+    // addresses), each of them is a different command sequence for the integrity check
+    alternatives?: Array<Alternative>
+}
+
+type Alternative = { label: string, data: Record<string, unknown> }
+
+const common = { max_fee: 0x11223344, actor: ACTOR, tpid: "rewards@wallet" }
+const dhCommon = { other_public_key: OTHER_PUBLIC_KEY, chain_code: "BTC", token_code: "BTC", amount: "amount 1000" }
+// optional DH fields of the alt variant: memo replaced by hash and offline_url
+const dhAlt = { memo: undefined, hash: "Hash of the offline data", offline_url: "https://offline.example.com/data" }
+
+const publicAddress = (i: number) => ({ chain_code: "BTC", token_code: `TOK${i}`, public_address: `Public address ${i}` })
+const nft = (i: number) => ({
+    chain_code: "ETH", contract_address: "0x123456789ABCDEF", token_id: `${i}`,
+    url: "https://nft.example.com/token", hash: "f83b5702557b1ee76d966c6bf92ae0d038cd176aaf36f86a18e2ab59e6aefa4b",
+    metadata: "Some metadata",
+})
+const smallNft = (i: number) => ({ chain_code: "ETH", contract_address: "0x123456789ABCDEF", token_id: `${i}` })
+const range = (n: number) => [...Array(n).keys()]
+// alternatives with 1 to max items
+const counts = (max: number, items: string, data: (n: number) => Record<string, unknown>): Array<Alternative> =>
+    range(max).map(i => ({ label: `${items}: ${i + 1}`, data: data(i + 1) }))
+
+export const SAMPLES: Array<Sample> = [
+    { account: "fio.token", name: "trnsfiopubky",
+        data: { payee_public_key: FIO_PUBLIC_KEY, amount: "2000", ...common },
+        alt: { amount: MAX_AMOUNT } },
+    { account: "fio.reqobt", name: "newfundsreq",
+        data: { payer_fio_address: "payer@fiotestnet", payee_fio_address: "payee@fiotestnet", ...common, ...dhCommon,
+            payee_public_address: "My payee public address", memo: "I have memo" },
+        alt: dhAlt },
+    { account: "fio.reqobt", name: "recordobt",
+        data: { fio_request_id: "42", payer_fio_address: "payer@fiotestnet", payee_fio_address: "payee@fiotestnet", ...common, ...dhCommon,
+            payer_public_address: "My payer public address", payee_public_address: "My payee public address",
+            status: "sent_to_blockchain", obt_id: "Transaction ID", memo: "I have memo" },
+        alt: dhAlt },
+    { account: "fio.reqobt", name: "cancelfndreq", data: { fio_request_id: "42", ...common } },
+    { account: "fio.reqobt", name: "rejectfndreq", data: { fio_request_id: "42", ...common } },
+    { account: "fio.address", name: "addaddress",
+        data: { fio_address: "address@fiotestnet", public_addresses: range(1).map(publicAddress), ...common },
+        alt: { public_addresses: range(5).map(publicAddress) },
+        alternatives: counts(5, "public addresses", n => ({ public_addresses: range(n).map(publicAddress) })) },
+    { account: "fio.address", name: "remaddress",
+        data: { fio_address: "address@fiotestnet", public_addresses: range(1).map(publicAddress), ...common },
+        alt: { public_addresses: range(5).map(publicAddress) },
+        alternatives: counts(5, "public addresses", n => ({ public_addresses: range(n).map(publicAddress) })) },
+    { account: "fio.address", name: "addnft",
+        data: { fio_address: "address@fiotestnet", nfts: range(1).map(nft), ...common },
+        alt: { nfts: range(3).map(nft) },
+        alternatives: counts(3, "NFTs", n => ({ nfts: range(n).map(nft) })) },
+    { account: "fio.address", name: "remnft",
+        data: { fio_address: "address@fiotestnet", nfts: range(1).map(smallNft), ...common },
+        alt: { nfts: range(3).map(smallNft) },
+        alternatives: counts(3, "NFTs", n => ({ nfts: range(n).map(smallNft) })) },
+    { account: "fio.address", name: "remalladdr", data: { fio_address: "address@fiotestnet", ...common } },
+    { account: "fio.address", name: "remallnfts", data: { fio_address: "address@fiotestnet", ...common } },
+    { account: "fio.address", name: "addbundles",
+        data: { fio_address: "address@fiotestnet", bundle_sets: 4, ...common },
+        alt: { bundle_sets: MAX_AMOUNT } },
+    { account: "fio.address", name: "regaddress",
+        data: { fio_address: "address@fiotestnet", owner_fio_public_key: FIO_PUBLIC_KEY, ...common } },
+    { account: "fio.address", name: "xferaddress",
+        data: { fio_address: "address@fiotestnet", new_owner_fio_public_key: FIO_PUBLIC_KEY, ...common } },
+    { account: "fio.address", name: "regdomain",
+        data: { fio_domain: "fiotestnet", owner_fio_public_key: FIO_PUBLIC_KEY, ...common } },
+    { account: "fio.address", name: "renewdomain", data: { fio_domain: "fiotestnet", ...common } },
+    { account: "fio.address", name: "setdomainpub",
+        data: { fio_domain: "fiotestnet", is_public: 1, ...common },
+        alt: { is_public: 0 },
+        alternatives: [{ label: "public", data: { is_public: 1 } }, { label: "not public", data: { is_public: 0 } }] },
+    { account: "fio.address", name: "xferdomain",
+        data: { fio_domain: "fiotestnet", new_owner_fio_public_key: FIO_PUBLIC_KEY, ...common } },
+    { account: "fio.staking", name: "stakefio",
+        data: { amount: "2000", fio_address: "address@fiotestnet", ...common },
+        alt: { amount: MAX_AMOUNT } },
+    { account: "fio.staking", name: "unstakefio",
+        data: { amount: "2000", fio_address: "address@fiotestnet", ...common },
+        alt: { amount: MAX_AMOUNT } },
+    { account: "eosio", name: "voteproducer",
+        data: { producers: ["producer@fiotestnet"], fio_address: "address@fiotestnet", max_fee: common.max_fee, actor: ACTOR },
+        alt: { producers: range(30).map(i => `producer${i}@fiotestnet`) },
+        alternatives: counts(30, "producers", n => ({ producers: range(n).map(i => `producer${i}@fiotestnet`) })) },
+    { account: "eosio", name: "voteproxy",
+        data: { proxy: "proxy@fiotestnet", fio_address: "address@fiotestnet", max_fee: common.max_fee, actor: ACTOR } },
+    { account: "fio.oracle", name: "wrapdomain",
+        data: { fio_domain: "fiotestnet", chain_code: "ETH", public_address: "0x123456789ABCDEF", max_oracle_fee: "2000", ...common },
+        alt: { max_oracle_fee: MAX_AMOUNT } },
+    { account: "fio.oracle", name: "wraptokens",
+        data: { amount: "2000", chain_code: "ETH", public_address: "0x123456789ABCDEF", max_oracle_fee: "2000", ...common },
+        alt: { amount: MAX_AMOUNT, max_oracle_fee: MAX_AMOUNT } },
+]
+
+// The transaction of a sample with the given action data
+export function sampleTransaction(sample: Sample, data: Record<string, unknown>): Transaction {
+    return {
+        expiration: "2021-08-28T12:50:36.686",
+        ref_block_num: 0x1122,
+        ref_block_prefix: 0x33445566,
+        context_free_actions: [],
+        actions: [{
+            account: sample.account,
+            name: sample.name,
+            authorization: [{ actor: ACTOR, permission: "active" }],
+            data: data as any,
+        }],
+        transaction_extensions: [],
+    }
+}
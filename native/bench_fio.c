@@ -0,0 +1,186 @@
+// Replays APDU transcripts against the host-native build of the app and reports
+// the average processing time per APDU.
+//
+// Usage: bench_fio [-t min_seconds] [-r] transcript.apdu...
+// With -r the data of the last response must equal <transcript>.response (the response
+// of the ledgerjs-fio simulator, written by tools/exportTranscripts.ts).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "device.h"
+#include "cx_soft.h"
+
+enum {
+    MAX_TRANSCRIPT_SIZE = 64 * 1024,
+    MAX_PATH_SIZE = 4096,
+    SW_OK = 0x9000,
+};
+
+typedef struct {
+    const char* name;
+    uint8_t data[MAX_TRANSCRIPT_SIZE];
+    size_t size;
+    size_t apduCount;
+} transcript_t;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static const char* basename_of(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static bool transcript_load(transcript_t* t, const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    t->name = basename_of(path);
+    t->size = fread(t->data, 1, sizeof(t->data), f);
+    bool tooLarge = !feof(f);
+    fclose(f);
+    if (tooLarge) {
+        fprintf(stderr, "%s: transcript too large\n", path);
+        return false;
+    }
+
+    t->apduCount = 0;
+    for (size_t offset = 0; offset < t->size; t->apduCount++) {
+        size_t apduSize = device_nextAPDUSize(t->data, t->size, offset);
+        if (apduSize == 0) {
+            fprintf(stderr, "%s: truncated APDU at offset %zu\n", path, offset);
+            return false;
+        }
+        offset += apduSize;
+    }
+    if (t->apduCount == 0) {
+        fprintf(stderr, "%s: empty transcript\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Compares the response with the .response file of the transcript at path
+static bool response_check(const char* path, const uint8_t* response, size_t responseSize) {
+    char expectedPath[MAX_PATH_SIZE];
+    uint8_t expected[DEVICE_MAX_RESPONSE_SIZE + 1];
+    size_t pathSize = strlen(path);
+    const char* suffix = ".apdu";
+    if (pathSize >= strlen(suffix) && strcmp(path + pathSize - strlen(suffix), suffix) == 0) {
+        pathSize -= strlen(suffix);
+    }
+    snprintf(expectedPath, sizeof(expectedPath), "%.*s.response", (int) pathSize, path);
+
+    FILE* f = fopen(expectedPath, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", expectedPath);
+        return false;
+    }
+    size_t expectedSize = fread(expected, 1, sizeof(expected), f);
+    fclose(f);
+    if (expectedSize != responseSize || memcmp(expected, response, responseSize) != 0) {
+        fprintf(stderr, "%s: the last response differs from %s\n", path, expectedPath);
+        return false;
+    }
+    return true;
+}
+
+// Returns the index of the first APDU which did not succeed, or apduCount.
+// The data of the last response are left in response.
+static size_t transcript_run(const transcript_t* t,
+                             uint16_t* failedSW,
+                             uint8_t* response,
+                             size_t* responseSize) {
+    size_t offset = 0;
+
+    // same IVs in every iteration
+    cx_soft_seed_rng(0);
+    for (size_t i = 0; i < t->apduCount; i++) {
+        size_t apduSize = device_nextAPDUSize(t->data, t->size, offset);
+        uint16_t sw = device_exchange(t->data + offset,
+                                      apduSize,
+                                      response,
+                                      DEVICE_MAX_RESPONSE_SIZE,
+                                      responseSize);
+        if (sw != SW_OK) {
+            *failedSW = sw;
+            return i;
+        }
+        offset += apduSize;
+    }
+    return t->apduCount;
+}
+
+int main(int argc, char** argv) {
+    double minSeconds = 0.2;
+    bool checkResponses = false;
+    int first = 1;
+
+    if (argc > first + 1 && strcmp(argv[first], "-t") == 0) {
+        minSeconds = atof(argv[first + 1]);
+        first += 2;
+    }
+    if (argc > first && strcmp(argv[first], "-r") == 0) {
+        checkResponses = true;
+        first++;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "Usage: %s [-t min_seconds] [-r] transcript.apdu...\n", argv[0]);
+        return 2;
+    }
+
+    static transcript_t transcript;
+    uint8_t response[DEVICE_MAX_RESPONSE_SIZE];
+    size_t responseSize = 0;
+    int failures = 0;
+
+    printf("%-40s %6s %10s %12s\n", "transcript", "apdus", "iterations", "ns/apdu");
+    for (int arg = first; arg < argc; arg++) {
+        if (!transcript_load(&transcript, argv[arg])) {
+            failures++;
+            continue;
+        }
+
+        // Warm-up run, also checks that the transcript is accepted by the app
+        device_reset();
+        uint16_t sw = 0;
+        size_t failedAt = transcript_run(&transcript, &sw, response, &responseSize);
+        if (failedAt != transcript.apduCount) {
+            fprintf(stderr,
+                    "%s: APDU %zu failed with status 0x%04x\n",
+                    transcript.name,
+                    failedAt,
+                    sw);
+            failures++;
+            continue;
+        }
+        if (checkResponses && !response_check(argv[arg], response, responseSize)) {
+            failures++;
+            continue;
+        }
+
+        uint64_t iterations = 0;
+        uint64_t start = now_ns();
+        uint64_t elapsed;
+        do {
+            transcript_run(&transcript, &sw, response, &responseSize);
+            iterations++;
+            elapsed = now_ns() - start;
+        } while (elapsed < (uint64_t) (minSeconds * 1e9));
+
+        printf("%-40s %6zu %10llu %12.0f\n",
+               transcript.name,
+               transcript.apduCount,
+               (unsigned long long) iterations,
+               (double) elapsed / (double) (iterations * transcript.apduCount));
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#!/bin/bash
+set -e
+
+SCRIPTDIR="$(cd "$( dirname "${BASH_SOURCE[0]}" )" >/dev/null 2>&1 && pwd)"
+BUILDDIR="$SCRIPTDIR/cmake-build-native"
+
+# Compile the host-native app core and tools
+cmake -S "$SCRIPTDIR" -B "$BUILDDIR"
+cmake --build "$BUILDDIR" -j"$(nproc)"
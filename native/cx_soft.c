@@ -0,0 +1,969 @@
+#include <string.h>
+#include <stdbool.h>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/obj_mac.h>
+
+#include "cx.h"
+#include "os.h"
+#include "lcx_rng.h"
+#include "lcx_sha512.h"
+#include "ox_aes.h"
+
+#include "bip44.h"
+#include "cx_soft.h"
+
+// ============================== HASHES ==============================
+
+// Note: the SDK keeps a pointer to the hash description in the context header,
+// we keep a pointer to our own description which the app never dereferences.
+typedef struct {
+    cx_md_t md;
+    size_t blockSize;
+    size_t outputSize;
+    void (*init)(uint8_t* acc);
+    void (*compress)(uint8_t* acc, const uint8_t* block);
+    void (*output)(const uint8_t* acc, uint8_t* out);
+    // size and endianness of the message length appended by the padding
+    size_t lengthSize;
+    bool lengthBigEndian;
+} soft_hash_info_t;
+
+static uint32_t ror32(uint32_t x, unsigned n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static uint32_t rol32(uint32_t x, unsigned n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+static uint64_t ror64(uint64_t x, unsigned n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+static uint32_t load_be32(const uint8_t* p) {
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | p[3];
+}
+
+static uint32_t load_le32(const uint8_t* p) {
+    return ((uint32_t) p[3] << 24) | ((uint32_t) p[2] << 16) | ((uint32_t) p[1] << 8) | p[0];
+}
+
+static uint64_t load_be64(const uint8_t* p) {
+    return ((uint64_t) load_be32(p) << 32) | load_be32(p + 4);
+}
+
+static void store_be32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t) (x >> 24);
+    p[1] = (uint8_t) (x >> 16);
+    p[2] = (uint8_t) (x >> 8);
+    p[3] = (uint8_t) x;
+}
+
+static void store_le32(uint8_t* p, uint32_t x) {
+    p[0] = (uint8_t) x;
+    p[1] = (uint8_t) (x >> 8);
+    p[2] = (uint8_t) (x >> 16);
+    p[3] = (uint8_t) (x >> 24);
+}
+
+static void store_be64(uint8_t* p, uint64_t x) {
+    store_be32(p, (uint32_t) (x >> 32));
+    store_be32(p + 4, (uint32_t) x);
+}
+
+// Accumulators are kept as native words, memcpy avoids alignment issues
+#define ACC_LOAD(acc, words)  memcpy((words), (acc), sizeof(words))
+#define ACC_STORE(acc, words) memcpy((acc), (words), sizeof(words))
+
+// ---------------- SHA-256 ----------------
+
+static const uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void sha256_init(uint8_t* acc) {
+    const uint32_t iv[8] = {0x6a09e667,
+                            0xbb67ae85,
+                            0x3c6ef372,
+                            0xa54ff53a,
+                            0x510e527f,
+                            0x9b05688c,
+                            0x1f83d9ab,
+                            0x5be0cd19};
+    ACC_STORE(acc, iv);
+}
+
+static void sha256_compress(uint8_t* acc, const uint8_t* block) {
+    uint32_t h[8], w[64];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 16; i++) {
+        w[i] = load_be32(block + 4 * i);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = k + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) +
+                      SHA256_K[i] + w[i];
+        uint32_t t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += k;
+    ACC_STORE(acc, h);
+}
+
+static void sha256_output(const uint8_t* acc, uint8_t* out) {
+    uint32_t h[8];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 8; i++) {
+        store_be32(out + 4 * i, h[i]);
+    }
+}
+
+static const soft_hash_info_t SOFT_SHA256 = {
+    .md = CX_SHA256,
+    .blockSize = 64,
+    .outputSize = 32,
+    .init = sha256_init,
+    .compress = sha256_compress,
+    .output = sha256_output,
+    .lengthSize = 8,
+    .lengthBigEndian = true,
+};
+
+// ---------------- SHA-512 ----------------
+
+static const uint64_t SHA512_K[80] = {
+    0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+    0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+    0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+    0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+    0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+    0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+    0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+    0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+    0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+    0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+    0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+    0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+    0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+    0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+    0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+    0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+    0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+    0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+    0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+    0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817,
+};
+
+static void sha512_init(uint8_t* acc) {
+    const uint64_t iv[8] = {0x6a09e667f3bcc908,
+                            0xbb67ae8584caa73b,
+                            0x3c6ef372fe94f82b,
+                            0xa54ff53a5f1d36f1,
+                            0x510e527fade682d1,
+                            0x9b05688c2b3e6c1f,
+                            0x1f83d9abfb41bd6b,
+                            0x5be0cd19137e2179};
+    ACC_STORE(acc, iv);
+}
+
+static void sha512_compress(uint8_t* acc, const uint8_t* block) {
+    uint64_t h[8], w[80];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 16; i++) {
+        w[i] = load_be64(block + 8 * i);
+    }
+    for (int i = 16; i < 80; i++) {
+        uint64_t s0 = ror64(w[i - 15], 1) ^ ror64(w[i - 15], 8) ^ (w[i - 15] >> 7);
+        uint64_t s1 = ror64(w[i - 2], 19) ^ ror64(w[i - 2], 61) ^ (w[i - 2] >> 6);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint64_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    for (int i = 0; i < 80; i++) {
+        uint64_t t1 = k + (ror64(e, 14) ^ ror64(e, 18) ^ ror64(e, 41)) + ((e & f) ^ (~e & g)) +
+                      SHA512_K[i] + w[i];
+        uint64_t t2 = (ror64(a, 28) ^ ror64(a, 34) ^ ror64(a, 39)) + ((a & b) ^ (a & c) ^ (b & c));
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+    h[5] += f;
+    h[6] += g;
+    h[7] += k;
+    ACC_STORE(acc, h);
+}
+
+static void sha512_output(const uint8_t* acc, uint8_t* out) {
+    uint64_t h[8];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 8; i++) {
+        store_be64(out + 8 * i, h[i]);
+    }
+}
+
+static const soft_hash_info_t SOFT_SHA512 = {
+    .md = CX_SHA512,
+    .blockSize = 128,
+    .outputSize = 64,
+    .init = sha512_init,
+    .compress = sha512_compress,
+    .output = sha512_output,
+    .lengthSize = 16,
+    .lengthBigEndian = true,
+};
+
+// ---------------- RIPEMD-160 ----------------
+
+static void ripemd160_init(uint8_t* acc) {
+    const uint32_t iv[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+    ACC_STORE(acc, iv);
+}
+
+static uint32_t ripemd160_f(int j, uint32_t x, uint32_t y, uint32_t z) {
+    switch (j / 16) {
+        case 0:
+            return x ^ y ^ z;
+        case 1:
+            return (x & y) | (~x & z);
+        case 2:
+            return (x | ~y) ^ z;
+        case 3:
+            return (x & z) | (y & ~z);
+        default:
+            return x ^ (y | ~z);
+    }
+}
+
+static void ripemd160_compress(uint8_t* acc, const uint8_t* block) {
+    static const uint8_t R[80] = {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15,
+                                  7,  4,  13, 1,  10, 6,  15, 3,  12, 0,  9,  5,  2,  14, 11, 8,
+                                  3,  10, 14, 4,  9,  15, 8,  1,  2,  7,  0,  6,  13, 11, 5,  12,
+                                  1,  9,  11, 10, 0,  8,  12, 4,  13, 3,  7,  15, 14, 5,  6,  2,
+                                  4,  0,  5,  9,  7,  12, 2,  10, 14, 1,  3,  8,  11, 6,  15, 13};
+    static const uint8_t RP[80] = {5,  14, 7,  0,  9, 2,  11, 4,  13, 6,  15, 8,  1,  10, 3,  12,
+                                   6,  11, 3,  7,  0, 13, 5,  10, 14, 15, 8,  12, 4,  9,  1,  2,
+                                   15, 5,  1,  3,  7, 14, 6,  9,  11, 8,  12, 2,  10, 0,  4,  13,
+                                   8,  6,  4,  1,  3, 11, 15, 0,  5,  12, 2,  13, 9,  7,  10, 14,
+                                   12, 15, 10, 4,  1, 5,  8,  7,  6,  2,  13, 14, 0,  3,  9,  11};
+    static const uint8_t S[80] = {11, 14, 15, 12, 5,  8,  7,  9,  11, 13, 14, 15, 6,  7,  9,  8,
+                                  7,  6,  8,  13, 11, 9,  7,  15, 7,  12, 15, 9,  11, 7,  13, 12,
+                                  11, 13, 6,  7,  14, 9,  13, 15, 14, 8,  13, 6,  5,  12, 7,  5,
+                                  11, 12, 14, 15, 14, 15, 9,  8,  9,  14, 5,  6,  8,  6,  5,  12,
+                                  9,  15, 5,  11, 6,  8,  13, 12, 5,  12, 13, 14, 11, 8,  5,  6};
+    static const uint8_t SP[80] = {8,  9,  9,  11, 13, 15, 15, 5,  7,  7,  8,  11, 14, 14, 12, 6,
+                                   9,  13, 15, 7,  12, 8,  9,  11, 7,  7,  12, 7,  6,  15, 13, 11,
+                                   9,  7,  15, 11, 8,  6,  6,  14, 12, 13, 5,  14, 13, 13, 7,  5,
+                                   15, 5,  8,  11, 14, 14, 6,  14, 6,  9,  12, 9,  12, 5,  15, 8,
+                                   8,  5,  12, 9,  12, 5,  14, 6,  8,  13, 6,  5,  15, 13, 11, 11};
+    static const uint32_t K[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+    static const uint32_t KP[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+    uint32_t h[5], x[16];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 16; i++) {
+        x[i] = load_le32(block + 4 * i);
+    }
+    uint32_t al = h[0], bl = h[1], cl = h[2], dl = h[3], el = h[4];
+    uint32_t ar = h[0], br = h[1], cr = h[2], dr = h[3], er = h[4];
+    for (int j = 0; j < 80; j++) {
+        uint32_t t = rol32(al + ripemd160_f(j, bl, cl, dl) + x[R[j]] + K[j / 16], S[j]) + el;
+        al = el;
+        el = dl;
+        dl = rol32(cl, 10);
+        cl = bl;
+        bl = t;
+        t = rol32(ar + ripemd160_f(79 - j, br, cr, dr) + x[RP[j]] + KP[j / 16], SP[j]) + er;
+        ar = er;
+        er = dr;
+        dr = rol32(cr, 10);
+        cr = br;
+        br = t;
+    }
+    uint32_t t = h[1] + cl + dr;
+    h[1] = h[2] + dl + er;
+    h[2] = h[3] + el + ar;
+    h[3] = h[4] + al + br;
+    h[4] = h[0] + bl + cr;
+    h[0] = t;
+    ACC_STORE(acc, h);
+}
+
+static void ripemd160_output(const uint8_t* acc, uint8_t* out) {
+    uint32_t h[5];
+    ACC_LOAD(acc, h);
+    for (int i = 0; i < 5; i++) {
+        store_le32(out + 4 * i, h[i]);
+    }
+}
+
+static const soft_hash_info_t SOFT_RIPEMD160 = {
+    .md = CX_RIPEMD160,
+    .blockSize = 64,
+    .outputSize = 20,
+    .init = ripemd160_init,
+    .compress = ripemd160_compress,
+    .output = ripemd160_output,
+    .lengthSize = 8,
+    .lengthBigEndian = false,
+};
+
+// ---------------- common hash driver ----------------
+
+typedef struct {
+    const soft_hash_info_t* info;
+    size_t* blen;
+    uint8_t* block;
+    uint8_t* acc;
+} soft_hash_state_t;
+
+static bool soft_hash_state(cx_hash_t* hash, soft_hash_state_t* state) {
+    const soft_hash_info_t* info = (const soft_hash_info_t*) hash->info;
+    state->info = info;
+    if (info == &SOFT_SHA256) {
+        cx_sha256_t* ctx = (cx_sha256_t*) hash;
+        state->blen = &ctx->blen;
+        state->block = ctx->block;
+        state->acc = ctx->acc;
+    } else if (info == &SOFT_SHA512) {
+        cx_sha512_t* ctx = (cx_sha512_t*) hash;
+        state->blen = &ctx->blen;
+        state->block = ctx->block;
+        state->acc = ctx->acc;
+    } else if (info == &SOFT_RIPEMD160) {
+        cx_ripemd160_t* ctx = (cx_ripemd160_t*) hash;
+        state->blen = &ctx->blen;
+        state->block = ctx->block;
+        state->acc = ctx->acc;
+    } else {
+        // not initialized (or cleared) context
+        return false;
+    }
+    return true;
+}
+
+static void soft_hash_init(cx_hash_t* hash, const soft_hash_info_t* info) {
+    soft_hash_state_t state = {0};
+    hash->info = (const cx_hash_info_t*) info;
+    hash->counter = 0;
+    soft_hash_state(hash, &state);
+    *state.blen = 0;
+    info->init(state.acc);
+}
+
+static void soft_hash_update(const soft_hash_state_t* state,
+                             cx_hash_t* hash,
+                             const uint8_t* in,
+                             size_t len) {
+    const size_t blockSize = state->info->blockSize;
+    while (len > 0) {
+        size_t chunk = blockSize - *state->blen;
+        if (chunk > len) chunk = len;
+        memcpy(state->block + *state->blen, in, chunk);
+        *state->blen += chunk;
+        in += chunk;
+        len -= chunk;
+        if (*state->blen == blockSize) {
+            state->info->compress(state->acc, state->block);
+            hash->counter++;
+            *state->blen = 0;
+        }
+    }
+}
+
+static void soft_hash_final(const soft_hash_state_t* state, cx_hash_t* hash, uint8_t* out) {
+    const soft_hash_info_t* info = state->info;
+    uint64_t bits = ((uint64_t) hash->counter * info->blockSize + *state->blen) * 8;
+
+    state->block[(*state->blen)++] = 0x80;
+    if (*state->blen > info->blockSize - info->lengthSize) {
+        memset(state->block + *state->blen, 0, info->blockSize - *state->blen);
+        info->compress(state->acc, state->block);
+        *state->blen = 0;
+    }
+    memset(state->block + *state->blen, 0, info->blockSize - *state->blen);
+    uint8_t* length = state->block + info->blockSize - info->lengthSize;
+    for (size_t i = 0; i < 8; i++) {
+        if (info->lengthBigEndian) {
+            length[info->lengthSize - 1 - i] = (uint8_t) (bits >> (8 * i));
+        } else {
+            length[i] = (uint8_t) (bits >> (8 * i));
+        }
+    }
+    info->compress(state->acc, state->block);
+    info->output(state->acc, out);
+}
+
+cx_err_t cx_sha256_init_no_throw(cx_sha256_t* hash) {
+    memset(hash, 0, sizeof(*hash));
+    soft_hash_init(&hash->header, &SOFT_SHA256);
+    return CX_OK;
+}
+
+cx_err_t cx_sha512_init_no_throw(cx_sha512_t* hash) {
+    memset(hash, 0, sizeof(*hash));
+    soft_hash_init(&hash->header, &SOFT_SHA512);
+    return CX_OK;
+}
+
+cx_err_t cx_ripemd160_init_no_throw(cx_ripemd160_t* hash) {
+    memset(hash, 0, sizeof(*hash));
+    soft_hash_init(&hash->header, &SOFT_RIPEMD160);
+    return CX_OK;
+}
+
+size_t cx_hash_get_size(const cx_hash_t* ctx) {
+    soft_hash_state_t state = {0};
+    if (!soft_hash_state((cx_hash_t*) ctx, &state)) return 0;
+    return state.info->outputSize;
+}
+
+cx_err_t cx_hash_no_throw(cx_hash_t* hash,
+                          uint32_t mode,
+                          const uint8_t* in,
+                          size_t len,
+                          uint8_t* out,
+                          size_t out_len) {
+    soft_hash_state_t state = {0};
+    if (!soft_hash_state(hash, &state)) return CX_INVALID_PARAMETER;
+    if (len > 0 && in == NULL) return CX_INVALID_PARAMETER;
+    soft_hash_update(&state, hash, in, len);
+    if (mode & CX_LAST) {
+        if (out == NULL || out_len < state.info->outputSize) return CX_INVALID_PARAMETER;
+        soft_hash_final(&state, hash, out);
+    }
+    return CX_OK;
+}
+
+// ============================== HMAC ==============================
+
+// hmac->key holds the key padded to the block size, hmac->hash_ctx the inner hash
+static void soft_hmac_start(cx_hmac_t* hmac, const soft_hash_info_t* info, uint8_t pad) {
+    uint8_t block[128];
+    cx_hash_t* inner = (cx_hash_t*) &hmac->hash_ctx;
+    soft_hash_state_t state = {0};
+
+    for (size_t i = 0; i < info->blockSize; i++) {
+        block[i] = hmac->key[i] ^ pad;
+    }
+    soft_hash_init(inner, info);
+    soft_hash_state(inner, &state);
+    soft_hash_update(&state, inner, block, info->blockSize);
+    explicit_bzero(block, sizeof(block));
+}
+
+static cx_err_t soft_hmac_init(cx_hmac_t* hmac,
+                               const soft_hash_info_t* info,
+                               const uint8_t* key,
+                               size_t key_len) {
+    memset(hmac, 0, sizeof(*hmac));
+    if (key_len > 0 && key == NULL) return CX_INVALID_PARAMETER;
+    if (key_len > info->blockSize) {
+        cx_hash_t* hash = (cx_hash_t*) &hmac->hash_ctx;
+        soft_hash_state_t state = {0};
+        soft_hash_init(hash, info);
+        soft_hash_state(hash, &state);
+        soft_hash_update(&state, hash, key, key_len);
+        soft_hash_final(&state, hash, hmac->key);
+    } else if (key_len > 0) {
+        memcpy(hmac->key, key, key_len);
+    }
+    soft_hmac_start(hmac, info, 0x36);
+    return CX_OK;
+}
+
+cx_err_t cx_hmac_sha256_init_no_throw(cx_hmac_sha256_t* hmac, const uint8_t* key, size_t key_len) {
+    return soft_hmac_init(hmac, &SOFT_SHA256, key, key_len);
+}
+
+cx_err_t cx_hmac_no_throw(cx_hmac_t* hmac,
+                          uint32_t mode,
+                          const uint8_t* in,
+                          size_t len,
+                          uint8_t* mac,
+                          size_t mac_len) {
+    cx_hash_t* inner = (cx_hash_t*) &hmac->hash_ctx;
+    soft_hash_state_t state = {0};
+    if (!soft_hash_state(inner, &state)) return CX_INVALID_PARAMETER;
+    if (len > 0 && in == NULL) return CX_INVALID_PARAMETER;
+    soft_hash_update(&state, inner, in, len);
+    if (!(mode & CX_LAST)) return CX_OK;
+
+    const soft_hash_info_t* info = state.info;
+    uint8_t innerHash[64];
+    uint8_t outerHash[64];
+    soft_hash_final(&state, inner, innerHash);
+
+    soft_hmac_start(hmac, info, 0x5c);
+    soft_hash_state(inner, &state);
+    soft_hash_update(&state, inner, innerHash, info->outputSize);
+    soft_hash_final(&state, inner, outerHash);
+
+    if (mac != NULL) {
+        memcpy(mac, outerHash, mac_len < info->outputSize ? mac_len : info->outputSize);
+    }
+    if (!(mode & CX_NO_REINIT)) {
+        soft_hmac_start(hmac, info, 0x36);
+    }
+    explicit_bzero(innerHash, sizeof(innerHash));
+    explicit_bzero(outerHash, sizeof(outerHash));
+    return CX_OK;
+}
+
+cx_err_t cx_hmac_update(cx_hmac_t* ctx, const uint8_t* data, size_t data_len) {
+    return cx_hmac_no_throw(ctx, 0, data, data_len, NULL, 0);
+}
+
+cx_err_t cx_hmac_final(cx_hmac_t* ctx, uint8_t* out, size_t* out_len) {
+    cx_hash_t* inner = (cx_hash_t*) &ctx->hash_ctx;
+    size_t size = cx_hash_get_size(inner);
+    if (size == 0 || *out_len < size) return CX_INVALID_PARAMETER;
+    *out_len = size;
+    return cx_hmac_no_throw(ctx, CX_LAST | CX_NO_REINIT, NULL, 0, out, size);
+}
+
+// ============================== AES ==============================
+
+cx_err_t cx_aes_init_key_no_throw(const uint8_t* rawkey, size_t key_len, cx_aes_key_t* key) {
+    if (key_len != 16 && key_len != 24 && key_len != 32) return CX_INVALID_PARAMETER;
+    memset(key, 0, sizeof(*key));
+    memcpy(key->keys, rawkey, key_len);
+    key->size = key_len;
+    return CX_OK;
+}
+
+// Key schedules are cached, the app encrypts block by block with the same key
+static cx_err_t soft_aes_block(const cx_aes_key_t* key,
+                               int encrypt,
+                               const uint8_t* inblock,
+                               uint8_t* outblock) {
+    static EVP_CIPHER_CTX* ctx[2];
+    static cx_aes_key_t cachedKey[2];
+    static bool cached[2];
+
+    if (ctx[encrypt] == NULL) {
+        ctx[encrypt] = EVP_CIPHER_CTX_new();
+        if (ctx[encrypt] == NULL) return CX_INTERNAL_ERROR;
+    }
+    if (!cached[encrypt] || memcmp(&cachedKey[encrypt], key, sizeof(*key)) != 0) {
+        const EVP_CIPHER* cipher;
+        switch (key->size) {
+            case 16:
+                cipher = EVP_aes_128_ecb();
+                break;
+            case 24:
+                cipher = EVP_aes_192_ecb();
+                break;
+            case 32:
+                cipher = EVP_aes_256_ecb();
+                break;
+            default:
+                return CX_INVALID_PARAMETER;
+        }
+        if (EVP_CipherInit_ex(ctx[encrypt], cipher, NULL, key->keys, NULL, encrypt) != 1) {
+            return CX_INTERNAL_ERROR;
+        }
+        EVP_CIPHER_CTX_set_padding(ctx[encrypt], 0);
+        cachedKey[encrypt] = *key;
+        cached[encrypt] = true;
+    }
+    int outLen = 0;
+    if (EVP_CipherUpdate(ctx[encrypt], outblock, &outLen, inblock, CX_AES_BLOCK_SIZE) != 1 ||
+        outLen != CX_AES_BLOCK_SIZE) {
+        return CX_INTERNAL_ERROR;
+    }
+    return CX_OK;
+}
+
+cx_err_t cx_aes_enc_block(const cx_aes_key_t* key, const uint8_t* inblock, uint8_t* outblock) {
+    return soft_aes_block(key, 1, inblock, outblock);
+}
+
+cx_err_t cx_aes_dec_block(const cx_aes_key_t* key, const uint8_t* inblock, uint8_t* outblock) {
+    return soft_aes_block(key, 0, inblock, outblock);
+}
+
+// ============================== RNG ==============================
+
+static uint64_t rngState = 0x46494f;  // "FIO"
+
+void cx_soft_seed_rng(uint64_t seed) {
+    rngState = seed;
+}
+
+// splitmix64, reproducible and good enough for IVs and test keys
+void cx_rng_no_throw(uint8_t* buffer, size_t len) {
+    while (len > 0) {
+        uint64_t z = (rngState += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        z ^= z >> 31;
+        for (int i = 0; i < 8 && len > 0; i++, len--) {
+            *buffer++ = (uint8_t) (z >> (8 * i));
+        }
+    }
+}
+
+// ============================== SECP256K1 ==============================
+
+enum {
+    SECP256K1_SCALAR_SIZE = 32,
+    SECP256K1_POINT_SIZE = 65,
+};
+
+typedef struct {
+    EC_GROUP* group;
+    BIGNUM* order;
+    BIGNUM* halfOrder;
+    BN_CTX* bn;
+} soft_curve_t;
+
+static const soft_curve_t* secp256k1(void) {
+    static soft_curve_t curve;
+    if (curve.group == NULL) {
+        curve.group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        curve.bn = BN_CTX_new();
+        curve.order = BN_new();
+        curve.halfOrder = BN_new();
+        EC_GROUP_get_order(curve.group, curve.order, curve.bn);
+        BN_rshift1(curve.halfOrder, curve.order);
+    }
+    return &curve;
+}
+
+// Writes d*G (or d*P) in uncompressed form, returns false for invalid inputs
+static bool soft_ec_mul(const uint8_t* scalar,
+                        size_t scalarLen,
+                        const uint8_t* point,
+                        size_t pointLen,
+                        uint8_t out[SECP256K1_POINT_SIZE]) {
+    const soft_curve_t* curve = secp256k1();
+    BIGNUM* d = BN_bin2bn(scalar, (int) scalarLen, NULL);
+    EC_POINT* p = NULL;
+    EC_POINT* result = EC_POINT_new(curve->group);
+    bool ok = false;
+
+    if (d == NULL || result == NULL || BN_is_zero(d) || BN_cmp(d, curve->order) >= 0) goto end;
+    if (point != NULL) {
+        p = EC_POINT_new(curve->group);
+        // Note: oct2point rejects points which are not on the curve
+        if (p == NULL || EC_POINT_oct2point(curve->group, p, point, pointLen, curve->bn) != 1) {
+            goto end;
+        }
+        if (EC_POINT_mul(curve->group, result, NULL, p, d, curve->bn) != 1) goto end;
+    } else {
+        if (EC_POINT_mul(curve->group, result, d, NULL, NULL, curve->bn) != 1) goto end;
+    }
+    ok = EC_POINT_point2oct(curve->group,
+                            result,
+                            POINT_CONVERSION_UNCOMPRESSED,
+                            out,
+                            SECP256K1_POINT_SIZE,
+                            curve->bn) == SECP256K1_POINT_SIZE;
+end:
+    BN_clear_free(d);
+    EC_POINT_free(p);
+    EC_POINT_free(result);
+    return ok;
+}
+
+cx_err_t cx_ecfp_init_private_key_no_throw(cx_curve_t curve,
+                                           const uint8_t* rawkey,
+                                           size_t key_len,
+                                           cx_ecfp_private_key_t* pvkey) {
+    if (curve != CX_CURVE_SECP256K1) return CX_EC_INVALID_CURVE;
+    if (key_len != 0 && key_len != SECP256K1_SCALAR_SIZE) return CX_INVALID_PARAMETER;
+    memset(pvkey, 0, sizeof(*pvkey));
+    pvkey->curve = curve;
+    pvkey->d_len = key_len;
+    if (key_len > 0) memcpy(pvkey->d, rawkey, key_len);
+    return CX_OK;
+}
+
+cx_err_t cx_ecfp_init_public_key_no_throw(cx_curve_t curve,
+                                          const uint8_t* rawkey,
+                                          size_t key_len,
+                                          cx_ecfp_public_key_t* key) {
+    if (curve != CX_CURVE_SECP256K1) return CX_EC_INVALID_CURVE;
+    if (key_len != 0 && key_len != SECP256K1_POINT_SIZE) return CX_INVALID_PARAMETER;
+    memset(key, 0, sizeof(*key));
+    key->curve = curve;
+    key->W_len = key_len;
+    if (key_len > 0) memcpy(key->W, rawkey, key_len);
+    return CX_OK;
+}
+
+cx_err_t cx_ecfp_generate_pair_no_throw(cx_curve_t curve,
+                                        cx_ecfp_public_key_t* pubkey,
+                                        cx_ecfp_private_key_t* privkey,
+                                        bool keepprivate) {
+    if (curve != CX_CURVE_SECP256K1) return CX_EC_INVALID_CURVE;
+    if (!keepprivate) {
+        uint8_t d[SECP256K1_SCALAR_SIZE];
+        cx_rng_no_throw(d, sizeof(d));
+        d[0] &= 0x7f;  // below the curve order
+        d[31] |= 0x01;
+        cx_ecfp_init_private_key_no_throw(curve, d, sizeof(d), privkey);
+        explicit_bzero(d, sizeof(d));
+    }
+    uint8_t W[SECP256K1_POINT_SIZE];
+    if (!soft_ec_mul(privkey->d, privkey->d_len, NULL, 0, W)) return CX_INVALID_PARAMETER;
+    return cx_ecfp_init_public_key_no_throw(curve, W, sizeof(W), pubkey);
+}
+
+cx_err_t cx_ecdh_no_throw(const cx_ecfp_private_key_t* pvkey,
+                          uint32_t mode,
+                          const uint8_t* P,
+                          size_t P_len,
+                          uint8_t* secret,
+                          size_t secret_len) {
+    uint8_t Q[SECP256K1_POINT_SIZE];
+    if (!soft_ec_mul(pvkey->d, pvkey->d_len, P, P_len, Q)) return CX_EC_INVALID_POINT;
+    switch (mode & (CX_ECDH_POINT | CX_ECDH_X)) {
+        case CX_ECDH_X:
+            if (secret_len < SECP256K1_SCALAR_SIZE) return CX_INVALID_PARAMETER;
+            memcpy(secret, Q + 1, SECP256K1_SCALAR_SIZE);
+            break;
+        case CX_ECDH_POINT:
+            if (secret_len < SECP256K1_POINT_SIZE) return CX_INVALID_PARAMETER;
+            memcpy(secret, Q, SECP256K1_POINT_SIZE);
+            break;
+        default:
+            return CX_INVALID_PARAMETER;
+    }
+    return CX_OK;
+}
+
+static size_t der_append_integer(uint8_t* out, const BIGNUM* value) {
+    uint8_t raw[SECP256K1_SCALAR_SIZE];
+    BN_bn2binpad(value, raw, sizeof(raw));
+    size_t skip = 0;
+    while (skip < sizeof(raw) - 1 && raw[skip] == 0) skip++;
+    size_t len = sizeof(raw) - skip;
+    size_t pos = 0;
+    out[pos++] = 0x02;
+    if (raw[skip] & 0x80) {
+        out[pos++] = (uint8_t) (len + 1);
+        out[pos++] = 0x00;
+    } else {
+        out[pos++] = (uint8_t) len;
+    }
+    memcpy(out + pos, raw + skip, len);
+    return pos + len;
+}
+
+// Plain ECDSA: r = (kG).x mod n, s = k^-1 (h + r d) mod n
+cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t* pvkey,
+                                uint32_t mode,
+                                cx_md_t hashID,
+                                const uint8_t* hash,
+                                size_t hash_len,
+                                uint8_t* sig,
+                                size_t* sig_len,
+                                uint32_t* info) {
+    (void) hashID;
+    const soft_curve_t* curve = secp256k1();
+    uint8_t kBytes[SECP256K1_SCALAR_SIZE];
+    uint8_t R[SECP256K1_POINT_SIZE];
+    cx_err_t err = CX_INVALID_PARAMETER;
+
+    if (pvkey->d_len != SECP256K1_SCALAR_SIZE || *sig_len < 72) return CX_INVALID_PARAMETER;
+    if (hash_len > SECP256K1_SCALAR_SIZE) hash_len = SECP256K1_SCALAR_SIZE;
+    if ((mode & CX_RND_PROVIDED) == CX_RND_PROVIDED) {
+        memcpy(kBytes, sig, sizeof(kBytes));
+    } else {
+        cx_rng_no_throw(kBytes, sizeof(kBytes));
+        kBytes[0] &= 0x7f;
+    }
+    if (!soft_ec_mul(kBytes, sizeof(kBytes), NULL, 0, R)) {
+        explicit_bzero(kBytes, sizeof(kBytes));
+        return CX_INVALID_PARAMETER;
+    }
+
+    BN_CTX* bn = curve->bn;
+    BN_CTX_start(bn);
+    BIGNUM* k = BN_CTX_get(bn);
+    BIGNUM* r = BN_CTX_get(bn);
+    BIGNUM* s = BN_CTX_get(bn);
+    BIGNUM* d = BN_CTX_get(bn);
+    BIGNUM* e = BN_CTX_get(bn);
+    if (e == NULL) goto end;
+    BN_bin2bn(kBytes, sizeof(kBytes), k);
+    BN_bin2bn(R + 1, SECP256K1_SCALAR_SIZE, r);
+    BN_bin2bn(pvkey->d, (int) pvkey->d_len, d);
+    BN_bin2bn(hash, (int) hash_len, e);
+
+    uint32_t infos = (R[SECP256K1_POINT_SIZE - 1] & 1) ? CX_ECCINFO_PARITY_ODD : 0;
+    if (BN_cmp(r, curve->order) >= 0) {
+        infos |= CX_ECCINFO_xGTn;
+        BN_sub(r, r, curve->order);
+    }
+    if (BN_is_zero(r)) goto end;
+
+    // s = k^-1 * (e + r * d) mod n
+    if (BN_mod_mul(s, r, d, curve->order, bn) != 1) goto end;
+    if (BN_mod_add(s, s, e, curve->order, bn) != 1) goto end;
+    if (BN_mod_inverse(k, k, curve->order, bn) == NULL) goto end;
+    if (BN_mod_mul(s, s, k, curve->order, bn) != 1) goto end;
+    if (BN_is_zero(s)) goto end;
+
+    if (!(mode & CX_NO_CANONICAL) && BN_cmp(s, curve->halfOrder) > 0) {
+        BN_sub(s, curve->order, s);
+        infos ^= CX_ECCINFO_PARITY_ODD;
+    }
+
+    size_t pos = 2;
+    pos += der_append_integer(sig + pos, r);
+    pos += der_append_integer(sig + pos, s);
+    sig[0] = 0x30;
+    sig[1] = (uint8_t) (pos - 2);
+    *sig_len = pos;
+    if (info != NULL) *info = infos;
+    err = CX_OK;
+end:
+    BN_CTX_end(bn);
+    explicit_bzero(kBytes, sizeof(kBytes));
+    return err;
+}
+
+// ============================== BIP32 ==============================
+
+typedef struct {
+    uint8_t key[SECP256K1_SCALAR_SIZE];
+    uint8_t chainCode[32];
+} soft_bip32_node_t;
+
+static void bip32_hmac(const uint8_t* key,
+                       size_t keyLen,
+                       const uint8_t* data,
+                       size_t dataLen,
+                       uint8_t out[64]) {
+    unsigned int outLen = 64;
+    HMAC(EVP_sha512(), key, (int) keyLen, data, dataLen, out, &outLen);
+}
+
+// Master node of the emulated seed, PBKDF2 is slow so it is computed only once
+static const soft_bip32_node_t* bip32_master(void) {
+    static soft_bip32_node_t master;
+    static bool initialized = false;
+    if (!initialized) {
+        static const char mnemonic[] = CX_SOFT_MNEMONIC;
+        static const char salt[] = "mnemonic";
+        static const char bitcoinSeed[] = "Bitcoin seed";
+        uint8_t seed[64], I[64];
+        PKCS5_PBKDF2_HMAC(mnemonic,
+                          sizeof(mnemonic) - 1,
+                          (const uint8_t*) salt,
+                          sizeof(salt) - 1,
+                          2048,
+                          EVP_sha512(),
+                          sizeof(seed),
+                          seed);
+        bip32_hmac((const uint8_t*) bitcoinSeed, sizeof(bitcoinSeed) - 1, seed, sizeof(seed), I);
+        memcpy(master.key, I, 32);
+        memcpy(master.chainCode, I + 32, 32);
+        initialized = true;
+    }
+    return &master;
+}
+
+static bool bip32_derive_child(soft_bip32_node_t* node, uint32_t index) {
+    const soft_curve_t* curve = secp256k1();
+    uint8_t data[37], I[64];
+
+    if (index & 0x80000000) {
+        data[0] = 0;
+        memcpy(data + 1, node->key, 32);
+    } else {
+        uint8_t W[SECP256K1_POINT_SIZE];
+        if (!soft_ec_mul(node->key, sizeof(node->key), NULL, 0, W)) return false;
+        data[0] = 0x02 | (W[SECP256K1_POINT_SIZE - 1] & 1);
+        memcpy(data + 1, W + 1, 32);
+    }
+    data[33] = (uint8_t) (index >> 24);
+    data[34] = (uint8_t) (index >> 16);
+    data[35] = (uint8_t) (index >> 8);
+    data[36] = (uint8_t) index;
+    bip32_hmac(node->chainCode, sizeof(node->chainCode), data, sizeof(data), I);
+
+    BN_CTX_start(curve->bn);
+    BIGNUM* tweak = BN_CTX_get(curve->bn);
+    BIGNUM* key = BN_CTX_get(curve->bn);
+    bool ok = key != NULL && BN_bin2bn(I, 32, tweak) != NULL &&
+              BN_cmp(tweak, curve->order) < 0 && BN_bin2bn(node->key, 32, key) != NULL &&
+              BN_mod_add(key, key, tweak, curve->order, curve->bn) == 1 && !BN_is_zero(key) &&
+              BN_bn2binpad(key, node->key, 32) == 32;
+    BN_CTX_end(curve->bn);
+    memcpy(node->chainCode, I + 32, 32);
+    explicit_bzero(I, sizeof(I));
+    explicit_bzero(data, sizeof(data));
+    return ok;
+}
+
+void os_perso_derive_node_bip32(cx_curve_t curve,
+                                const unsigned int* path,
+                                unsigned int pathLength,
+                                unsigned char* privateKey,
+                                unsigned char* chain) {
+    // Derivation of the last path is reused, flows derive the same key several times
+    static unsigned int cachedPath[BIP44_MAX_PATH_ELEMENTS];
+    static unsigned int cachedPathLength = (unsigned int) -1;
+    static soft_bip32_node_t cachedNode;
+
+    if (curve != CX_CURVE_SECP256K1) THROW(EXCEPTION);
+    if (pathLength > BIP44_MAX_PATH_ELEMENTS) THROW(EXCEPTION);
+    soft_bip32_node_t node;
+    if (pathLength == cachedPathLength &&
+        memcmp(path, cachedPath, pathLength * sizeof(path[0])) == 0) {
+        node = cachedNode;
+    } else {
+        node = *bip32_master();
+        for (unsigned int i = 0; i < pathLength; i++) {
+            if (!bip32_derive_child(&node, path[i])) THROW(EXCEPTION);
+        }
+        memcpy(cachedPath, path, pathLength * sizeof(path[0]));
+        cachedPathLength = pathLength;
+        cachedNode = node;
+    }
+    if (privateKey != NULL) memcpy(privateKey, node.key, sizeof(node.key));
+    if (chain != NULL) memcpy(chain, node.chainCode, sizeof(node.chainCode));
+    explicit_bzero(&node, sizeof(node));
+}
@@ -0,0 +1,19 @@
+#ifndef H_FIO_NATIVE_CX_SOFT
+#define H_FIO_NATIVE_CX_SOFT
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Software implementation of the cx_* and os_perso_* calls used by the app.
+// Hashes and HMAC keep their state inside the SDK context structures (so the app
+// can copy and clear them as on the device), AES and secp256k1 are backed by OpenSSL.
+
+// Mnemonic of the emulated device, the same as WORDS in the Makefile used for speculos
+// and physical devices, so public keys and signatures match the ones in test-integration.
+#define CX_SOFT_MNEMONIC \
+    "abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about"
+
+// cx_rng_no_throw is a deterministic generator so that runs are reproducible
+void cx_soft_seed_rng(uint64_t seed);
+
+#endif  // H_FIO_NATIVE_CX_SOFT
@@ -0,0 +1,92 @@
+#include <string.h>
+
+#include "device.h"
+#include "os_native.h"
+#include "handlers.h"
+#include "dispatch.h"
+#include "state.h"
+#include "uiHelpers.h"
+
+void device_reset(void) {
+    explicit_bzero(&instructionState, SIZEOF(instructionState));
+    explicit_bzero(&displayState, SIZEOF(displayState));
+    explicit_bzero(&nativeIO, SIZEOF(nativeIO));
+    currentInstruction = INS_NONE;
+    io_state = IO_EXPECT_IO;
+}
+
+// Runs the headless confirmations until the app responds,
+// as the ticker events would do on the device
+static void device_runUI(void) {
+    while (!nativeIO.responded && nativeIO.timer != NULL) {
+        timeout_callback_fn_t* callback = nativeIO.timer;
+        nativeIO.timer = NULL;  // clear first if cb() throws
+        callback(true);
+    }
+}
+
+uint16_t device_exchange(const uint8_t* apdu,
+                         size_t apduSize,
+                         uint8_t* response,
+                         size_t responseMaxSize,
+                         size_t* responseSize) {
+    volatile bool crashed = false;
+
+    *responseSize = 0;
+    nativeIO.responded = false;
+    if (apduSize == 0 || apduSize > SIZEOF(G_io_apdu_buffer) || io_state != IO_EXPECT_IO) {
+        return DEVICE_SW_NO_RESPONSE;
+    }
+    memcpy(G_io_apdu_buffer, apdu, apduSize);
+    io_state = IO_EXPECT_NONE;
+
+    // Mirrors the TRY block of fio_main
+    BEGIN_TRY {
+        TRY {
+            VALIDATE(device_is_unlocked(), ERR_DEVICE_LOCKED);
+            dispatchAPDU(apduSize);
+            device_runUI();
+        }
+        CATCH(EXCEPTION_IO_RESET) {
+            crashed = true;
+        }
+        CATCH(ERR_ASSERT) {
+            // Note(ppershing): assertions should not auto-respond
+            crashed = true;
+        }
+        CATCH_OTHER(e) {
+            if (e >= _ERR_AUTORESPOND_START && e < _ERR_AUTORESPOND_END) {
+                io_send_buf(e, NULL, 0);
+                ui_idle();
+            } else {
+                crashed = true;
+            }
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+
+    if (crashed) {
+        device_reset();
+        return DEVICE_SW_RESET;
+    }
+    if (!nativeIO.responded) {
+        // the device would hang waiting for the user
+        device_reset();
+        return DEVICE_SW_NO_RESPONSE;
+    }
+    if (nativeIO.responseSize > responseMaxSize) {
+        return DEVICE_SW_NO_RESPONSE;
+    }
+    memcpy(response, nativeIO.response, nativeIO.responseSize);
+    *responseSize = nativeIO.responseSize;
+    return nativeIO.sw;
+}
+
+size_t device_nextAPDUSize(const uint8_t* transcript, size_t transcriptSize, size_t offset) {
+    if (offset + DEVICE_APDU_HEADER_SIZE > transcriptSize) return 0;
+    size_t apduSize = DEVICE_APDU_HEADER_SIZE + transcript[offset + DEVICE_APDU_HEADER_SIZE - 1];
+    if (offset + apduSize > transcriptSize) return 0;
+    return apduSize;
+}
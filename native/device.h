@@ -0,0 +1,43 @@
+#ifndef H_FIO_NATIVE_DEVICE
+#define H_FIO_NATIVE_DEVICE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Host-native emulation of the app main loop (fio_main in main.c).
+// The app is built HEADLESS, so every prompt is confirmed automatically.
+
+enum {
+    // Pseudo status words, real ones are always >= 0x6000
+    // The app reset itself (failed assertion or unexpected exception)
+    DEVICE_SW_RESET = 0x0000,
+    // The app neither responded nor scheduled a headless confirmation
+    DEVICE_SW_NO_RESPONSE = 0x0001,
+};
+
+enum {
+    DEVICE_APDU_HEADER_SIZE = 5,
+    DEVICE_MAX_APDU_SIZE = DEVICE_APDU_HEADER_SIZE + 255,
+    // response data without the status word
+    DEVICE_MAX_RESPONSE_SIZE = 258,
+};
+
+// Restarts the app, as after power-on
+void device_reset(void);
+
+// Processes a single request APDU the same way the main loop does, including
+// all UI steps it triggers, and returns the status word of the response.
+// Response data (without the status word) are copied to response.
+uint16_t device_exchange(const uint8_t* apdu,
+                         size_t apduSize,
+                         uint8_t* response,
+                         size_t responseMaxSize,
+                         size_t* responseSize);
+
+// Transcripts are concatenated request APDUs, each one a 5 byte header followed
+// by lc bytes of data. Returns the size of the next APDU starting at offset,
+// or 0 if the transcript is truncated there.
+size_t device_nextAPDUSize(const uint8_t* transcript, size_t transcriptSize, size_t offset);
+
+#endif  // H_FIO_NATIVE_DEVICE
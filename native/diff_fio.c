@@ -0,0 +1,515 @@
+// Differential test of the app's encoding kernels against straightforward reference
+// implementations (OpenSSL for AES-CBC, HMAC, RIPEMD-160 and base64, bignum division
+// for base58, printf for amounts) on random inputs. Reports the mismatches and the
+// time per call of the app's kernel relative to the reference, so that optimizations
+// of these kernels can be checked before they go to the device.
+//
+// Usage: diff_fio [-n iterations] [-s seed] [kernel...]
+// Without kernel names all kernels are run. The exit code is 1 if any mismatch was found.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+#include "cx_soft.h"
+#include "device.h"
+
+#include "diffieHellman.h"
+#include "eos_utils.h"
+#include "errors.h"
+#include "textUtils.h"
+
+enum {
+    MAX_PLAINTEXT_SIZE = 256,
+    MAX_CIPHERTEXT_SIZE = DH_AES_IV_SIZE + MAX_PLAINTEXT_SIZE + CX_AES_BLOCK_SIZE + DH_HMAC_SIZE,
+    MAX_BASE64_SIZE = (MAX_CIPHERTEXT_SIZE + 2) / 3 * 4 + 1,
+    // b58enc works on at most 42 bytes (MAX_B58ENC_LENGTH in eos_utils.c)
+    MAX_B58_INPUT_SIZE = 42,
+    MAX_B58_OUTPUT_SIZE = 64,
+    // the public key of diffieHellmann_test.c
+    OTHER_PUBLIC_KEY_SIZE = 65,
+};
+
+static const uint8_t OTHER_PUBLIC_KEY[OTHER_PUBLIC_KEY_SIZE] = {
+    0x04, 0x84, 0xe5, 0x2d, 0xfe, 0xa5, 0x7b, 0x8f, 0x17, 0x87, 0x48, 0x8a, 0x35,
+    0x63, 0x74, 0xcd, 0x8e, 0x85, 0x15, 0xb8, 0xad, 0x8d, 0xb3, 0xdd, 0x4f, 0x90,
+    0x88, 0xd8, 0xe4, 0x2e, 0xd2, 0xfb, 0x6d, 0x57, 0x1e, 0x88, 0x94, 0xcc, 0xcb,
+    0xdb, 0xf1, 0x5e, 0x1b, 0xd8, 0x4f, 0x8b, 0x43, 0x62, 0xf5, 0x2d, 0x1b, 0x5b,
+    0x71, 0x2b, 0x97, 0x75, 0xc0, 0xa5, 0x1c, 0xdd, 0x5e, 0xe9, 0xa9, 0xe8, 0xca,
+};
+
+static const uint32_t DH_PATH[] = {HARDENED_BIP32 + 44,
+                                   HARDENED_BIP32 + 235,
+                                   HARDENED_BIP32 + 0,
+                                   0,
+                                   0};
+
+// ------------------------------ utils ------------------------------
+
+static uint64_t rngState;
+
+// xorshift64*, independent of cx_rng so that the inputs do not depend on the app
+static uint64_t rnd(void) {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return rngState * 0x2545F4914F6CDD1Dull;
+}
+
+static size_t rnd_below(size_t bound) {
+    return (size_t) (rnd() % bound);
+}
+
+static void rnd_bytes(uint8_t* out, size_t size) {
+    for (size_t i = 0; i < size; i++) out[i] = (uint8_t) rnd();
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+typedef struct {
+    uint64_t calls;
+    uint64_t appNs;
+    uint64_t refNs;
+    uint64_t mismatches;
+} kernel_stats_t;
+
+// Reports the first few mismatches of a kernel
+static void report_mismatch(kernel_stats_t* stats,
+                            const char* kernel,
+                            const char* what,
+                            const uint8_t* input,
+                            size_t inputSize) {
+    stats->mismatches++;
+    if (stats->mismatches > 5) return;
+    fprintf(stderr, "%s: %s, input ", kernel, what);
+    for (size_t i = 0; i < inputSize; i++) fprintf(stderr, "%02x", input[i]);
+    fprintf(stderr, "\n");
+}
+
+// Runs an app kernel, returns the exception it threw or 0
+#define APP_CALL(error, call)        \
+    {                                \
+        error = 0;                   \
+        BEGIN_TRY {                  \
+            TRY {                    \
+                call;                \
+            }                        \
+            CATCH_OTHER(e) {         \
+                error = e;           \
+            }                        \
+            FINALLY {                \
+            }                        \
+        }                            \
+        END_TRY;                     \
+    }
+
+// ------------------------------ references ------------------------------
+
+typedef struct {
+    uint8_t aesKey[DH_AES_SECRET_SIZE];
+    uint8_t km[DH_KM_SIZE];
+} ref_dh_key_t;
+
+// IV || AES-256-CBC(PKCS#7 padded plaintext) || HMAC-SHA256(km, IV || ciphertext)
+static size_t ref_dh_encrypt(const ref_dh_key_t* key,
+                             const uint8_t* iv,
+                             const uint8_t* in,
+                             size_t inSize,
+                             uint8_t* out) {
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int len1 = 0, len2 = 0;
+    memcpy(out, iv, DH_AES_IV_SIZE);
+    EVP_EncryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key->aesKey, iv);
+    EVP_EncryptUpdate(ctx, out + DH_AES_IV_SIZE, &len1, in, (int) inSize);
+    EVP_EncryptFinal_ex(ctx, out + DH_AES_IV_SIZE + len1, &len2);
+    EVP_CIPHER_CTX_free(ctx);
+
+    size_t size = DH_AES_IV_SIZE + (size_t) (len1 + len2);
+    unsigned int hmacSize = DH_HMAC_SIZE;
+    HMAC(EVP_sha256(), key->km, DH_KM_SIZE, out, size, out + size, &hmacSize);
+    return size + hmacSize;
+}
+
+// Returns the plaintext size or -1 if the data is rejected
+static int ref_dh_decrypt(const ref_dh_key_t* key, const uint8_t* in, size_t inSize, uint8_t* out) {
+    if (inSize < DH_AES_IV_SIZE + CX_AES_BLOCK_SIZE + DH_HMAC_SIZE) return -1;
+    if (inSize % CX_AES_BLOCK_SIZE != 0) return -1;
+
+    uint8_t hmac[DH_HMAC_SIZE];
+    unsigned int hmacSize = DH_HMAC_SIZE;
+    HMAC(EVP_sha256(), key->km, DH_KM_SIZE, in, inSize - DH_HMAC_SIZE, hmac, &hmacSize);
+    if (CRYPTO_memcmp(hmac, in + inSize - DH_HMAC_SIZE, DH_HMAC_SIZE) != 0) return -1;
+
+    EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+    int len1 = 0, len2 = 0;
+    EVP_DecryptInit_ex(ctx, EVP_aes_256_cbc(), NULL, key->aesKey, in);
+    EVP_DecryptUpdate(ctx,
+                      out,
+                      &len1,
+                      in + DH_AES_IV_SIZE,
+                      (int) (inSize - DH_AES_IV_SIZE - DH_HMAC_SIZE));
+    int ok = EVP_DecryptFinal_ex(ctx, out + len1, &len2);
+    EVP_CIPHER_CTX_free(ctx);
+    return ok == 1 ? len1 + len2 : -1;
+}
+
+static const char BASE58[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// Schoolbook conversion: divide the whole number by 58 until it is zero
+static size_t ref_base58(const uint8_t* in, size_t inSize, char* out) {
+    uint8_t number[MAX_B58_INPUT_SIZE];
+    char digits[MAX_B58_OUTPUT_SIZE];
+    size_t digitCount = 0;
+    size_t zeroes = 0;
+
+    memcpy(number, in, inSize);
+    while (zeroes < inSize && in[zeroes] == 0) zeroes++;
+
+    for (size_t start = zeroes; start < inSize;) {
+        unsigned remainder = 0;
+        for (size_t i = start; i < inSize; i++) {
+            unsigned value = remainder * 256 + number[i];
+            number[i] = (uint8_t) (value / 58);
+            remainder = value % 58;
+        }
+        digits[digitCount++] = BASE58[remainder];
+        while (start < inSize && number[start] == 0) start++;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < zeroes; i++) out[size++] = '1';
+    while (digitCount > 0) out[size++] = digits[--digitCount];
+    out[size] = 0;
+    return size;
+}
+
+static size_t ref_public_key_to_wif(const uint8_t* publicKey, char* out) {
+    uint8_t data[37];
+    data[0] = (publicKey[64] & 1) ? 0x03 : 0x02;
+    memcpy(data + 1, publicKey + 1, 32);
+
+    uint8_t check[20];
+    EVP_Digest(data, 33, check, NULL, EVP_ripemd160(), NULL);
+    memcpy(data + 33, check, 4);
+
+    memcpy(out, "FIO", 3);
+    return 3 + ref_base58(data, sizeof(data), out + 3);
+}
+
+static size_t ref_formatFIOAmount(uint64_t amount, char* out, size_t outSize) {
+    char whole[32];
+    snprintf(whole, sizeof(whole), "%" PRIu64, amount / 1000000000);
+
+    // thousands separators
+    char grouped[40];
+    size_t size = 0;
+    size_t wholeLength = strlen(whole);
+    for (size_t i = 0; i < wholeLength; i++) {
+        if (i > 0 && (wholeLength - i) % 3 == 0) grouped[size++] = ',';
+        grouped[size++] = whole[i];
+    }
+    grouped[size] = 0;
+
+    return (size_t) snprintf(out, outSize, "%s.%09" PRIu64 " FIO", grouped, amount % 1000000000);
+}
+
+// ------------------------------ kernels ------------------------------
+
+// keys derived once by the app, the kernels below do not cover the key derivation
+// (it is checked against fiojs vectors by run_diffieHellman_test)
+static dh_aes_key_t appKey;
+static ref_dh_key_t refKey;
+static bip44_path_t dhPath;
+static public_key_t otherPublicKey;
+
+static size_t app_dh_encode(const uint8_t* iv,
+                            const uint8_t* plaintext,
+                            const size_t* chunks,
+                            size_t chunkCount,
+                            uint8_t* out,
+                            size_t outSize) {
+    dh_context_t ctx;
+    size_t written = dh_encode_init(&ctx, &appKey, iv, DH_AES_IV_SIZE, out, outSize);
+    for (size_t i = 0; i < chunkCount; i++) {
+        written +=
+            dh_encode_append(&ctx, &appKey, plaintext, chunks[i], out + written, outSize - written);
+        plaintext += chunks[i];
+    }
+    written += dh_encode_finalize(&ctx, &appKey, out + written, outSize - written);
+    return written;
+}
+
+// dh_encode_init/append/finalize with the plaintext split into random chunks,
+// also covers base64EncWholeBlocks and the padding of the last base64 block
+static void kernel_dh_encode(kernel_stats_t* stats) {
+    uint8_t plaintext[MAX_PLAINTEXT_SIZE];
+    uint8_t iv[DH_AES_IV_SIZE];
+    size_t chunks[MAX_PLAINTEXT_SIZE];
+    uint8_t appOut[MAX_BASE64_SIZE];
+    uint8_t refRaw[MAX_CIPHERTEXT_SIZE];
+    uint8_t refOut[MAX_BASE64_SIZE];
+
+    size_t size = rnd_below(MAX_PLAINTEXT_SIZE + 1);
+    rnd_bytes(plaintext, size);
+    rnd_bytes(iv, sizeof(iv));
+    size_t chunkCount = 0;
+    for (size_t offset = 0; offset < size; offset += chunks[chunkCount++]) {
+        chunks[chunkCount] = 1 + rnd_below(size - offset);
+    }
+
+    uint16_t error;
+    size_t appSize = 0;
+    uint64_t start = now_ns();
+    APP_CALL(error,
+             appSize = app_dh_encode(iv, plaintext, chunks, chunkCount, appOut, sizeof(appOut)));
+    uint64_t middle = now_ns();
+    size_t rawSize = ref_dh_encrypt(&refKey, iv, plaintext, size, refRaw);
+    size_t refSize = (size_t) EVP_EncodeBlock(refOut, refRaw, (int) rawSize);
+    uint64_t end = now_ns();
+
+    stats->appNs += middle - start;
+    stats->refNs += end - middle;
+    if (error != 0) {
+        report_mismatch(stats, "dh_encode", "app threw", plaintext, size);
+    } else if (appSize != refSize || memcmp(appOut, refOut, refSize) != 0) {
+        report_mismatch(stats, "dh_encode", "different output", plaintext, size);
+    }
+}
+
+// dh_decode of valid messages, and of messages with one byte flipped which both must reject
+static void kernel_dh_decode(kernel_stats_t* stats) {
+    uint8_t plaintext[MAX_PLAINTEXT_SIZE];
+    uint8_t iv[DH_AES_IV_SIZE];
+    uint8_t message[MAX_CIPHERTEXT_SIZE];
+    uint8_t appBuffer[MAX_CIPHERTEXT_SIZE];
+    uint8_t refOut[MAX_CIPHERTEXT_SIZE];
+
+    size_t size = rnd_below(MAX_PLAINTEXT_SIZE + 1);
+    rnd_bytes(plaintext, size);
+    rnd_bytes(iv, sizeof(iv));
+    size_t messageSize = ref_dh_encrypt(&refKey, iv, plaintext, size, message);
+    if (rnd_below(4) == 0) {
+        message[rnd_below(messageSize)] ^= (uint8_t) (1 + rnd_below(255));
+    }
+    memcpy(appBuffer, message, messageSize);
+
+    uint16_t error;
+    size_t appSize = 0;
+    uint64_t start = now_ns();
+    APP_CALL(error, appSize = dh_decode(&dhPath, &otherPublicKey, appBuffer, messageSize));
+    uint64_t middle = now_ns();
+    int refSize = ref_dh_decrypt(&refKey, message, messageSize, refOut);
+    uint64_t end = now_ns();
+
+    stats->appNs += middle - start;
+    stats->refNs += end - middle;
+    if (refSize < 0) {
+        if (error != ERR_INVALID_HMAC && error != ERR_INVALID_DATA) {
+            report_mismatch(stats, "dh_decode", "app accepted invalid data", message, messageSize);
+        }
+    } else if (error != 0) {
+        report_mismatch(stats, "dh_decode", "app rejected valid data", message, messageSize);
+    } else if (appSize != (size_t) refSize || memcmp(appBuffer, refOut, appSize) != 0) {
+        report_mismatch(stats, "dh_decode", "different plaintext", message, messageSize);
+    }
+}
+
+// b58enc (used by public_key_to_wif) on inputs with leading zeroes
+static void kernel_base58(kernel_stats_t* stats) {
+    uint8_t input[MAX_B58_INPUT_SIZE];
+    char appOut[MAX_B58_OUTPUT_SIZE];
+    char refOut[MAX_B58_OUTPUT_SIZE];
+
+    size_t size = 1 + rnd_below(MAX_B58_INPUT_SIZE);
+    rnd_bytes(input, size);
+    memset(input, 0, rnd_below(4) == 0 ? rnd_below(size + 1) : 0);
+
+    uint16_t error;
+    bool ok = false;
+    uint32_t appSize = sizeof(appOut);
+    uint64_t start = now_ns();
+    APP_CALL(error, ok = b58enc(input, (uint32_t) size, appOut, &appSize));
+    uint64_t middle = now_ns();
+    size_t refSize = ref_base58(input, size, refOut);
+    uint64_t end = now_ns();
+
+    stats->appNs += middle - start;
+    stats->refNs += end - middle;
+    // appSize includes the terminating zero
+    if (error != 0 || !ok) {
+        report_mismatch(stats, "base58", "app failed", input, size);
+    } else if (appSize != refSize + 1 || strcmp(appOut, refOut) != 0) {
+        report_mismatch(stats, "base58", "different output", input, size);
+    }
+}
+
+static void kernel_public_key_to_wif(kernel_stats_t* stats) {
+    uint8_t publicKey[65];
+    char appOut[MAX_B58_OUTPUT_SIZE];
+    char refOut[MAX_B58_OUTPUT_SIZE];
+
+    rnd_bytes(publicKey, sizeof(publicKey));
+    publicKey[0] = 0x04;
+
+    uint16_t error;
+    uint32_t appSize = 0;
+    uint64_t start = now_ns();
+    APP_CALL(error,
+             appSize = public_key_to_wif(publicKey, sizeof(publicKey), appOut, sizeof(appOut)));
+    uint64_t middle = now_ns();
+    size_t refSize = ref_public_key_to_wif(publicKey, refOut);
+    uint64_t end = now_ns();
+
+    stats->appNs += middle - start;
+    stats->refNs += end - middle;
+    // as for b58enc, the returned size includes the terminating zero
+    if (error != 0) {
+        report_mismatch(stats, "public_key_to_wif", "app threw", publicKey, sizeof(publicKey));
+    } else if (appSize != refSize + 1 || strcmp(appOut, refOut) != 0) {
+        report_mismatch(stats,
+                        "public_key_to_wif",
+                        "different output",
+                        publicKey,
+                        sizeof(publicKey));
+    }
+}
+
+static void kernel_fio_amount(kernel_stats_t* stats) {
+    char appOut[40];
+    char refOut[40];
+
+    // all magnitudes, not only the huge numbers uniform sampling would give
+    uint64_t amount = rnd() >> rnd_below(64);
+
+    uint16_t error;
+    size_t appSize = 0;
+    uint64_t start = now_ns();
+    APP_CALL(error, appSize = str_formatFIOAmount(amount, appOut, sizeof(appOut)));
+    uint64_t middle = now_ns();
+    size_t refSize = ref_formatFIOAmount(amount, refOut, sizeof(refOut));
+    uint64_t end = now_ns();
+
+    stats->appNs += middle - start;
+    stats->refNs += end - middle;
+    const uint8_t* input = (const uint8_t*) &amount;
+    if (error != 0) {
+        report_mismatch(stats, "str_formatFIOAmount", "app threw", input, sizeof(amount));
+    } else if (appSize != refSize || strcmp(appOut, refOut) != 0) {
+        report_mismatch(stats, "str_formatFIOAmount", "different output", input, sizeof(amount));
+    }
+}
+
+typedef struct {
+    const char* name;
+    void (*run)(kernel_stats_t* stats);
+    // dh_decode derives the key (an EC multiplication) in every call
+    uint64_t iterationDivisor;
+} kernel_t;
+
+static const kernel_t KERNELS[] = {
+    {"dh_encode", kernel_dh_encode, 1},
+    {"dh_decode", kernel_dh_decode, 1000},
+    {"base58", kernel_base58, 1},
+    {"public_key_to_wif", kernel_public_key_to_wif, 1},
+    {"str_formatFIOAmount", kernel_fio_amount, 1},
+};
+
+static void init_keys(void) {
+    dhPath.length = ARRAY_LEN(DH_PATH);
+    memcpy(dhPath.path, DH_PATH, sizeof(DH_PATH));
+    cx_ecfp_init_public_key_no_throw(CX_CURVE_SECP256K1,
+                                     OTHER_PUBLIC_KEY,
+                                     sizeof(OTHER_PUBLIC_KEY),
+                                     &otherPublicKey);
+    dh_init_aes_key(&appKey, &dhPath, &otherPublicKey);
+
+    STATIC_ASSERT(sizeof(appKey.aesKey.keys) == sizeof(refKey.aesKey), "unexpected AES key size");
+    memcpy(refKey.aesKey, appKey.aesKey.keys, sizeof(refKey.aesKey));
+    memcpy(refKey.km, appKey.km, sizeof(refKey.km));
+}
+
+static bool run_kernel(const kernel_t* kernel, uint64_t iterations) {
+    kernel_stats_t stats = {0};
+    uint64_t calls = iterations / kernel->iterationDivisor;
+    if (calls == 0) calls = 1;
+
+    for (stats.calls = 0; stats.calls < calls; stats.calls++) {
+        kernel->run(&stats);
+    }
+
+    printf("%-22s %10" PRIu64 " %10" PRIu64 " %10.0f %10.0f %8.2f\n",
+           kernel->name,
+           stats.calls,
+           stats.mismatches,
+           (double) stats.appNs / (double) stats.calls,
+           (double) stats.refNs / (double) stats.calls,
+           (double) stats.refNs / (double) stats.appNs);
+    return stats.mismatches == 0;
+}
+
+int main(int argc, char** argv) {
+    uint64_t iterations = 1000000;
+    uint64_t seed = 1;
+
+    int arg = 1;
+    for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+        if (strcmp(argv[arg], "-n") == 0) {
+            iterations = strtoull(argv[arg + 1], NULL, 10);
+        } else if (strcmp(argv[arg], "-s") == 0) {
+            seed = strtoull(argv[arg + 1], NULL, 10);
+        } else {
+            break;
+        }
+    }
+    if (arg < argc && argv[arg][0] == '-') {
+        fprintf(stderr, "Usage: diff_fio [-n iterations] [-s seed] [kernel...]\n");
+        return 2;
+    }
+
+    device_reset();
+    cx_soft_seed_rng(0);
+    rngState = seed != 0 ? seed : 1;
+
+    uint16_t error;
+    APP_CALL(error, init_keys());
+    if (error != 0) {
+        fprintf(stderr, "Key derivation failed with 0x%04x\n", error);
+        return 1;
+    }
+
+    printf("%-22s %10s %10s %10s %10s %8s\n",
+           "kernel",
+           "calls",
+           "mismatches",
+           "app ns",
+           "ref ns",
+           "speedup");
+    int failures = 0;
+    if (arg == argc) {
+        for (size_t i = 0; i < ARRAY_LEN(KERNELS); i++) {
+            if (!run_kernel(&KERNELS[i], iterations)) failures++;
+        }
+    }
+    for (; arg < argc; arg++) {
+        const kernel_t* kernel = NULL;
+        for (size_t i = 0; i < ARRAY_LEN(KERNELS); i++) {
+            if (strcmp(KERNELS[i].name, argv[arg]) == 0) kernel = &KERNELS[i];
+        }
+        if (kernel == NULL) {
+            fprintf(stderr, "Unknown kernel %s\n", argv[arg]);
+            failures++;
+        } else if (!run_kernel(kernel, iterations)) {
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+// Host replacement of the SDK syscalls and of io.c / main.c glue used by the app core.
+// Crypto lives in cx_soft.c.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "os_native.h"
+#include "state.h"
+#include "uiHelpers.h"
+
+native_io_t nativeIO;
+
+unsigned char G_io_apdu_buffer[260];
+unsigned int app_stack_canary = 0xDEAD0031;
+
+io_state_t io_state = IO_EXPECT_NONE;
+
+// ============================== EXCEPTIONS ==============================
+
+static try_context_t* current_context = NULL;
+
+try_context_t* try_context_get(void) {
+    return current_context;
+}
+
+try_context_t* try_context_set(try_context_t* ctx) {
+    try_context_t* previous_ctx = current_context;
+    current_context = ctx;
+    return previous_ctx;
+}
+
+void os_longjmp(unsigned int exception) {
+    // an exception outside of any TRY would crash the device
+    if (current_context == NULL) abort();
+    longjmp(current_context->jmp_buf, exception);
+}
+
+// ============================== IO ==============================
+
+void CHECK_RESPONSE_SIZE(unsigned int tx) {
+    // Note(ppershing): we do both checks due to potential overflows
+    ASSERT(tx < sizeof(G_io_apdu_buffer));
+    ASSERT(tx + 2u < sizeof(G_io_apdu_buffer));
+}
+
+void io_send_buf(uint16_t code, uint8_t* buffer, size_t bufferSize) {
+    CHECK_RESPONSE_SIZE(bufferSize);
+    STATIC_ASSERT(SIZEOF(nativeIO.response) >= SIZEOF(G_io_apdu_buffer) - 2, "response too small");
+
+    if (bufferSize > 0) {
+        memmove(nativeIO.response, buffer, bufferSize);
+    }
+    nativeIO.responseSize = bufferSize;
+    nativeIO.sw = code;
+    nativeIO.responded = true;
+
+    // From now on we can receive new APDU
+    io_state = IO_EXPECT_IO;
+}
+
+void io_seproxyhal_se_reset(void) {
+    // unwinds to device_exchange which restarts the app
+    THROW(EXCEPTION_IO_RESET);
+}
+
+void io_seproxyhal_io_heartbeat(void) {
+}
+
+bool device_is_unlocked() {
+    return true;
+}
+
+// ============================== UI ==============================
+
+void nanos_clear_timer() {
+    nativeIO.timer = NULL;
+}
+
+void nanos_set_timer(int ms, timeout_callback_fn_t* cb) {
+    ASSERT(nativeIO.timer == NULL);
+    ASSERT(ms >= 0);
+    nativeIO.timer = cb;
+}
+
+void ui_idle(void) {
+    currentInstruction = INS_NONE;
+    nanos_clear_timer();
+}
+
+void io_seproxyhal_init_ux(void) {
+}
+
+void io_seproxyhal_init_button(void) {
+}
+
+void io_seproxyhal_display(const bagl_element_t* element) {
+    (void) element;
+}
+
+unsigned int io_seph_is_status_sent(void) {
+    return 1;
+}
+
+unsigned int os_ux(bolos_ux_params_t* params) {
+    (void) params;
+    return 1;
+}
+
+bolos_task_status_t os_sched_last_status(unsigned int task_idx) {
+    (void) task_idx;
+    return 0;
+}
+
+bolos_bool_t os_perso_isonboarded(void) {
+    return 1;
+}
+
+void* pic(void* link_address) {
+    return link_address;
+}
+
+unsigned int os_serial(unsigned char* serial, unsigned int maxlength) {
+    static const uint8_t SERIAL[] = {0x46, 0x49, 0x4f, 0x00, 0x00, 0x00, 0x01};
+    unsigned int len = maxlength < sizeof(SERIAL) ? maxlength : sizeof(SERIAL);
+    memcpy(serial, SERIAL, len);
+    return len;
+}
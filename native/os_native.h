@@ -0,0 +1,24 @@
+#ifndef H_FIO_NATIVE_OS_NATIVE
+#define H_FIO_NATIVE_OS_NATIVE
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "io.h"
+#include "device.h"
+
+// State of the emulated io layer, see os_native.c
+typedef struct {
+    // set by io_send_buf
+    bool responded;
+    uint16_t sw;
+    uint8_t response[DEVICE_MAX_RESPONSE_SIZE];
+    size_t responseSize;
+    // headless confirmation scheduled by nanos_set_timer
+    timeout_callback_fn_t* timer;
+} native_io_t;
+
+extern native_io_t nativeIO;
+
+#endif  // H_FIO_NATIVE_OS_NATIVE
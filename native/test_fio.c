@@ -0,0 +1,105 @@
+// Runs the unit tests of the app (run_*_test, the same ones as handleRunTests)
+// on the host-native DEVEL build.
+//
+// Usage: test_fio [--list | test_name...]
+// Without arguments all tests are run.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "device.h"
+#include "cx_soft.h"
+#include "os_native.h"
+#include "state.h"
+#include "uiHelpers.h"
+
+#include "bip44.h"
+#include "diffieHellman.h"
+#include "hexUtils.h"
+#include "keyDerivation.h"
+#include "signTransactionCountedSection.h"
+#include "signTransactionIntegrity.h"
+#include "signTransactionTemplates.h"
+#include "textUtils.h"
+
+typedef struct {
+    const char* name;
+    void (*run)();
+} test_case_t;
+
+static const test_case_t TESTS[] = {
+    {"hex", run_hex_test},
+    {"textUtils", run_textUtils_test},
+    {"bip44", run_bip44_test},
+    {"keyDerivation", run_key_derivation_test},
+    {"diffieHellman", run_diffieHellman_test},
+    {"integrityCheck", run_integrityCheck_test},
+    {"countedSection", run_countedSection_test},
+    {"txTemplates", run_txTemplates_test},
+};
+
+static const test_case_t* findTest(const char* name) {
+    for (size_t i = 0; i < ARRAY_LEN(TESTS); i++) {
+        if (strcmp(TESTS[i].name, name) == 0) return &TESTS[i];
+    }
+    return NULL;
+}
+
+// Returns true if the test passed
+static bool runTest(const test_case_t* test) {
+    volatile unsigned short error = 0;
+
+    device_reset();
+    cx_soft_seed_rng(0);
+    // as while handling an APDU on the device
+    io_state = IO_EXPECT_NONE;
+    BEGIN_TRY {
+        TRY {
+            test->run();
+        }
+        CATCH_OTHER(e) {
+            error = e;
+        }
+        FINALLY {
+        }
+    }
+    END_TRY;
+
+    if (error == ERR_ASSERT) {
+        // the DEVEL assert shows its message before throwing
+        printf("FAIL %s: assertion failed %s\n", test->name, displayState.paginatedText.fullText);
+    } else if (error != 0) {
+        printf("FAIL %s: unexpected exception 0x%04x\n", test->name, error);
+    } else {
+        printf("OK   %s\n", test->name);
+    }
+    // drop the assertion screen
+    nanos_clear_timer();
+    return error == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 2 && strcmp(argv[1], "--list") == 0) {
+        for (size_t i = 0; i < ARRAY_LEN(TESTS); i++) {
+            printf("%s\n", TESTS[i].name);
+        }
+        return 0;
+    }
+
+    int failures = 0;
+    if (argc == 1) {
+        for (size_t i = 0; i < ARRAY_LEN(TESTS); i++) {
+            if (!runTest(&TESTS[i])) failures++;
+        }
+    }
+    for (int arg = 1; arg < argc; arg++) {
+        const test_case_t* test = findTest(argv[arg]);
+        if (test == NULL) {
+            fprintf(stderr, "Unknown test %s\n", argv[arg]);
+            failures++;
+        } else if (!runTest(test)) {
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
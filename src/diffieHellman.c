@@ -197,6 +197,52 @@ __noinline_due_to_stack__ size_t dh_encode_append(dh_context_t* ctx,
     return written;
 }
 
+size_t dh_encode_append_output_size(const dh_context_t* ctx, size_t inSize) {
+    ASSERT(inSize < BUFFER_SIZE_PARANOIA);
+    ASSERT(ctx->initialized_magic == HASH_CONTEXT_INITIALIZED_MAGIC);
+    ASSERT(ctx->cacheLength < CX_AES_BLOCK_SIZE);
+
+    // every whole AES block is encrypted and pushed to the base64 cache,
+    // only whole base64 blocks are written out
+    size_t aesBlocks = (ctx->cacheLength + inSize) / CX_AES_BLOCK_SIZE;
+    size_t base64Input = ctx->base64EncodingCacheLen + aesBlocks * CX_AES_BLOCK_SIZE;
+    return BASE64_OUT_BLOCK_SIZE * (base64Input / BASE64_IN_BLOCK_SIZE);
+}
+
+__noinline_due_to_stack__ size_t dh_encode_append_in_place(dh_context_t* ctx,
+                                                           const dh_aes_key_t* aes_key,
+                                                           const uint8_t* inBuffer,
+                                                           size_t inSize,
+                                                           uint8_t* buffer,
+                                                           size_t bufferSize) {
+    TRACE_STACK_USAGE();
+    ASSERT(inSize < BUFFER_SIZE_PARANOIA);
+    ASSERT(inBuffer >= buffer && inBuffer + inSize <= buffer + bufferSize);
+
+    const size_t outSize = dh_encode_append_output_size(ctx, inSize);
+    VALIDATE(outSize <= bufferSize, ERR_INVALID_DATA);
+
+    // The last partial AES block is read to the cache only after the last output is written,
+    // so it is kept aside
+    const size_t tailSize = MIN((ctx->cacheLength + inSize) % CX_AES_BLOCK_SIZE, inSize);
+    uint8_t tail[CX_AES_BLOCK_SIZE];
+    memcpy(tail, inBuffer + inSize - tailSize, tailSize);
+
+    // The whole blocks are moved to the end of the buffer and the output is written from its
+    // beginning. Every block adds at least 20 bytes of base64 output while 16 bytes of input are
+    // read, so if the whole output fits, it never reaches the input not read yet.
+    const size_t blocksSize = inSize - tailSize;
+    uint8_t* blocks = buffer + bufferSize - blocksSize;
+    memmove(blocks, inBuffer, blocksSize);
+
+    size_t written = dh_encode_append(ctx, aes_key, blocks, blocksSize, buffer, bufferSize);
+    written +=
+        dh_encode_append(ctx, aes_key, tail, tailSize, buffer + written, bufferSize - written);
+    explicit_bzero(tail, SIZEOF(tail));
+    ASSERT(written == outSize);
+    return written;
+}
+
 __noinline_due_to_stack__ size_t dh_encode_finalize(dh_context_t* ctx,
                                                     const dh_aes_key_t* aes_key,
                                                     uint8_t* outBuffer,
@@ -71,6 +71,19 @@ __noinline_due_to_stack__ size_t dh_encode_append(dh_context_t* ctx,
                                                   uint8_t* outBuffer,
                                                   size_t outSize);
 
+// Number of bytes dh_encode_append will write for inSize bytes of input, given the current state
+// of ctx
+size_t dh_encode_append_output_size(const dh_context_t* ctx, size_t inSize);
+
+// dh_encode_append of input which is in buffer (e.g. G_io_apdu_buffer), the output is written from
+// the beginning of the same buffer. Throws ERR_INVALID_DATA if the output does not fit.
+__noinline_due_to_stack__ size_t dh_encode_append_in_place(dh_context_t* ctx,
+                                                           const dh_aes_key_t* aes_key,
+                                                           const uint8_t* inBuffer,
+                                                           size_t inSize,
+                                                           uint8_t* buffer,
+                                                           size_t bufferSize);
+
 // Output data are base64 encrypted
 __noinline_due_to_stack__ size_t dh_encode_finalize(dh_context_t* ctx,
                                                     const dh_aes_key_t* aes_key,
@@ -326,6 +326,115 @@ __noinline_due_to_stack__ static void run_dh_decode_failed_hmac_tests() {
     EXPECT_THROWS(dh_decode(&pathSpec, &publicKey, msg, msgLen), ERR_INVALID_HMAC);
 }
 
+// Byte of the test input at the given position
+static uint8_t inPlaceTestByte(size_t i) {
+    return (uint8_t) (i * 7 + 3);
+}
+
+// dh_encode_append_in_place writes the same output as dh_encode_append for every state of the
+// AES block cache, up to the output filling the whole APDU buffer (the input being at its
+// position in the APDU). A larger output is rejected.
+__noinline_due_to_stack__ static void run_dh_encode_append_in_place_tests() {
+    BEGIN_ASSERT_NOEXCEPT {
+        TRACE_STACK_USAGE();
+
+        uint32_t path[] = {HD + 44, HD + 235, HD + 0, 0, 2000};
+        bip44_path_t pathSpec;
+        pathSpec_init(&pathSpec, path, 5);
+
+        public_key_t publicKey;
+        {
+            const char* publicKeyHex =
+                "0484e52dfea57b8f1787488a356374cd8e8515b8ad8db3dd4f9088d8e42ed2fb6d571e8894cccbdbf1"
+                "5e1bd84f8b4362f52d1b5b712b9775c0a51cdd5ee9a9e8ca";
+            uint8_t publicKeyBuffer[65];
+            size_t publicKeyLen =
+                decode_hex(publicKeyHex, publicKeyBuffer, SIZEOF(publicKeyBuffer));
+            ASSERT(publicKeyLen == 65);
+            cx_ecfp_init_public_key_no_throw(CX_CURVE_SECP256K1,
+                                             publicKeyBuffer,
+                                             publicKeyLen,
+                                             &publicKey);
+        }
+        const uint8_t IV[DH_AES_IV_SIZE] = {0};
+
+        dh_aes_key_t key;
+        dh_init_aes_key(&key, &pathSpec, &publicKey);
+
+        // APDU header, const and var data lengths and the const data of APPEND_DATA
+        const size_t inOffset = 5 + 2 + 20;
+        // due to memory limitations we reuse static tx data
+        dh_context_t* ctx = &instructionState.signTransactionContext.dhContext;
+        bool acceptedAtBoundary = false;
+        for (size_t cached = 0; cached < CX_AES_BLOCK_SIZE; cached++) {
+            for (size_t inSize = 180; inSize <= MAX_TX_APPEND_IN_SINGLE_APDU; inSize++) {
+                const uint8_t prefix[CX_AES_BLOCK_SIZE] = {0};
+                uint8_t* out = G_io_apdu_buffer;
+                dh_encode_init(ctx, &key, IV, SIZEOF(IV), out, SIZEOF(G_io_apdu_buffer));
+                dh_encode_append(ctx, &key, prefix, cached, out, SIZEOF(G_io_apdu_buffer));
+                dh_context_t saved;
+                memcpy(&saved, ctx, SIZEOF(saved));
+
+                // the reference output, encoded block by block from another buffer
+                uint8_t expectedHash[SHA_256_SIZE];
+                size_t expectedSize = 0;
+                {
+                    sha_256_context_t hashCtx;
+                    sha_256_init(&hashCtx);
+                    uint8_t piece[CX_AES_BLOCK_SIZE];
+                    uint8_t out[6 * BASE64_OUT_BLOCK_SIZE];
+                    for (size_t read = 0; read < inSize; read += CX_AES_BLOCK_SIZE) {
+                        const size_t pieceSize = MIN(CX_AES_BLOCK_SIZE, inSize - read);
+                        for (size_t i = 0; i < pieceSize; i++) {
+                            piece[i] = inPlaceTestByte(read + i);
+                        }
+                        size_t written =
+                            dh_encode_append(ctx, &key, piece, pieceSize, out, SIZEOF(out));
+                        sha_256_append(&hashCtx, out, written);
+                        expectedSize += written;
+                    }
+                    sha_256_finalize(&hashCtx, expectedHash, SIZEOF(expectedHash));
+                }
+
+                memcpy(ctx, &saved, SIZEOF(saved));
+                uint8_t* inBuffer = G_io_apdu_buffer + inOffset;
+                for (size_t i = 0; i < inSize; i++) {
+                    inBuffer[i] = inPlaceTestByte(i);
+                }
+                if (expectedSize > SIZEOF(G_io_apdu_buffer)) {
+                    EXPECT_THROWS(dh_encode_append_in_place(ctx,
+                                                            &key,
+                                                            inBuffer,
+                                                            inSize,
+                                                            G_io_apdu_buffer,
+                                                            SIZEOF(G_io_apdu_buffer)),
+                                  ERR_INVALID_DATA);
+                    continue;
+                }
+                size_t written = dh_encode_append_in_place(ctx,
+                                                           &key,
+                                                           inBuffer,
+                                                           inSize,
+                                                           G_io_apdu_buffer,
+                                                           SIZEOF(G_io_apdu_buffer));
+                ASSERT(written == expectedSize);
+                ASSERT(ctx->cacheLength == (cached + inSize) % CX_AES_BLOCK_SIZE);
+                uint8_t hash[SHA_256_SIZE];
+                sha_256_hash(G_io_apdu_buffer, written, hash, SIZEOF(hash));
+                EXPECT_EQ_BYTES(hash, expectedHash, SIZEOF(hash));
+
+                // the last partial block would have been overwritten if it was encoded in place
+                if (written + ctx->cacheLength > SIZEOF(G_io_apdu_buffer)) {
+                    acceptedAtBoundary = true;
+                }
+            }
+        }
+        ASSERT(acceptedAtBoundary);
+        explicit_bzero(&key, SIZEOF(key));
+    }
+    END_ASSERT_NOEXCEPT;
+}
+
 __noinline_due_to_stack__ void run_diffieHellman_test() {
     PRINTF("Running DH tests\n");
     PRINTF("If they fail, make sure you seeded your device with\n");
@@ -335,6 +444,8 @@ __noinline_due_to_stack__ void run_diffieHellman_test() {
     TRACE_STACK_USAGE();
     run_dh_encode_init_append_finalize_tests();
     TRACE_STACK_USAGE();
+    run_dh_encode_append_in_place_tests();
+    TRACE_STACK_USAGE();
     run_dh_decode_tests();
     TRACE_STACK_USAGE();
     run_dh_decode_failed_hmac_tests();
@@ -0,0 +1,57 @@
+#ifndef H_FIO_APP_DISPATCH
+#define H_FIO_APP_DISPATCH
+
+#include <os_io_seproxyhal.h>
+
+#include "handlers.h"
+#include "state.h"
+#include "errors.h"
+#include "assert.h"
+
+static const uint8_t CLA = 0xD7;
+
+// Validates the request APDU of size rx in G_io_apdu_buffer and calls the handler
+// of its instruction. Throws on malformed requests.
+// Inlined into the main loop (and the native harness) so that the handler runs at the same
+// stack depth as before it was shared.
+static inline void dispatchAPDU(size_t rx) {
+    // Note(ppershing): unsafe to access before checks
+    // Warning(ppershing): in case of unlikely change of APDU format
+    // make sure you read wider values as big endian
+    struct {
+        uint8_t cla;
+        uint8_t ins;
+        uint8_t p1;
+        uint8_t p2;
+        uint8_t lc;
+    }* header = (void*) G_io_apdu_buffer;
+
+    VALIDATE(rx >= SIZEOF(*header), ERR_MALFORMED_REQUEST_HEADER);
+
+    // check that data is safe to access
+    VALIDATE(rx == header->lc + SIZEOF(*header), ERR_MALFORMED_REQUEST_HEADER);
+
+    uint8_t* data = G_io_apdu_buffer + SIZEOF(*header);
+
+    VALIDATE(header->cla == CLA, ERR_BAD_CLA);
+
+    TRACE("APDU: ins = %d,   p1 = %d,    p2 = %d", header->ins, header->p1, header->p2);
+
+    // Lookup and call the requested command handler.
+    handler_fn_t* handlerFn = lookupHandler(header->ins);
+
+    VALIDATE(handlerFn != NULL, ERR_UNKNOWN_INS);
+
+    bool isNewCall = false;
+    if (currentInstruction == INS_NONE) {
+        explicit_bzero(&instructionState, SIZEOF(instructionState));
+        isNewCall = true;
+        currentInstruction = header->ins;
+    } else {
+        VALIDATE(header->ins == currentInstruction, ERR_STILL_IN_CALL);
+    }
+
+    handlerFn(header->p1, header->p2, data, header->lc, isNewCall);
+}
+
+#endif  // H_FIO_APP_DISPATCH
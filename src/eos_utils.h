@@ -34,6 +34,8 @@ void rng_rfc6979(unsigned char *rnd,
                  unsigned char *V,
                  unsigned char *K);
 
+bool b58enc(uint8_t *bin, uint32_t binsz, char *b58, uint32_t *b58sz);
+
 uint32_t public_key_to_wif(const uint8_t *publicKey,
                            uint32_t keyLength,
                            char *out,
@@ -0,0 +1,74 @@
+#include "common.h"
+#include "handlers.h"
+
+#include "getAppInfo.h"
+#include "signTransaction.h"
+#include "uiHelpers.h"
+
+#define SERIAL_LENGTH 7  // if too short, exception 2 is thrown by os_serial
+
+// Instruction and command lists are bounded, there are only a few of them
+#define MAX_LISTED 16
+
+enum {
+    FLAG_DEVEL = 1,
+};
+
+// Everything the host needs at the start of a session in a single response: the same version
+// as GET_VERSION, the same serial as GET_SERIAL, the maximal data size of a request and
+// the supported instructions and sign transaction commands (P1 values).
+// It does not change while the app runs, so the host can cache it.
+void getAppInfo_handleAPDU(uint8_t p1,
+                           uint8_t p2,
+                           uint8_t *wireDataBuffer MARK_UNUSED,
+                           size_t wireDataSize,
+                           bool isNewCall MARK_UNUSED) {
+    VALIDATE(p1 == P1_UNUSED, ERR_INVALID_REQUEST_PARAMETERS);
+    VALIDATE(p2 == P2_UNUSED, ERR_INVALID_REQUEST_PARAMETERS);
+    VALIDATE(wireDataSize == 0, ERR_INVALID_DATA);
+
+    // version, flags, serial, max data size, then two lists prefixed by their length
+    uint8_t response[4 + SERIAL_LENGTH + 1 + (1 + MAX_LISTED) * 2];
+    size_t len = 0;
+
+    response[len++] = MAJOR_VERSION;
+    response[len++] = MINOR_VERSION;
+    response[len++] = PATCH_VERSION;
+    response[len] = 0;
+#ifdef DEVEL
+    response[len] |= FLAG_DEVEL;
+#endif  // DEVEL
+    len++;
+
+    size_t serialLen = os_serial(response + len, SERIAL_LENGTH);
+    ASSERT(serialLen == SERIAL_LENGTH);
+    len += SERIAL_LENGTH;
+
+    // the request header takes 5 bytes of the APDU buffer
+    STATIC_ASSERT(SIZEOF(G_io_apdu_buffer) - 5 >= 255, "APDU buffer too small");
+    response[len++] = 255;
+
+    size_t countPos = len++;
+    response[countPos] = 0;
+    for (unsigned ins = 0; ins <= 0xFF; ins++) {
+        if (lookupHandler((uint8_t) ins) != NULL) {
+            ASSERT(response[countPos] < MAX_LISTED);
+            response[len++] = (uint8_t) ins;
+            response[countPos]++;
+        }
+    }
+
+    countPos = len++;
+    response[countPos] = 0;
+    for (unsigned command = 0; command <= 0xFF; command++) {
+        if (signTransaction_isSupportedCommand((uint8_t) command)) {
+            ASSERT(response[countPos] < MAX_LISTED);
+            response[len++] = (uint8_t) command;
+            response[countPos]++;
+        }
+    }
+    ASSERT(len <= SIZEOF(response));
+
+    io_send_buf(SUCCESS, response, len);
+    ui_idle();
+}
@@ -0,0 +1,8 @@
+#ifndef H_FIO_APP_GET_APP_INFO
+#define H_FIO_APP_GET_APP_INFO
+
+#include "handlers.h"
+
+handler_fn_t getAppInfo_handleAPDU;
+
+#endif  // H_FIO_APP_GET_APP_INFO
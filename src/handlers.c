@@ -7,9 +7,11 @@
 #include "decodeDH.h"
 #include "getVersion.h"
 #include "getSerial.h"
+#include "getAppInfo.h"
 #include "getPublicKey.h"
 #include "signTransaction.h"
 #include "runTests.h"
+#include "state.h"
 
 // The APDU protocol uses a single-byte instruction code (INS) to specify
 // which command should be executed. We'll use this code to dispatch on a
@@ -22,6 +24,7 @@ handler_fn_t* lookupHandler(uint8_t ins) {
         // 0x0* -  app status calls
         CASE(0x00, getVersion_handleAPDU);
         CASE(0x01, getSerial_handleAPDU);
+        CASE(0x02, getAppInfo_handleAPDU);
 
         // 0x1* -  public-key related
         CASE(0x10, getPublicKey_handleAPDU);
@@ -27,6 +27,7 @@
 
 #include "getVersion.h"
 #include "handlers.h"
+#include "dispatch.h"
 #include "state.h"
 #include "errors.h"
 #include "menu.h"
@@ -39,8 +40,6 @@
 // the API level!
 STATIC_ASSERT(CX_APILEVEL >= 9, "bad api level");
 
-static const int INS_NONE = -1;
-
 // ui_idle displays the main menu. Note that your app isn't required to use a
 // menu as its idle screen; you can define your own completely custom screen.
 void ui_idle(void) {
@@ -62,8 +61,6 @@ void ui_idle(void) {
 #endif
 }
 
-static const uint8_t CLA = 0xD7;
-
 // This is the main loop that reads and writes APDUs. It receives request
 // APDUs from the computer, looks up the corresponding command handler, and
 // calls it on the APDU payload. Then it loops around and calls io_exchange
@@ -105,45 +102,9 @@ static void fio_main(void) {
 
                 VALIDATE(device_is_unlocked(), ERR_DEVICE_LOCKED);
 
-                // Note(ppershing): unsafe to access before checks
-                // Warning(ppershing): in case of unlikely change of APDU format
-                // make sure you read wider values as big endian
-                struct {
-                    uint8_t cla;
-                    uint8_t ins;
-                    uint8_t p1;
-                    uint8_t p2;
-                    uint8_t lc;
-                }* header = (void*) G_io_apdu_buffer;
-
-                VALIDATE(rx >= SIZEOF(*header), ERR_MALFORMED_REQUEST_HEADER);
-
-                // check that data is safe to access
-                VALIDATE(rx == header->lc + SIZEOF(*header), ERR_MALFORMED_REQUEST_HEADER);
-
-                uint8_t* data = G_io_apdu_buffer + SIZEOF(*header);
-
-                VALIDATE(header->cla == CLA, ERR_BAD_CLA);
-
-                TRACE("APDU: ins = %d,   p1 = %d,    p2 = %d", header->ins, header->p1, header->p2);
-
-                // Lookup and call the requested command handler.
-                handler_fn_t* handlerFn = lookupHandler(header->ins);
-
-                VALIDATE(handlerFn != NULL, ERR_UNKNOWN_INS);
-
-                bool isNewCall = false;
-                if (currentInstruction == INS_NONE) {
-                    explicit_bzero(&instructionState, SIZEOF(instructionState));
-                    isNewCall = true;
-                    currentInstruction = header->ins;
-                } else {
-                    VALIDATE(header->ins == currentInstruction, ERR_STILL_IN_CALL);
-                }
-
-                // Note: handlerFn is responsible for calling io_send
+                // Note: the handler is responsible for calling io_send
                 // either during its call or subsequent UI actions
-                handlerFn(header->p1, header->p2, data, header->lc, isNewCall);
+                dispatchAPDU(rx);
                 flags = IO_ASYNCH_REPLY;
             }
             CATCH(EXCEPTION_IO_RESET) {
@@ -0,0 +1,75 @@
+// RAM report, compiled only by `make ram_report`
+//
+// The file is compiled to assembly (never linked), the compiler evaluates sizeof/offsetof for the
+// target and we scrape the resulting constants from the assembly output. This works with the cross
+// compiler, nothing needs to run on the device. Same trick as asm-offsets in the Linux kernel.
+#ifdef RAM_REPORT
+
+#include <stddef.h>
+#include "state.h"
+
+#define REPORT(name, size, offset) \
+    __asm__ volatile("\n->RAM_REPORT " name " %0 %1" : : "i"(size), "i"(offset))
+
+#define REPORT_STRUCT(type) REPORT(#type, sizeof(type), 0)
+
+#define REPORT_FIELD(type, field) \
+    REPORT(#type "." #field, sizeof(((type*) 0)->field), offsetof(type, field))
+
+void ramReport(void) {
+    REPORT_STRUCT(instructionState_t);
+
+    REPORT_STRUCT(ins_get_key_context_t);
+    REPORT_FIELD(ins_get_key_context_t, show_or_not);
+    REPORT_FIELD(ins_get_key_context_t, pathSpec);
+    REPORT_FIELD(ins_get_key_context_t, pubKey);
+    REPORT_FIELD(ins_get_key_context_t, responseReadyMagic);
+    REPORT_FIELD(ins_get_key_context_t, ui_step);
+
+    REPORT_STRUCT(ins_sign_transaction_context_t);
+    REPORT_FIELD(ins_sign_transaction_context_t, initWasCalledMagic);
+    REPORT_FIELD(ins_sign_transaction_context_t, wittnessPath);
+    REPORT_FIELD(ins_sign_transaction_context_t, hashContext);
+    REPORT_FIELD(ins_sign_transaction_context_t, integrity);
+    REPORT_FIELD(ins_sign_transaction_context_t, countedSections);
+    REPORT_FIELD(ins_sign_transaction_context_t, storage);
+    REPORT_FIELD(ins_sign_transaction_context_t, dhIsActive);
+    REPORT_FIELD(ins_sign_transaction_context_t, dhCountedSectionEntryLevel);
+    REPORT_FIELD(ins_sign_transaction_context_t, otherPubkey);
+    REPORT_FIELD(ins_sign_transaction_context_t, dhContext);
+    REPORT_FIELD(ins_sign_transaction_context_t, countedSectionDifference);
+    REPORT_FIELD(ins_sign_transaction_context_t, templateRun);
+    REPORT_FIELD(ins_sign_transaction_context_t, ui_step);
+    REPORT_FIELD(ins_sign_transaction_context_t, responseLength);
+    REPORT_FIELD(ins_sign_transaction_context_t, key);
+    REPORT_FIELD(ins_sign_transaction_context_t, value);
+
+    REPORT_STRUCT(dh_context_t);
+    REPORT_FIELD(dh_context_t, IV);
+    REPORT_FIELD(dh_context_t, cache);
+    REPORT_FIELD(dh_context_t, base64EncodingCache);
+    REPORT_FIELD(dh_context_t, hmacCtx);
+
+    REPORT_STRUCT(tx_value_storage_t);
+    REPORT_STRUCT(tx_integrity_t);
+    REPORT_STRUCT(tx_counted_section_t);
+    REPORT_STRUCT(sha_256_context_t);
+
+    REPORT_STRUCT(ins_decode_context_t);
+    REPORT_FIELD(ins_decode_context_t, stage);
+    REPORT_FIELD(ins_decode_context_t, pathSpec);
+    REPORT_FIELD(ins_decode_context_t, otherPubKey);
+    REPORT_FIELD(ins_decode_context_t, bufferLen);
+    REPORT_FIELD(ins_decode_context_t, bufferSentLen);
+    REPORT_FIELD(ins_decode_context_t, buffer);
+    REPORT_FIELD(ins_decode_context_t, messageDecodedMagic);
+    REPORT_FIELD(ins_decode_context_t, ui_step);
+    REPORT_FIELD(ins_decode_context_t, parsedContent);
+
+    REPORT_STRUCT(cx_sha256_t);
+    REPORT_STRUCT(cx_hmac_sha256_t);
+    REPORT_STRUCT(public_key_t);
+    REPORT_STRUCT(bip44_path_t);
+}
+
+#endif  // RAM_REPORT
@@ -12,6 +12,7 @@
 #include "diffieHellman.h"
 #include "signTransactionIntegrity.h"
 #include "signTransactionCountedSection.h"
+#include "signTransactionTemplates.h"
 #include "utils.h"
 
 void handleRunTests(uint8_t p1 MARK_UNUSED,
@@ -31,6 +32,7 @@ void handleRunTests(uint8_t p1 MARK_UNUSED,
         run_diffieHellman_test();
         run_integrityCheck_test();
         run_countedSection_test();
+        run_txTemplates_test();
         TRACE_STACK_USAGE();
         PRINTF("All tests done\n");
     }
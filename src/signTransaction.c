@@ -6,10 +6,12 @@
 #include "fio.h"
 #include "hash.h"
 #include "lcx_rng.h"
+#include "os_math.h"
 #include "securityPolicy.h"
 #include "signTransactionCountedSection.h"
 #include "signTransactionIntegrity.h"
 #include "signTransactionParse.h"
+#include "signTransactionTemplates.h"
 #include "uiHelpers.h"
 #include "uiScreens.h"
 #include "textUtils.h"
@@ -39,11 +41,12 @@ static uint8_t const SECP256K1_N[] = {
     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
     0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
 
-// Uses ctx->dataToAppendToTx, ctx->dataToAppendToTxLen to extend hash
+// Extends hash with data, data is expected to point into G_io_apdu_buffer (no copy is made)
 // If ctx->dhIsActive then, we extend hash with encrypted data and prepare resulting encrypted
 // blocks to G_io_apdu_buffer, ctx->responseLength Variables (&ctx->wittnessPath, &ctx->otherPubkey,
 // &ctx->dhContext) are needed for encryption
-static void processShaAndPosibleDHAndPrepareResponse() {
+static void processShaAndPosibleDHAndPrepareResponse(const uint8_t* data, size_t dataSize) {
+    ASSERT(dataSize <= MAX_TX_APPEND_IN_SINGLE_APDU);
     if (ctx->dhIsActive) {
         dh_aes_key_t aesKey;
         BEGIN_TRY {
@@ -51,23 +54,22 @@ static void processShaAndPosibleDHAndPrepareResponse() {
                 // Compute AES key
                 dh_init_aes_key(&aesKey, &ctx->wittnessPath, &ctx->otherPubkey);
 
-                // Encode message chunk
-                ctx->responseLength = dh_encode_append(&ctx->dhContext,
-                                                       &aesKey,
-                                                       ctx->dataToAppendToTx,
-                                                       ctx->dataToAppendToTxLen,
-                                                       G_io_apdu_buffer,
-                                                       SIZEOF(G_io_apdu_buffer));
+                // Encode message chunk, the output overwrites the APDU
+                ctx->responseLength = dh_encode_append_in_place(&ctx->dhContext,
+                                                                &aesKey,
+                                                                data,
+                                                                dataSize,
+                                                                G_io_apdu_buffer,
+                                                                SIZEOF(G_io_apdu_buffer));
                 sha_256_append(&ctx->hashContext, G_io_apdu_buffer, ctx->responseLength);
-                VALIDATE(
-                    ctx->countedSectionDifference + ctx->responseLength >= ctx->dataToAppendToTxLen,
-                    ERR_INVALID_STATE);
+                VALIDATE(ctx->countedSectionDifference + ctx->responseLength >= dataSize,
+                         ERR_INVALID_STATE);
                 ctx->countedSectionDifference =
-                    ctx->countedSectionDifference + ctx->responseLength - ctx->dataToAppendToTxLen;
+                    ctx->countedSectionDifference + ctx->responseLength - dataSize;
                 TRACE("CS diff %d from:%d, %d",
                       (int) ctx->countedSectionDifference,
                       (int) ctx->responseLength,
-                      (int) ctx->dataToAppendToTxLen);
+                      (int) dataSize);
             }
             FINALLY {
                 explicit_bzero(&aesKey, SIZEOF(aesKey));
@@ -75,7 +77,7 @@ static void processShaAndPosibleDHAndPrepareResponse() {
         }
         END_TRY;
     } else {
-        sha_256_append(&ctx->hashContext, ctx->dataToAppendToTx, ctx->dataToAppendToTxLen);
+        sha_256_append(&ctx->hashContext, data, dataSize);
         ctx->responseLength = 0;
     }
 }
@@ -96,6 +98,12 @@ static void prepareOurPubkeyForDisplay() {
     ctx->value[outlen] = 0;
 }
 
+// True if the command is a step of a template followed by other steps in the same APDU,
+// such step does not respond
+static bool signTx_hasNextTemplateStep() {
+    return ctx->templateRun.isActive && ctx->templateRun.stepDataSize > 0;
+}
+
 // Simple reusable UI step with one or no screens
 enum {
     HANDLE_SIMPLE_STEP_DISPLAY_DETAILS = 100,
@@ -116,8 +124,15 @@ static void signTx_ui_runStep_simple() {
 
     UI_STEP(HANDLE_SIMPLE_STEP_RESPOND) {
         TRACE();
-        io_send_buf(SUCCESS, G_io_apdu_buffer, ctx->responseLength);
-        ui_displayBusy();  // needs to happen after I/O
+        if (signTx_hasNextTemplateStep()) {
+            // the steps which respond with data or can show a screen end their APDU
+            ASSERT(ctx->templateRun.isRunningSteps);
+            ASSERT(ctx->responseLength == 0);
+            ctx->templateRun.stepDone = true;
+        } else {
+            io_send_buf(SUCCESS, G_io_apdu_buffer, ctx->responseLength);
+            ui_displayBusy();  // needs to happen after I/O
+        }
     }
 
     UI_STEP_END(HANDLE_SIMPLE_STEP_INVALID);
@@ -148,7 +163,7 @@ __noinline_due_to_stack__ void signTx_handleInitAPDU(uint8_t p2,
     }* varData = (void*) varDataBuffer;
     VALIDATE(varSize >= SIZEOF(varData->chainId), ERR_INVALID_DATA);
 
-    // Parsing: network, ctx->wittnessPath, ctx->dataToAppendToTx,
+    // Parsing: network, ctx->wittnessPath
     network_type_t network = NETWORK_UNKNOWN;
     {
         network = getNetworkByChainId(varData->chainId, SIZEOF(varData->chainId));
@@ -161,11 +176,6 @@ __noinline_due_to_stack__ void signTx_handleInitAPDU(uint8_t p2,
         BIP44_PRINTF(&ctx->wittnessPath);
         PRINTF("\n");
         VALIDATE(parsedSize == varSize - SIZEOF(varData->chainId), ERR_INVALID_DATA);
-
-        STATIC_ASSERT(SIZEOF(ctx->dataToAppendToTx) >= SIZEOF(varData->chainId),
-                      "Buffer too small");
-        memcpy(ctx->dataToAppendToTx, varData->chainId, SIZEOF(varData->chainId));
-        ctx->dataToAppendToTxLen = SIZEOF(varData->chainId);
     }
 
     // Prepare display variables ctx->key, ctx->value
@@ -191,9 +201,9 @@ __noinline_due_to_stack__ void signTx_handleInitAPDU(uint8_t p2,
     {
         TRACE_STACK_USAGE();
         VALIDATE(!ctx->dhIsActive, ERR_INVALID_STATE);
-        VALIDATE(countedSectionProcess(&ctx->countedSections, ctx->dataToAppendToTxLen),
+        VALIDATE(countedSectionProcess(&ctx->countedSections, SIZEOF(varData->chainId)),
                  ERR_INVALID_DATA);
-        sha_256_append(&ctx->hashContext, ctx->dataToAppendToTx, ctx->dataToAppendToTxLen);
+        sha_256_append(&ctx->hashContext, varData->chainId, SIZEOF(varData->chainId));
 
         ctx->responseLength = 0;
     }
@@ -239,21 +249,18 @@ __noinline_due_to_stack__ void signTx_handleAppendConstDataAPDU(
     VALIDATE(constSize < MAX_TX_APPEND_IN_SINGLE_APDU, ERR_INVALID_DATA);
     VALIDATE(varSize == 0, ERR_INVALID_DATA);
 
-    // Parsing: ctx->dataToAppendToTx, ctx->dataToAppendToTxLen
     // Preparing display variables ctx->key, ctx->value
     {
-        memcpy(ctx->dataToAppendToTx, constData, constSize);
-        ctx->dataToAppendToTxLen = constSize;
         ctx->key[0] = 0;
         ctx->value[0] = 0;
     }
     // Reading data finished, from now on we use G_io_apdu_buffer for output
+    // Data is hashed directly from the APDU buffer
 
     // Append data to hash (with possible DH encryption) and prepare response
     {
-        VALIDATE(countedSectionProcess(&ctx->countedSections, ctx->dataToAppendToTxLen),
-                 ERR_INVALID_DATA);
-        processShaAndPosibleDHAndPrepareResponse();
+        VALIDATE(countedSectionProcess(&ctx->countedSections, constSize), ERR_INVALID_DATA);
+        processShaAndPosibleDHAndPrepareResponse(constData->data, constSize);
     }
 
     // Run ui step
@@ -397,7 +404,6 @@ __noinline_due_to_stack__ void signTx_handleAppendDataAPDU(uint8_t p2,
         }
     }
 
-    // Parsing ctx->dataToAppendToTx, ctx->dataToAppendToTxLen
     // Prepare display variables ctx->key, ctx->value, policy
     security_policy_t policy = POLICY_DENY;
     {
@@ -414,19 +420,16 @@ __noinline_due_to_stack__ void signTx_handleAppendDataAPDU(uint8_t p2,
                             varSize,
                             ctx->value);
 
-        ASSERT(SIZEOF(ctx->dataToAppendToTx) >= varSize);
-        memcpy(ctx->dataToAppendToTx, varData->value, varSize);
-        ctx->dataToAppendToTxLen = varSize;
-
         policy = constData->valuePolicyAndStorage & 0x0F;
     }
 
     // Reading data finished, from now on we use G_io_apdu_buffer for output
+    // Data is hashed directly from the APDU buffer
 
     // Append data to hash (with possible DH encryption) and prepare response
     {
         VALIDATE(countedSectionProcess(&ctx->countedSections, varSize), ERR_INVALID_DATA);
-        processShaAndPosibleDHAndPrepareResponse();
+        processShaAndPosibleDHAndPrepareResponse(varData->value, varSize);
     }
 
     // Policy
@@ -481,7 +484,7 @@ __noinline_due_to_stack__ void signTx_handleStartCountedSectionAPDU(uint8_t p2,
     }* varData = (void*) varDataBuffer;
     VALIDATE(varSize <= MAX_TX_APPEND_IN_SINGLE_APDU, ERR_INVALID_DATA);
 
-    // Parse data numberOfExpectedBytes, ctx->dataToAppendToTx, ctx->dataToAppendToTxLen
+    // Parse data numberOfExpectedBytes
     uint32_t numberOfExpectedBytes = 0;
     {
         uint64_t value = 0;
@@ -494,9 +497,6 @@ __noinline_due_to_stack__ void signTx_handleStartCountedSectionAPDU(uint8_t p2,
                            &value);
         VALIDATE(value <= UINT32_MAX, ERR_INVALID_DATA);  // to fit into uint32_t
         numberOfExpectedBytes = value;
-
-        memcpy(ctx->dataToAppendToTx, varData->value, varSize);
-        ctx->dataToAppendToTxLen = varSize;
     }
 
     // Preparing display variables ctx->key, ctx->value
@@ -506,15 +506,15 @@ __noinline_due_to_stack__ void signTx_handleStartCountedSectionAPDU(uint8_t p2,
     }
 
     // Reading data finished, from now on we use G_io_apdu_buffer for output
+    // Data is hashed directly from the APDU buffer
 
     // Append data to hash (with possible DH encryption) and prepare response, begin counted section
     {
         // this data does not count towards new counted section but counts towards old ones
-        VALIDATE(countedSectionProcess(&ctx->countedSections, ctx->dataToAppendToTxLen),
-                 ERR_INVALID_DATA);
+        VALIDATE(countedSectionProcess(&ctx->countedSections, varSize), ERR_INVALID_DATA);
         VALIDATE(countedSectionBegin(&ctx->countedSections, numberOfExpectedBytes),
                  ERR_INVALID_DATA);
-        processShaAndPosibleDHAndPrepareResponse();
+        processShaAndPosibleDHAndPrepareResponse(varData->value, varSize);
     }
 
     // Run ui step
@@ -1037,22 +1037,126 @@ static subhandler_fn_t* lookup_subhandler(uint8_t p1) {
 #define DEFAULT(HANDLER) \
     default:             \
         return HANDLER;
-        CASE(0x01, signTx_handleInitAPDU);
-        CASE(0x02, signTx_handleAppendConstDataAPDU);
-        CASE(0x03, signTx_handleShowMessageAPDU);
-        CASE(0x04, signTx_handleAppendDataAPDU);
-        CASE(0x05, signTx_handleStartCountedSectionAPDU);
-        CASE(0x06, signTx_handleEndCountedSectionAPDU);
-        CASE(0x07, signTx_handleStoreValueAPDU);
-        CASE(0x08, signTx_handleStartDHEncodingAPDU);
-        CASE(0x09, signTx_handleEndDHEncodingAPDU);
-        CASE(0x10, signTx_handleFinishAPDU);
+        CASE(SIGN_TX_P1_INIT, signTx_handleInitAPDU);
+        CASE(SIGN_TX_P1_APPEND_CONST_DATA, signTx_handleAppendConstDataAPDU);
+        CASE(SIGN_TX_P1_SHOW_MESSAGE, signTx_handleShowMessageAPDU);
+        CASE(SIGN_TX_P1_APPEND_DATA, signTx_handleAppendDataAPDU);
+        CASE(SIGN_TX_P1_START_COUNTED_SECTION, signTx_handleStartCountedSectionAPDU);
+        CASE(SIGN_TX_P1_END_COUNTED_SECTION, signTx_handleEndCountedSectionAPDU);
+        CASE(SIGN_TX_P1_STORE_VALUE, signTx_handleStoreValueAPDU);
+        CASE(SIGN_TX_P1_START_DH_ENCODING, signTx_handleStartDHEncodingAPDU);
+        CASE(SIGN_TX_P1_END_DH_ENCODING, signTx_handleEndDHEncodingAPDU);
+        CASE(SIGN_TX_P1_FINISH, signTx_handleFinishAPDU);
         DEFAULT(NULL)
 #undef CASE
 #undef DEFAULT
     }
 }
 
+// ============================== TEMPLATE ==============================
+
+// Offset of valuePolicyAndStorage in the const data of APPEND_DATA
+#define APPEND_DATA_POLICY_AND_STORAGE_OFFSET 18
+
+// True if the step can wait for the user. Such step ends its APDU, so the next steps never run
+// from the UI callback, only from the APDU handler (the stack is tuned for that).
+// Decided from the const data only, the host frames the APDUs by the same rule.
+static bool signTx_templateStepCanPrompt(const tx_template_step_t* step) {
+    switch (step->p1) {
+        case SIGN_TX_P1_APPEND_CONST_DATA:
+        case SIGN_TX_P1_START_COUNTED_SECTION:
+        case SIGN_TX_P1_END_COUNTED_SECTION:
+        case SIGN_TX_P1_STORE_VALUE:
+            return false;
+        case SIGN_TX_P1_APPEND_DATA:
+            // the const data size is validated by the subhandler
+            return step->constDataLength <= APPEND_DATA_POLICY_AND_STORAGE_OFFSET ||
+                   (step->constData[APPEND_DATA_POLICY_AND_STORAGE_OFFSET] & 0x0F) !=
+                       POLICY_ALLOW_WITHOUT_PROMPT;
+        default:
+            return true;
+    }
+}
+
+// Runs the steps of the current APDU until the last one, which responds or waits for the user
+__noinline_due_to_stack__ static void signTx_runTemplateSteps() {
+    tx_template_run_t* run = &ctx->templateRun;
+    run->isRunningSteps = true;
+    while (run->stepDataSize > 0) {
+        // Entry format: varDataLength, varData (or the value of a parameter)
+        uint8_t* varData = run->stepData + 1;
+        uint8_t varSize = run->stepData[0];
+        VALIDATE(run->stepDataSize >= 1 + varSize, ERR_INVALID_DATA);
+        run->stepData += 1 + varSize;
+        run->stepDataSize -= 1 + varSize;
+
+        tx_template_step_t step;
+        if (!txTemplate_next(&run->cursor, varData, varSize, &step)) {
+            // a parameter of the template, the step using it follows in the same APDU
+            VALIDATE(run->stepDataSize > 0, ERR_INVALID_DATA);
+            continue;
+        }
+
+        // The host needs the response of the steps encrypting the data and of FINISH, they
+        // must be the last step of the APDU (the encryption also overwrites the APDU buffer).
+        // So must be the steps which can wait for the user, see signTx_templateStepCanPrompt.
+        if (ctx->dhIsActive || signTx_templateStepCanPrompt(&step)) {
+            VALIDATE(run->stepDataSize == 0, ERR_INVALID_DATA);
+        }
+
+        integrityCheckProcessInstruction(&ctx->integrity,
+                                         step.p1,
+                                         step.p2,
+                                         step.constData,
+                                         step.constDataLength);
+
+        subhandler_fn_t* subhandler = lookup_subhandler(step.p1);
+        ASSERT(subhandler != NULL);
+        run->stepDone = false;
+        // The subhandlers do not modify the const data
+        subhandler(step.p2, (uint8_t*) step.constData, step.constDataLength, varData, varSize);
+        if (!run->stepDone) {
+            // the last step, it responded or waits for the user
+            ASSERT(run->stepDataSize == 0);
+            break;
+        }
+    }
+    run->isRunningSteps = false;
+}
+
+// The template ID in the first APDU of the call, then the entries of the template
+// (varDataLength, varData for every step and parameter) in as many APDUs as needed
+__noinline_due_to_stack__ static void signTx_handleTemplateAPDU(uint8_t p2,
+                                                                uint8_t* wireDataBuffer,
+                                                                size_t wireDataSize,
+                                                                bool isNewCall) {
+    TRACE_STACK_USAGE();
+    VALIDATE(p2 == P2_UNUSED, ERR_INVALID_REQUEST_PARAMETERS);
+    TRACE_BUFFER(wireDataBuffer, wireDataSize);
+
+    tx_template_run_t* run = &ctx->templateRun;
+    if (isNewCall) {
+        VALIDATE(wireDataSize >= TX_TEMPLATE_ID_LENGTH, ERR_INVALID_DATA);
+        VALIDATE(txTemplate_start(wireDataBuffer, &run->cursor), ERR_INVALID_DATA);
+        TRACE("Template %d", (int) run->cursor.templateIndex);
+        run->isActive = true;
+        wireDataBuffer += TX_TEMPLATE_ID_LENGTH;
+        wireDataSize -= TX_TEMPLATE_ID_LENGTH;
+    }
+    VALIDATE(run->isActive, ERR_INVALID_STATE);
+    // every APDU responds, so it must run at least one step
+    VALIDATE(wireDataSize > 0, ERR_INVALID_DATA);
+    ASSERT(wireDataSize <= UINT8_MAX);
+
+    run->stepData = wireDataBuffer;
+    run->stepDataSize = wireDataSize;
+    signTx_runTemplateSteps();
+}
+
+bool signTransaction_isSupportedCommand(uint8_t p1) {
+    return p1 == SIGN_TX_P1_TEMPLATE || lookup_subhandler(p1) != NULL;
+}
+
 void signTransaction_handleAPDU(uint8_t p1,
                                 uint8_t p2,
                                 uint8_t* wireDataBuffer,
@@ -1078,6 +1182,13 @@ void signTransaction_handleAPDU(uint8_t p1,
     }
     VALIDATE(TX_INIT_WAS_CALLED_INITIALIZED_MAGIC, ERR_INVALID_DATA);
 
+    if (p1 == SIGN_TX_P1_TEMPLATE) {
+        signTx_handleTemplateAPDU(p2, wireDataBuffer, wireDataSize, isNewCall);
+        return;
+    }
+    // the commands of a template are its steps only
+    VALIDATE(!ctx->templateRun.isActive, ERR_INVALID_STATE);
+
     // Parse APDU into const and non-const part
     ASSERT(wireDataSize < BUFFER_SIZE_PARANOIA);
     VALIDATE(wireDataSize >= 2, ERR_INVALID_DATA);
@@ -8,10 +8,29 @@
 #include "keyDerivation.h"
 #include "signTransactionIntegrity.h"
 #include "signTransactionCountedSection.h"
+#include "signTransactionTemplates.h"
 #include <stdint.h>
 
 handler_fn_t signTransaction_handleAPDU;
 
+// Commands of the sign transaction call (P1), see doc/ins_sign_tx.md
+enum {
+    SIGN_TX_P1_INIT = 0x01,
+    SIGN_TX_P1_APPEND_CONST_DATA = 0x02,
+    SIGN_TX_P1_SHOW_MESSAGE = 0x03,
+    SIGN_TX_P1_APPEND_DATA = 0x04,
+    SIGN_TX_P1_START_COUNTED_SECTION = 0x05,
+    SIGN_TX_P1_END_COUNTED_SECTION = 0x06,
+    SIGN_TX_P1_STORE_VALUE = 0x07,
+    SIGN_TX_P1_START_DH_ENCODING = 0x08,
+    SIGN_TX_P1_END_DH_ENCODING = 0x09,
+    SIGN_TX_P1_FINISH = 0x10,
+    SIGN_TX_P1_TEMPLATE = 0x11,
+};
+
+// True if the sign transaction call handles the command (P1)
+bool signTransaction_isSupportedCommand(uint8_t p1);
+
 #define MAX_DISPLAY_KEY_LENGTH   20
 #define MAX_DISPLAY_VALUE_LENGTH 220
 
@@ -30,6 +49,20 @@ typedef struct {
     uint8_t storedValue3[64];
 } tx_value_storage_t;
 
+// Template run by the TEMPLATE command, its steps are the commands and the APDUs carry only
+// their variable data (varDataLength, varData for every step) and the parameters of the template
+typedef struct {
+    uint8_t isActive;
+    tx_template_cursor_t cursor;
+    // Steps of the current APDU not run yet, point into G_io_apdu_buffer
+    uint8_t* stepData;
+    uint8_t stepDataSize;
+    // Set while the steps are run from the APDU handler, the loop runs the next step
+    uint8_t isRunningSteps;
+    // Set when a step which is not the last one of the APDU is done (instead of responding)
+    uint8_t stepDone;
+} tx_template_run_t;
+
 typedef struct {
     uint16_t initWasCalledMagic;
     bip44_path_t wittnessPath;
@@ -38,10 +71,6 @@ typedef struct {
     tx_counted_section_t countedSections;
     tx_value_storage_t storage;
 
-    // This is data before posible DH encoding
-    uint8_t dataToAppendToTxLen;
-    uint8_t dataToAppendToTx[MAX_TX_APPEND_IN_SINGLE_APDU];
-
     // DH encryption variables
     uint8_t dhIsActive;
     uint8_t dhCountedSectionEntryLevel;
@@ -51,6 +80,8 @@ typedef struct {
     // counted section after we finish DH encoding
     uint16_t countedSectionDifference;
 
+    tx_template_run_t templateRun;
+
     int ui_step;
     uint8_t responseLength;  // Response is in G_io_apdu_buffer
 
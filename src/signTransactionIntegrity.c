@@ -45,252 +45,278 @@ static const uint8_t allowedHashes[][SHA_256_SIZE] = {
      0xbb, 0x66, 0xea, 0x0e, 0xff, 0xde, 0x09, 0x43, 0x50, 0xca, 0xba,
      0xd4, 0x6f, 0xbf, 0x94, 0xc5, 0x4d, 0x7c, 0x5c, 0xb3, 0x41},
 #endif
+    // trnsfiopubky
     {0x72, 0x0b, 0x29, 0xb9, 0xb7, 0x06, 0xaa, 0xac, 0xdd, 0x35, 0xa7,
      0xae, 0xef, 0xde, 0x25, 0x59, 0x1a, 0x55, 0x46, 0x06, 0x16, 0x54,
      0x82, 0x78, 0x84, 0x16, 0x83, 0xe1, 0xf0, 0xd7, 0x98, 0x73},
-    {0x72, 0x0b, 0x29, 0xb9, 0xb7, 0x06, 0xaa, 0xac, 0xdd, 0x35, 0xa7,
-     0xae, 0xef, 0xde, 0x25, 0x59, 0x1a, 0x55, 0x46, 0x06, 0x16, 0x54,
-     0x82, 0x78, 0x84, 0x16, 0x83, 0xe1, 0xf0, 0xd7, 0x98, 0x73},
-    {0x72, 0x0b, 0x29, 0xb9, 0xb7, 0x06, 0xaa, 0xac, 0xdd, 0x35, 0xa7,
-     0xae, 0xef, 0xde, 0x25, 0x59, 0x1a, 0x55, 0x46, 0x06, 0x16, 0x54,
-     0x82, 0x78, 0x84, 0x16, 0x83, 0xe1, 0xf0, 0xd7, 0x98, 0x73},
-    {0x72, 0x0b, 0x29, 0xb9, 0xb7, 0x06, 0xaa, 0xac, 0xdd, 0x35, 0xa7,
-     0xae, 0xef, 0xde, 0x25, 0x59, 0x1a, 0x55, 0x46, 0x06, 0x16, 0x54,
-     0x82, 0x78, 0x84, 0x16, 0x83, 0xe1, 0xf0, 0xd7, 0x98, 0x73},
-    {0x04, 0x68, 0x6b, 0x09, 0xf5, 0x1d, 0x68, 0xb0, 0x8a, 0x0d, 0x0c,
-     0x6f, 0xac, 0x1a, 0x53, 0x37, 0x05, 0xe4, 0x02, 0x8a, 0x86, 0xf0,
-     0xc5, 0x2f, 0xb9, 0x2c, 0x2c, 0x09, 0xe1, 0x30, 0x09, 0x52},
-    {0x23, 0x27, 0x7c, 0x5c, 0x25, 0x48, 0x1d, 0xa2, 0xa8, 0x97, 0xa5,
-     0xf2, 0xb7, 0xa3, 0x66, 0x1e, 0x35, 0xd7, 0x89, 0x90, 0x61, 0xad,
-     0x9b, 0x00, 0x91, 0xc2, 0x53, 0x30, 0xb2, 0x6b, 0x42, 0xca},
-    {0x04, 0x68, 0x6b, 0x09, 0xf5, 0x1d, 0x68, 0xb0, 0x8a, 0x0d, 0x0c,
-     0x6f, 0xac, 0x1a, 0x53, 0x37, 0x05, 0xe4, 0x02, 0x8a, 0x86, 0xf0,
-     0xc5, 0x2f, 0xb9, 0x2c, 0x2c, 0x09, 0xe1, 0x30, 0x09, 0x52},
-    {0x23, 0x27, 0x7c, 0x5c, 0x25, 0x48, 0x1d, 0xa2, 0xa8, 0x97, 0xa5,
-     0xf2, 0xb7, 0xa3, 0x66, 0x1e, 0x35, 0xd7, 0x89, 0x90, 0x61, 0xad,
-     0x9b, 0x00, 0x91, 0xc2, 0x53, 0x30, 0xb2, 0x6b, 0x42, 0xca},
-    {0x04, 0x68, 0x6b, 0x09, 0xf5, 0x1d, 0x68, 0xb0, 0x8a, 0x0d, 0x0c,
-     0x6f, 0xac, 0x1a, 0x53, 0x37, 0x05, 0xe4, 0x02, 0x8a, 0x86, 0xf0,
-     0xc5, 0x2f, 0xb9, 0x2c, 0x2c, 0x09, 0xe1, 0x30, 0x09, 0x52},
-    {0x23, 0x27, 0x7c, 0x5c, 0x25, 0x48, 0x1d, 0xa2, 0xa8, 0x97, 0xa5,
-     0xf2, 0xb7, 0xa3, 0x66, 0x1e, 0x35, 0xd7, 0x89, 0x90, 0x61, 0xad,
-     0x9b, 0x00, 0x91, 0xc2, 0x53, 0x30, 0xb2, 0x6b, 0x42, 0xca},
+    // newfundsreq (DH step)
     {0x04, 0x68, 0x6b, 0x09, 0xf5, 0x1d, 0x68, 0xb0, 0x8a, 0x0d, 0x0c,
      0x6f, 0xac, 0x1a, 0x53, 0x37, 0x05, 0xe4, 0x02, 0x8a, 0x86, 0xf0,
      0xc5, 0x2f, 0xb9, 0x2c, 0x2c, 0x09, 0xe1, 0x30, 0x09, 0x52},
+    // newfundsreq (FINISH step)
     {0x23, 0x27, 0x7c, 0x5c, 0x25, 0x48, 0x1d, 0xa2, 0xa8, 0x97, 0xa5,
      0xf2, 0xb7, 0xa3, 0x66, 0x1e, 0x35, 0xd7, 0x89, 0x90, 0x61, 0xad,
      0x9b, 0x00, 0x91, 0xc2, 0x53, 0x30, 0xb2, 0x6b, 0x42, 0xca},
+    // recordobt (DH step)
     {0xb9, 0xb3, 0x6e, 0x49, 0xe5, 0xc2, 0xac, 0x9e, 0x27, 0xd7, 0xbf,
      0xd1, 0x6c, 0x33, 0xdb, 0xa4, 0x79, 0x36, 0xc3, 0x6f, 0xa2, 0xac,
      0x28, 0xdc, 0x9e, 0xd8, 0xa8, 0x5b, 0x67, 0x33, 0x6f, 0x44},
+    // recordobt (FINISH step)
     {0x90, 0xd9, 0xdd, 0xf7, 0x0d, 0x88, 0x32, 0xc2, 0x8a, 0xb2, 0xa8,
      0xb2, 0xd5, 0xae, 0x08, 0x21, 0x54, 0xc6, 0xcf, 0x76, 0x4e, 0x77,
      0x5e, 0x22, 0xde, 0x34, 0x63, 0x10, 0x4b, 0x60, 0xd4, 0x73},
-    {0xb9, 0xb3, 0x6e, 0x49, 0xe5, 0xc2, 0xac, 0x9e, 0x27, 0xd7, 0xbf,
-     0xd1, 0x6c, 0x33, 0xdb, 0xa4, 0x79, 0x36, 0xc3, 0x6f, 0xa2, 0xac,
-     0x28, 0xdc, 0x9e, 0xd8, 0xa8, 0x5b, 0x67, 0x33, 0x6f, 0x44},
-    {0x90, 0xd9, 0xdd, 0xf7, 0x0d, 0x88, 0x32, 0xc2, 0x8a, 0xb2, 0xa8,
-     0xb2, 0xd5, 0xae, 0x08, 0x21, 0x54, 0xc6, 0xcf, 0x76, 0x4e, 0x77,
-     0x5e, 0x22, 0xde, 0x34, 0x63, 0x10, 0x4b, 0x60, 0xd4, 0x73},
-    {0xb9, 0xb3, 0x6e, 0x49, 0xe5, 0xc2, 0xac, 0x9e, 0x27, 0xd7, 0xbf,
-     0xd1, 0x6c, 0x33, 0xdb, 0xa4, 0x79, 0x36, 0xc3, 0x6f, 0xa2, 0xac,
-     0x28, 0xdc, 0x9e, 0xd8, 0xa8, 0x5b, 0x67, 0x33, 0x6f, 0x44},
-    {0x90, 0xd9, 0xdd, 0xf7, 0x0d, 0x88, 0x32, 0xc2, 0x8a, 0xb2, 0xa8,
-     0xb2, 0xd5, 0xae, 0x08, 0x21, 0x54, 0xc6, 0xcf, 0x76, 0x4e, 0x77,
-     0x5e, 0x22, 0xde, 0x34, 0x63, 0x10, 0x4b, 0x60, 0xd4, 0x73},
-    {0xb9, 0xb3, 0x6e, 0x49, 0xe5, 0xc2, 0xac, 0x9e, 0x27, 0xd7, 0xbf,
-     0xd1, 0x6c, 0x33, 0xdb, 0xa4, 0x79, 0x36, 0xc3, 0x6f, 0xa2, 0xac,
-     0x28, 0xdc, 0x9e, 0xd8, 0xa8, 0x5b, 0x67, 0x33, 0x6f, 0x44},
-    {0x90, 0xd9, 0xdd, 0xf7, 0x0d, 0x88, 0x32, 0xc2, 0x8a, 0xb2, 0xa8,
-     0xb2, 0xd5, 0xae, 0x08, 0x21, 0x54, 0xc6, 0xcf, 0x76, 0x4e, 0x77,
-     0x5e, 0x22, 0xde, 0x34, 0x63, 0x10, 0x4b, 0x60, 0xd4, 0x73},
+    // cancelfndreq
+    {0x10, 0x21, 0x24, 0x06, 0xf8, 0xec, 0xc1, 0x2b, 0x09, 0x46, 0x00,
+     0x4c, 0x6c, 0x81, 0x01, 0x82, 0x67, 0xc8, 0x81, 0x68, 0x5a, 0x8a,
+     0x57, 0x6a, 0x7e, 0xb1, 0xb1, 0xf7, 0x6a, 0x7b, 0x4b, 0xae},
+    // rejectfndreq
+    {0xb8, 0x19, 0x6b, 0x10, 0x79, 0x4b, 0x3f, 0xe1, 0x50, 0xb3, 0xa1,
+     0xdb, 0x0f, 0x74, 0xd3, 0x82, 0xa1, 0x6c, 0xad, 0xdb, 0xb1, 0x0d,
+     0xd0, 0x20, 0xc2, 0xad, 0x8e, 0x74, 0xbe, 0xb1, 0x9f, 0xb4},
+    // addaddress, public addresses: 1
     {0xab, 0x0f, 0x5c, 0xce, 0x2f, 0xaf, 0x6b, 0x90, 0x93, 0xf3, 0xb5,
      0xbe, 0xa9, 0x6a, 0x74, 0xa7, 0x70, 0xd2, 0x91, 0x68, 0xf7, 0x1f,
      0xe5, 0x3d, 0x19, 0x74, 0xf7, 0xa5, 0x10, 0x39, 0x63, 0xc1},
+    // addaddress, public addresses: 2
     {0x30, 0x73, 0x00, 0xed, 0x8d, 0x10, 0x65, 0x24, 0x7f, 0xa3, 0xdd,
      0x2a, 0x1b, 0x7c, 0x90, 0xa8, 0xb2, 0x6f, 0xaf, 0xad, 0xb6, 0xf7,
      0xa7, 0x5f, 0x91, 0x92, 0x97, 0xe5, 0xf1, 0xb1, 0x21, 0x96},
+    // addaddress, public addresses: 3
     {0x13, 0x02, 0x4a, 0xa0, 0xa0, 0xea, 0x70, 0xc8, 0x11, 0x52, 0x2d,
      0x67, 0x17, 0x41, 0xcd, 0x8c, 0x4e, 0xf6, 0x80, 0x31, 0x7c, 0x4d,
      0x5c, 0xa0, 0xf2, 0xfa, 0x3c, 0x4b, 0xb1, 0x85, 0xc5, 0xcd},
+    // addaddress, public addresses: 4
     {0x8e, 0x26, 0x84, 0x94, 0x40, 0xd8, 0xcd, 0xf9, 0xd0, 0x1a, 0x08,
      0x17, 0xaa, 0x0b, 0x57, 0x33, 0xf6, 0x48, 0xf0, 0x1f, 0xea, 0xfd,
      0x51, 0xb4, 0xac, 0x3d, 0x18, 0xad, 0x87, 0x3f, 0xb9, 0xa4},
+    // addaddress, public addresses: 5
     {0xf6, 0x9c, 0xe5, 0x0f, 0x3c, 0xdf, 0xa4, 0x1e, 0x00, 0x7e, 0xf3,
      0xb0, 0x29, 0xc4, 0x3b, 0xc7, 0x92, 0x3e, 0xb3, 0x78, 0x71, 0x7d,
      0xed, 0x96, 0x1c, 0x41, 0x5a, 0x4c, 0x82, 0x50, 0xc9, 0xa1},
+    // remaddress, public addresses: 1
     {0xe7, 0xa8, 0xd4, 0xed, 0x82, 0xd2, 0x60, 0x32, 0x54, 0x5a, 0xc2,
      0xc6, 0x73, 0x73, 0xfb, 0xf5, 0xfa, 0xa6, 0x8f, 0x2f, 0xb4, 0xb8,
      0x91, 0xe3, 0xe8, 0x11, 0x6a, 0xca, 0x08, 0xbf, 0x59, 0xe1},
+    // remaddress, public addresses: 2
     {0x26, 0xe5, 0x21, 0x0f, 0x8f, 0xc8, 0x77, 0x8e, 0xb7, 0x24, 0x97,
      0x32, 0x20, 0xa2, 0xbc, 0x85, 0xbe, 0x11, 0x10, 0xb8, 0x39, 0x8d,
      0xd2, 0x7e, 0x9d, 0x3a, 0xbc, 0xaf, 0x58, 0x1a, 0x48, 0x79},
-    {0xe0, 0xa6, 0x06, 0xd1, 0x34, 0xb3, 0xbf, 0xfd, 0x72, 0x6f, 0x69, 0xf7, 0xd1, 0xa5, 0x68, 0x78,
-     0xd8, 0xad, 0x15, 0x66, 0xd4, 0x1e, 0xdc, 0x30, 0x1d, 0xbe, 0xea, 0x09, 0x82, 0xf1, 0x3d, 0xb},
+    // remaddress, public addresses: 3
+    {0xe0, 0xa6, 0x06, 0xd1, 0x34, 0xb3, 0xbf, 0xfd, 0x72, 0x6f, 0x69,
+     0xf7, 0xd1, 0xa5, 0x68, 0x78, 0xd8, 0xad, 0x15, 0x66, 0xd4, 0x1e,
+     0xdc, 0x30, 0x1d, 0xbe, 0xea, 0x09, 0x82, 0xf1, 0x3d, 0x0b},
+    // remaddress, public addresses: 4
     {0xd6, 0xcc, 0x05, 0x60, 0xfd, 0xa9, 0x7d, 0x55, 0xb2, 0x49, 0x4e,
      0x2a, 0x59, 0x13, 0xe3, 0xe4, 0x3c, 0xf7, 0x3e, 0x5e, 0x28, 0x3d,
      0x15, 0xe4, 0x68, 0x2d, 0x23, 0x3e, 0x7c, 0x9b, 0x0b, 0x63},
+    // remaddress, public addresses: 5
     {0xb5, 0xf3, 0xed, 0x5f, 0x34, 0x48, 0x5d, 0xa3, 0xa4, 0x93, 0x10,
      0xf0, 0x09, 0x8d, 0xfb, 0x71, 0x34, 0x5e, 0x0f, 0x6a, 0xc8, 0x42,
      0x16, 0xc0, 0xe1, 0xb9, 0xed, 0x11, 0x09, 0x7c, 0x22, 0x30},
+    // addnft, NFTs: 1
     {0x3b, 0x19, 0xb4, 0x63, 0xcd, 0xba, 0xd4, 0x75, 0x76, 0x78, 0x03,
      0x92, 0x17, 0xae, 0xd5, 0xea, 0x13, 0xe1, 0xe8, 0xab, 0xc8, 0xc8,
      0x35, 0x7b, 0x50, 0xc8, 0xef, 0x5c, 0x1c, 0x2e, 0xe1, 0x72},
+    // addnft, NFTs: 2
     {0x39, 0x31, 0xa7, 0x1c, 0x07, 0x8e, 0x5e, 0x28, 0x20, 0x90, 0x3e,
      0x25, 0xe1, 0x81, 0x8f, 0xea, 0x46, 0xda, 0x16, 0xd9, 0xd2, 0x56,
      0xf3, 0x91, 0x7e, 0x5a, 0xe4, 0x5b, 0x94, 0x73, 0x45, 0xdf},
+    // addnft, NFTs: 3
     {0xea, 0xa0, 0xae, 0x50, 0x58, 0x10, 0x80, 0x4b, 0x52, 0x1e, 0x91,
      0x0b, 0xc9, 0x64, 0xad, 0x73, 0x76, 0xd9, 0x37, 0xfa, 0x33, 0xab,
      0xcf, 0x1f, 0xf8, 0x71, 0x50, 0xf9, 0xba, 0xea, 0x4b, 0x2d},
+    // remnft, NFTs: 1
     {0xeb, 0x12, 0x64, 0xc2, 0x90, 0xa6, 0x78, 0x09, 0xe1, 0x56, 0xdf,
      0x06, 0x15, 0xd6, 0x64, 0x7e, 0x47, 0xb9, 0x92, 0x95, 0x92, 0x2b,
      0x51, 0x40, 0xe8, 0xc9, 0x82, 0x7f, 0x68, 0x4f, 0xe6, 0xfc},
+    // remnft, NFTs: 2
     {0x62, 0x62, 0x11, 0x4f, 0xad, 0x75, 0x96, 0x76, 0x7f, 0x65, 0x43,
      0xd0, 0x61, 0x91, 0x35, 0x1d, 0x6e, 0xbf, 0x64, 0xd6, 0x94, 0x1c,
      0x25, 0xbb, 0x59, 0xc1, 0x26, 0xe5, 0x94, 0xce, 0x89, 0xcf},
+    // remnft, NFTs: 3
     {0x68, 0x4d, 0x19, 0x1b, 0xec, 0x18, 0x69, 0x3a, 0xc2, 0x2a, 0x79,
      0xe3, 0xbc, 0xe5, 0xa4, 0xc6, 0xe1, 0xa5, 0xb3, 0xfd, 0x6e, 0x04,
      0xb0, 0x33, 0xd4, 0x2f, 0xe6, 0x1b, 0x5d, 0x51, 0x7b, 0x80},
+    // remalladdr
     {0xf7, 0xf1, 0xe3, 0xcc, 0xda, 0xbc, 0x21, 0x9c, 0xb7, 0xef, 0xbe,
      0x45, 0x6c, 0x87, 0xf3, 0x59, 0x76, 0xc9, 0x9c, 0x0d, 0xe9, 0xac,
      0x10, 0x93, 0x46, 0xda, 0x1f, 0x91, 0xd3, 0x78, 0x1b, 0x53},
+    // remallnfts
+    {0x21, 0xfb, 0x21, 0x50, 0xd1, 0x7b, 0xa2, 0x06, 0x4b, 0xe7, 0x52,
+     0xa8, 0x1f, 0xca, 0x68, 0xdf, 0x60, 0x62, 0x43, 0xeb, 0x75, 0x3c,
+     0x56, 0x9d, 0x97, 0x10, 0xc4, 0x24, 0x20, 0xba, 0xf4, 0x4d},
+    // addbundles
     {0x04, 0x7d, 0x85, 0x04, 0xb6, 0xb9, 0x21, 0x51, 0x19, 0x7d, 0x20,
      0xc9, 0xe7, 0x9f, 0xc1, 0x81, 0x3e, 0xe4, 0xa0, 0xd5, 0xa2, 0x1d,
      0x3c, 0x36, 0x66, 0x89, 0x01, 0x1a, 0x71, 0xe9, 0x2a, 0x8a},
+    // regaddress
     {0x47, 0x75, 0xd1, 0x26, 0xa4, 0x4b, 0x48, 0x95, 0x2d, 0x84, 0x5e,
      0x43, 0x06, 0x7e, 0x6b, 0x13, 0x42, 0x6f, 0xdd, 0x77, 0x55, 0x25,
      0x9d, 0x6a, 0xfc, 0x7f, 0x83, 0xc0, 0x82, 0xc2, 0xeb, 0x4c},
+    // xferaddress
     {0x52, 0x44, 0x21, 0x4f, 0x79, 0xf9, 0xba, 0x27, 0x9e, 0x34, 0xd4,
      0xfb, 0x35, 0x13, 0x7f, 0xc4, 0x06, 0xe6, 0xc7, 0x7d, 0x99, 0x51,
      0x7e, 0xd4, 0xd2, 0x7d, 0x8e, 0x97, 0xf8, 0x1c, 0x34, 0x54},
+    // regdomain
     {0xf8, 0x73, 0x29, 0xbd, 0xc7, 0x2d, 0xaf, 0x8d, 0xdb, 0xac, 0xac,
      0x28, 0xea, 0x24, 0x7a, 0xe1, 0x1a, 0x82, 0x97, 0x47, 0x4f, 0x9b,
      0x59, 0x86, 0xcb, 0x27, 0xe5, 0xf9, 0x99, 0x1d, 0xf1, 0x43},
+    // renewdomain
     {0x2d, 0x26, 0x7c, 0x41, 0xf6, 0x32, 0x27, 0x91, 0x10, 0x76, 0x96,
      0x39, 0x57, 0x0f, 0xe3, 0xf5, 0x56, 0x9b, 0x81, 0xa3, 0x02, 0xc9,
      0x1d, 0x46, 0x95, 0x19, 0x0b, 0x26, 0x3b, 0x60, 0xf0, 0xe4},
+    // setdomainpub, public
     {0x2f, 0x1e, 0x4e, 0xa2, 0x81, 0x48, 0x5e, 0x01, 0x55, 0x1b, 0x4f,
      0x20, 0x56, 0x7b, 0x97, 0x27, 0xba, 0xae, 0xad, 0x60, 0x5f, 0xb6,
      0x83, 0xd7, 0x37, 0x4a, 0x0d, 0x06, 0xeb, 0xa0, 0xf8, 0xbb},
+    // setdomainpub, not public
     {0xe4, 0x85, 0x22, 0x61, 0x22, 0x3b, 0xa3, 0x05, 0x42, 0xa0, 0xb6,
      0x0d, 0x73, 0xbf, 0xf9, 0xcd, 0x82, 0x6a, 0x9c, 0x9b, 0x74, 0x70,
      0x47, 0x5c, 0x61, 0x80, 0x31, 0x25, 0x46, 0xa9, 0x4f, 0x21},
+    // xferdomain
     {0xf2, 0xef, 0xc6, 0x69, 0x8f, 0x05, 0x36, 0x14, 0x8b, 0x56, 0x1d,
      0x43, 0xb2, 0x22, 0xfb, 0x42, 0xb9, 0x1f, 0x8d, 0xd8, 0x83, 0x07,
      0xb7, 0xff, 0x87, 0x09, 0x47, 0xf1, 0xb8, 0x61, 0x52, 0xbb},
-    {0x21, 0xfb, 0x21, 0x50, 0xd1, 0x7b, 0xa2, 0x06, 0x4b, 0xe7, 0x52,
-     0xa8, 0x1f, 0xca, 0x68, 0xdf, 0x60, 0x62, 0x43, 0xeb, 0x75, 0x3c,
-     0x56, 0x9d, 0x97, 0x10, 0xc4, 0x24, 0x20, 0xba, 0xf4, 0x4d},
-    {0x10, 0x21, 0x24, 0x06, 0xf8, 0xec, 0xc1, 0x2b, 0x09, 0x46, 0x00,
-     0x4c, 0x6c, 0x81, 0x01, 0x82, 0x67, 0xc8, 0x81, 0x68, 0x5a, 0x8a,
-     0x57, 0x6a, 0x7e, 0xb1, 0xb1, 0xf7, 0x6a, 0x7b, 0x4b, 0xae},
-    {0xb8, 0x19, 0x6b, 0x10, 0x79, 0x4b, 0x3f, 0xe1, 0x50, 0xb3, 0xa1,
-     0xdb, 0x0f, 0x74, 0xd3, 0x82, 0xa1, 0x6c, 0xad, 0xdb, 0xb1, 0x0d,
-     0xd0, 0x20, 0xc2, 0xad, 0x8e, 0x74, 0xbe, 0xb1, 0x9f, 0xb4},
+    // stakefio
     {0xa8, 0x1e, 0x4e, 0xc5, 0xa9, 0x1e, 0x6b, 0x4d, 0xe2, 0x33, 0x46,
      0x1f, 0xfd, 0xbf, 0x3c, 0x84, 0x77, 0x55, 0xcb, 0x1f, 0x64, 0xdd,
      0x17, 0xdc, 0xe6, 0x35, 0xb4, 0xb9, 0xe7, 0x7d, 0x27, 0xdc},
+    // unstakefio
     {0x84, 0x95, 0x42, 0x84, 0x3c, 0x8b, 0x00, 0xd8, 0x9c, 0x2c, 0x17,
      0xa0, 0x72, 0x66, 0xf9, 0x15, 0x08, 0x0b, 0xc9, 0xf0, 0x48, 0x7c,
      0x01, 0x09, 0x15, 0x2e, 0x42, 0x7b, 0x70, 0x82, 0x0d, 0x7a},
+    // voteproducer, producers: 1
     {0x72, 0x12, 0x3c, 0xb5, 0x28, 0xc5, 0x67, 0xc4, 0xe3, 0x45, 0x56,
      0x1f, 0xa9, 0x74, 0xe3, 0xcc, 0x87, 0x33, 0xbf, 0x9e, 0xe4, 0xc6,
      0x37, 0x0b, 0x8f, 0x77, 0x7c, 0xe3, 0xa3, 0xa1, 0x02, 0xa3},
+    // voteproducer, producers: 2
     {0xbd, 0x92, 0x94, 0x84, 0x09, 0xaa, 0x7b, 0x8e, 0xc0, 0xed, 0x3a,
      0x07, 0x81, 0xa3, 0x71, 0x32, 0xec, 0x5d, 0xda, 0x02, 0x54, 0x3f,
      0xe7, 0x2c, 0xed, 0xb5, 0xe8, 0xc0, 0xb9, 0x5a, 0xdd, 0x38},
+    // voteproducer, producers: 3
     {0xfd, 0x00, 0x10, 0x47, 0x1a, 0x47, 0xad, 0xd1, 0x5b, 0x01, 0x5d,
      0xcf, 0x12, 0xd4, 0xba, 0x20, 0x12, 0x7d, 0xd6, 0x6a, 0x99, 0x37,
      0xde, 0x57, 0x79, 0x6a, 0x30, 0x3f, 0xc3, 0x92, 0x45, 0x86},
+    // voteproducer, producers: 4
     {0x4c, 0x3b, 0x0f, 0xe9, 0x89, 0x90, 0xd3, 0x01, 0xac, 0x21, 0x87,
      0x6f, 0x36, 0xf1, 0x3c, 0x74, 0xe0, 0xad, 0x9d, 0x6e, 0x2b, 0xb6,
      0x5a, 0x22, 0x64, 0x78, 0x04, 0xca, 0x15, 0xa1, 0x8c, 0xfc},
+    // voteproducer, producers: 5
     {0xbf, 0xb9, 0x78, 0x51, 0x6e, 0x2d, 0x39, 0x0e, 0x60, 0x99, 0x18,
      0x16, 0x7b, 0x35, 0xe3, 0xea, 0xa5, 0x6c, 0x85, 0x10, 0x7a, 0x79,
      0x31, 0xe3, 0xc3, 0x72, 0x3d, 0x46, 0x4a, 0xb1, 0x40, 0x6a},
+    // voteproducer, producers: 6
     {0x41, 0x5f, 0x45, 0x83, 0x7a, 0xb3, 0xbf, 0x54, 0x4c, 0x6a, 0xa0,
      0x99, 0x48, 0xfb, 0x93, 0x9a, 0xa9, 0x9f, 0x4e, 0x60, 0x61, 0x25,
      0xea, 0xa3, 0xe3, 0x3e, 0xca, 0x60, 0xde, 0xa9, 0xce, 0x8e},
+    // voteproducer, producers: 7
     {0xfd, 0xa3, 0xe5, 0x8e, 0x32, 0x92, 0xb9, 0xa4, 0x6c, 0x17, 0x80,
      0x34, 0x87, 0xf8, 0xaf, 0xcd, 0xa8, 0xe5, 0x1e, 0x91, 0xbd, 0x2f,
      0x89, 0x8e, 0x1e, 0xe8, 0x30, 0x48, 0xa8, 0x8d, 0xd7, 0xbc},
+    // voteproducer, producers: 8
     {0x9c, 0x08, 0x4d, 0x07, 0x8a, 0x16, 0x6f, 0x65, 0xca, 0xd8, 0x80,
      0x5a, 0x82, 0x6f, 0xe3, 0x28, 0x18, 0x13, 0x88, 0xee, 0xc4, 0xd7,
      0xaf, 0x2f, 0xda, 0x1b, 0xe9, 0xa0, 0xf3, 0x74, 0x01, 0x60},
+    // voteproducer, producers: 9
     {0x22, 0x77, 0x67, 0x74, 0x9f, 0x04, 0xfd, 0xb0, 0x1b, 0x4a, 0x9e,
      0x87, 0xaa, 0x3c, 0x35, 0xa6, 0xc3, 0xf1, 0xb8, 0x62, 0xb1, 0xd9,
      0x12, 0x33, 0x43, 0x55, 0x2d, 0xe8, 0x25, 0x7d, 0x7c, 0xaa},
+    // voteproducer, producers: 10
     {0x53, 0x8f, 0xc3, 0xe7, 0xcc, 0x10, 0x26, 0x04, 0x1c, 0xe7, 0x08,
      0xfd, 0x9a, 0xf0, 0xf8, 0x8a, 0x06, 0xc4, 0x62, 0x04, 0xa5, 0xd0,
      0x7c, 0xfd, 0xd4, 0x99, 0x30, 0xbd, 0x29, 0x98, 0x59, 0x8e},
+    // voteproducer, producers: 11
     {0x23, 0xc9, 0xce, 0x25, 0xf6, 0x0a, 0xd3, 0x61, 0x65, 0x42, 0xcd,
      0x86, 0xb6, 0x76, 0x73, 0x47, 0x7f, 0xf2, 0x14, 0x45, 0x2b, 0x01,
      0x66, 0x96, 0x35, 0xed, 0x82, 0xf7, 0x1a, 0xf1, 0x5d, 0x30},
+    // voteproducer, producers: 12
     {0xac, 0x34, 0x97, 0xb2, 0xd8, 0xeb, 0x94, 0xd3, 0x22, 0x46, 0x08,
      0x2e, 0x3f, 0x28, 0x09, 0xb3, 0x40, 0x1a, 0xf0, 0x8f, 0x7d, 0x30,
      0x1a, 0x83, 0xd7, 0x7b, 0xbc, 0x13, 0x7c, 0xa2, 0xde, 0x5c},
+    // voteproducer, producers: 13
     {0x92, 0x80, 0x45, 0xf0, 0x68, 0xab, 0x62, 0x83, 0xfd, 0x9b, 0x55,
      0xaf, 0x83, 0xaf, 0x5f, 0x9f, 0x8b, 0x92, 0x4c, 0xb1, 0xb6, 0x2d,
      0x12, 0x1a, 0xe9, 0x46, 0xa0, 0x0f, 0x0f, 0xd5, 0x4c, 0x82},
+    // voteproducer, producers: 14
     {0x54, 0xa0, 0xde, 0x88, 0x10, 0xbd, 0x6f, 0x67, 0x14, 0xfc, 0xd1,
      0x0d, 0x93, 0xb9, 0xe7, 0x07, 0x28, 0x14, 0x2d, 0xab, 0x50, 0x5c,
      0x12, 0x83, 0xdc, 0x87, 0xb5, 0x52, 0x6a, 0x02, 0xf9, 0x61},
-    {0xf5, 0xd6, 0xf2, 0x37, 0xb4, 0x66, 0x56, 0xe3, 0xca, 0xba, 0xac, 0x01, 0x50, 0x4c, 0x97, 0xa6,
-     0x2b, 0xb7, 0x14, 0x45, 0xb6, 0x54, 0x7c, 0x18, 0x29, 0xb7, 0xde, 0x4f, 0xf3, 0xae, 0xfd, 0x2},
+    // voteproducer, producers: 15
+    {0xf5, 0xd6, 0xf2, 0x37, 0xb4, 0x66, 0x56, 0xe3, 0xca, 0xba, 0xac,
+     0x01, 0x50, 0x4c, 0x97, 0xa6, 0x2b, 0xb7, 0x14, 0x45, 0xb6, 0x54,
+     0x7c, 0x18, 0x29, 0xb7, 0xde, 0x4f, 0xf3, 0xae, 0xfd, 0x02},
+    // voteproducer, producers: 16
     {0x81, 0x6f, 0x57, 0xd9, 0x7d, 0x97, 0x3f, 0xc6, 0x30, 0x61, 0x79,
      0x5b, 0x26, 0x2d, 0x57, 0x22, 0xe8, 0xe7, 0xdc, 0x8d, 0xbf, 0xb2,
      0xab, 0x51, 0x15, 0x4b, 0x7b, 0x57, 0x52, 0x70, 0xdc, 0x2d},
+    // voteproducer, producers: 17
     {0xa9, 0xae, 0x65, 0x7f, 0x2c, 0x82, 0x95, 0x2b, 0xab, 0x45, 0x31,
      0x85, 0x43, 0xe4, 0x12, 0x59, 0x45, 0x4e, 0x2c, 0x10, 0x9c, 0x13,
      0xe6, 0xbe, 0x2a, 0x1e, 0x97, 0x0a, 0xce, 0xfa, 0xc6, 0x13},
-    {0x0f, 0x32, 0x00, 0x3e, 0xa4, 0x48, 0xc1, 0xdf, 0x21, 0xe8, 0xf4, 0xec, 0x4e, 0xae, 0x7a, 0x68,
-     0x36, 0x68, 0x0a, 0x20, 0xb5, 0xa0, 0xd5, 0x2c, 0xec, 0x26, 0x2c, 0x95, 0x04, 0x50, 0xf9, 0x7},
+    // voteproducer, producers: 18
+    {0x0f, 0x32, 0x00, 0x3e, 0xa4, 0x48, 0xc1, 0xdf, 0x21, 0xe8, 0xf4,
+     0xec, 0x4e, 0xae, 0x7a, 0x68, 0x36, 0x68, 0x0a, 0x20, 0xb5, 0xa0,
+     0xd5, 0x2c, 0xec, 0x26, 0x2c, 0x95, 0x04, 0x50, 0xf9, 0x07},
+    // voteproducer, producers: 19
     {0x5a, 0x28, 0xc1, 0x55, 0xfe, 0x77, 0x53, 0x06, 0xe7, 0x97, 0xcd,
      0x1f, 0x65, 0xe5, 0xbe, 0xbe, 0x6a, 0x49, 0xdd, 0x0d, 0xce, 0x10,
      0x04, 0x10, 0xf2, 0xcb, 0xe0, 0xad, 0xa4, 0xd7, 0x0d, 0x66},
+    // voteproducer, producers: 20
     {0x89, 0x16, 0x45, 0xa3, 0xad, 0x26, 0xe6, 0xdc, 0xc6, 0xb9, 0x44,
      0xb3, 0x74, 0x7c, 0x76, 0xe7, 0x0e, 0x56, 0xb8, 0x39, 0xe5, 0x75,
      0xe5, 0x48, 0x23, 0x32, 0x93, 0xb2, 0x7c, 0xbf, 0x44, 0xad},
+    // voteproducer, producers: 21
     {0x0c, 0xf2, 0x4f, 0x0e, 0x34, 0xeb, 0x55, 0xae, 0xa2, 0x60, 0x55,
      0x46, 0xa3, 0x4e, 0x48, 0x0d, 0xb8, 0x34, 0x58, 0x2a, 0x80, 0x62,
      0xc3, 0x07, 0x65, 0x76, 0x65, 0x34, 0xe6, 0xe9, 0x45, 0x69},
+    // voteproducer, producers: 22
     {0x80, 0x4e, 0x3b, 0x2d, 0xea, 0x0b, 0x2c, 0x7b, 0x06, 0xfb, 0x0c,
      0xb5, 0x63, 0xfc, 0x66, 0xf1, 0x0c, 0x95, 0xd0, 0x0e, 0x67, 0x65,
      0xa8, 0x98, 0xa3, 0xa8, 0xe0, 0x1e, 0xeb, 0x5e, 0x65, 0x3c},
+    // voteproducer, producers: 23
     {0xa2, 0x12, 0x84, 0xf7, 0xd7, 0x4e, 0x24, 0x3b, 0xbd, 0x7c, 0x61,
      0x03, 0xbe, 0x8b, 0xeb, 0xeb, 0xde, 0x44, 0x09, 0xf2, 0x5c, 0xd2,
      0x08, 0x90, 0x1d, 0x03, 0xf2, 0xaf, 0xa3, 0x22, 0xbc, 0xb1},
+    // voteproducer, producers: 24
     {0x85, 0xd6, 0x13, 0x4e, 0x7e, 0x0c, 0x78, 0x9c, 0x59, 0x8b, 0x42,
      0x3d, 0xa8, 0x57, 0x3e, 0x53, 0xb0, 0x82, 0xcb, 0xc9, 0x03, 0x01,
      0xe9, 0x62, 0xbd, 0x01, 0x55, 0x73, 0x40, 0xa0, 0xc6, 0xd9},
+    // voteproducer, producers: 25
     {0xaf, 0xca, 0xde, 0x50, 0xca, 0xf1, 0x6f, 0x6c, 0x6e, 0x0e, 0xca,
      0x9b, 0xda, 0x54, 0x7d, 0x22, 0xa4, 0x04, 0x32, 0x17, 0x98, 0x63,
      0x24, 0x62, 0x37, 0xe4, 0x09, 0x7d, 0x02, 0x15, 0x48, 0xed},
+    // voteproducer, producers: 26
     {0x7c, 0x77, 0x9d, 0x79, 0xd4, 0x5e, 0x49, 0x5a, 0xd4, 0xb9, 0x8d,
      0xf6, 0xb9, 0xb3, 0x4b, 0x44, 0x5e, 0xd3, 0x6a, 0x4a, 0x36, 0x9f,
      0x1f, 0xd7, 0x1a, 0x5b, 0xec, 0x19, 0x45, 0xd9, 0x6c, 0x39},
+    // voteproducer, producers: 27
     {0x2e, 0x75, 0xa8, 0x74, 0x8b, 0xcf, 0xdd, 0x43, 0x2d, 0xb2, 0x58,
      0x1a, 0x20, 0xc1, 0x06, 0xcd, 0x76, 0x6a, 0x55, 0x6d, 0xac, 0x29,
      0x33, 0x62, 0x3e, 0x3f, 0x72, 0xf4, 0xaf, 0xf2, 0x1c, 0x20},
+    // voteproducer, producers: 28
     {0x3a, 0xb8, 0xac, 0xce, 0x82, 0x3b, 0x31, 0xff, 0xf5, 0x4f, 0x18,
      0x95, 0x19, 0x82, 0xed, 0xec, 0x82, 0x76, 0xde, 0x4a, 0x91, 0x4c,
      0x97, 0xc8, 0x18, 0xc4, 0xaa, 0x90, 0x65, 0xae, 0x99, 0xc1},
+    // voteproducer, producers: 29
     {0x2c, 0x03, 0x66, 0x3b, 0xa4, 0xa8, 0x16, 0xe1, 0xd5, 0x33, 0xed,
      0xc9, 0x53, 0xe4, 0xe0, 0xb2, 0xb5, 0xf1, 0x9f, 0xfa, 0x48, 0x61,
      0x62, 0xdc, 0xd2, 0x20, 0x6e, 0xc9, 0x46, 0x8c, 0xe2, 0xcb},
+    // voteproducer, producers: 30
     {0x4a, 0xde, 0x67, 0x61, 0x5f, 0xa6, 0x74, 0x60, 0xa0, 0x70, 0x9b,
      0x9e, 0x81, 0x0f, 0x54, 0x76, 0xe8, 0x6a, 0xed, 0x5b, 0xaa, 0xbc,
      0x04, 0x96, 0xc1, 0x5d, 0xeb, 0x28, 0xf5, 0x7c, 0xa5, 0x25},
+    // voteproxy
     {0xf8, 0x4d, 0xac, 0xa3, 0xb0, 0x93, 0xa7, 0x32, 0x47, 0x21, 0x4c,
      0x7e, 0xf1, 0xfb, 0x99, 0x0a, 0xb5, 0x4f, 0xf0, 0x6b, 0x9d, 0x3b,
      0x69, 0xac, 0x73, 0xd9, 0x91, 0xf9, 0xdf, 0x79, 0x54, 0x4c},
+    // wrapdomain
     {0x15, 0x20, 0xa0, 0x1b, 0x8c, 0x14, 0xc1, 0x46, 0x2c, 0xe2, 0xcb,
      0x55, 0x20, 0x7c, 0xef, 0xba, 0x6d, 0x77, 0x56, 0x5f, 0xec, 0xe1,
      0xbf, 0xe9, 0x0a, 0x60, 0xf9, 0xa2, 0xe1, 0x2d, 0x33, 0xf8},
-    {0x97, 0xb8, 0xd1, 0xc4, 0x89, 0x18, 0x9b, 0xbc, 0xcb, 0xc6, 0xb1, 0x8e, 0x54, 0x0c, 0xba, 0x73,
-     0x37, 0xd2, 0xe3, 0x8f, 0x04, 0x3e, 0x98, 0xad, 0xb9, 0x7e, 0x6d, 0xba, 0xaa, 0xae, 0xef, 0xa0}
-
+    // wraptokens
+    {0x97, 0xb8, 0xd1, 0xc4, 0x89, 0x18, 0x9b, 0xbc, 0xcb, 0xc6, 0xb1,
+     0x8e, 0x54, 0x0c, 0xba, 0x73, 0x37, 0xd2, 0xe3, 0x8f, 0x04, 0x3e,
+     0x98, 0xad, 0xb9, 0x7e, 0x6d, 0xba, 0xaa, 0xae, 0xef, 0xa0}
 };
 
 enum {
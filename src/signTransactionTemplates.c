@@ -0,0 +1,692 @@
+#include "common.h"
+#include "signTransactionTemplates.h"
+#include "signTransaction.h"
+#include "textUtils.h"
+
+// Transaction templates run by the TEMPLATE command of SIGN_TX: the host sends only the variable
+// data of the commands and the constant part is taken from here. Every action has one program,
+// the number of items of the action (e.g. producers) is a counted loop and the host sends the count
+// (or the alternative of a choice) as a parameter entry. The tables are generated with
+// the integrity hashes by ledgerjs-fio/tools/integrityHashes.ts (`make js-integrity-hashes`) from
+// the same samples, do not edit them by hand.
+
+typedef struct {
+    uint8_t id[TX_TEMPLATE_ID_LENGTH];
+    uint16_t programStart;
+    uint8_t programLength;
+} tx_template_t;
+
+// Ops of the template programs, see doc/ins_sign_tx.md
+enum {
+    // step: runs the command of the step
+    TX_TEMPLATE_OP_STEP = 0x01,
+    // step: runs the command of the step with the iteration of the loop appended to its key
+    TX_TEMPLATE_OP_STEP_INDEXED = 0x02,
+    // min, max: takes the count of the loop from the host
+    TX_TEMPLATE_OP_COUNT = 0x03,
+    // appends the count as constant data (APPEND_CONST_DATA of one byte)
+    TX_TEMPLATE_OP_APPEND_COUNT = 0x04,
+    // body length: repeats the ops of the body count times
+    TX_TEMPLATE_OP_LOOP = 0x05,
+    // alternatives, alternative length: takes the alternative from the host and runs its ops
+    TX_TEMPLATE_OP_CHOICE = 0x06,
+};
+
+// Offset of the key length in the const data of the commands with an indexed key
+#define APPEND_DATA_KEY_LENGTH_OFFSET  19
+#define SHOW_MESSAGE_KEY_LENGTH_OFFSET 0
+
+// Constant part of every command of the templates, each once: p1, p2, const data length and data
+static const uint8_t templateStepData[] = {
+    // 0: INIT
+    0x01, 0x00, 0x00,
+    // 1: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x01, 0x02, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 2: APPEND_CONST_DATA 5 bytes
+    0x02, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x01,
+    // 3: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x00, 0x98, 0x0a, 0xd2, 0x0c, 0xa8, 0x5b, 0xe0, 0xe1, 0xd1, 0x95, 0xba,
+    0x85, 0xe7, 0xcd, 0x01,
+    // 4: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1b, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x13, 0x54, 0x72, 0x61, 0x6e, 0x73,
+    0x66, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x74, 0x6f, 0x6b, 0x65, 0x6e, 0x73,
+    // 5: STORE_VALUE R1
+    0x07, 0x01, 0x00,
+    // 6: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x01, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x12, 0x00,
+    // 7: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x01, 0x02, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 8: START_COUNTED_SECTION
+    0x05, 0x00, 0x12, 0x17, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0x00, 0x00, 0x00, 0x00,
+    // 9: APPEND_DATA "Payee Pubkey"
+    0x04, 0x00, 0x20, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x0c, 0x50, 0x61, 0x79, 0x65, 0x65, 0x20, 0x50, 0x75, 0x62,
+    0x6b, 0x65, 0x79,
+    // 10: APPEND_DATA "Amount"
+    0x04, 0x00, 0x1a, 0x10, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x7f, 0x05, 0x06, 0x41, 0x6d, 0x6f, 0x75, 0x6e, 0x74,
+    // 11: APPEND_DATA "Max fee"
+    0x04, 0x00, 0x1b, 0x10, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x7f, 0x05, 0x07, 0x4d, 0x61, 0x78, 0x20, 0x66, 0x65, 0x65,
+    // 12: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 13: END_COUNTED_SECTION
+    0x06, 0x00, 0x00,
+    // 14: APPEND_CONST_DATA 33 bytes
+    0x02, 0x00, 0x21, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00,
+    // 15: FINISH
+    0x10, 0x00, 0x00,
+    // 16: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x40, 0x3e, 0xd4, 0xaa, 0x0b, 0xa8, 0x5b, 0x00, 0xac, 0xba, 0x38, 0x4d,
+    0xbd, 0xb8, 0x9a, 0x01,
+    // 17: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x15, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x52, 0x65, 0x71, 0x75, 0x65,
+    0x73, 0x74, 0x20, 0x46, 0x75, 0x6e, 0x64, 0x73,
+    // 18: APPEND_DATA "Payer FIO Handle"
+    0x04, 0x00, 0x24, 0x04, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x10, 0x50, 0x61, 0x79, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f,
+    0x20, 0x48, 0x61, 0x6e, 0x64, 0x6c, 0x65,
+    // 19: APPEND_DATA "Payee FIO Handle"
+    0x04, 0x00, 0x24, 0x04, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x10, 0x50, 0x61, 0x79, 0x65, 0x65, 0x20, 0x46, 0x49, 0x4f,
+    0x20, 0x48, 0x61, 0x6e, 0x64, 0x6c, 0x65,
+    // 20: START_COUNTED_SECTION
+    0x05, 0x00, 0x12, 0x17, 0x03, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00,
+    // 21: START_DH_ENCRYPTION
+    0x08, 0x00, 0x00,
+    // 22: APPEND_DATA "Payee Public Addr"
+    0x04, 0x00, 0x25, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x11, 0x50, 0x61, 0x79, 0x65, 0x65, 0x20, 0x50, 0x75, 0x62,
+    0x6c, 0x69, 0x63, 0x20, 0x41, 0x64, 0x64, 0x72,
+    // 23: APPEND_DATA "Amount requested"
+    0x04, 0x00, 0x24, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x10, 0x41, 0x6d, 0x6f, 0x75, 0x6e, 0x74, 0x20, 0x72, 0x65,
+    0x71, 0x75, 0x65, 0x73, 0x74, 0x65, 0x64,
+    // 24: APPEND_DATA "Chain code"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x43, 0x68, 0x61, 0x69, 0x6e, 0x20, 0x63, 0x6f, 0x64,
+    0x65,
+    // 25: APPEND_DATA "Token code"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x54, 0x6f, 0x6b, 0x65, 0x6e, 0x20, 0x63, 0x6f, 0x64,
+    0x65,
+    // 26: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x20, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 27: END_DH_ENCRYPTION
+    0x09, 0x00, 0x00,
+    // 28: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0e, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x42, 0x00,
+    // 29: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x40, 0x3e, 0xd4, 0xaa, 0x0b, 0xa8, 0x5b, 0x00, 0x00, 0xc8, 0x87, 0xa6,
+    0x4b, 0x91, 0xba, 0x01,
+    // 30: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x17, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0f, 0x52, 0x65, 0x63, 0x6f, 0x72,
+    0x64, 0x20, 0x6d, 0x65, 0x74, 0x61, 0x64, 0x61, 0x74, 0x61,
+    // 31: APPEND_DATA "Request ID"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x0a, 0x52, 0x65, 0x71, 0x75, 0x65, 0x73, 0x74, 0x20, 0x49,
+    0x44,
+    // 32: START_COUNTED_SECTION
+    0x05, 0x00, 0x12, 0x17, 0x03, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb0, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00,
+    // 33: APPEND_DATA "Payer Public Addr"
+    0x04, 0x00, 0x25, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x11, 0x50, 0x61, 0x79, 0x65, 0x72, 0x20, 0x50, 0x75, 0x62,
+    0x6c, 0x69, 0x63, 0x20, 0x41, 0x64, 0x64, 0x72,
+    // 34: APPEND_DATA "Status"
+    0x04, 0x00, 0x1a, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x06, 0x53, 0x74, 0x61, 0x74, 0x75, 0x73,
+    // 35: APPEND_DATA "Obt ID"
+    0x04, 0x00, 0x1a, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x06, 0x4f, 0x62, 0x74, 0x20, 0x49, 0x44,
+    // 36: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x40, 0x3e, 0xd4, 0xaa, 0x0b, 0xa8, 0x5b, 0x60, 0xd5, 0x4d, 0x73, 0x45,
+    0x85, 0xa6, 0x41, 0x01,
+    // 37: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1c, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x14, 0x43, 0x61, 0x6e, 0x63, 0x65,
+    0x6c, 0x20, 0x66, 0x75, 0x6e, 0x64, 0x73, 0x20, 0x72, 0x65, 0x71, 0x75, 0x65, 0x73, 0x74,
+    // 38: APPEND_DATA "Request ID"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x52, 0x65, 0x71, 0x75, 0x65, 0x73, 0x74, 0x20, 0x49,
+    0x44,
+    // 39: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x40, 0x3e, 0xd4, 0xaa, 0x0b, 0xa8, 0x5b, 0x60, 0xd5, 0x4d, 0x73, 0x65,
+    0xa4, 0x9e, 0xba, 0x01,
+    // 40: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1c, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x14, 0x52, 0x65, 0x6a, 0x65, 0x63,
+    0x74, 0x20, 0x66, 0x75, 0x6e, 0x64, 0x73, 0x20, 0x72, 0x65, 0x71, 0x75, 0x65, 0x73, 0x74,
+    // 41: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0xc6, 0xea, 0xa6,
+    0x64, 0x52, 0x32, 0x01,
+    // 42: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1a, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x12, 0x4d, 0x61, 0x70, 0x20, 0x70,
+    0x75, 0x62, 0x6c, 0x69, 0x63, 0x20, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73,
+    // 43: APPEND_DATA "FIO Handle"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x46, 0x49, 0x4f, 0x20, 0x48, 0x61, 0x6e, 0x64, 0x6c,
+    0x65,
+    // 44: APPEND_DATA "Mapping "
+    0x04, 0x00, 0x1c, 0x21, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x08, 0x4d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x20,
+    // 45: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0xc6, 0xea, 0xa6,
+    0x64, 0xa4, 0xba, 0x01,
+    // 46: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x26, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x1e, 0x52, 0x65, 0x6d, 0x6f, 0x76,
+    0x65, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x20, 0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73,
+    0x20, 0x6d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x73,
+    // 47: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0x00, 0x00, 0xe4,
+    0x35, 0x53, 0x32, 0x01,
+    // 48: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x10, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x08, 0x4d, 0x61, 0x70, 0x20, 0x6e,
+    0x66, 0x74, 0x73,
+    // 49: SHOW_MESSAGE "Mapping "
+    0x03, 0x00, 0x0a, 0x08, 0x4d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x20, 0x00,
+    // 50: APPEND_DATA "Contract address"
+    0x04, 0x00, 0x24, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x10, 0x43, 0x6f, 0x6e, 0x74, 0x72, 0x61, 0x63, 0x74, 0x20,
+    0x61, 0x64, 0x64, 0x72, 0x65, 0x73, 0x73,
+    // 51: APPEND_DATA "NFT Token ID"
+    0x04, 0x00, 0x20, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0c, 0x4e, 0x46, 0x54, 0x20, 0x54, 0x6f, 0x6b, 0x65, 0x6e,
+    0x20, 0x49, 0x44,
+    // 52: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 53: APPEND_DATA ""
+    0x04, 0x00, 0x14, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+    // 54: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0x00, 0x00, 0xe4,
+    0x35, 0xa5, 0xba, 0x01,
+    // 55: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1b, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x13, 0x52, 0x65, 0x6d, 0x6f, 0x76,
+    0x65, 0x20, 0x6e, 0x66, 0x74, 0x20, 0x6d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x73,
+    // 56: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0xc0, 0x4d, 0xc9, 0xc4,
+    0x68, 0xa4, 0xba, 0x01,
+    // 57: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x2a, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x22, 0x52, 0x65, 0x6d, 0x6f, 0x76,
+    0x65, 0x20, 0x61, 0x6c, 0x6c, 0x20, 0x70, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x20, 0x61, 0x64, 0x64,
+    0x72, 0x65, 0x73, 0x73, 0x20, 0x6d, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x73,
+    // 58: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0xce, 0x6b, 0xc6,
+    0x68, 0xa4, 0xba, 0x01,
+    // 59: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1f, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x17, 0x52, 0x65, 0x6d, 0x6f, 0x76,
+    0x65, 0x20, 0x61, 0x6c, 0x6c, 0x20, 0x6e, 0x66, 0x74, 0x20, 0x6d, 0x61, 0x70, 0x70, 0x69, 0x6e,
+    0x67, 0x73,
+    // 60: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0x56, 0x31, 0x4d,
+    0x7d, 0x52, 0x32, 0x01,
+    // 61: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x13, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0b, 0x41, 0x64, 0x64, 0x20, 0x42,
+    0x75, 0x6e, 0x64, 0x6c, 0x65, 0x73,
+    // 62: APPEND_DATA "Bundle sets"
+    0x04, 0x00, 0x1f, 0x14, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x7f, 0x05, 0x0b, 0x42, 0x75, 0x6e, 0x64, 0x6c, 0x65, 0x20, 0x73, 0x65,
+    0x74, 0x73,
+    // 63: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0xc6, 0xea, 0xa6,
+    0x64, 0x98, 0xba, 0x01,
+    // 64: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x22, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x1a, 0x52, 0x65, 0x67, 0x69, 0x73,
+    0x74, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x43, 0x72, 0x79, 0x70, 0x74, 0x6f, 0x20, 0x48,
+    0x61, 0x6e, 0x64, 0x6c, 0x65,
+    // 65: APPEND_DATA "Owner Pubkey"
+    0x04, 0x00, 0x20, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x0c, 0x4f, 0x77, 0x6e, 0x65, 0x72, 0x20, 0x50, 0x75, 0x62,
+    0x6b, 0x65, 0x79,
+    // 66: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x30, 0x56, 0x37, 0x25,
+    0x73, 0xd5, 0xea, 0x01,
+    // 67: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x22, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x1a, 0x54, 0x72, 0x61, 0x6e, 0x73,
+    0x66, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x43, 0x72, 0x79, 0x70, 0x74, 0x6f, 0x20, 0x48,
+    0x61, 0x6e, 0x64, 0x6c, 0x65,
+    // 68: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0x00, 0x98, 0xce, 0x48,
+    0x9a, 0x98, 0xba, 0x01,
+    // 69: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1b, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x13, 0x52, 0x65, 0x67, 0x69, 0x73,
+    0x74, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x44, 0x6f, 0x6d, 0x61, 0x69, 0x6e,
+    // 70: APPEND_DATA "FIO Domain"
+    0x04, 0x00, 0x1e, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3f, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x46, 0x49, 0x4f, 0x20, 0x44, 0x6f, 0x6d, 0x61, 0x69,
+    0x6e,
+    // 71: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0xa6, 0x33, 0x92, 0x26,
+    0xae, 0xa6, 0xba, 0x01,
+    // 72: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x18, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x10, 0x52, 0x65, 0x6e, 0x65, 0x77,
+    0x20, 0x46, 0x49, 0x4f, 0x20, 0x64, 0x6f, 0x6d, 0x61, 0x69, 0x6e,
+    // 73: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x70, 0x74, 0x9d, 0xce, 0x48,
+    0x9a, 0xb2, 0xc2, 0x01,
+    // 74: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x2e, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x26, 0x53, 0x65, 0x74, 0x20, 0x46,
+    0x49, 0x4f, 0x20, 0x44, 0x6f, 0x6d, 0x61, 0x69, 0x6e, 0x20, 0x72, 0x65, 0x67, 0x69, 0x73, 0x74,
+    0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x70, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f,
+    0x6e,
+    // 75: APPEND_CONST_DATA 1 bytes
+    0x02, 0x00, 0x01, 0x01,
+    // 76: SHOW_MESSAGE "Make"
+    0x03, 0x00, 0x0c, 0x04, 0x4d, 0x61, 0x6b, 0x65, 0x06, 0x50, 0x75, 0x62, 0x6c, 0x69, 0x63,
+    // 77: APPEND_CONST_DATA 1 bytes
+    0x02, 0x00, 0x01, 0x00,
+    // 78: SHOW_MESSAGE "Make"
+    0x03, 0x00, 0x0d, 0x04, 0x4d, 0x61, 0x6b, 0x65, 0x07, 0x50, 0x72, 0x69, 0x76, 0x61, 0x74, 0x65,
+    // 79: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x30, 0x56, 0x37, 0x25, 0x03, 0xa8, 0x5b, 0x00, 0xc0, 0x74, 0x46, 0xd2,
+    0x74, 0xd5, 0xea, 0x01,
+    // 80: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1b, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x13, 0x54, 0x72, 0x61, 0x6e, 0x73,
+    0x66, 0x65, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x44, 0x6f, 0x6d, 0x61, 0x69, 0x6e,
+    // 81: APPEND_DATA "New owner Pubkey"
+    0x04, 0x00, 0x24, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x10, 0x4e, 0x65, 0x77, 0x20, 0x6f, 0x77, 0x6e, 0x65, 0x72,
+    0x20, 0x50, 0x75, 0x62, 0x6b, 0x65, 0x79,
+    // 82: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0xd8, 0x74, 0xd0, 0x64, 0x0c, 0xa8, 0x5b, 0x00, 0x00, 0x00, 0xd4, 0x2d,
+    0x05, 0x4d, 0xc6, 0x01,
+    // 83: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x18, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x10, 0x53, 0x74, 0x61, 0x6b, 0x65,
+    0x20, 0x46, 0x49, 0x4f, 0x20, 0x54, 0x6f, 0x6b, 0x65, 0x6e, 0x73,
+    // 84: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0xd8, 0x74, 0xd0, 0x64, 0x0c, 0xa8, 0x5b, 0x00, 0x00, 0x75, 0x4b, 0x41,
+    0x93, 0xf1, 0xd4, 0x01,
+    // 85: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x1a, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x12, 0x55, 0x6e, 0x73, 0x74, 0x61,
+    0x6b, 0x65, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x54, 0x6f, 0x6b, 0x65, 0x6e, 0x73,
+    // 86: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0xea, 0x30, 0x55, 0x70, 0x15, 0xd2, 0x89, 0xde,
+    0xaa, 0x32, 0xdd, 0x01,
+    // 87: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x24, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x1c, 0x56, 0x6f, 0x74, 0x65, 0x20,
+    0x66, 0x6f, 0x72, 0x20, 0x46, 0x49, 0x4f, 0x20, 0x42, 0x6c, 0x6f, 0x63, 0x6b, 0x20, 0x70, 0x72,
+    0x6f, 0x64, 0x75, 0x63, 0x65, 0x72, 0x73,
+    // 88: APPEND_DATA "Producer "
+    0x04, 0x00, 0x1d, 0x04, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x09, 0x50, 0x72, 0x6f, 0x64, 0x75, 0x63, 0x65, 0x72, 0x20,
+    // 89: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00, 0xea, 0x30, 0x55, 0x00, 0x00, 0xf0, 0x9d, 0xde,
+    0xaa, 0x32, 0xdd, 0x01,
+    // 90: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x13, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0b, 0x50, 0x72, 0x6f, 0x78, 0x79,
+    0x20, 0x76, 0x6f, 0x74, 0x65, 0x73,
+    // 91: APPEND_DATA "Proxy"
+    0x04, 0x00, 0x19, 0x04, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x05, 0x50, 0x72, 0x6f, 0x78, 0x79,
+    // 92: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x80, 0x8a, 0xc8, 0x5c, 0x0a, 0xa8, 0x5b, 0x00, 0xc0, 0x74, 0x46, 0xd2,
+    0x54, 0xcd, 0xe5, 0x01,
+    // 93: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x17, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0f, 0x57, 0x72, 0x61, 0x70, 0x20,
+    0x46, 0x49, 0x4f, 0x20, 0x44, 0x6f, 0x6d, 0x61, 0x69, 0x6e,
+    // 94: APPEND_DATA "Public Address"
+    0x04, 0x00, 0x22, 0x04, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x0e, 0x50, 0x75, 0x62, 0x6c, 0x69, 0x63, 0x20, 0x41, 0x64,
+    0x64, 0x72, 0x65, 0x73, 0x73,
+    // 95: APPEND_DATA "Max oracle fee"
+    0x04, 0x00, 0x22, 0x10, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x7f, 0x05, 0x0e, 0x4d, 0x61, 0x78, 0x20, 0x6f, 0x72, 0x61, 0x63, 0x6c,
+    0x65, 0x20, 0x66, 0x65, 0x65,
+    // 96: APPEND_CONST_DATA 17 bytes
+    0x02, 0x00, 0x11, 0x00, 0x80, 0x8a, 0xc8, 0x5c, 0x0a, 0xa8, 0x5b, 0x00, 0x00, 0x9e, 0x0a, 0xd2,
+    0x5c, 0xcd, 0xe5, 0x01,
+    // 97: SHOW_MESSAGE "Action"
+    0x03, 0x00, 0x13, 0x06, 0x41, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0b, 0x57, 0x72, 0x61, 0x70, 0x20,
+    0x54, 0x6f, 0x6b, 0x65, 0x6e, 0x73,
+};
+
+// Offset of every step in templateStepData
+static const uint16_t templateStepOffsets[] = {
+    0, 3, 26, 34, 54, 84, 87, 110, 133, 154, 189, 218, 248, 271, 274, 310, 313, 333, 357, 396, 435,
+    456, 459, 499, 538, 571, 604, 627, 630, 653, 673, 699, 732, 753, 793, 822, 851, 871, 902, 935,
+    955, 986, 1006, 1035, 1068, 1099, 1119, 1160, 1180, 1199, 1212, 1251, 1286, 1309, 1332, 1352,
+    1382, 1402, 1447, 1467, 1501, 1521, 1543, 1577, 1597, 1634, 1669, 1689, 1726, 1746, 1776, 1809,
+    1829, 1856, 1876, 1925, 1929, 1944, 1948, 1964, 1984, 2014, 2053, 2073, 2100, 2120, 2149, 2169,
+    2208, 2240, 2260, 2282, 2310, 2330, 2356, 2393, 2430, 2450,
+};
+
+#define STEP(step)                       TX_TEMPLATE_OP_STEP, step
+#define STEP_INDEXED(step)               TX_TEMPLATE_OP_STEP_INDEXED, step
+#define COUNT(min, max)                  TX_TEMPLATE_OP_COUNT, min, max
+#define APPEND_COUNT                     TX_TEMPLATE_OP_APPEND_COUNT
+#define LOOP(bodyLength)                 TX_TEMPLATE_OP_LOOP, bodyLength
+#define CHOICE(alternatives, altLength)  TX_TEMPLATE_OP_CHOICE, alternatives, altLength
+
+// Program of every template one after another, the steps are indices to templateStepOffsets
+static const uint8_t templatePrograms[] = {
+    // trnsfiopubky
+    STEP(0), STEP(1), STEP(2), STEP(3), STEP(4), STEP(5), STEP(6), STEP(7), STEP(8), STEP(9),
+    STEP(10), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // newfundsreq
+    STEP(0), STEP(1), STEP(2), STEP(16), STEP(17), STEP(5), STEP(6), STEP(7), STEP(8), STEP(18),
+    STEP(19), STEP(20), STEP(21), STEP(22), STEP(23), STEP(24), STEP(25), STEP(26), STEP(27),
+    STEP(13), STEP(11), STEP(8), STEP(28), STEP(13), STEP(12), STEP(13), STEP(14), STEP(15),
+    // recordobt
+    STEP(0), STEP(1), STEP(2), STEP(29), STEP(30), STEP(5), STEP(6), STEP(7), STEP(8), STEP(31),
+    STEP(18), STEP(19), STEP(32), STEP(21), STEP(33), STEP(22), STEP(23), STEP(24), STEP(25),
+    STEP(34), STEP(35), STEP(26), STEP(27), STEP(13), STEP(11), STEP(8), STEP(28), STEP(13),
+    STEP(12), STEP(13), STEP(14), STEP(15),
+    // cancelfndreq
+    STEP(0), STEP(1), STEP(2), STEP(36), STEP(37), STEP(5), STEP(6), STEP(7), STEP(8), STEP(38),
+    STEP(11), STEP(8), STEP(28), STEP(13), STEP(12), STEP(13), STEP(14), STEP(15),
+    // rejectfndreq
+    STEP(0), STEP(1), STEP(2), STEP(39), STEP(40), STEP(5), STEP(6), STEP(7), STEP(8), STEP(38),
+    STEP(11), STEP(8), STEP(28), STEP(13), STEP(12), STEP(13), STEP(14), STEP(15),
+    // addaddress
+    STEP(0), STEP(1), STEP(2), STEP(41), STEP(42), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    COUNT(1, 5), APPEND_COUNT, LOOP(2), STEP_INDEXED(44), STEP(11), STEP(6), STEP(12), STEP(13),
+    STEP(14), STEP(15),
+    // remaddress
+    STEP(0), STEP(1), STEP(2), STEP(45), STEP(46), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    COUNT(1, 5), APPEND_COUNT, LOOP(2), STEP_INDEXED(44), STEP(11), STEP(6), STEP(12), STEP(13),
+    STEP(14), STEP(15),
+    // addnft
+    STEP(0), STEP(1), STEP(2), STEP(47), STEP(48), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    COUNT(1, 3), APPEND_COUNT, LOOP(14), STEP_INDEXED(49), STEP(24), STEP(50), STEP(51), STEP(52),
+    STEP(53), STEP(52), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // remnft
+    STEP(0), STEP(1), STEP(2), STEP(54), STEP(55), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    COUNT(1, 3), APPEND_COUNT, LOOP(8), STEP_INDEXED(49), STEP(24), STEP(50), STEP(51), STEP(11),
+    STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // remalladdr
+    STEP(0), STEP(1), STEP(2), STEP(56), STEP(57), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // remallnfts
+    STEP(0), STEP(1), STEP(2), STEP(58), STEP(59), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // addbundles
+    STEP(0), STEP(1), STEP(2), STEP(60), STEP(61), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(62), STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+    // regaddress
+    STEP(0), STEP(1), STEP(2), STEP(63), STEP(64), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(65), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // xferaddress
+    STEP(0), STEP(1), STEP(2), STEP(66), STEP(67), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(65), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // regdomain
+    STEP(0), STEP(1), STEP(2), STEP(68), STEP(69), STEP(5), STEP(6), STEP(7), STEP(8), STEP(70),
+    STEP(65), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // renewdomain
+    STEP(0), STEP(1), STEP(2), STEP(71), STEP(72), STEP(5), STEP(6), STEP(7), STEP(8), STEP(70),
+    STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+    // setdomainpub
+    STEP(0), STEP(1), STEP(2), STEP(73), STEP(74), STEP(5), STEP(6), STEP(7), STEP(8), STEP(70),
+    CHOICE(2, 4), STEP(75), STEP(76), STEP(77), STEP(78), STEP(11), STEP(6), STEP(12), STEP(13),
+    STEP(14), STEP(15),
+    // xferdomain
+    STEP(0), STEP(1), STEP(2), STEP(79), STEP(80), STEP(5), STEP(6), STEP(7), STEP(8), STEP(70),
+    STEP(81), STEP(11), STEP(6), STEP(12), STEP(13), STEP(14), STEP(15),
+    // stakefio
+    STEP(0), STEP(1), STEP(2), STEP(82), STEP(83), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(10), STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+    // unstakefio
+    STEP(0), STEP(1), STEP(2), STEP(84), STEP(85), STEP(5), STEP(6), STEP(7), STEP(8), STEP(43),
+    STEP(10), STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+    // voteproducer
+    STEP(0), STEP(1), STEP(2), STEP(86), STEP(87), STEP(5), STEP(6), STEP(7), STEP(8), COUNT(1, 30),
+    APPEND_COUNT, LOOP(2), STEP_INDEXED(88), STEP(43), STEP(6), STEP(11), STEP(13), STEP(14),
+    STEP(15),
+    // voteproxy
+    STEP(0), STEP(1), STEP(2), STEP(89), STEP(90), STEP(5), STEP(6), STEP(7), STEP(8), STEP(91),
+    STEP(43), STEP(6), STEP(11), STEP(13), STEP(14), STEP(15),
+    // wrapdomain
+    STEP(0), STEP(1), STEP(2), STEP(92), STEP(93), STEP(5), STEP(6), STEP(7), STEP(8), STEP(70),
+    STEP(24), STEP(94), STEP(95), STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+    // wraptokens
+    STEP(0), STEP(1), STEP(2), STEP(96), STEP(97), STEP(5), STEP(6), STEP(7), STEP(8), STEP(10),
+    STEP(24), STEP(94), STEP(95), STEP(11), STEP(12), STEP(6), STEP(13), STEP(14), STEP(15),
+};
+
+#undef STEP
+#undef STEP_INDEXED
+#undef COUNT
+#undef APPEND_COUNT
+#undef LOOP
+#undef CHOICE
+
+static const tx_template_t templates[] = {
+    // trnsfiopubky
+    {{0x85, 0x42, 0xbf, 0x32}, 0, 34},
+    // newfundsreq
+    {{0xb8, 0x7a, 0xcb, 0xe0}, 34, 56},
+    // recordobt
+    {{0x84, 0xe9, 0x66, 0x63}, 90, 64},
+    // cancelfndreq
+    {{0xec, 0x41, 0x06, 0x38}, 154, 36},
+    // rejectfndreq
+    {{0x85, 0x2b, 0x1d, 0x85}, 190, 36},
+    // addaddress
+    {{0x4a, 0x97, 0xcf, 0xc0}, 226, 40},
+    // remaddress
+    {{0x9a, 0xfc, 0xcd, 0xa4}, 266, 40},
+    // addnft
+    {{0xe5, 0xc7, 0x26, 0x57}, 306, 52},
+    // remnft
+    {{0xcf, 0xad, 0x86, 0x75}, 358, 46},
+    // remalladdr
+    {{0xe5, 0x53, 0x12, 0x4c}, 404, 32},
+    // remallnfts
+    {{0x9a, 0x53, 0x11, 0xa7}, 436, 32},
+    // addbundles
+    {{0xc3, 0x9c, 0xa1, 0x4b}, 468, 34},
+    // regaddress
+    {{0xdb, 0xa8, 0x3a, 0xe8}, 502, 34},
+    // xferaddress
+    {{0x7a, 0x7c, 0xd7, 0x37}, 536, 34},
+    // regdomain
+    {{0x0e, 0x55, 0x07, 0x6d}, 570, 34},
+    // renewdomain
+    {{0x96, 0x16, 0xa2, 0x9c}, 604, 32},
+    // setdomainpub
+    {{0xa9, 0xe6, 0x5c, 0xa3}, 636, 43},
+    // xferdomain
+    {{0x77, 0x3e, 0x3e, 0xc2}, 679, 34},
+    // stakefio
+    {{0xc5, 0x92, 0x81, 0xec}, 713, 34},
+    // unstakefio
+    {{0x32, 0x28, 0xac, 0x12}, 747, 34},
+    // voteproducer
+    {{0xeb, 0x28, 0x26, 0x86}, 781, 38},
+    // voteproxy
+    {{0x57, 0x3e, 0x90, 0x44}, 819, 32},
+    // wrapdomain
+    {{0xf9, 0x45, 0x5b, 0x9d}, 851, 38},
+    // wraptokens
+    {{0x92, 0x5e, 0x73, 0xdf}, 889, 38},
+};
+
+__noinline_due_to_stack__ bool txTemplate_start(const uint8_t *templateId,
+                                                tx_template_cursor_t *cursor) {
+    STATIC_ASSERT(ARRAY_LEN(templates) <= UINT8_MAX, "Too many templates");
+    for (uint8_t i = 0; i < ARRAY_LEN(templates); i++) {
+        if (memcmp(templates[i].id, templateId, TX_TEMPLATE_ID_LENGTH) == 0) {
+            explicit_bzero(cursor, sizeof(tx_template_cursor_t));
+            cursor->templateIndex = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void txTemplate_getStep(uint8_t stepIndex, tx_template_step_t *out) {
+    ASSERT(stepIndex < ARRAY_LEN(templateStepOffsets));
+    const size_t offset = templateStepOffsets[stepIndex];
+    ASSERT(offset + 3 <= ARRAY_LEN(templateStepData));
+
+    out->p1 = templateStepData[offset];
+    out->p2 = templateStepData[offset + 1];
+    out->constDataLength = templateStepData[offset + 2];
+    out->constData = templateStepData + offset + 3;
+    ASSERT(offset + 3 + out->constDataLength <= ARRAY_LEN(templateStepData));
+}
+
+// Appends the iteration to the key of the step, the const data is copied to the step
+static void txTemplate_indexStep(uint8_t iteration, tx_template_step_t *step) {
+    size_t keyLengthOffset = 0;
+    switch (step->p1) {
+        case SIGN_TX_P1_APPEND_DATA:
+            keyLengthOffset = APPEND_DATA_KEY_LENGTH_OFFSET;
+            break;
+        case SIGN_TX_P1_SHOW_MESSAGE:
+            keyLengthOffset = SHOW_MESSAGE_KEY_LENGTH_OFFSET;
+            break;
+        default:
+            ASSERT(false);
+    }
+    ASSERT(keyLengthOffset < step->constDataLength);
+    const size_t keyEnd = keyLengthOffset + 1 + step->constData[keyLengthOffset];
+    ASSERT(keyEnd <= step->constDataLength);
+
+    char digits[4];
+    const size_t digitsLength = str_formatUint64(iteration, digits, SIZEOF(digits));
+    const size_t length = step->constDataLength + digitsLength;
+    ASSERT(length <= SIZEOF(step->indexedConstData));
+
+    uint8_t *out = step->indexedConstData;
+    memmove(out, step->constData, keyEnd);
+    memmove(out + keyEnd, digits, digitsLength);
+    memmove(out + keyEnd + digitsLength, step->constData + keyEnd, step->constDataLength - keyEnd);
+    out[keyLengthOffset] += digitsLength;
+    step->constData = out;
+    step->constDataLength = (uint8_t) length;
+}
+
+__noinline_due_to_stack__ bool txTemplate_next(tx_template_cursor_t *cursor,
+                                               const uint8_t *entry,
+                                               uint8_t entrySize,
+                                               tx_template_step_t *step) {
+    ASSERT(cursor->templateIndex < ARRAY_LEN(templates));
+    const tx_template_t *template = &templates[cursor->templateIndex];
+    ASSERT((size_t) template->programStart + template->programLength <=
+           ARRAY_LEN(templatePrograms));
+    const uint8_t *program = templatePrograms + template->programStart;
+
+    while (true) {
+        if (cursor->choiceEnd != 0 && cursor->pc == cursor->alternativeEnd) {
+            cursor->pc = cursor->choiceEnd;
+            cursor->alternativeEnd = cursor->choiceEnd = 0;
+        }
+        if (cursor->iteration != 0 && cursor->pc == cursor->loopEnd) {
+            if (cursor->iteration < cursor->count) {
+                cursor->iteration++;
+                cursor->pc = cursor->loopStart;
+            } else {
+                cursor->iteration = 0;
+            }
+        }
+        // the host sent more entries than the template takes
+        VALIDATE(cursor->pc < template->programLength, ERR_INVALID_DATA);
+
+        const uint8_t *op = program + cursor->pc;
+        switch (op[0]) {
+            case TX_TEMPLATE_OP_STEP:
+            case TX_TEMPLATE_OP_STEP_INDEXED:
+                ASSERT(cursor->pc + 2 <= template->programLength);
+                txTemplate_getStep(op[1], step);
+                if (op[0] == TX_TEMPLATE_OP_STEP_INDEXED) {
+                    ASSERT(cursor->iteration != 0);
+                    txTemplate_indexStep(cursor->iteration, step);
+                }
+                cursor->pc += 2;
+                return true;
+
+            case TX_TEMPLATE_OP_COUNT:
+                ASSERT(cursor->pc + 3 <= template->programLength);
+                VALIDATE(entrySize == 1, ERR_INVALID_DATA);
+                VALIDATE(op[1] <= entry[0] && entry[0] <= op[2], ERR_INVALID_DATA);
+                cursor->count = entry[0];
+                cursor->pc += 3;
+                return false;
+
+            case TX_TEMPLATE_OP_APPEND_COUNT:
+                // a single byte varuint32, the counts are below 128
+                ASSERT(cursor->count < 0x80);
+                step->p1 = SIGN_TX_P1_APPEND_CONST_DATA;
+                step->p2 = 0;
+                step->constData = &cursor->count;
+                step->constDataLength = 1;
+                cursor->pc += 1;
+                return true;
+
+            case TX_TEMPLATE_OP_LOOP:
+                ASSERT(cursor->pc + 2 + op[1] <= template->programLength);
+                // the loops are not nested
+                ASSERT(cursor->iteration == 0);
+                cursor->pc += 2;
+                if (cursor->count > 0) {
+                    cursor->iteration = 1;
+                    cursor->loopStart = cursor->pc;
+                    cursor->loopEnd = cursor->pc + op[1];
+                } else {
+                    cursor->pc += op[1];
+                }
+                break;
+
+            case TX_TEMPLATE_OP_CHOICE:
+                ASSERT(cursor->pc + 3 + op[1] * op[2] <= template->programLength);
+                ASSERT(cursor->choiceEnd == 0);
+                VALIDATE(entrySize == 1, ERR_INVALID_DATA);
+                VALIDATE(entry[0] < op[1], ERR_INVALID_DATA);
+                cursor->pc += 3;
+                cursor->choiceEnd = cursor->pc + op[1] * op[2];
+                cursor->pc += entry[0] * op[2];
+                cursor->alternativeEnd = cursor->pc + op[2];
+                return false;
+
+            default:
+                ASSERT(false);
+        }
+    }
+}
+
+#ifdef DEVEL
+__noinline_due_to_stack__ uint8_t txTemplate_count() {
+    return ARRAY_LEN(templates);
+}
+
+__noinline_due_to_stack__ void txTemplate_getId(uint8_t templateIndex, uint8_t *templateId) {
+    ASSERT(templateIndex < ARRAY_LEN(templates));
+    memmove(templateId, templates[templateIndex].id, TX_TEMPLATE_ID_LENGTH);
+}
+
+__noinline_due_to_stack__ void txTemplate_parameterRange(uint8_t templateIndex,
+                                                         uint8_t *min,
+                                                         uint8_t *max) {
+    ASSERT(templateIndex < ARRAY_LEN(templates));
+    const tx_template_t *template = &templates[templateIndex];
+    const uint8_t *program = templatePrograms + template->programStart;
+    *min = *max = 0;
+    for (size_t pc = 0; pc < template->programLength;) {
+        switch (program[pc]) {
+            case TX_TEMPLATE_OP_COUNT:
+                *min = program[pc + 1];
+                *max = program[pc + 2];
+                return;
+            case TX_TEMPLATE_OP_CHOICE:
+                *max = program[pc + 1] - 1;
+                return;
+            case TX_TEMPLATE_OP_APPEND_COUNT:
+                pc += 1;
+                break;
+            default:
+                // the body of a loop is after its op
+                pc += 2;
+        }
+    }
+}
+#endif  // DEVEL
@@ -0,0 +1,64 @@
+#ifndef H_FIO_APP_SIGN_TRANSACTION_TEMPLATES
+#define H_FIO_APP_SIGN_TRANSACTION_TEMPLATES
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils.h"
+
+// Template ID is the beginning of the hash of the template program, see integrityHashes.ts
+#define TX_TEMPLATE_ID_LENGTH 4
+
+// Const data of an indexed step with the iteration appended to its key
+#define TX_TEMPLATE_MAX_INDEXED_STEP_LENGTH 32
+
+// One command of a template, the constant part of the command is in flash (in the step for
+// the indexed steps, in the cursor for the count). Valid until the next step is taken.
+typedef struct {
+    uint8_t p1;
+    uint8_t p2;
+    const uint8_t *constData;
+    uint8_t constDataLength;
+    uint8_t indexedConstData[TX_TEMPLATE_MAX_INDEXED_STEP_LENGTH];
+} tx_template_step_t;
+
+// Position in the program of the running template, kept between the APDUs
+typedef struct {
+    uint8_t templateIndex;
+    // Offset of the next op in the program
+    uint8_t pc;
+    // Count of the loop, from the host
+    uint8_t count;
+    // Iteration of the running loop from 1, 0 outside of the loop
+    uint8_t iteration;
+    uint8_t loopStart;
+    uint8_t loopEnd;
+    // End of the running alternative of a choice and the end of the choice, 0 outside of it
+    uint8_t alternativeEnd;
+    uint8_t choiceEnd;
+} tx_template_cursor_t;
+
+__noinline_due_to_stack__ bool txTemplate_start(const uint8_t *templateId,
+                                                tx_template_cursor_t *cursor);
+
+// Runs the ops of the template up to the next one which takes an entry of the host. True if it is
+// a step, the entry is the variable data of its command. Otherwise the entry is the value of
+// a parameter of the template (count of the loop, alternative of the choice), which is taken.
+__noinline_due_to_stack__ bool txTemplate_next(tx_template_cursor_t *cursor,
+                                               const uint8_t *entry,
+                                               uint8_t entrySize,
+                                               tx_template_step_t *step);
+
+#ifdef DEVEL
+__noinline_due_to_stack__ uint8_t txTemplate_count();
+
+__noinline_due_to_stack__ void txTemplate_getId(uint8_t templateIndex, uint8_t *templateId);
+
+// Range of the parameter of the template (count or alternative), 0 to 0 if it has none
+__noinline_due_to_stack__ void txTemplate_parameterRange(uint8_t templateIndex,
+                                                         uint8_t *min,
+                                                         uint8_t *max);
+
+__noinline_due_to_stack__ void run_txTemplates_test();
+#endif  // DEVEL
+
+#endif  // H_FIO_APP_SIGN_TRANSACTION_TEMPLATES
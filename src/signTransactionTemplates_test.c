@@ -0,0 +1,84 @@
+#ifdef DEVEL
+
+#include "signTransaction.h"
+#include "signTransactionTemplates.h"
+#include "signTransactionIntegrity.h"
+#include "testUtils.h"
+#include "assert.h"
+
+// Starts the template by its ID
+static void startTemplate(uint8_t templateIndex, tx_template_cursor_t *cursor) {
+    uint8_t id[TX_TEMPLATE_ID_LENGTH] = {0};
+    txTemplate_getId(templateIndex, id);
+    ASSERT(txTemplate_start(id, cursor));
+    ASSERT(cursor->templateIndex == templateIndex);
+}
+
+// Runs the steps of the template up to FINISH, the parameter is sent as every entry
+static void runTemplate(tx_template_cursor_t *cursor,
+                        uint8_t parameter,
+                        tx_integrity_t *integrity) {
+    tx_template_step_t step = {0};
+    while (step.p1 != SIGN_TX_P1_FINISH) {
+        if (!txTemplate_next(cursor, &parameter, 1, &step)) {
+            continue;
+        }
+        integrityCheckProcessInstruction(integrity,
+                                         step.p1,
+                                         step.p2,
+                                         step.constData,
+                                         step.constDataLength);
+        if (step.p1 == SIGN_TX_P1_END_DH_ENCODING) {
+            ASSERT(integrityCheckEvaluate(integrity));
+        }
+    }
+}
+
+// The steps of the template run with the parameter pass the integrity check
+static void templateRun_test(uint8_t templateIndex, uint8_t parameter) {
+    tx_template_cursor_t cursor;
+    tx_integrity_t integrity;
+    startTemplate(templateIndex, &cursor);
+    integrityCheckInit(&integrity);
+    runTemplate(&cursor, parameter, &integrity);
+    ASSERT(integrityCheckEvaluate(&integrity));
+
+    // nothing follows FINISH
+    tx_template_step_t step;
+    EXPECT_THROWS(txTemplate_next(&cursor, &parameter, 1, &step), ERR_INVALID_DATA);
+}
+
+// The parameter out of its range is rejected
+static void templateInvalidParameter_test(uint8_t templateIndex, uint8_t parameter) {
+    tx_template_cursor_t cursor;
+    tx_integrity_t integrity;
+    startTemplate(templateIndex, &cursor);
+    integrityCheckInit(&integrity);
+    EXPECT_THROWS(runTemplate(&cursor, parameter, &integrity), ERR_INVALID_DATA);
+}
+
+static void unknownTemplate_test() {
+    const uint8_t id[TX_TEMPLATE_ID_LENGTH] = {0};
+    tx_template_cursor_t cursor;
+    ASSERT(!txTemplate_start(id, &cursor));
+}
+
+void run_txTemplates_test() {
+    ASSERT(txTemplate_count() > 0);
+    for (uint8_t i = 0; i < txTemplate_count(); i++) {
+        uint8_t min = 0, max = 0;
+        txTemplate_parameterRange(i, &min, &max);
+        for (uint16_t parameter = min; parameter <= max; parameter++) {
+            templateRun_test(i, (uint8_t) parameter);
+        }
+        if (max > 0) {
+            if (min > 0) {
+                templateInvalidParameter_test(i, min - 1);
+            }
+            templateInvalidParameter_test(i, max + 1);
+        }
+    }
+    unknownTemplate_test();
+}
+
+#endif  // DEVEL
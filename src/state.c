@@ -1,4 +1,12 @@
 #include "state.h"
 
+STATIC_ASSERT(sizeof(ins_get_key_context_t) <= GET_KEY_CONTEXT_RAM_BUDGET,
+              "getKeyContext over RAM budget");
+STATIC_ASSERT(sizeof(ins_sign_transaction_context_t) <=
+                  SIGN_TX_CONTEXT_RAM_BUDGET + sizeof(cx_sha256_t) + sizeof(cx_hmac_sha256_t),
+              "signTransactionContext over RAM budget");
+STATIC_ASSERT(sizeof(ins_decode_context_t) <= DECODE_CONTEXT_RAM_BUDGET,
+              "decodeContext over RAM budget");
+
 instructionState_t instructionState;
 int currentInstruction;
@@ -18,7 +18,16 @@ typedef union {
     ins_decode_context_t decodeContext;
 } instructionState_t;
 
+// RAM budgets of the instruction contexts, enforced in state.c.
+// Crypto contexts provided by the SDK (cx_sha256_t, cx_hmac_sha256_t) are not counted, their size
+// depends on the SDK version and on the enabled hash functions.
+// Use `make ram_report` to see the actual size of every context and field.
+#define GET_KEY_CONTEXT_RAM_BUDGET 160
+#define SIGN_TX_CONTEXT_RAM_BUDGET 672
+#define DECODE_CONTEXT_RAM_BUDGET  600
+
 // Note(instructions are uint8_t but we have a special INS_NONE value
+enum { INS_NONE = -1 };
 extern int currentInstruction;
 
 extern instructionState_t instructionState;
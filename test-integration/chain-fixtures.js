@@ -0,0 +1,68 @@
+import fetch from "node-fetch"
+import fs from "fs"
+import path from "path"
+import { fileURLToPath } from "url"
+
+// Chain info and contract ABIs used by the signing tests to serialize transactions with fiojs.
+// TEST_CHAIN_FIXTURES selects where they come from:
+//   unset     - fetched from the API endpoint (the default, needs network)
+//   offline   - read from chain-fixtures/<endpoint host>/, no network access
+//   record    - fetched from the API endpoint and stored in chain-fixtures/<endpoint host>/
+// Offline mode needs a recording of both endpoints, the fixtures are never written by hand
+// (ABIs derived from the transaction templates could not catch a bug in them). A recording
+// goes stale when a contract ABI changes, the live mode is the reference.
+
+const fixturesDir = path.join(path.dirname(fileURLToPath(import.meta.url)), "chain-fixtures")
+const mode = process.env.TEST_CHAIN_FIXTURES || "live"
+
+if (!["live", "offline", "record"].includes(mode)) {
+    throw new Error(`Unknown TEST_CHAIN_FIXTURES mode: ${mode}`)
+}
+
+function fixtureFile(endpoint, name) {
+    return path.join(fixturesDir, new URL(endpoint).host, name)
+}
+
+// responses by fixture file, so that the tests run in one process fetch each of them once;
+// a failed request is evicted, so that the next test retries it instead of failing too
+const cache = new Map()
+
+function getJson(endpoint, apiPath, fixture, init) {
+    const file = fixtureFile(endpoint, fixture)
+    if (!cache.has(file)) {
+        const json = loadJson(endpoint, apiPath, file, init)
+        cache.set(file, json)
+        json.catch(() => {
+            if (cache.get(file) === json) cache.delete(file)
+        })
+    }
+    return cache.get(file)
+}
+
+async function loadJson(endpoint, apiPath, file, init) {
+    if (mode === "offline") {
+        if (!fs.existsSync(file)) {
+            throw new Error(`Missing chain fixture ${file}, record it with TEST_CHAIN_FIXTURES=record`)
+        }
+        return JSON.parse(fs.readFileSync(file, "utf8"))
+    }
+    const json = await (await fetch(endpoint + apiPath, init)).json()
+    if (mode === "record") {
+        fs.mkdirSync(path.dirname(file), { recursive: true })
+        fs.writeFileSync(file, JSON.stringify(json, null, 2) + "\n")
+    }
+    return json
+}
+
+async function getChainInfo(endpoint) {
+    return getJson(endpoint, '/v1/chain/get_info', 'get_info.json')
+}
+
+async function getAbi(endpoint, account) {
+    return getJson(endpoint, '/v1/chain/get_abi', `abi.${account}.json`, {
+        body: `{"account_name": "${account}"}`,
+        method: 'POST',
+    })
+}
+
+export { getChainInfo, getAbi }
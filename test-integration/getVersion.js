@@ -22,6 +22,8 @@ assert.equal(version.minor, parseInt(process.env.APPVERSION_N))
 assert.equal(version.patch, parseInt(process.env.APPVERSION_P))
 assert.equal(compatibility.isCompatible, true)
 assert.equal(compatibility.recommendedVersion, null)
+assert.equal(compatibility.supportsGetAppInfo, true)
+assert.equal(compatibility.supportsSignTransactionTemplate, true)
 
 await transport.close()
 testEnd(scriptName);
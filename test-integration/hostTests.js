@@ -0,0 +1,411 @@
+import { testStart, testStep, testEnd, getScriptName } from "./speculos-common.js"
+import {
+    Fio, FioPool, FioScheduler, HARDENED, Histogram, HistogramObserver, InvalidData, RecordingTransport, ReplayTransport,
+    SchedulerPriority, SimulatorTransport, TranscriptMismatch, recoverSigner, verifySigner,
+} from "ledgerjs-hw-app-fio"
+import { fileURLToPath } from 'url';
+import assert from 'assert/strict';
+
+// Tests of the host-side parts of ledgerjs-fio, they run without speculos or a device:
+// the simulator (SimulatorTransport) answers the APDUs.
+
+const scriptName = getScriptName(fileURLToPath(import.meta.url));
+testStart(scriptName);
+
+const path = [44 + HARDENED, 235 + HARDENED, 0 + HARDENED, 0, 0]
+const chainId = "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e"
+const tx = {
+    expiration: "2021-08-28T12:50:36.686",
+    ref_block_num: 0x1122,
+    ref_block_prefix: 0x33445566,
+    context_free_actions: [],
+    actions: [{
+        account: "fio.token",
+        name: "trnsfiopubky",
+        authorization: [{ actor: "aftyershcu22", permission: "active" }],
+        data: {
+            payee_public_key: "FIO8PRe4WRZJj5mkem6qVGKyvNFgPsNnjNN6kPhh6EaCpzCVin5Jj",
+            amount: "2000",
+            max_fee: 0x11223344,
+            actor: "aftyershcu22",
+            tpid: "rewards@wallet",
+        },
+    }],
+    transaction_extensions: null,
+}
+const txWithAmount = (amount) => ({ ...tx, actions: [{ ...tx.actions[0], data: { ...tx.actions[0].data, amount } }] })
+
+testStep(" - - -", "RecordingTransport / ReplayTransport: replay of a recorded transcript");
+const recording = new RecordingTransport(new SimulatorTransport())
+const recordedVersion = await new Fio(recording).getVersion()
+const recordedFio = new Fio(recording)
+const recordedSignature = await recordedFio.signTransaction({ path, chainId, tx })
+const transcript = JSON.parse(JSON.stringify(recording.transcript))
+{
+    const replay = new ReplayTransport(transcript)
+    assert.deepEqual(await new Fio(replay).getVersion(), recordedVersion)
+    assert.deepEqual(await new Fio(replay).signTransaction({ path, chainId, tx }), recordedSignature)
+    assert.equal(replay.done, true)
+
+    replay.rewind()
+    assert.equal(replay.done, false)
+    assert.deepEqual(await new Fio(replay).getVersion(), recordedVersion)
+}
+
+testStep(" - - -", "ReplayTransport: an APDU which differs from the recorded one is a mismatch");
+{
+    const replay = new ReplayTransport(transcript)
+    await new Fio(replay).getVersion()
+    await assert.rejects(new Fio(replay).signTransaction({ path, chainId, tx: txWithAmount("2001") }), TranscriptMismatch)
+    assert.equal(replay.done, false)
+}
+
+testStep(" - - -", "ReplayTransport: an APDU after the end of the transcript is a mismatch");
+{
+    const replay = new ReplayTransport(transcript.slice(0, 1))
+    await new Fio(replay).getVersion()
+    assert.equal(replay.done, true)
+    await assert.rejects(new Fio(replay).getVersion(), TranscriptMismatch)
+}
+
+testStep(" - - -", "ReplayTransport: the APDUs must come in the recorded order");
+{
+    const replay = new ReplayTransport([...transcript].reverse())
+    await assert.rejects(new Fio(replay).getVersion(), TranscriptMismatch)
+}
+
+testStep(" - - -", "getCompatibility: GET_APP_INFO and the TEMPLATE command only with apps from 1.0.8");
+{
+    const signTxP1s = async (version) => {
+        const recording = new RecordingTransport(new SimulatorTransport({ version }))
+        const fio = new Fio(recording)
+        const { compatibility } = await fio.getVersion()
+        await fio.signTransaction({ path, chainId, tx })
+        const p1s = recording.transcript.map(({ apdu }) => Buffer.from(apdu, "hex"))
+            .filter((apdu) => apdu[1] === 0x20).map((apdu) => apdu[2])
+        return { compatibility, p1s }
+    }
+    const flags = { isDebug: false }
+    const v107 = await signTxP1s({ major: 1, minor: 0, patch: 7, flags })
+    assert.equal(v107.compatibility.isCompatible, true)
+    assert.equal(v107.compatibility.supportsGetAppInfo, false)
+    assert.equal(v107.compatibility.supportsSignTransactionTemplate, false)
+    // the simulator lists the TEMPLATE command, an app before 1.0.8 had a different framing
+    assert.ok(v107.p1s.length > 1 && !v107.p1s.includes(0x11), `${v107.p1s}`)
+
+    const v108 = await signTxP1s({ major: 1, minor: 0, patch: 8, flags })
+    assert.equal(v108.compatibility.supportsGetAppInfo, true)
+    assert.equal(v108.compatibility.supportsSignTransactionTemplate, true)
+    assert.ok(v108.p1s.length > 0 && v108.p1s.every((p1) => p1 === 0x11), `${v108.p1s}`)
+
+    const { compatibility: v110 } = await new Fio(new SimulatorTransport({ version: { major: 1, minor: 1, patch: 0, flags } }))
+        .getVersion()
+    assert.equal(v110.isCompatible, false)
+    assert.equal(v110.supportsSignTransactionTemplate, false)
+}
+
+testStep(" - - -", "TEMPLATE: every count of the loop signs the same as the commands, in fewer bytes");
+{
+    const voteproducer = (count) => ({
+        ...tx,
+        actions: [{
+            account: "eosio",
+            name: "voteproducer",
+            authorization: [{ actor: "aftyershcu22", permission: "active" }],
+            data: {
+                producers: Array.from({ length: count }, (_, i) => `producer${i}@fiotestnet`),
+                fio_address: "address@fiotestnet",
+                max_fee: 0x11223344,
+                actor: "aftyershcu22",
+            },
+        }],
+    })
+    const sign = async (patch, count) => {
+        const recording = new RecordingTransport(new SimulatorTransport({ version: { major: 1, minor: 0, patch, flags: { isDebug: false } } }))
+        const { witness } = await new Fio(recording).signTransaction({ path, chainId, tx: voteproducer(count) })
+        const apdus = recording.transcript.map(({ apdu }) => Buffer.from(apdu, "hex")).filter((apdu) => apdu[1] === 0x20)
+        return { witness, apdus, bytes: apdus.reduce((sum, apdu) => sum + apdu.length, 0) }
+    }
+    for (const count of [1, 2, 9, 10, 30]) {
+        const commands = await sign(7, count)
+        const template = await sign(8, count)
+        assert.deepEqual(template.witness, commands.witness)
+        assert.ok(template.apdus.every((apdu) => apdu[2] === 0x11))
+        assert.ok(template.apdus.length <= commands.apdus.length, `${count}: ${template.apdus.length} APDUs`)
+        assert.ok(template.bytes < commands.bytes, `${count}: ${template.bytes} bytes`)
+    }
+    // the count out of the range of the template is refused on the host
+    await assert.rejects(new Fio(new SimulatorTransport()).signTransaction({ path, chainId, tx: voteproducer(31) }), InvalidData)
+}
+
+testStep(" - - -", "FioScheduler: the highest priority first, callers of the same priority take turns");
+{
+    const scheduler = new FioScheduler(new Fio(new SimulatorTransport()))
+    const order = []
+    let release
+    const running = scheduler.schedule(() => new Promise((resolve) => { release = resolve }))
+    const run = (name, options) => scheduler.schedule(async () => { order.push(name) }, options)
+    const bulk = { priority: SchedulerPriority.BULK }
+    const all = [
+        run("A1", { caller: "A", ...bulk }), run("A2", { caller: "A", ...bulk }), run("A3", { caller: "A", ...bulk }),
+        run("B1", { caller: "B", ...bulk }), run("B2", { caller: "B", ...bulk }),
+        run("C1", { caller: "C", ...bulk }),
+        run("N1", { caller: "A" }), run("N2", { caller: "B" }), run("N3", { caller: "A" }),
+        run("I1", { priority: SchedulerPriority.INTERACTIVE }),
+    ]
+    const stats = scheduler.stats()
+    assert.equal(stats.queueDepth, 10)
+    assert.deepEqual(stats.queueDepthByPriority, { [SchedulerPriority.INTERACTIVE]: 1, [SchedulerPriority.NORMAL]: 3, [SchedulerPriority.BULK]: 6 })
+    assert.equal(stats.running, true)
+
+    release()
+    await running
+    await Promise.all(all)
+    assert.deepEqual(order, ["I1", "N1", "N2", "N3", "A1", "B1", "C1", "A2", "B2", "A3"])
+    assert.equal(scheduler.stats().completed, 11)
+}
+
+testStep(" - - -", "FioScheduler: a failed operation does not stop the queue, calls of the device do not interleave");
+{
+    const scheduler = new FioScheduler(new Fio(new SimulatorTransport()))
+    const failing = scheduler.schedule(async () => { throw new Error("failed operation") })
+    // signTransaction runs at NORMAL priority, getPublicKey at INTERACTIVE
+    const signatures = [1, 2, 3].map((i) => scheduler.signTransaction({ path, chainId, tx: txWithAmount(String(i)) }, { caller: "wallet" + i }))
+    const publicKey = scheduler.getPublicKey({ path, show_or_not: false })
+    await assert.rejects(failing, /failed operation/)
+    const results = await Promise.all(signatures)
+    assert.equal(new Set(results.map((r) => r.txHashHex)).size, 3)
+    assert.match((await publicKey).publicKeyWIF, /^FIO/)
+    const stats = scheduler.stats()
+    assert.equal(stats.completed, 5)
+    assert.equal(stats.failed, 1)
+    assert.equal(stats.queueDepth, 0)
+}
+
+testStep(" - - -", "FioPool: only the requests which opt in are retried after a device failure");
+{
+    // a simulator whose transport fails the next `failures` exchanges
+    const failingTransport = () => {
+        const transport = new SimulatorTransport()
+        const exchange = transport.exchange.bind(transport)
+        transport.failures = 0
+        transport.exchange = (apdu) => {
+            if (transport.failures > 0) {
+                transport.failures--
+                return Promise.reject(new Error("device disconnected"))
+            }
+            return exchange(apdu)
+        }
+        return transport
+    }
+    const transport = failingTransport()
+    const pool = new FioPool([new Fio(transport)], { maxConsecutiveFailures: 10 })
+
+    transport.failures = 1
+    assert.match((await pool.getPublicKey({ path, show_or_not: false })).publicKeyWIF, /^FIO/)
+    assert.equal(pool.stats().retried, 1)
+
+    transport.failures = 1
+    await assert.rejects(pool.signTransaction({ path, chainId, tx }), /device disconnected/)
+    transport.failures = 1
+    const otherPublicKeyHex = "04" + "79be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798" +
+        "483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8"
+    const message = Buffer.alloc(64).toString("base64")
+    await assert.rejects(pool.decodeMessage({ path, publicKeyHex: otherPublicKeyHex, message, context: "newfundsreq" }),
+        /device disconnected/)
+    assert.equal(pool.stats().retried, 1)
+
+    transport.failures = 1
+    await pool.signTransaction({ path, chainId, tx }, undefined, true)
+    assert.equal(pool.stats().retried, 2)
+
+    // checkHealth() requests the app info from the device, not from the cache
+    transport.failures = 1
+    const [device] = await pool.checkHealth()
+    assert.equal(device.consecutiveFailures, 1)
+    assert.equal(transport.failures, 0)
+    assert.equal((await pool.checkHealth())[0].consecutiveFailures, 0)
+}
+
+// the value of the given percentile of the sorted values: the smallest value which the given
+// percentage of the values do not exceed (percentile with at most one decimal place)
+const exactPercentile = (sorted, percentile) =>
+    sorted[Math.max(1, Math.ceil(Math.round(percentile * 10) * sorted.length / 1000)) - 1]
+
+// checks the summary against the exact values, the percentiles to the precision of the histogram
+function assertSummary(histogram, values, significantDigits) {
+    const sorted = [...values].sort((a, b) => a - b)
+    const summary = histogram.summary()
+    assert.equal(summary.count, values.length)
+    assert.equal(summary.min, sorted[0])
+    assert.equal(summary.max, sorted[sorted.length - 1])
+    assert.equal(summary.mean, values.reduce((a, b) => a + b, 0) / values.length)
+    for (const [key, percentile] of [["p50", 50], ["p90", 90], ["p99", 99], ["p999", 99.9]]) {
+        const exact = exactPercentile(sorted, percentile)
+        // the bucket of the exact value, which is reported by its highest value
+        assert.ok(summary[key] >= exact && summary[key] <= exact * (1 + 10 ** -significantDigits),
+            `${key} ${summary[key]}, exact ${exact}`)
+    }
+}
+
+testStep(" - - -", "Histogram: percentiles of known distributions");
+{
+    // below 2^subBucketBits (2048 for 3 digits) the values are counted exactly
+    const small = Array.from({ length: 1000 }, (_, i) => i)
+    const histogram = new Histogram(3)
+    small.forEach((v) => histogram.record(v))
+    assert.deepEqual(histogram.summary(), { count: 1000, min: 0, max: 999, mean: 499.5, p50: 499, p90: 899, p99: 989, p999: 998 })
+
+    // uniform
+    const uniform = Array.from({ length: 100000 }, (_, i) => (i + 1) * 1000)
+    const uniformHistogram = new Histogram(3)
+    uniform.forEach((v) => uniformHistogram.record(v))
+    assertSummary(uniformHistogram, uniform, 3)
+
+    // geometric (latencies spanning many powers of two), lower precision
+    const geometric = Array.from({ length: 4000 }, (_, i) => Math.round(1000 * 1.005 ** i))
+    const geometricHistogram = new Histogram(2)
+    geometric.forEach((v) => geometricHistogram.record(v))
+    assertSummary(geometricHistogram, geometric, 2)
+
+    // bimodal: 1% slow outliers decide p99.9 but not p99
+    const bimodal = [...Array(990).fill(200000), ...Array(10).fill(5000000000)]
+    const bimodalHistogram = new Histogram(3)
+    bimodal.forEach((v) => bimodalHistogram.record(v))
+    assertSummary(bimodalHistogram, bimodal, 3)
+    assert.ok(bimodalHistogram.percentile(99) < 200300)
+    assert.ok(bimodalHistogram.percentile(99.9) >= 5000000000)
+
+    // add() of two halves equals the whole, record() with a count equals repeated records
+    const halves = [new Histogram(3), new Histogram(3)]
+    uniform.forEach((v, i) => halves[i % 2].record(v))
+    halves[0].add(halves[1])
+    assert.deepEqual(halves[0].summary(), uniformHistogram.summary())
+    const counted = new Histogram(3)
+    counted.record(200000, 990)
+    counted.record(5000000000, 10)
+    assert.deepEqual(counted.summary(), bimodalHistogram.summary())
+
+    const empty = new Histogram(3)
+    assert.deepEqual(empty.summary(), { count: 0, min: 0, max: 0, mean: 0, p50: 0, p90: 0, p99: 0, p999: 0 })
+}
+
+testStep(" - - -", "HistogramObserver: APDUs and operations of a signed transaction");
+{
+    const recording = new RecordingTransport(new SimulatorTransport())
+    const fio = new Fio(recording)
+    const metrics = new HistogramObserver()
+    fio.setObserver(metrics)
+    await fio.signTransaction({ path, chainId, tx })
+    const { apdus, operations } = metrics.snapshot()
+    assert.equal(apdus.reduce((count, stats) => count + stats.count, 0), recording.transcript.length)
+    assert.deepEqual(apdus.map((stats) => stats.latencyNs.count), apdus.map((stats) => stats.count))
+    assert.equal(apdus.reduce((bytes, stats) => bytes + stats.bytesOut, 0),
+        recording.transcript.reduce((bytes, entry) => bytes + entry.apdu.length / 2, 0))
+    assert.deepEqual(operations.map(({ operation, count, errors, apduCount }) => ({ operation, count, errors, apduCount })),
+        [{ operation: "signTransaction", count: 1, errors: 0, apduCount: recording.transcript.length }])
+}
+
+// Known answers of secp256k1, the keys and signatures are made with OpenSSL (node crypto).
+// The private keys 1, 2 and N-1 give G, 2G and -G. The recovery byte is 27 + 4 + recovery id.
+const N = BigInt("0xfffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364141")
+const RECOVERY_VECTORS = [
+    {
+        privateKey: "1",
+        publicKeyHex: "0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798483ada7726a3c4655da4fbfc0e1108a8fd17b448a68554199c47d08ffb10d4b8",
+        hashHex: "00f36abc41581760e901196619a713e591017365b2ded38d3bf2fe850beaf913",
+        signatureHex: "1f7c02aa78a23a97f55f8cf6cc726f5212600508cfbaa0027be9f22dab1f06b5690eadb55a40a525dae1dcc8f42b69a1dcb43c4596ea4a913a035cb76d6d8d8938",
+    },
+    {
+        privateKey: "2",
+        publicKeyHex: "04c6047f9441ed7d6d3045406e95c07cd85c778e4b8cef3ca7abac09b95c709ee51ae168fea63dc339a3c58419466ceaeef7f632653266d0e1236431a950cfe52a",
+        hashHex: "ee99614d6913635482a093ba6a5d70e25d9c16c6845decc0f28064027d13a462",
+        // high s
+        signatureHex: "2042063dd2ee84228553bcaa55bd5517a72410e36c46575007e22aed53dbe04d58a7f713a1fb99b15afd318b95e522fc995ea0605877532bef9c36dac8e915a412",
+    },
+    {
+        privateKey: "N-1",
+        publicKeyHex: "0479be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798b7c52588d95c3b9aa25b0403f1eef75702e84bb7597aabe663b82f6f04ef2777",
+        hashHex: "7a12952df0b8f65c200adeb160446dccc4175a4e5802510855df75e35ded17a7",
+        // high s
+        signatureHex: "2012ece7fd7e375546888d0e880b6b659d80ca5f8c7e6664709978a07e5fba9c5ef8958ad450e97b1d4b8326a9a20ad4799bc1c62d8ffa434e5966429e6cb798e2",
+    },
+    {
+        // the key of the path used by the tests, signatures of the app (RFC 6979 nonce, low s)
+        privateKey: "4d597899db76e87933e7c6841c2d661810f070bad20487ef20eb84e182695a3a",
+        publicKeyHex: "04a9a222bc3b1a5a58ada17d10069b3961ebd0f917d4b2106031a061915ca9cc24a06941e0a4c0d5e266850ff980ad349ab8b027c93bf4aead1984168ad43e30ab",
+        hashHex: "c232b6147b9ee78aa9ad0ef4ff66874e6d5b23467426457ddd4c5248e9b5d066",
+        signatureHex: "1f2c368e247f4a91fa544b5998c32906970d520b28987a5134be6e650f4d37d5924dc40e9b84a9f0c3fd0ef97deb45ca0baa4ae28bcc46599387e4aa782831ab7c",
+    },
+    {
+        privateKey: "4d597899db76e87933e7c6841c2d661810f070bad20487ef20eb84e182695a3a",
+        publicKeyHex: "04a9a222bc3b1a5a58ada17d10069b3961ebd0f917d4b2106031a061915ca9cc24a06941e0a4c0d5e266850ff980ad349ab8b027c93bf4aead1984168ad43e30ab",
+        hashHex: "5d482c8685aeacceca1a7fb1df270e11a20393f0fbf9097179441456f24d2ecb",
+        signatureHex: "20292c7419c0827da948c5292c1c495ff2488d9e20a0829c439ed81c13e5810e957c1171c0520fcb35ebb72dc90c187e85676e0629034c11ad8c24325814d08538",
+    },
+]
+
+const hex32 = (n) => n.toString(16).padStart(64, "0")
+const signatureOf = (recoveryByte, r, s) => recoveryByte.toString(16) + hex32(r) + hex32(s)
+// the recovery byte of the other parity of y of R
+const otherParity = (recoveryByte) => 31 + ((recoveryByte - 31) ^ 1)
+const parseSignature = (signatureHex) => ({
+    recoveryByte: parseInt(signatureHex.slice(0, 2), 16),
+    r: BigInt("0x" + signatureHex.slice(2, 66)),
+    s: BigInt("0x" + signatureHex.slice(66)),
+})
+
+testStep(" - - -", "recoverSigner: known answers, both values of s");
+for (const { publicKeyHex, hashHex, signatureHex } of RECOVERY_VECTORS) {
+    const signer = recoverSigner(hashHex, signatureHex)
+    assert.equal(signer.publicKeyHex, publicKeyHex)
+    assert.equal(verifySigner({ txHashHex: hashHex, witness: { witnessSignatureHex: signatureHex } }, signer.publicKeyWIF), true)
+
+    // (r, N - s) is the signature of the same key with the nonce -k, whose point has the other y
+    const { recoveryByte, r, s } = parseSignature(signatureHex)
+    assert.equal(recoverSigner(hashHex, signatureOf(otherParity(recoveryByte), r, N - s)).publicKeyHex, publicKeyHex)
+
+    // the other parity of R is another key, so is another hash
+    assert.notEqual(recoverSigner(hashHex, signatureOf(otherParity(recoveryByte), r, s)).publicKeyHex, publicKeyHex)
+    const otherHashHex = hashHex.slice(0, 63) + (hashHex[63] === "0" ? "1" : "0")
+    assert.equal(verifySigner({ txHashHex: otherHashHex, witness: { witnessSignatureHex: signatureHex } }, publicKeyHex), false)
+}
+assert.equal(recoverSigner(RECOVERY_VECTORS[3].hashHex, RECOVERY_VECTORS[3].signatureHex).publicKeyWIF, "FIO87wawwaniQzqWPmNaCqGkiUNmCAhq9PiGUVNKKjRMTYgoBfKYa")
+
+testStep(" - - -", "recoverSigner: invalid signatures");
+{
+    const { hashHex, signatureHex } = RECOVERY_VECTORS[3]
+    const { recoveryByte, r, s } = parseSignature(signatureHex)
+    const invalid = [
+        signatureOf(recoveryByte, 0n, s),
+        signatureOf(recoveryByte, r, 0n),
+        signatureOf(recoveryByte, N, s),
+        signatureOf(recoveryByte, r, N),
+        signatureOf(recoveryByte, r, N + 1n),
+        // no point of the curve has x = 5
+        signatureOf(recoveryByte, 5n, s),
+        // recovery ids other than 0 to 3
+        signatureOf(27, r, s),
+        signatureOf(31 + 4, r, s),
+        signatureHex.slice(0, 128),
+        signatureHex + "00",
+    ]
+    for (const witnessSignatureHex of invalid) {
+        assert.throws(() => recoverSigner(hashHex, witnessSignatureHex), InvalidData, witnessSignatureHex)
+        assert.equal(verifySigner({ txHashHex: hashHex, witness: { witnessSignatureHex } }, RECOVERY_VECTORS[3].publicKeyHex), false)
+    }
+    assert.throws(() => recoverSigner(hashHex.slice(2), signatureHex), InvalidData)
+}
+
+testStep(" - - -", "recoverSigner: signatures of the simulator");
+{
+    const fio = new Fio(new SimulatorTransport())
+    const { publicKeyWIF } = await fio.getPublicKey({ path, show_or_not: false })
+    for (const amount of ["1", "2", "3"]) {
+        const signed = await fio.signTransaction({ path, chainId, tx: txWithAmount(amount) })
+        assert.equal(verifySigner(signed, publicKeyWIF), true)
+    }
+}
+
+testEnd(scriptName);
+process.stdin.pause()
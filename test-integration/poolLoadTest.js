@@ -0,0 +1,57 @@
+import SpeculosTransport from "@ledgerhq/hw-transport-node-speculos";
+import { Fio, FioPool, HARDENED } from "ledgerjs-hw-app-fio"
+import assert from 'assert/strict';
+import { humanTime } from "./speculos-common.js"
+
+// Load test of FioPool: runs the same requests on pools of 1, 2, 4, ... speculos instances
+// and reports the throughput of each pool size. The instances listen on the APDU ports
+// TEST_SPECULOS_APDU_PORT, TEST_SPECULOS_APDU_PORT + 1, ... (see speculos_pool_load_test).
+// Requests are public keys exported without a prompt, routed by the public key, so that
+// no buttons have to be pressed.
+//
+// Usage: node poolLoadTest.js <number of instances> [<requests per pool size>]
+
+const instances = parseInt(process.argv[2] ?? "1")
+const requests = parseInt(process.argv[3] ?? "200")
+const firstApduPort = parseInt(process.env.TEST_SPECULOS_APDU_PORT ?? "40001")
+
+const transports = []
+for (let i = 0; i < instances; i++) {
+    transports.push(await SpeculosTransport.default.open({ apduPort: firstApduPort + i }))
+}
+
+// the instances run with the same seed, each of them holds the keys
+const paths = Array.from({ length: 8 }, (_, i) => [44 + HARDENED, 235 + HARDENED, 0 + HARDENED, 0, i])
+const expected = []
+for (const path of paths) {
+    expected.push((await new Fio(transports[0]).getPublicKey({ path, show_or_not: false })).publicKeyHex)
+}
+
+const sizes = []
+for (let size = 1; size < instances; size *= 2) {
+    sizes.push(size)
+}
+sizes.push(instances)
+
+let baseline = null
+for (const size of sizes) {
+    const pool = new FioPool(transports.slice(0, size).map((transport) => new Fio(transport)))
+    const start = Date.now()
+    await Promise.all(Array.from({ length: requests }, async (_, i) => {
+        const path = paths[i % paths.length]
+        const publicKeyHex = expected[i % paths.length]
+        const response = await pool.getPublicKey({ path, show_or_not: false }, { publicKeyHex })
+        assert.equal(response.publicKeyHex, publicKeyHex)
+    }))
+    const throughput = requests * 1000 / (Date.now() - start)
+    baseline = baseline ?? throughput
+    const stats = pool.stats()
+    assert.equal(stats.failed, 0)
+    console.log(humanTime() + " poolLoadTest() // " + size + " device(s): " + throughput.toFixed(1) + " requests/s, "
+        + (throughput / baseline).toFixed(2) + "x, per device: " + stats.devices.map((device) => device.completed).join(" "))
+}
+
+for (const transport of transports) {
+    await transport.close()
+}
+process.stdin.pause()
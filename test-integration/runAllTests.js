@@ -0,0 +1,52 @@
+import { humanTime } from "./speculos-common.js"
+import { useSharedTransport, closeSharedTransport } from "./speculos-transport.js"
+
+// Runs the given test files one after another in this process instead of one node process
+// per file: fiojs, the chain info and ABIs, the transport and the speculos event stream are
+// set up once. Every file is imported as its own module, so the tests keep their own state.
+// A failed file does not stop the run, the transport is reopened for the next one.
+//
+// Usage: node runAllTests.js <test file>...
+
+const files = process.argv.slice(2)
+if (files.length == 0) {
+    console.log("Usage: node runAllTests.js <test file>...")
+    process.exit(2)
+}
+
+// An unhandled rejection (e.g. a button press that failed without being awaited, or a pending
+// signTransaction() of a failed test rejecting later) must not end the run, but it fails the
+// file that is running when it is reported.
+let rejections = []
+process.on("unhandledRejection", (reason) => {
+    console.log(humanTime() + " runAllTests() // unhandled rejection: " + (reason && reason.stack ? reason.stack : reason))
+    rejections.push(reason)
+})
+
+// unhandled rejections are reported after the microtasks, let those of the finished file come
+const settle = () => new Promise(resolve => setImmediate(resolve))
+
+useSharedTransport()
+
+const failed = []
+for (const file of files) {
+    const start = Date.now()
+    rejections = []
+    try {
+        await import("./" + file)
+        await settle()
+        if (rejections.length > 0) {
+            throw new Error(rejections.length + " unhandled rejection(s), see above")
+        }
+        console.log(humanTime() + " runAllTests() // " + file + " passed in " + (Date.now() - start) + "ms")
+    } catch (err) {
+        console.log(humanTime() + " runAllTests() // " + file + " FAILED: " + (err && err.stack ? err.stack : err))
+        failed.push(file)
+        await closeSharedTransport().catch(() => {})
+    }
+}
+await closeSharedTransport()
+
+console.log(humanTime() + " runAllTests() // " + (files.length - failed.length) + "/" + files.length + " test files passed" + (failed.length ? ", FAILED: " + failed.join(" ") : ""))
+process.exitCode = failed.length == 0 ? 0 : 1
+process.stdin.pause()
@@ -42,7 +42,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing INIT, APPEND_
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -56,7 +56,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing INIT, APPEND_
     const buffer13 = getAPDUDataBuffer("0854657374204b65790a546573742056616c7565", "");
     const promise13 = transport.send(215, 0x20, 0x03, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response13 = await promise13;
     assert.equal(response13.toString("hex"), "9000");
 
@@ -83,7 +83,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing INIT, APPEND_
     const buffer11 = getAPDUDataBuffer("", "21dcae42c0182200e93f954a074011f9048a7624c6fe81d3c9541a614a88bd1c052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -97,7 +97,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing INIT, APPEND_
     const buffer13 = getAPDUDataBuffer("0854657374204b65790a546573742056616c7565", "");
     const promise13 = transport.send(215, 0x20, 0x03, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response13 = await promise13;
     assert.equal(response13.toString("hex"), "9000");
 
@@ -124,7 +124,7 @@ testStep(" - - -", "One byte constant data difference should cause integrity val
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -138,7 +138,7 @@ testStep(" - - -", "One byte constant data difference should cause integrity val
     const buffer13 = getAPDUDataBuffer("0854657374204b65790a556573742056616c7565", "");
     const promise13 = transport.send(215, 0x20, 0x03, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response13 = await promise13;
     assert.equal(response13.toString("hex"), "9000");
 
@@ -164,7 +164,7 @@ testStep(" - - -", "Incorrect lengths should lead to failure");
     const buffer11 = getAPDUDataBuffer("", "21dcae42c0182200e93f954a074011f9048a7624c6fe81d3c9541a614a88bd1c052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -182,7 +182,7 @@ testStep(" - - -", "Non ASCII character in message");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
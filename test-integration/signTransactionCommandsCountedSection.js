@@ -41,7 +41,7 @@ testStep(" - - -", "Sign minimal fake devel transaction cotaining COUNTED_SECTIO
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -136,7 +136,7 @@ testStep(" - - -", "Validation failure");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -154,7 +154,7 @@ testStep(" - - -", "VarInt32 incorrect format");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -172,7 +172,7 @@ testStep(" - - -", "VarInt32 too many bytes");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -190,7 +190,7 @@ testStep(" - - -", "Too big for UInt32");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -208,7 +208,7 @@ testStep(" - - -", "too much nesting");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -267,7 +267,7 @@ testStep(" - - -", "Unexpected end counted section");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -286,7 +286,7 @@ testStep(" - - -", "Length mismatch");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -44,7 +44,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -53,7 +53,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
     let dhEncodedMsg = response12.slice(0, -2).toString("hex");
@@ -69,7 +69,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     const buffer14 = getAPDUDataBuffer("0201000000000000000000000000000000000506537472696e67", "4e69636520616e64206c6f6e67206c6f6e67206c6f6e67206c6f6e6720737472696e67");
     const promise14 = transport.send(215, 0x20, 0x04, 0, buffer14);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response14 = await promise14;
     assert.equal(response14.slice(-2).toString("hex"), "9000");
     dhEncodedMsg += response14.slice(0, -2).toString("hex");
@@ -78,7 +78,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     const buffer15 = getAPDUDataBuffer("", "");
     const promise15 = transport.send(215, 0x20, 0x09, 0, buffer15);
     await device.curlScreenShot();
-    device.curlButton("right", "Confirm create shared secret"); //!!!!!!
+    await device.curlButton("right", "Confirm create shared secret"); //!!!!!!
     const response15 = await promise15;
     assert.equal(response15.slice(-2).toString("hex"), "9000");
     dhEncodedMsg += response15.slice(0, -2).toString("hex");
@@ -115,7 +115,7 @@ testStep(" - - -", "Ending DH encoding without beggining it does not work");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -134,7 +134,7 @@ testStep(" - - -", "Nested DH encryption disallowed");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -143,7 +143,7 @@ testStep(" - - -", "Nested DH encryption disallowed");
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
 
@@ -160,7 +160,7 @@ testStep(" - - -", "You can restart DH encryption. You cannot finish the transac
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -169,7 +169,7 @@ testStep(" - - -", "You can restart DH encryption. You cannot finish the transac
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
 
@@ -177,7 +177,7 @@ testStep(" - - -", "You can restart DH encryption. You cannot finish the transac
     const buffer13 = getAPDUDataBuffer("", "");
     const promise13 = transport.send(215, 0x20, 0x09, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("right", "Confirm create shared secret"); //!!!!!!
+    await device.curlButton("right", "Confirm create shared secret"); //!!!!!!
     const response13 = await promise13;
     assert.equal(response13.slice(-2).toString("hex"), "9000");
 
@@ -185,7 +185,7 @@ testStep(" - - -", "You can restart DH encryption. You cannot finish the transac
     const buffer14 = getAPDUDataBuffer("", otherPublicKey);
     const promise14 = transport.send(215, 0x20, 0x08, 0, buffer14);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response14 = await promise14;
     assert.equal(response14.slice(-2).toString("hex"), "9000");
 
@@ -204,7 +204,7 @@ testStep(" - - -", "If you reject DH encryption it fails imediately, without exp
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -213,7 +213,7 @@ testStep(" - - -", "If you reject DH encryption it fails imediately, without exp
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
 
@@ -221,7 +221,7 @@ testStep(" - - -", "If you reject DH encryption it fails imediately, without exp
     const buffer13 = getAPDUDataBuffer("", "");
     const promise13 = transport.send(215, 0x20, 0x09, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("left", "Reject create shared secret"); //!!!!!!
+    await device.curlButton("left", "Reject create shared secret"); //!!!!!!
     await assert.rejects(promise13, err(0x6e09));
 
     await device.makeStartingScreenshot();
@@ -234,7 +234,7 @@ testStep(" - - -", "Modifying anything within DH block should lead to integrity
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -243,7 +243,7 @@ testStep(" - - -", "Modifying anything within DH block should lead to integrity
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
     let dhEncodedMsg = response12.slice(0, -2).toString("hex");
@@ -259,7 +259,7 @@ testStep(" - - -", "Modifying anything within DH block should lead to integrity
     const buffer14 = getAPDUDataBuffer("0201000000000000000000000000000000000506537472696e67", "4e69636520616e64206c6f6e67206c6f6e67206c6f6e67206c6f6e6720737472696e67");
     const promise14 = transport.send(215, 0x20, 0x04, 0, buffer14);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response14 = await promise14;
     assert.equal(response14.slice(-2).toString("hex"), "9000");
     dhEncodedMsg += response14.slice(0, -2).toString("hex");
@@ -44,7 +44,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -61,7 +61,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
     let dhEncodedMsg = response12.slice(0, -2).toString("hex");
@@ -95,7 +95,7 @@ testStep(" - - -", "Sign minimal devel DH tranaction");
     const buffer15 = getAPDUDataBuffer("", "");
     const promise15 = transport.send(215, 0x20, 0x09, 0, buffer15);
     await device.curlScreenShot();
-    device.curlButton("right", "Confirm create shared secret"); //!!!!!!
+    await device.curlButton("right", "Confirm create shared secret"); //!!!!!!
     const response15 = await promise15;
     assert.equal(response15.slice(-2).toString("hex"), "9000");
     dhEncodedMsg += response15.slice(0, -2).toString("hex");
@@ -140,7 +140,7 @@ testStep(" - - -", "You cannt just end counted section within DH encription with
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -157,7 +157,7 @@ testStep(" - - -", "You cannt just end counted section within DH encription with
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
 
@@ -176,7 +176,7 @@ testStep(" - - -", "Counted section from within DH encoding mus be finished");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -185,7 +185,7 @@ testStep(" - - -", "Counted section from within DH encoding mus be finished");
     const buffer12 = getAPDUDataBuffer("", otherPublicKey);
     const promise12 = transport.send(215, 0x20, 0x08, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "message");
+    await device.curlButton("both", "message");
     const response12 = await promise12;
     assert.equal(response12.slice(-2).toString("hex"), "9000");
 
@@ -41,7 +41,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -49,7 +49,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer12 = getAPDUDataBuffer("0102000000000000000008000000000000000509486578537472696e67", "0011223344556677");
     const promise12 = transport.send(215, 0x20, 0x04, 0, buffer12);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response12 = await promise12;
     assert.equal(response12.toString("hex"), "9000");
 
@@ -57,7 +57,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer13 = getAPDUDataBuffer("0201000000000000000000000000000000000506537472696e67", "4e69636520616e64206c6f6e67206c6f6e67206c6f6e67206c6f6e6720737472696e67");
     const promise13 = transport.send(215, 0x20, 0x04, 0, buffer13);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response13 = await promise13;
     assert.equal(response13.toString("hex"), "9000");
 
@@ -65,7 +65,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer14 = getAPDUDataBuffer("030100000000000000000000000000000000050a4e616d65537472696e67", "0000980ad20ca85b");
     const promise14 = transport.send(215, 0x20, 0x04, 0, buffer14);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response14 = await promise14;
     assert.equal(response14.toString("hex"), "9000");
 
@@ -73,7 +73,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer15 = getAPDUDataBuffer("1001000000000000000000000000000000000506416d6f756e74", "0100000000000000");
     const promise15 = transport.send(215, 0x20, 0x04, 0, buffer15);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response15 = await promise15;
     assert.equal(response15.toString("hex"), "9000");
 
@@ -81,7 +81,7 @@ testStep(" - - -", "Sign minimal fake devel transaction containing SHOW_DATA ins
     const buffer16 = getAPDUDataBuffer("14010000000000000000000000000000000005064e756d626572", "0200000000000000");
     const promise16 = transport.send(215, 0x20, 0x04, 0, buffer16);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response16 = await promise16;
     assert.equal(response16.toString("hex"), "9000");
 
@@ -122,7 +122,7 @@ testStep(" - - -", "Unknown data type leads to failure");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -140,7 +140,7 @@ testStep(" - - -", "Buffer does not pass length validation");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -158,7 +158,7 @@ testStep(" - - -", "Key length does not match");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -176,7 +176,7 @@ testStep(" - - -", "Key contains invalid symbols");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -194,7 +194,7 @@ testStep(" - - -", "Key too long");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -212,7 +212,7 @@ testStep(" - - -", "String value contains non readable characters");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -230,7 +230,7 @@ testStep(" - - -", "Name string has incorrect length");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -248,7 +248,7 @@ testStep(" - - -", "Amount incorrect length");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -266,7 +266,7 @@ testStep(" - - -", "UInt64 incorrect length");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -284,7 +284,7 @@ testStep(" - - -", "Policy show if not empty empty check");
     const buffer11 = getAPDUDataBuffer("", "b20901380af44ef59c5918439a1f9a41d83669020319a80574b804a5f95cbd7e052c000080eb000080000000800000000000000000");
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -298,7 +298,7 @@ testStep(" - - -", "Policy show if not empty empty check");
     const buffer17 = getAPDUDataBuffer("0201000000000000000000000000000000000606537472696e67", "53");
     const promise17 = transport.send(215, 0x20, 0x04, 0, buffer17);
     await device.curlScreenShot();
-    device.curlButton("both", "Comfirm String");
+    await device.curlButton("both", "Comfirm String");
     const response17 = await promise17;
     assert.equal(response17.toString("hex"), "9000");
 
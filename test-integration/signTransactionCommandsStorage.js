@@ -42,7 +42,7 @@ testStep(" - - -", "Sign transaction using storage");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -62,7 +62,7 @@ testStep(" - - -", "Sign transaction using storage");
     const buffer14 = getAPDUDataBuffer("0101000000000000000000000000000000001509486578537472696e67", "001122334455");
     const promise14 = transport.send(215, 0x20, 0x04, 0, buffer14);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response14 = await promise14;
     assert.equal(response14.toString("hex"), "9000");
 
@@ -70,7 +70,7 @@ testStep(" - - -", "Sign transaction using storage");
     const buffer15 = getAPDUDataBuffer("0101000000000000000000000000000000003509486578537472696e67", "00112233445566778899aa");
     const promise15 = transport.send(215, 0x20, 0x04, 0, buffer15);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm message"); //!!!!!!
+    await device.curlButton("both", "Confirm message"); //!!!!!!
     const response15 = await promise15;
     assert.equal(response15.toString("hex"), "9000");
     
@@ -100,7 +100,7 @@ testStep(" - - -", "Storing too long data");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -119,7 +119,7 @@ testStep(" - - -", "Data do not match");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
@@ -144,7 +144,7 @@ testStep(" - - -", "Data do not match using name conversion");
     console.log(buffer11.toString("hex"))
     const promise11 = transport.send(215, 0x20, 0x01, 0, buffer11);
     await device.curlScreenShot();
-    device.curlButton("both", "Confirm chain"); //!!!!!!
+    await device.curlButton("both", "Confirm chain"); //!!!!!!
     const response11 = await promise11;
     assert.equal(response11.toString("hex"), "9000");
 
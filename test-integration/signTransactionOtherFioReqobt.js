@@ -4,7 +4,7 @@ import { getButtonsAndSnapshots } from "./speculos-buttons-and-snapshots.js"
 import { Fio, DeviceStatusError, HARDENED } from "ledgerjs-hw-app-fio"
 import { fileURLToPath } from 'url';
 import assert from 'assert/strict';
-import fetch from "node-fetch"
+import { getChainInfo, getAbi } from "./chain-fixtures.js"
 import crypto from "crypto"
 
 import textenc from "text-encoding"
@@ -30,33 +30,15 @@ const textEncoder = new TextEncoder()
 const httpEndpointTestnet = 'http://testnet.fioprotocol.io'
 const httpEndpointMainnet = 'https://fio.greymass.com'
 
-const infoTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_info')).json()
-const infoMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_info')).json()
-
-const abiFioAddressTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.token"}`,
-    method: 'POST',
-})).json()
-const abiMsigTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "eosio.msig"}`,
-    method: 'POST',
-})).json()
-const abiFioAddressMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.token"}`,
-    method: 'POST',
-})).json()
-const abiMsigMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "eosio.msig"}`,
-    method: 'POST',
-})).json()
-const abiReqobtMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.reqobt"}`,
-    method: 'POST',
-})).json()
-const abiReqobtTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.reqobt"}`,
-    method: 'POST',
-})).json()
+const infoTestnet = await getChainInfo(httpEndpointTestnet)
+const infoMainnet = await getChainInfo(httpEndpointMainnet)
+
+const abiFioAddressTestnet = await getAbi(httpEndpointTestnet, "fio.token")
+const abiMsigTestnet = await getAbi(httpEndpointTestnet, "eosio.msig")
+const abiFioAddressMainnet = await getAbi(httpEndpointMainnet, "fio.token")
+const abiMsigMainnet = await getAbi(httpEndpointMainnet, "eosio.msig")
+const abiReqobtMainnet = await getAbi(httpEndpointMainnet, "fio.reqobt")
+const abiReqobtTestnet = await getAbi(httpEndpointTestnet, "fio.reqobt")
 
 // Get a Map of all the types from fio.address
 const typesFioAddressTestnet = ser.getTypesFromAbi(ser.createInitialTypes(), abiFioAddressTestnet.abi)
@@ -1,10 +1,10 @@
 import { testStart, testStep, testEnd, getScriptName, getSpeculosDefaultConf } from "./speculos-common.js"
 import { getTransport } from "./speculos-transport.js"
 import { getButtonsAndSnapshots } from "./speculos-buttons-and-snapshots.js"
-import { Fio, DeviceStatusError, HARDENED } from "ledgerjs-hw-app-fio"
+import { Fio, DeviceStatusError, HARDENED, recoverSigner } from "ledgerjs-hw-app-fio"
 import { fileURLToPath } from 'url';
 import assert from 'assert/strict';
-import fetch from "node-fetch"
+import { getChainInfo, getAbi } from "./chain-fixtures.js"
 import crypto from "crypto"
 
 import textenc from "text-encoding"
@@ -30,25 +30,13 @@ const textEncoder = new TextEncoder()
 const httpEndpointTestnet = 'http://testnet.fioprotocol.io'
 const httpEndpointMainnet = 'https://fio.greymass.com'
 
-const infoTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_info')).json()
-const infoMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_info')).json()
-
-const abiFioAddressTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.token"}`,
-    method: 'POST',
-})).json()
-const abiMsigTestnet = await (await fetch(httpEndpointTestnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "eosio.msig"}`,
-    method: 'POST',
-})).json()
-const abiFioAddressMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "fio.token"}`,
-    method: 'POST',
-})).json()
-const abiMsigMainnet = await (await fetch(httpEndpointMainnet + '/v1/chain/get_abi', {
-    body: `{"account_name": "eosio.msig"}`,
-    method: 'POST',
-})).json()
+const infoTestnet = await getChainInfo(httpEndpointTestnet)
+const infoMainnet = await getChainInfo(httpEndpointMainnet)
+
+const abiFioAddressTestnet = await getAbi(httpEndpointTestnet, "fio.token")
+const abiMsigTestnet = await getAbi(httpEndpointTestnet, "eosio.msig")
+const abiFioAddressMainnet = await getAbi(httpEndpointMainnet, "fio.token")
+const abiMsigMainnet = await getAbi(httpEndpointMainnet, "eosio.msig")
 
 // Get a Map of all the types from fio.address
 const typesFioAddressTestnet = ser.getTypesFromAbi(ser.createInitialTypes(), abiFioAddressTestnet.abi)
@@ -185,6 +173,24 @@ const device = getButtonsAndSnapshots(scriptName, speculosConf);
 
 await device.makeStartingScreenshot();
 
+// the signer recovered on the host must be the key of the path on the device
+const {publicKeyHex: signerKeyHex} = await app.getPublicKey({path, show_or_not: false})
+
+testStep(" - - -", "Recover signer of known signatures");
+{
+    // signatures of path 44'/235'/0'/0/0 with recovery id 0 (header 0x1f) and 1 (header 0x20),
+    // checked by an independent ECDSA verification against the key of the path
+    const vectors = [
+        ["c232b6147b9ee78aa9ad0ef4ff66874e6d5b23467426457ddd4c5248e9b5d066", "1f2c368e247f4a91fa544b5998c32906970d520b28987a5134be6e650f4d37d5924dc40e9b84a9f0c3fd0ef97deb45ca0baa4ae28bcc46599387e4aa782831ab7c"],
+        ["5d482c8685aeacceca1a7fb1df270e11a20393f0fbf9097179441456f24d2ecb", "20292c7419c0827da948c5292c1c495ff2488d9e20a0829c439ed81c13e5810e957c1171c0520fcb35ebb72dc90c187e85676e0629034c11ad8c24325814d08538"],
+    ]
+    for (const [hashHex, signatureHex] of vectors) {
+        const signer = recoverSigner(hashHex, signatureHex)
+        assert.equal(signer.publicKeyHex, "04a9a222bc3b1a5a58ada17d10069b3961ebd0f917d4b2106031a061915ca9cc24a06941e0a4c0d5e266850ff980ad349ab8b027c93bf4aead1984168ad43e30ab")
+        assert.equal(signer.publicKeyWIF, "FIO87wawwaniQzqWPmNaCqGkiUNmCAhq9PiGUVNKKjRMTYgoBfKYa")
+        assert.equal(signer.publicKeyHex, signerKeyHex)
+    }
+}
 
 testStep(" - - -", "Sign testnet transaction");
 {
@@ -206,6 +212,7 @@ testStep(" - - -", "Sign testnet transaction");
     assert.equal(ledgerResponse.txHashHex, hash);
     assert.equal(signatureLedger.verify(fullMsg, publicKey), true);
     assert.equal(signatureLedger.verify(fullMsg, otherPublicKey), false);
+    assert.equal(recoverSigner(ledgerResponse.txHashHex, ledgerResponse.witness.witnessSignatureHex).publicKeyHex, signerKeyHex);
 }
 
 testStep(" - - -", "Sign mainnet transaction");
@@ -226,6 +233,7 @@ testStep(" - - -", "Sign mainnet transaction");
     assert.equal(ledgerResponse.txHashHex, hash);
     assert.equal(signatureLedger.verify(fullMsg, publicKey), true);
     assert.equal(signatureLedger.verify(fullMsg, otherPublicKey), false);
+    assert.equal(recoverSigner(ledgerResponse.txHashHex, ledgerResponse.witness.witnessSignatureHex).publicKeyHex, signerKeyHex);
 }
 
 
@@ -309,6 +317,7 @@ testStep(" - - -", "Sign mainnet transaction - large values");
     assert.equal(ledgerResponse.txHashHex, hash);
     assert.equal(signatureLedger.verify(fullMsg, publicKey), true);
     assert.equal(signatureLedger.verify(fullMsg, otherPublicKey), false);
+    assert.equal(recoverSigner(ledgerResponse.txHashHex, ledgerResponse.witness.witnessSignatureHex).publicKeyHex, signerKeyHex);
 }
 
 await transport.close()
@@ -1,4 +1,7 @@
-import { syncBackTicks, sleep, humanTime } from "./speculos-common.js"
+import { sleep, humanTime } from "./speculos-common.js"
+import crypto from "crypto"
+import fs from "fs"
+import http from "http"
 
 const fioWaitingForCommandsSHA = {
     "nanos": "sha256:13bd32a0f8a2eb3d5723b7e131e439105d63875272e952f703a268a0f1e00728",
@@ -24,6 +27,76 @@ const fioEmptyScreenSHA = {
     "nanosp": "sha256:6dde663afd5a4b7cf8f4955a8a4b035d358affcb661f18bda910ec837a70ee77",
 } 
 
+// HTTP requests to the speculos API are made in-process, with a keep-alive connection
+const speculosAgent = new http.Agent({ keepAlive: true });
+
+function speculosRequest(port, method, path, body = null) {
+	return new Promise((resolve, reject) => {
+		const req = http.request({ host: "127.0.0.1", port: port, method: method, path: path, agent: speculosAgent, timeout: 60000 }, (res) => {
+			const chunks = [];
+			res.on("data", (chunk) => chunks.push(chunk));
+			res.on("end", () => resolve(Buffer.concat(chunks)));
+			res.on("error", reject);
+		});
+		req.on("timeout", () => req.destroy(new Error("speculos request timed out: " + method + " " + path)));
+		req.on("error", reject);
+		req.end(body);
+	});
+}
+
+function sha256Of(data) {
+	return "sha256:" + crypto.createHash("sha256").update(data).digest("hex");
+}
+
+// Counts the events of speculos' /events stream (every change of the display produces some)
+// so that we can wait for the next screen change instead of polling screen shots.
+// Without the stream (e.g. older speculos) waitForChange() just waits for the timeout.
+class SpeculosEvents {
+	count = 0;
+	waiters = [];
+
+	constructor(port) {
+		const req = http.get({ host: "127.0.0.1", port: port, path: "/events?stream=true", agent: false }, (res) => {
+			if (res.statusCode != 200) {
+				console.log(humanTime() + " SpeculosEvents() // event stream not available (" + res.statusCode + "), falling back to timed waits");
+				res.resume();
+				return;
+			}
+			res.on("data", () => {
+				this.count++;
+				this.waiters.forEach(resolve => resolve());
+				this.waiters = [];
+			});
+		});
+		req.on("error", (err) => {
+			console.log(humanTime() + " SpeculosEvents() // event stream failed (" + err.message + "), falling back to timed waits");
+		});
+		// the stream must not keep the test process alive
+		req.on("socket", (socket) => socket.unref());
+	}
+
+	// Resolves once there were more than `since` events, or after timeoutMs
+	async waitForChange(since, timeoutMs) {
+		if (this.count > since) return;
+		let timer;
+		await new Promise(resolve => {
+			this.waiters.push(resolve);
+			timer = setTimeout(resolve, timeoutMs);
+		});
+		clearTimeout(timer);
+	}
+}
+
+// One event stream per speculos instance, shared by all the tests run in this process
+const speculosEventsByPort = new Map();
+
+function getSpeculosEvents(port) {
+	if (!speculosEventsByPort.has(port)) {
+		speculosEventsByPort.set(port, new SpeculosEvents(port));
+	}
+	return speculosEventsByPort.get(port);
+}
+
 class ButtonsAndSnapshots {
     scriptName;
     pngNum = 1;
@@ -33,6 +106,8 @@ class ButtonsAndSnapshots {
 
 	fioReadySHA;
 	approveSHA;
+	// SHA256 of the stored PNGs, by file name
+	pngSha256Stored = new Map();
     
     constructor(scriptName, conf) {
         this.scriptName = scriptName;
@@ -42,22 +117,30 @@ class ButtonsAndSnapshots {
 		this.fioWaitingSHA = fioWaitingForCommandsSHA[this.deviceType];
 		this.fioWarningSHA = fioWarningDevelSHA[this.deviceType];
 		this.fioThreeDots = [fioThreeDotsSHA[this.deviceType], fioEmptyScreenSHA[this.deviceType]];
+		this.events = getSpeculosEvents(this.speculosButtonsPort);
     }
 
-	curlButton(which, hint) { // e.g. which: 'left', 'right', or 'both'
+	async curlButton(which, hint) { // e.g. which: 'left', 'right', or 'both'
 		console.log(humanTime() + " curlButton() // " + which + hint);
-		const output = syncBackTicks('curl --silent --show-error --max-time 60 --data \'{"action":"press-and-release"}\' http://127.0.0.1:' + this.speculosButtonsPort + '/button/' + which + ' 2>&1');
+		const output = (await speculosRequest(this.speculosButtonsPort, "POST", "/button/" + which, '{"action":"press-and-release"}')).toString().trim();
 		if (output != '{}') {
-			console.log(humanTime() + " ERROR: unexpected curl stdout: " + output);
+			console.log(humanTime() + " ERROR: unexpected button response: " + output);
 			throw new Error();
 		}
 	}
 
 	async curlButtonAndScreenshot(which, hint) {
-		this.curlButton(which, hint);
+		await this.curlButton(which, hint);
 		return await this.curlScreenShot(which);
 	}
 
+	storedSha256(png) {
+		if (!this.pngSha256Stored.has(png)) {
+			this.pngSha256Stored.set(png, fs.existsSync(png) ? sha256Of(fs.readFileSync(png)) : undefined);
+		}
+		return this.pngSha256Stored.get(png);
+	}
+
 	async curlScreenShot(lastButton = "") {
 		const test_device = this.snapshotName; 
 		const originalScreenshotSHA = this.pngSha256Previous;
@@ -66,47 +149,46 @@ class ButtonsAndSnapshots {
 		console.log(humanTime() + " curlScreenShot() // " + png + ".new.png");
 
 		const makeScreenshot = (process.env.TEST_PNG_RE_GEN_FOR && (this.scriptName.substring(0, process.env.TEST_PNG_RE_GEN_FOR.length) == process.env.TEST_PNG_RE_GEN_FOR));
-		const oldSHAcmd = makeScreenshot ? "" : "echo sha256:`sha256sum $PNG`";
+		const oldSHA = makeScreenshot ? undefined : this.storedSha256(png);
 
         let generateNewScreenshotFromNextCapture = 0;
 		let loops = 0;
+		let eventsSeen = this.events.count;
 		do {
-			// get screenshot
-			const output = syncBackTicks('export PNG=' + png + ' ; curl --silent --show-error --output $PNG.new.png http://127.0.0.1:' + this.speculosButtonsPort + '/screenshot 2>&1 ; echo sha256:`sha256sum $PNG.new.png` ; '+ oldSHAcmd);
-
-			const errorArray = output.match(/Empty reply from server/gi);
-			if (null != errorArray) {
-				console.log(humanTime() + " curl: screen shot: warning: curl failed to grab screen shot");
+			// get screenshot, the events from now on can change the screen
+			eventsSeen = this.events.count;
+			let screenshot;
+			try {
+				screenshot = await speculosRequest(this.speculosButtonsPort, "GET", "/screenshot");
+			} catch (err) {
+				console.log(humanTime() + " screen shot: warning: failed to grab screen shot: " + err.message);
 				throw new Error();
 			}
-			const regex = /sha256:[^\s]*/gm;
-			const sha256Array = output.match(regex); // e.g. ['sha256:f3916e7cbbf8502b3eedbdf40cc6d6063b90f0e4a4814e34f2e7029bdaa4eaac','sha256:f3916e7cbbf8502b3eedbdf40cc6d6063b90f0e4a4814e34f2e7029bdaa4eaac']
+			const newSHA = sha256Of(screenshot);
 
 			// verify, that the screenshot is not the same as previous one
-			if (sha256Array[0] /* newly generated PNG */ == this.pngSha256Previous) {
+			if (newSHA == this.pngSha256Previous) {
 				loops += 1;
 				generateNewScreenshotFromNextCapture = 0
 				if (loops < 20) {
-					if (loops == 15 && lastButton != "" && sha256Array[0] == originalScreenshotSHA) {
+					if (loops == 15 && lastButton != "" && newSHA == originalScreenshotSHA) {
 						await sleep(100);
 						console.log(humanTime() + " Retrying last button press: " +lastButton);
-						this.curlButton(lastButton, " Retry last button press.");
-						await sleep(100);
+						await this.curlButton(lastButton, " Retry last button press.");
 					}
-					console.log(humanTime() + " curlScreenShot() // matches previous screen shot SHA256 (" + this.pngSha256Previous + "); so requesting another screen shot");
-					await sleep(90+10*loops)
+					console.log(humanTime() + " curlScreenShot() // matches previous screen shot SHA256 (" + this.pngSha256Previous + "); so waiting for a screen change");
+					await this.events.waitForChange(eventsSeen, 90+10*loops);
 					continue;
 				} else {
-					console.log(humanTime() + " curlScreenShot() // matches previous screen shot SHA256 (" +  + "); ERROR: giving up because too many tries; curl one-liner output:");
-					console.log(output);
+					console.log(humanTime() + " curlScreenShot() // matches previous screen shot SHA256 (" + newSHA + "); ERROR: giving up because too many tries");
 					console.log(png);
 					console.log(humanTime() + " curlScreenShot() // NOTE: re-run with TEST_PNG_RE_GEN_FOR=" + this.scriptName + " to regenerate PNGs");
 					throw new Error();
 				}
 			}
 
-			if (sha256Array[0] /* newly generated PNG */ == this.fioThreeDots[0] || sha256Array == this.fioThreeDots[1]) {
-				await sleep(90+10*loops)
+			if (newSHA == this.fioThreeDots[0] || newSHA == this.fioThreeDots[1]) {
+				await this.events.waitForChange(eventsSeen, 90+10*loops);
 				continue;
 			}
 
@@ -118,27 +200,31 @@ class ButtonsAndSnapshots {
 					generateNewScreenshotFromNextCapture = 1;
 					continue;
 				}
-				this.pngSha256Previous = sha256Array[0];
+				this.pngSha256Previous = newSHA;
 
 				// second try, we believe the screenshot is correct
 				generateNewScreenshotFromNextCapture = 0;
-				syncBackTicks('export PNG=' + png + ' ; cp $PNG.new.png $PNG');
+				fs.writeFileSync(png + ".new.png", screenshot);
+				fs.writeFileSync(png, screenshot);
+				this.pngSha256Stored.set(png, newSHA);
 				break;
 			}
 			// if we want to compare this screenshot
 			else {
-				this.pngSha256Previous = sha256Array[0];
+				this.pngSha256Previous = newSHA;
 			
 				// if we have it, we are done
-				if (sha256Array[0] == sha256Array[1]) {
+				if (newSHA == oldSHA) {
 					break;
 				}
 
 				//ignore DEVEL/nonDEVEL mismatch
-				if ((sha256Array[0] == this.fioWaitingSHA && sha256Array[1] == this.fioWarningSHA) ||
-				        (sha256Array[1] == this.fioWaitingSHA && sha256Array[0] == this.fioWarningSHA)) {
+				if ((newSHA == this.fioWaitingSHA && oldSHA == this.fioWarningSHA) ||
+				        (oldSHA == this.fioWaitingSHA && newSHA == this.fioWarningSHA)) {
 					break
 				}
+				// keep the differing screen shot for review
+				fs.writeFileSync(png + ".new.png", screenshot);
 				// if we want to ignore the test we are done
 				if (process.env.TEST_IGNORE_SHA256_SUMS >= 1) {
 					console.log(humanTime() + " curlScreenShot() // running tests with TEST_IGNORE_SHA256_SUMS=1 to ignore all PNG differences");
@@ -147,9 +233,8 @@ class ButtonsAndSnapshots {
 				// otherwise, we will try again (this deals with partial capture)
 				loops += 1;
 				if (loops < 20) {
-					await sleep(100+10*loops)
 					console.log(humanTime() + " curlScreenShot() // screen shot: warning: sha256 sums are different; could be partially rendered screen, so re-requesting screen shot // re-run with TEST_IGNORE_SHA256_SUMS=1 to ignore all PNGs");
-					this.pngSha256Previous = sha256Array[0];
+					await this.events.waitForChange(eventsSeen, 100+10*loops);
 					continue;
 				} else {
 					console.log(humanTime() + " curlScreenShot() // screen shot: warning: sha256 sums are different; ERROR: re-requested screen shot too many times // re-run with TEST_IGNORE_SHA256_SUMS=1 to ignore all PNGs");
@@ -257,7 +342,7 @@ class LedgerButtonsAndSnapshots {
 //  		    await sleep(5000);
 		};
 	}
-	curlButton(which, hint) {}
+	async curlButton(which, hint) {}
 	async curlButtonAndScreenshot(which, hint) {}
 	async curlScreenShot(lastButton = "") {}
     async makeStartingScreenshot() {}
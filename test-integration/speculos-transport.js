@@ -2,7 +2,11 @@
 import SpeculosTransport from "@ledgerhq/hw-transport-node-speculos";
 import TransportNodeHid from "@ledgerhq/hw-transport-node-hid"
 
-async function getTransport(speculosConf) {
+// When the tests run in one process (runAllTests.js) they share one transport,
+// transport.close() of the tests is then a no-op and closeSharedTransport() closes it.
+let shared = null;
+
+async function openTransport(speculosConf) {
 	let transport = 0;
 	if (speculosConf.testOn === "ledger") {
 		transport = await TransportNodeHid.default.create(1000);
@@ -13,4 +17,31 @@ async function getTransport(speculosConf) {
     return transport;	
 }
 
-export {getTransport};
+async function getTransport(speculosConf) {
+	if (shared === null) {
+		return await openTransport(speculosConf);
+	}
+	if (shared.transport === null) {
+		const transport = await openTransport(speculosConf);
+		shared.close = transport.close.bind(transport);
+		transport.close = async () => {};
+		shared.transport = transport;
+	}
+	return shared.transport;
+}
+
+function useSharedTransport() {
+	shared = { transport: null, close: null };
+}
+
+// Closes the shared transport, the next getTransport() opens a new one
+async function closeSharedTransport() {
+	if (shared === null || shared.transport === null) {
+		return;
+	}
+	const close = shared.close;
+	shared.transport = null;
+	await close();
+}
+
+export {getTransport, useSharedTransport, closeSharedTransport};